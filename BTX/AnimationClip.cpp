@@ -0,0 +1,249 @@
+#include "BTX\Physics\AnimationClip.h"
+using namespace BTX;
+
+//Keys a cursor walks before a binary search is cheaper
+static const uint uCursorSteps = 4;
+
+//Puts a key in its place by time, a key at the same time is replaced
+template <class T>
+static void InsertKey(AnimationClip::Track<T>& a_Track, float a_fTime, T const& a_Value)
+{
+	auto it = std::lower_bound(a_Track.lTime.begin(), a_Track.lTime.end(), a_fTime);
+	size_t uIndex = it - a_Track.lTime.begin();
+	if (it != a_Track.lTime.end() && *it == a_fTime)
+	{
+		a_Track.lValue[uIndex] = a_Value;
+		return;
+	}
+	a_Track.lTime.insert(it, a_fTime);
+	a_Track.lValue.insert(a_Track.lValue.begin() + uIndex, a_Value);
+}
+//Samples a position or scale track, does nothing if it has no keys
+static void SampleTrack(AnimationClip::Track<vector3> const& a_Track, float a_fTime, uint& a_uCursor, vector3& a_v3Out)
+{
+	uint uKeys = a_Track.lTime.size();
+	if (uKeys == 0)
+		return;
+	if (uKeys == 1 || a_fTime <= a_Track.lTime[0])
+	{
+		a_v3Out = a_Track.lValue[0];
+		return;
+	}
+	if (a_fTime >= a_Track.lTime[uKeys - 1])
+	{
+		a_v3Out = a_Track.lValue[uKeys - 1];
+		return;
+	}
+
+	uint uKey = AnimationClip::FindKey(a_Track.lTime, a_fTime, a_uCursor);
+	a_uCursor = uKey;
+	float fS = (a_fTime - a_Track.lTime[uKey]) / (a_Track.lTime[uKey + 1] - a_Track.lTime[uKey]);
+	switch (a_Track.eInterpolation)
+	{
+	case INTERPOLATION_STEP:
+		a_v3Out = a_Track.lValue[uKey];
+		break;
+	case INTERPOLATION_CUBIC:
+		a_v3Out = AnimationClip::Cubic(a_Track, uKey, fS);
+		break;
+	default:
+		a_v3Out = glm::mix(a_Track.lValue[uKey], a_Track.lValue[uKey + 1], fS);
+		break;
+	}
+}
+//Samples the rotation track, does nothing if it has no keys
+static void SampleTrack(AnimationClip::Track<quaternion> const& a_Track, float a_fTime, uint& a_uCursor, quaternion& a_qOut)
+{
+	uint uKeys = a_Track.lTime.size();
+	if (uKeys == 0)
+		return;
+	if (uKeys == 1 || a_fTime <= a_Track.lTime[0])
+	{
+		a_qOut = a_Track.lValue[0];
+		return;
+	}
+	if (a_fTime >= a_Track.lTime[uKeys - 1])
+	{
+		a_qOut = a_Track.lValue[uKeys - 1];
+		return;
+	}
+
+	uint uKey = AnimationClip::FindKey(a_Track.lTime, a_fTime, a_uCursor);
+	a_uCursor = uKey;
+	float fS = (a_fTime - a_Track.lTime[uKey]) / (a_Track.lTime[uKey + 1] - a_Track.lTime[uKey]);
+	switch (a_Track.eInterpolation)
+	{
+	case INTERPOLATION_STEP:
+		a_qOut = a_Track.lValue[uKey];
+		break;
+	case INTERPOLATION_CUBIC:
+		a_qOut = AnimationClip::Cubic(a_Track, uKey, fS);
+		break;
+	default:
+		a_qOut = glm::slerp(a_Track.lValue[uKey], a_Track.lValue[uKey + 1], fS);
+		break;
+	}
+}
+
+//The big 3
+AnimationClip::AnimationClip(String a_sName, bool a_bLoop)
+{
+	Init();
+	m_sName = a_sName;
+	m_bLoop = a_bLoop;
+}
+AnimationClip::AnimationClip(AnimationClip const& other)
+{
+	Init();
+	m_sName = other.m_sName;
+	m_bLoop = other.m_bLoop;
+	m_fDuration = other.m_fDuration;
+	m_Position = other.m_Position;
+	m_Rotation = other.m_Rotation;
+	m_Scale = other.m_Scale;
+}
+AnimationClip& AnimationClip::operator=(AnimationClip const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		AnimationClip temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+AnimationClip::~AnimationClip(void) { Release(); }
+void AnimationClip::Swap(AnimationClip& other)
+{
+	std::swap(m_sName, other.m_sName);
+	std::swap(m_bLoop, other.m_bLoop);
+	std::swap(m_fDuration, other.m_fDuration);
+	std::swap(m_Position, other.m_Position);
+	std::swap(m_Rotation, other.m_Rotation);
+	std::swap(m_Scale, other.m_Scale);
+}
+void AnimationClip::Release(void)
+{
+	m_Position = Track<vector3>();
+	m_Rotation = Track<quaternion>();
+	m_Scale = Track<vector3>();
+	m_fDuration = 0.0f;
+}
+void AnimationClip::Init(void) { }
+//Accessors
+AnimationClip::Track<vector3> const& AnimationClip::GetPositionTrack(void) { return m_Position; }
+AnimationClip::Track<quaternion> const& AnimationClip::GetRotationTrack(void) { return m_Rotation; }
+AnimationClip::Track<vector3> const& AnimationClip::GetScaleTrack(void) { return m_Scale; }
+float AnimationClip::GetDuration(void) { return m_fDuration; }
+void AnimationClip::SetLoop(bool a_bLoop) { m_bLoop = a_bLoop; }
+bool AnimationClip::IsLoop(void) { return m_bLoop; }
+String AnimationClip::GetName(void) { return m_sName; }
+void AnimationClip::SetInterpolation(eBTX_INTERPOLATION a_ePosition, eBTX_INTERPOLATION a_eRotation, eBTX_INTERPOLATION a_eScale)
+{
+	m_Position.eInterpolation = a_ePosition;
+	m_Rotation.eInterpolation = a_eRotation;
+	m_Scale.eInterpolation = a_eScale;
+}
+//--- Methods
+void AnimationClip::AddPositionKey(float a_fTime, vector3 a_v3Position)
+{
+	InsertKey(m_Position, a_fTime, a_v3Position);
+	m_fDuration = std::max(m_fDuration, a_fTime);
+}
+void AnimationClip::AddRotationKey(float a_fTime, quaternion a_qRotation)
+{
+	InsertKey(m_Rotation, a_fTime, glm::normalize(a_qRotation));
+	//q and -q are the same rotation, keeping each key on the side of the one before it makes
+	//every blend take the short way around
+	for (uint i = 1; i < m_Rotation.lValue.size(); ++i)
+	{
+		if (glm::dot(m_Rotation.lValue[i - 1], m_Rotation.lValue[i]) < 0.0f)
+			m_Rotation.lValue[i] = -m_Rotation.lValue[i];
+	}
+	m_fDuration = std::max(m_fDuration, a_fTime);
+}
+void AnimationClip::AddScaleKey(float a_fTime, vector3 a_v3Scale)
+{
+	InsertKey(m_Scale, a_fTime, a_v3Scale);
+	m_fDuration = std::max(m_fDuration, a_fTime);
+}
+float AnimationClip::WrapTime(float a_fTime)
+{
+	if (m_fDuration <= 0.0f)
+		return 0.0f;
+	if (!m_bLoop)
+		return std::min(std::max(a_fTime, 0.0f), m_fDuration);
+	float fTime = std::fmod(a_fTime, m_fDuration);
+	if (fTime < 0.0f)
+		fTime += m_fDuration;
+	return fTime;
+}
+uint AnimationClip::FindKey(std::vector<float> const& a_lTime, float a_fTime, uint a_uCursor)
+{
+	uint uLast = a_lTime.size() - 2;
+	uint uKey = std::min(a_uCursor, uLast);
+	//time usually moves forward a little each frame, the key is the same one or the next
+	for (uint uStep = 0; uStep < uCursorSteps; ++uStep)
+	{
+		if (a_fTime < a_lTime[uKey])
+		{
+			if (uKey == 0)
+				return 0;
+			--uKey;
+		}
+		else if (uKey < uLast && a_fTime >= a_lTime[uKey + 1])
+			++uKey;
+		else
+			return uKey;
+	}
+	//a jump, like the clip starting over, searches the whole track
+	auto it = std::upper_bound(a_lTime.begin(), a_lTime.end(), a_fTime);
+	uint uFound = static_cast<uint>(it - a_lTime.begin());
+	return uFound == 0 ? 0 : std::min(uFound - 1, uLast);
+}
+vector3 AnimationClip::Cubic(Track<vector3> const& a_Track, uint a_uKey, float a_fS)
+{
+	std::vector<float> const& lTime = a_Track.lTime;
+	std::vector<vector3> const& lValue = a_Track.lValue;
+	uint uPrev = a_uKey > 0 ? a_uKey - 1 : a_uKey;
+	uint uNext = std::min(a_uKey + 2, static_cast<uint>(lTime.size()) - 1);
+	float fSegment = lTime[a_uKey + 1] - lTime[a_uKey];
+	vector3 v3Tangent0 = (lValue[a_uKey + 1] - lValue[uPrev]) * (fSegment / (lTime[a_uKey + 1] - lTime[uPrev]));
+	vector3 v3Tangent1 = (lValue[uNext] - lValue[a_uKey]) * (fSegment / (lTime[uNext] - lTime[a_uKey]));
+
+	//Hermite basis
+	float fS2 = a_fS * a_fS;
+	float fS3 = fS2 * a_fS;
+	return	(2.0f * fS3 - 3.0f * fS2 + 1.0f) * lValue[a_uKey] +
+			(fS3 - 2.0f * fS2 + a_fS) * v3Tangent0 +
+			(-2.0f * fS3 + 3.0f * fS2) * lValue[a_uKey + 1] +
+			(fS3 - fS2) * v3Tangent1;
+}
+quaternion AnimationClip::Cubic(Track<quaternion> const& a_Track, uint a_uKey, float a_fS)
+{
+	//the keys were put on the same hemisphere when added so the control points do not flip
+	std::vector<quaternion> const& lValue = a_Track.lValue;
+	uint uPrev = a_uKey > 0 ? a_uKey - 1 : a_uKey;
+	uint uNext = std::min(a_uKey + 2, static_cast<uint>(lValue.size()) - 1);
+	quaternion qS0 = glm::intermediate(lValue[uPrev], lValue[a_uKey], lValue[a_uKey + 1]);
+	quaternion qS1 = glm::intermediate(lValue[a_uKey], lValue[a_uKey + 1], lValue[uNext]);
+	return glm::normalize(glm::squad(lValue[a_uKey], lValue[a_uKey + 1], qS0, qS1, a_fS));
+}
+void AnimationClip::Sample(float a_fTime, vector3& a_v3Position, quaternion& a_qRotation, vector3& a_v3Scale, AnimationCursor& a_Cursor)
+{
+	float fTime = WrapTime(a_fTime);
+	SampleTrack(m_Position, fTime, a_Cursor.uPosition, a_v3Position);
+	SampleTrack(m_Rotation, fTime, a_Cursor.uRotation, a_qRotation);
+	SampleTrack(m_Scale, fTime, a_Cursor.uScale, a_v3Scale);
+}
+void AnimationClip::Sample(float a_fTime, vector3& a_v3Position, quaternion& a_qRotation, vector3& a_v3Scale)
+{
+	//a cursor past the end of every track is never close, the search starts right away
+	AnimationCursor cursor;
+	cursor.uPosition = cursor.uRotation = cursor.uScale = static_cast<uint>(-1);
+	float fTime = WrapTime(a_fTime);
+	SampleTrack(m_Position, fTime, cursor.uPosition, a_v3Position);
+	SampleTrack(m_Rotation, fTime, cursor.uRotation, a_qRotation);
+	SampleTrack(m_Scale, fTime, cursor.uScale, a_v3Scale);
+}
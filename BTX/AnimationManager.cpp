@@ -0,0 +1,320 @@
+#include "BTX\Physics\AnimationManager.h"
+using namespace BTX;
+
+//Below this angle cosine SLERP would divide by a tiny sine, the keys are blended linearly instead
+static const float fSlerpThreshold = 0.9995f;
+
+AnimationManager* AnimationManager::m_pInstance = nullptr;
+AnimationManager* AnimationManager::GetInstance(void)
+{
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new AnimationManager();
+	}
+	return m_pInstance;
+}
+void AnimationManager::ReleaseInstance(void)
+{
+	if (m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+}
+//The big 3
+AnimationManager::AnimationManager(void) { Init(); }
+AnimationManager::AnimationManager(AnimationManager const& other) { }
+AnimationManager& AnimationManager::operator=(AnimationManager const& other) { return *this; }
+AnimationManager::~AnimationManager(void) { Release(); }
+void AnimationManager::Release(void)
+{
+	ClearInstances();
+	m_lClip.clear();
+}
+void AnimationManager::Init(void) { }
+//Accessors
+uint AnimationManager::GetClipCount(void) { return m_lClip.size(); }
+uint AnimationManager::GetInstanceCount(void) { return m_lTime.size(); }
+uint AnimationManager::GetAppliedCount(void) { return m_uApplied; }
+AnimationClip* AnimationManager::GetClip(uint a_uClip)
+{
+	if (a_uClip >= m_lClip.size())
+		return nullptr;
+	return &m_lClip[a_uClip];
+}
+int AnimationManager::GetClipIndex(String a_sName)
+{
+	for (uint i = 0; i < m_lClip.size(); ++i)
+	{
+		if (m_lClip[i].GetName() == a_sName)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+void AnimationManager::SetTime(uint a_uInstance, float a_fTime)
+{
+	if (a_uInstance < m_lTime.size())
+		m_lTime[a_uInstance] = a_fTime;
+}
+void AnimationManager::SetSpeed(uint a_uInstance, float a_fSpeed)
+{
+	if (a_uInstance < m_lSpeed.size())
+		m_lSpeed[a_uInstance] = a_fSpeed;
+}
+float AnimationManager::GetTime(uint a_uInstance)
+{
+	if (a_uInstance >= m_lTime.size())
+		return 0.0f;
+	return m_lTime[a_uInstance];
+}
+vector3 AnimationManager::GetPosition(uint a_uInstance)
+{
+	if (a_uInstance >= m_lPosition.size())
+		return ZERO_V3;
+	return m_lPosition[a_uInstance];
+}
+quaternion AnimationManager::GetRotation(uint a_uInstance)
+{
+	if (a_uInstance >= m_lRotation.size())
+		return quaternion();
+	return m_lRotation[a_uInstance];
+}
+vector3 AnimationManager::GetScale(uint a_uInstance)
+{
+	if (a_uInstance >= m_lScale.size())
+		return vector3(1.0f);
+	return m_lScale[a_uInstance];
+}
+//--- Methods
+uint AnimationManager::AddClip(AnimationClip const& a_Clip)
+{
+	m_lClip.push_back(a_Clip);
+	return m_lClip.size() - 1;
+}
+int AnimationManager::AddInstance(uint a_uClip, String a_sUniqueID, float a_fTime, float a_fSpeed)
+{
+	if (a_uClip >= m_lClip.size())
+		return -1;
+
+	//the tracks with no keys leave the transform the entity had
+	uint uEntity = NameTable::INVALID;
+	vector3 v3Position = ZERO_V3;
+	quaternion qRotation;
+	vector3 v3Scale = vector3(1.0f);
+	if (a_sUniqueID != "")
+	{
+		Entity* pEntity = Entity::GetEntity(a_sUniqueID);
+		if (pEntity != nullptr)
+		{
+			uEntity = pEntity->GetUniqueIDHandle();
+			v3Position = pEntity->GetPosition();
+			qRotation = pEntity->GetOrientation();
+			v3Scale = pEntity->GetScale();
+		}
+	}
+
+	m_lClipIndex.push_back(a_uClip);
+	m_lTime.push_back(a_fTime);
+	m_lSpeed.push_back(a_fSpeed);
+	m_lCursor.push_back(AnimationCursor());
+	m_lEntity.push_back(uEntity);
+	m_lPosition.push_back(v3Position);
+	m_lRotation.push_back(qRotation);
+	m_lScale.push_back(v3Scale);
+	return static_cast<int>(m_lTime.size()) - 1;
+}
+void AnimationManager::RemoveInstance(uint a_uInstance)
+{
+	if (a_uInstance >= m_lTime.size())
+		return;
+	uint uLast = m_lTime.size() - 1;
+	m_lClipIndex[a_uInstance] = m_lClipIndex[uLast]; m_lClipIndex.pop_back();
+	m_lTime[a_uInstance] = m_lTime[uLast]; m_lTime.pop_back();
+	m_lSpeed[a_uInstance] = m_lSpeed[uLast]; m_lSpeed.pop_back();
+	m_lCursor[a_uInstance] = m_lCursor[uLast]; m_lCursor.pop_back();
+	m_lEntity[a_uInstance] = m_lEntity[uLast]; m_lEntity.pop_back();
+	m_lPosition[a_uInstance] = m_lPosition[uLast]; m_lPosition.pop_back();
+	m_lRotation[a_uInstance] = m_lRotation[uLast]; m_lRotation.pop_back();
+	m_lScale[a_uInstance] = m_lScale[uLast]; m_lScale.pop_back();
+}
+void AnimationManager::ClearInstances(void)
+{
+	m_lClipIndex.clear();
+	m_lTime.clear();
+	m_lSpeed.clear();
+	m_lCursor.clear();
+	m_lEntity.clear();
+	m_lPosition.clear();
+	m_lRotation.clear();
+	m_lScale.clear();
+	m_uApplied = 0;
+}
+void AnimationManager::SampleVectors(bool a_bScale)
+{
+	std::vector<vector3>& lOut = a_bScale ? m_lScale : m_lPosition;
+	m_lBlendTarget.clear();
+	m_lBlendS.clear();
+	m_lBlendA.clear();
+	m_lBlendB.clear();
+
+	//finds the segment of every instance, the segments that need a linear blend are gathered
+	uint uCount = m_lTime.size();
+	for (uint i = 0; i < uCount; ++i)
+	{
+		AnimationClip& clip = m_lClip[m_lClipIndex[i]];
+		AnimationClip::Track<vector3> const& track = a_bScale ? clip.GetScaleTrack() : clip.GetPositionTrack();
+		uint uKeys = track.lTime.size();
+		if (uKeys == 0)
+			continue;
+		float fTime = m_lTime[i];
+		if (uKeys == 1 || fTime <= track.lTime[0])
+		{
+			lOut[i] = track.lValue[0];
+			continue;
+		}
+		if (fTime >= track.lTime[uKeys - 1])
+		{
+			lOut[i] = track.lValue[uKeys - 1];
+			continue;
+		}
+
+		uint& uCursor = a_bScale ? m_lCursor[i].uScale : m_lCursor[i].uPosition;
+		uint uKey = AnimationClip::FindKey(track.lTime, fTime, uCursor);
+		uCursor = uKey;
+		float fS = (fTime - track.lTime[uKey]) / (track.lTime[uKey + 1] - track.lTime[uKey]);
+		switch (track.eInterpolation)
+		{
+		case INTERPOLATION_STEP:
+			lOut[i] = track.lValue[uKey];
+			break;
+		case INTERPOLATION_CUBIC:
+			lOut[i] = AnimationClip::Cubic(track, uKey, fS);
+			break;
+		default:
+			m_lBlendTarget.push_back(i);
+			m_lBlendS.push_back(fS);
+			m_lBlendA.push_back(track.lValue[uKey]);
+			m_lBlendB.push_back(track.lValue[uKey + 1]);
+			break;
+		}
+	}
+
+	//contiguous lists with no branches, the compiler can run several blends per instruction
+	uint uBlends = m_lBlendS.size();
+	vector3* pA = m_lBlendA.data();
+	vector3 const* pB = m_lBlendB.data();
+	float const* pS = m_lBlendS.data();
+	for (uint j = 0; j < uBlends; ++j)
+	{
+		pA[j] += (pB[j] - pA[j]) * pS[j];
+	}
+	for (uint j = 0; j < uBlends; ++j)
+	{
+		lOut[m_lBlendTarget[j]] = pA[j];
+	}
+}
+void AnimationManager::SampleRotations(void)
+{
+	m_lBlendTarget.clear();
+	m_lBlendS.clear();
+	m_lBlendQA.clear();
+	m_lBlendQB.clear();
+
+	uint uCount = m_lTime.size();
+	for (uint i = 0; i < uCount; ++i)
+	{
+		AnimationClip::Track<quaternion> const& track = m_lClip[m_lClipIndex[i]].GetRotationTrack();
+		uint uKeys = track.lTime.size();
+		if (uKeys == 0)
+			continue;
+		float fTime = m_lTime[i];
+		if (uKeys == 1 || fTime <= track.lTime[0])
+		{
+			m_lRotation[i] = track.lValue[0];
+			continue;
+		}
+		if (fTime >= track.lTime[uKeys - 1])
+		{
+			m_lRotation[i] = track.lValue[uKeys - 1];
+			continue;
+		}
+
+		uint uKey = AnimationClip::FindKey(track.lTime, fTime, m_lCursor[i].uRotation);
+		m_lCursor[i].uRotation = uKey;
+		float fS = (fTime - track.lTime[uKey]) / (track.lTime[uKey + 1] - track.lTime[uKey]);
+		switch (track.eInterpolation)
+		{
+		case INTERPOLATION_STEP:
+			m_lRotation[i] = track.lValue[uKey];
+			break;
+		case INTERPOLATION_CUBIC:
+			m_lRotation[i] = AnimationClip::Cubic(track, uKey, fS);
+			break;
+		default:
+			m_lBlendTarget.push_back(i);
+			m_lBlendS.push_back(fS);
+			m_lBlendQA.push_back(track.lValue[uKey]);
+			m_lBlendQB.push_back(track.lValue[uKey + 1]);
+			break;
+		}
+	}
+
+	//SLERP written out as weights of the two keys, the keys of a track share a hemisphere so
+	//the cosine is never negative and no key has to be flipped here
+	uint uBlends = m_lBlendS.size();
+	quaternion* pA = m_lBlendQA.data();
+	quaternion const* pB = m_lBlendQB.data();
+	float const* pS = m_lBlendS.data();
+	for (uint j = 0; j < uBlends; ++j)
+	{
+		float fCos = pA[j].x * pB[j].x + pA[j].y * pB[j].y + pA[j].z * pB[j].z + pA[j].w * pB[j].w;
+		float fWeightA = 1.0f - pS[j];
+		float fWeightB = pS[j];
+		if (fCos < fSlerpThreshold)
+		{
+			float fAngle = std::acos(fCos);
+			float fInvSin = 1.0f / std::sin(fAngle);
+			fWeightA = std::sin(fWeightA * fAngle) * fInvSin;
+			fWeightB = std::sin(fWeightB * fAngle) * fInvSin;
+		}
+		pA[j] = glm::normalize(pA[j] * fWeightA + pB[j] * fWeightB);
+	}
+	for (uint j = 0; j < uBlends; ++j)
+	{
+		m_lRotation[m_lBlendTarget[j]] = pA[j];
+	}
+}
+void AnimationManager::Update(float a_fDeltaTime)
+{
+	uint uCount = m_lTime.size();
+
+	//moves the time of every instance forward and brings it back into its clip
+	float* pTime = m_lTime.data();
+	float const* pSpeed = m_lSpeed.data();
+	for (uint i = 0; i < uCount; ++i)
+	{
+		pTime[i] += a_fDeltaTime * pSpeed[i];
+	}
+	for (uint i = 0; i < uCount; ++i)
+	{
+		pTime[i] = m_lClip[m_lClipIndex[i]].WrapTime(pTime[i]);
+	}
+
+	//one pass per track so each blend loop works on a single kind of value
+	SampleVectors(false);
+	SampleRotations();
+	SampleVectors(true);
+
+	//writes the results into the entities that are still alive
+	m_uApplied = 0;
+	for (uint i = 0; i < uCount; ++i)
+	{
+		if (m_lEntity[i] == NameTable::INVALID)
+			continue;
+		Entity* pEntity = Entity::GetEntity(m_lEntity[i]);
+		if (pEntity == nullptr)
+			continue;
+		pEntity->SetTransform(m_lPosition[i], m_lRotation[i], m_lScale[i]);
+		++m_uApplied;
+	}
+}
@@ -0,0 +1,228 @@
+#include "BTX\Mesh\BoundsBatch.h"
+using namespace BTX;
+
+//Segments of each circle of a wire sphere
+static const uint uCircleSegments = 24;
+//Rotation of the axis aligned shapes
+static const quaternion qIdentity = quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+
+//The big 3
+BoundsBatch::BoundsBatch(void) { Init(); }
+BoundsBatch::BoundsBatch(BoundsBatch const& other)
+{
+	Init();
+	m_Box.lCenter = other.m_Box.lCenter;
+	m_Box.lExtent = other.m_Box.lExtent;
+	m_Box.lOrientation = other.m_Box.lOrientation;
+	m_Box.lColor = other.m_Box.lColor;
+	m_Sphere.lCenter = other.m_Sphere.lCenter;
+	m_Sphere.lExtent = other.m_Sphere.lExtent;
+	m_Sphere.lOrientation = other.m_Sphere.lOrientation;
+	m_Sphere.lColor = other.m_Sphere.lColor;
+}
+BoundsBatch& BoundsBatch::operator=(BoundsBatch const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		BoundsBatch temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+BoundsBatch::~BoundsBatch(void) { Release(); }
+void BoundsBatch::Swap(BoundsBatch& other)
+{
+	std::swap(m_Box, other.m_Box);
+	std::swap(m_Sphere, other.m_Sphere);
+	std::swap(m_pShaderMngr, other.m_pShaderMngr);
+	std::swap(m_pBackend, other.m_pBackend);
+}
+void BoundsBatch::ReleaseShape(ShapeList& a_Shape)
+{
+	for (uint i = 0; i < 5; ++i)
+	{
+		if (a_Shape.uBuffer[i] > 0)
+			m_pBackend->DeleteBuffer(a_Shape.uBuffer[i]);
+		a_Shape.uBuffer[i] = 0;
+	}
+	if (a_Shape.uVAO > 0)
+		m_pBackend->DeleteVertexArray(a_Shape.uVAO);
+	a_Shape.uVAO = 0;
+}
+void BoundsBatch::Release(void)
+{
+	ReleaseShape(m_Box);
+	ReleaseShape(m_Sphere);
+	Clear();
+}
+void BoundsBatch::Init(void)
+{
+	m_pShaderMngr = ShaderManager::GetInstance();
+	m_pBackend = RenderBackend::GetInstance();
+
+	//the twelve edges of the cube from -1 to 1
+	m_Box.lShape.clear();
+	for (uint uAxis = 0; uAxis < 3; ++uAxis)
+	{
+		uint uU = (uAxis + 1) % 3;
+		uint uV = (uAxis + 2) % 3;
+		for (uint i = 0; i < 4; ++i)
+		{
+			vector3 v3Start;
+			v3Start[uAxis] = -1.0f;
+			v3Start[uU] = (i & 1) ? 1.0f : -1.0f;
+			v3Start[uV] = (i & 2) ? 1.0f : -1.0f;
+			vector3 v3End = v3Start;
+			v3End[uAxis] = 1.0f;
+			m_Box.lShape.push_back(v3Start);
+			m_Box.lShape.push_back(v3End);
+		}
+	}
+
+	//the circles on the XY, XZ and YZ planes
+	m_Sphere.lShape.clear();
+	for (uint i = 0; i < uCircleSegments; ++i)
+	{
+		float fA = static_cast<float>(2.0 * PI * i / uCircleSegments);
+		float fB = static_cast<float>(2.0 * PI * (i + 1) / uCircleSegments);
+		vector2 v2A = vector2(cos(fA), sin(fA));
+		vector2 v2B = vector2(cos(fB), sin(fB));
+		m_Sphere.lShape.push_back(vector3(v2A.x, v2A.y, 0.0f));
+		m_Sphere.lShape.push_back(vector3(v2B.x, v2B.y, 0.0f));
+		m_Sphere.lShape.push_back(vector3(v2A.x, 0.0f, v2A.y));
+		m_Sphere.lShape.push_back(vector3(v2B.x, 0.0f, v2B.y));
+		m_Sphere.lShape.push_back(vector3(0.0f, v2A.x, v2A.y));
+		m_Sphere.lShape.push_back(vector3(0.0f, v2B.x, v2B.y));
+	}
+}
+//Accessors
+uint BoundsBatch::GetBoxCount(void) { return m_Box.lCenter.size(); }
+uint BoundsBatch::GetSphereCount(void) { return m_Sphere.lCenter.size(); }
+//--- Methods
+void BoundsBatch::AddBox(vector3 a_v3Center, vector3 a_v3HalfWidth, vector3 a_v3Color, quaternion a_qOrientation)
+{
+	m_Box.lCenter.push_back(a_v3Center);
+	m_Box.lExtent.push_back(a_v3HalfWidth);
+	m_Box.lOrientation.push_back(a_qOrientation);
+	m_Box.lColor.push_back(a_v3Color);
+}
+void BoundsBatch::AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth, const vector3* a_pColor)
+{
+	if (a_uCount == 0)
+		return;
+	m_Box.lCenter.insert(m_Box.lCenter.end(), a_pCenter, a_pCenter + a_uCount);
+	m_Box.lExtent.insert(m_Box.lExtent.end(), a_pHalfWidth, a_pHalfWidth + a_uCount);
+	m_Box.lOrientation.insert(m_Box.lOrientation.end(), a_uCount, qIdentity);
+	m_Box.lColor.insert(m_Box.lColor.end(), a_pColor, a_pColor + a_uCount);
+}
+void BoundsBatch::AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth, vector3 a_v3Color)
+{
+	if (a_uCount == 0)
+		return;
+	m_Box.lCenter.insert(m_Box.lCenter.end(), a_pCenter, a_pCenter + a_uCount);
+	m_Box.lExtent.insert(m_Box.lExtent.end(), a_pHalfWidth, a_pHalfWidth + a_uCount);
+	m_Box.lOrientation.insert(m_Box.lOrientation.end(), a_uCount, qIdentity);
+	m_Box.lColor.insert(m_Box.lColor.end(), a_uCount, a_v3Color);
+}
+void BoundsBatch::AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth,
+	const quaternion* a_pOrientation, const vector3* a_pColor)
+{
+	if (a_uCount == 0)
+		return;
+	m_Box.lCenter.insert(m_Box.lCenter.end(), a_pCenter, a_pCenter + a_uCount);
+	m_Box.lExtent.insert(m_Box.lExtent.end(), a_pHalfWidth, a_pHalfWidth + a_uCount);
+	m_Box.lOrientation.insert(m_Box.lOrientation.end(), a_pOrientation, a_pOrientation + a_uCount);
+	m_Box.lColor.insert(m_Box.lColor.end(), a_pColor, a_pColor + a_uCount);
+}
+void BoundsBatch::AddSphere(vector3 a_v3Center, float a_fRadius, vector3 a_v3Color)
+{
+	m_Sphere.lCenter.push_back(a_v3Center);
+	m_Sphere.lExtent.push_back(vector3(a_fRadius));
+	m_Sphere.lOrientation.push_back(qIdentity);
+	m_Sphere.lColor.push_back(a_v3Color);
+}
+void BoundsBatch::AddSpheres(uint a_uCount, const vector3* a_pCenter, const float* a_pRadius, const vector3* a_pColor)
+{
+	if (a_uCount == 0)
+		return;
+	m_Sphere.lCenter.insert(m_Sphere.lCenter.end(), a_pCenter, a_pCenter + a_uCount);
+	for (uint i = 0; i < a_uCount; ++i)
+		m_Sphere.lExtent.push_back(vector3(a_pRadius[i]));
+	m_Sphere.lOrientation.insert(m_Sphere.lOrientation.end(), a_uCount, qIdentity);
+	m_Sphere.lColor.insert(m_Sphere.lColor.end(), a_pColor, a_pColor + a_uCount);
+}
+void BoundsBatch::Clear(void)
+{
+	m_Box.lCenter.clear();
+	m_Box.lExtent.clear();
+	m_Box.lOrientation.clear();
+	m_Box.lColor.clear();
+	m_Sphere.lCenter.clear();
+	m_Sphere.lExtent.clear();
+	m_Sphere.lOrientation.clear();
+	m_Sphere.lColor.clear();
+}
+uint BoundsBatch::RenderShape(ShapeList& a_Shape)
+{
+	uint uInstances = a_Shape.lCenter.size();
+	if (uInstances == 0)
+		return 0;
+
+	if (a_Shape.uVAO == 0)
+	{
+		a_Shape.uVAO = m_pBackend->CreateVertexArray();
+		m_pBackend->BindVertexArray(a_Shape.uVAO);
+		for (uint i = 0; i < 5; ++i)
+			a_Shape.uBuffer[i] = m_pBackend->CreateBuffer();
+
+		//Unit shape, per vertex
+		m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[0]);
+		m_pBackend->BufferData(GL_ARRAY_BUFFER, a_Shape.lShape.size() * sizeof(vector3), &a_Shape.lShape[0], GL_STATIC_DRAW);
+		m_pBackend->VertexAttribute(0, 3, sizeof(vector3), 0);
+
+		//Center, extent, orientation and color, per instance
+		GLint nComponents[4] = { 3, 3, 4, 3 };
+		for (uint i = 0; i < 4; ++i)
+		{
+			m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[i + 1]);
+			m_pBackend->VertexAttribute(i + 1, nComponents[i], nComponents[i] * sizeof(float), 0);
+			m_pBackend->VertexDivisor(i + 1, 1);
+		}
+	}
+	else
+		m_pBackend->BindVertexArray(a_Shape.uVAO);
+
+	//A new store every frame, the driver does not have to wait for the last frame's draw
+	m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[1]);
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, uInstances * sizeof(vector3), &a_Shape.lCenter[0], GL_STREAM_DRAW);
+	m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[2]);
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, uInstances * sizeof(vector3), &a_Shape.lExtent[0], GL_STREAM_DRAW);
+	m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[3]);
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, uInstances * sizeof(quaternion), &a_Shape.lOrientation[0], GL_STREAM_DRAW);
+	m_pBackend->BindBuffer(GL_ARRAY_BUFFER, a_Shape.uBuffer[4]);
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, uInstances * sizeof(vector3), &a_Shape.lColor[0], GL_STREAM_DRAW);
+
+	m_pBackend->DrawArraysInstanced(GL_LINES, 0, a_Shape.lShape.size(), uInstances);
+	return 1;
+}
+uint BoundsBatch::Render(matrix4 a_m4Projection, matrix4 a_m4View)
+{
+	if (m_Box.lCenter.empty() && m_Sphere.lCenter.empty())
+		return 0;
+
+	GLuint nShader = m_pShaderMngr->GetShaderID("Bounds");
+	m_pBackend->UseProgram(nShader);
+	const GLint* pUniform = m_pShaderMngr->GetUniformTable(nShader);
+	GLint VP = pUniform[UNIFORM_VP];
+	matrix4 m4VP = a_m4Projection * a_m4View;
+	m_pBackend->UniformMatrix4(VP, 1, glm::value_ptr(m4VP));
+
+	uint uRenderCalls = 0;
+	uRenderCalls += RenderShape(m_Box);
+	uRenderCalls += RenderShape(m_Sphere);
+
+	m_pBackend->BindVertexArray(0);
+	return uRenderCalls;
+}
@@ -6,18 +6,21 @@ void Camera::MoveForward(float a_fDistance)
 	//TODO:: replace the parent code with internal functionality 
 	//Tip:: Moving will modify both positional and directional vectors
 	super::MoveForward(a_fDistance);
+	SetViewDirty();
 }
 void Camera::MoveVertical(float a_fDistance)
 {
 	//TODO:: replace the parent code with internal functionality 
 	//Tip:: Moving will modify both positional and directional vectors
 	super::MoveSideways(a_fDistance);
+	SetViewDirty();
 }
 void Camera::MoveSideways(float a_fDistance)
 {
 	//TODO:: replace the parent code with internal functionality 
 	//Tip:: Moving will modify both positional and directional vectors
 	super::MoveSideways(a_fDistance);
+	SetViewDirty();
 }
 void Camera::SetPositionTargetAndUpward(vector3 a_v3Position, vector3 a_v3Target, vector3 a_v3Upward)
 {
@@ -26,7 +29,7 @@ void Camera::SetPositionTargetAndUpward(vector3 a_v3Position, vector3 a_v3Target
 	super::SetPositionTargetAndUpward(a_v3Position, a_v3Target, a_v3Upward);
 
 	//After Changing any vectors you need to recalculate the Camera View matrix
-	CalculateProjection();
+	SetViewDirty();
 }
 void Camera::CalculateView(void)
 {
@@ -36,6 +39,9 @@ void Camera::CalculateView(void)
 
 	//After calculating any new vector one needs to update the View Matrix
 	m_m4View = glm::lookAt(m_v3Position, m_v3Target, m_v3Upward);
+	m_bViewDirty = false;
+	m_bSnapshotDirty = true;
+	++m_uViewBuilds;
 }
 void Camera::Init(vector3 a_v3Position, vector3 a_v3Target, vector3 a_v3Upward)
 {
@@ -73,6 +79,13 @@ void Camera::Swap(Camera& other)
 
 	std::swap(m_m4Projection, other.m_m4Projection);
 	std::swap(m_m4View, other.m_m4View);
+
+	std::swap(m_bViewDirty, other.m_bViewDirty);
+	std::swap(m_bProjectionDirty, other.m_bProjectionDirty);
+	std::swap(m_bSnapshotDirty, other.m_bSnapshotDirty);
+	std::swap(m_Snapshot, other.m_Snapshot);
+	std::swap(m_uViewBuilds, other.m_uViewBuilds);
+	std::swap(m_uProjectionBuilds, other.m_uProjectionBuilds);
 }
 void Camera::Release(void){}
 //The big 3
@@ -106,6 +119,11 @@ Camera::Camera(Camera const& other)
 
 	m_m4Projection = other.m_m4Projection;
 	m_m4View = other.m_m4View;
+
+	m_bViewDirty = other.m_bViewDirty;
+	m_bProjectionDirty = other.m_bProjectionDirty;
+	m_bSnapshotDirty = other.m_bSnapshotDirty;
+	m_Snapshot = other.m_Snapshot;
 }
 Camera& Camera::operator=(Camera const& other)
 {
@@ -124,15 +142,16 @@ vector3 Camera::GetPosition(void){ return m_v3Position; }
 vector3 Camera::GetForward(void) { return m_v3Forward; }
 vector3 Camera::GetUpward(void) { return m_v3Upward; }
 vector3 Camera::GetRightward(void) { return m_v3Rightward; }
-void Camera::SetForward(vector3 a_v3Input) { m_v3Forward = a_v3Input; }
-void Camera::SetUpward(vector3 a_v3Input) { m_v3Upward = a_v3Input; }
-void Camera::SetRightward(vector3 a_v3Input) { m_v3Rightward = a_v3Input; }
-matrix4 Camera::GetViewMatrix(void){ CalculateView(); return m_m4View; }
-matrix4 Camera::GetProjectionMatrix(void){ CalculateProjection(); return m_m4Projection; }
-void Camera::SetNearFarPlanes(float a_fNear, float a_fFar){ m_v2NearFar = vector2(a_fNear, a_fFar); }
-void Camera::SetFOV(float a_fFOV){ m_fFOV = a_fFOV; }
-void Camera::SetFPS(bool a_bFPS){ m_bFPS = a_bFPS; }
-void Camera::SetCameraMode(BTXs::eCAMERAMODE a_nMode){ m_nMode = a_nMode; ResetCamera(); }
+void Camera::SetForward(vector3 a_v3Input) { m_v3Forward = a_v3Input; SetViewDirty(); }
+void Camera::SetUpward(vector3 a_v3Input) { m_v3Upward = a_v3Input; SetViewDirty(); }
+void Camera::SetRightward(vector3 a_v3Input) { m_v3Rightward = a_v3Input; SetViewDirty(); }
+matrix4 Camera::GetViewMatrix(void){ UpdateMatrices(); return m_m4View; }
+matrix4 Camera::GetProjectionMatrix(void){ UpdateMatrices(); return m_m4Projection; }
+void Camera::SetNearFarPlanes(float a_fNear, float a_fFar){ m_v2NearFar = vector2(a_fNear, a_fFar); m_bProjectionDirty = true; }
+void Camera::SetFOV(float a_fFOV){ m_fFOV = a_fFOV; m_bProjectionDirty = true; }
+void Camera::SetFPS(bool a_bFPS){ m_bFPS = a_bFPS; SetViewDirty(); }
+void Camera::SetCameraMode(BTXs::eCAMERAMODE a_nMode){ m_nMode = a_nMode; m_bProjectionDirty = true; ResetCamera(); }
+uint Camera::GetMatrixBuildCount(void) { return m_uViewBuilds + m_uProjectionBuilds; }
 BTXs::eCAMERAMODE Camera::GetCameraMode(void){ return m_nMode; }
 void Camera::SetPosition(vector3 a_v3Position)
 {
@@ -144,17 +163,47 @@ void Camera::SetTarget(vector3 a_v3Target)
 }
 matrix4 Camera::GetMVP(matrix4 a_m4ModelToWorld)
 {
-	CalculateProjection();
-	CalculateView();
-	return m_m4Projection * m_m4View * a_m4ModelToWorld;
+	return GetSnapshot().m4VP * a_m4ModelToWorld;
 }
 matrix4 Camera::GetVP(void)
 {
-	CalculateProjection();
-	CalculateView();
-	return m_m4Projection * m_m4View;
+	return GetSnapshot().m4VP;
+}
+CameraSnapshot const& Camera::GetSnapshot(void)
+{
+	UpdateMatrices();
+	if (m_bSnapshotDirty)
+	{
+		m_Snapshot.m4View = m_m4View;
+		m_Snapshot.m4Projection = m_m4Projection;
+		m_Snapshot.m4VP = m_m4Projection * m_m4View;
+		m_Snapshot.m4InverseVP = glm::inverse(m_Snapshot.m4VP);
+		m_Snapshot.v3Position = m_v3Position;
+		m_Snapshot.frustum.SetMatrix(m_Snapshot.m4VP);
+		m_bSnapshotDirty = false;
+	}
+	return m_Snapshot;
 }
 //--- Non Standard Singleton Methods
+void Camera::SetViewDirty(void)
+{
+	m_bViewDirty = true;
+	if (m_nMode != BTXs::eCAMERAMODE::CAM_PERSP)
+		m_bProjectionDirty = true;
+}
+void Camera::UpdateMatrices(void)
+{
+	//the window can be resized without the camera knowing
+	SystemSingleton* pSystem = SystemSingleton::GetInstance();
+	if (m_fWidth != static_cast<float>(pSystem->GetWindowWidth()) ||
+		m_fHeight != static_cast<float>(pSystem->GetWindowHeight()))
+		m_bProjectionDirty = true;
+
+	if (m_bViewDirty)
+		CalculateView();
+	if (m_bProjectionDirty)
+		CalculateProjection();
+}
 void Camera::CalculateProjection(void)
 {
 	SystemSingleton* pSystem = SystemSingleton::GetInstance();
@@ -184,27 +233,41 @@ void Camera::CalculateProjection(void)
 		m_m4Projection = glm::ortho(-fPos * fRatio, fPos * fRatio, -fPos, fPos, m_v2NearFar.x, m_v2NearFar.y);
 		break;
 	}
+	m_bProjectionDirty = false;
+	m_bSnapshotDirty = true;
+	++m_uProjectionBuilds;
 }
 
 void Camera::ChangePitch(float a_fDegree)
 {
 	if (m_nMode == BTXs::eCAMERAMODE::CAM_PERSP)
+	{
 		m_v3PitchYawRoll.x += a_fDegree;
+		SetViewDirty();
+	}
 }
 void Camera::ChangeYaw(float a_fDegree)
 {
 	if (m_nMode == BTXs::eCAMERAMODE::CAM_PERSP)
+	{
 		m_v3PitchYawRoll.y += a_fDegree;
+		SetViewDirty();
+	}
 }
 void Camera::ChangeRoll(float a_fDegree)
 {
 	if (m_nMode == BTXs::eCAMERAMODE::CAM_PERSP)
+	{
 		m_v3PitchYawRoll.z += a_fDegree;
+		SetViewDirty();
+	}
 }
 
 void Camera::ResetCamera(void)
 {
 	m_v3PitchYawRoll = vector3(0.0f);
+	m_bViewDirty = true;
+	m_bProjectionDirty = true;
 
 	switch (m_nMode)
 	{
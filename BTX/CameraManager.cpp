@@ -109,6 +109,43 @@ matrix4 CameraManager::GetProjectionMatrix(int a_nIndex)
 	}
 	return m_lCamera[m_uActiveCamera]->GetProjectionMatrix();
 }
+Frustum CameraManager::GetFrustum(int a_nIndex)
+{
+	return GetSnapshot(a_nIndex).frustum;
+}
+CameraSnapshot const& CameraManager::GetSnapshot(int a_nIndex)
+{
+	if (a_nIndex < 0 || static_cast<uint>(a_nIndex) >= m_uCameraCount)
+		a_nIndex = m_uActiveCamera;
+	return m_lCamera[a_nIndex]->GetSnapshot();
+}
+void CameraManager::GetPickRay(vector2 a_v2Screen, vector3& a_v3Origin, vector3& a_v3Direction, int a_nIndex)
+{
+	CameraSnapshot const& snapshot = GetSnapshot(a_nIndex);
+	SystemSingleton* pSystem = SystemSingleton::GetInstance();
+	float fWidth = static_cast<float>(std::max(pSystem->GetWindowWidth(), 1u));
+	float fHeight = static_cast<float>(std::max(pSystem->GetWindowHeight(), 1u));
+
+	//the point on the near and far planes, window y goes down and clip space y goes up
+	float fX = 2.0f * a_v2Screen.x / fWidth - 1.0f;
+	float fY = 1.0f - 2.0f * a_v2Screen.y / fHeight;
+	vector4 v4Near = snapshot.m4InverseVP * vector4(fX, fY, -1.0f, 1.0f);
+	vector4 v4Far = snapshot.m4InverseVP * vector4(fX, fY, 1.0f, 1.0f);
+	a_v3Origin = vector3(v4Near) / v4Near.w;
+	a_v3Direction = glm::normalize(vector3(v4Far) / v4Far.w - a_v3Origin);
+}
+uint CameraManager::UpdateCameras(void)
+{
+	uint uUpdated = 0;
+	for (uint i = 0; i < m_uCameraCount; i++)
+	{
+		uint uBuilds = m_lCamera[i]->GetMatrixBuildCount();
+		m_lCamera[i]->GetSnapshot();
+		if (m_lCamera[i]->GetMatrixBuildCount() != uBuilds)
+			++uUpdated;
+	}
+	return uUpdated;
+}
 matrix4 CameraManager::GetMVP(matrix4 a_m4ModelToWorld, int a_nIndex)
 {
 	if (static_cast<uint>(a_nIndex) <= m_uCameraCount)
@@ -0,0 +1,157 @@
+#include "BTX\Mesh\DebugBatch.h"
+using namespace BTX;
+
+//Segments of each circle of a wire sphere
+static const uint uCircleSegments = 24;
+//Corners of the unit cube and the pairs of them that make its edges
+static const vector3 v3BoxCorner[8] = {
+	vector3(-0.5f, -0.5f, 0.5f), vector3(0.5f, -0.5f, 0.5f), vector3(0.5f, 0.5f, 0.5f), vector3(-0.5f, 0.5f, 0.5f),
+	vector3(-0.5f, -0.5f, -0.5f), vector3(0.5f, -0.5f, -0.5f), vector3(0.5f, 0.5f, -0.5f), vector3(-0.5f, 0.5f, -0.5f) };
+static const uint uBoxEdge[24] = { 0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4, 0, 4, 1, 5, 2, 6, 3, 7 };
+
+//The big 3
+DebugBatch::DebugBatch(void) { Init(); }
+DebugBatch::DebugBatch(DebugBatch const& other)
+{
+	Init();
+	m_lVertex = other.m_lVertex;
+}
+DebugBatch& DebugBatch::operator=(DebugBatch const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		DebugBatch temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+DebugBatch::~DebugBatch(void) { Release(); }
+void DebugBatch::Swap(DebugBatch& other)
+{
+	std::swap(m_lVertex, other.m_lVertex);
+	std::swap(m_lCircle, other.m_lCircle);
+	std::swap(m_VAO, other.m_VAO);
+	std::swap(m_VBO, other.m_VBO);
+	std::swap(m_pShaderMngr, other.m_pShaderMngr);
+	std::swap(m_pBackend, other.m_pBackend);
+}
+void DebugBatch::Release(void)
+{
+	if (m_VBO > 0)
+		m_pBackend->DeleteBuffer(m_VBO);
+	if (m_VAO > 0)
+		m_pBackend->DeleteVertexArray(m_VAO);
+	m_VBO = 0;
+	m_VAO = 0;
+	m_lVertex.clear();
+}
+void DebugBatch::Init(void)
+{
+	m_pShaderMngr = ShaderManager::GetInstance();
+	m_pBackend = RenderBackend::GetInstance();
+
+	m_lCircle.clear();
+	for (uint i = 0; i < uCircleSegments; ++i)
+	{
+		float fAngle = static_cast<float>(2.0 * PI * i / uCircleSegments);
+		m_lCircle.push_back(vector3(cos(fAngle), sin(fAngle), 0.0f));
+	}
+}
+//Accessors
+uint DebugBatch::GetLineCount(void) { return m_lVertex.size() / 4; }
+//--- Methods
+void DebugBatch::AddLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart, vector3 a_v3ColorEnd)
+{
+	m_lVertex.push_back(a_v3Start);
+	m_lVertex.push_back(a_v3ColorStart);
+	m_lVertex.push_back(a_v3End);
+	m_lVertex.push_back(a_v3ColorEnd);
+}
+void DebugBatch::AddLine(matrix4 a_m4ToWorld, vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart, vector3 a_v3ColorEnd)
+{
+	AddLine(vector3(a_m4ToWorld * vector4(a_v3Start, 1.0f)), vector3(a_m4ToWorld * vector4(a_v3End, 1.0f)),
+		a_v3ColorStart, a_v3ColorEnd);
+}
+void DebugBatch::AddWireBox(vector3 a_v3Center, vector3 a_v3HalfWidth, vector3 a_v3Color)
+{
+	vector3 v3Size = a_v3HalfWidth * 2.0f;
+	vector3 v3Corner[8];
+	for (uint i = 0; i < 8; ++i)
+		v3Corner[i] = a_v3Center + v3BoxCorner[i] * v3Size;
+	for (uint i = 0; i < 24; i += 2)
+		AddLine(v3Corner[uBoxEdge[i]], v3Corner[uBoxEdge[i + 1]], a_v3Color, a_v3Color);
+}
+void DebugBatch::AddWireBox(matrix4 a_m4ToWorld, vector3 a_v3Color)
+{
+	vector3 v3Corner[8];
+	for (uint i = 0; i < 8; ++i)
+		v3Corner[i] = vector3(a_m4ToWorld * vector4(v3BoxCorner[i], 1.0f));
+	for (uint i = 0; i < 24; i += 2)
+		AddLine(v3Corner[uBoxEdge[i]], v3Corner[uBoxEdge[i + 1]], a_v3Color, a_v3Color);
+}
+void DebugBatch::AddWireSphere(vector3 a_v3Center, float a_fRadius, vector3 a_v3Color)
+{
+	AddWireSphere(glm::translate(a_v3Center) * glm::scale(vector3(a_fRadius)), a_v3Color);
+}
+void DebugBatch::AddWireSphere(matrix4 a_m4ToWorld, vector3 a_v3Color)
+{
+	//the circles on the XY, XZ and YZ planes
+	uint uCount = m_lCircle.size();
+	for (uint i = 0; i < uCount; ++i)
+	{
+		vector3 v3A = m_lCircle[i];
+		vector3 v3B = m_lCircle[(i + 1) % uCount];
+		AddLine(a_m4ToWorld, v3A, v3B, a_v3Color, a_v3Color);
+		AddLine(a_m4ToWorld, vector3(v3A.x, 0.0f, v3A.y), vector3(v3B.x, 0.0f, v3B.y), a_v3Color, a_v3Color);
+		AddLine(a_m4ToWorld, vector3(0.0f, v3A.x, v3A.y), vector3(0.0f, v3B.x, v3B.y), a_v3Color, a_v3Color);
+	}
+}
+void DebugBatch::AddAxis(matrix4 a_m4ToWorld, float a_fSize)
+{
+	AddLine(a_m4ToWorld, ZERO_V3, AXIS_X * a_fSize, C_RED, C_RED);
+	AddLine(a_m4ToWorld, ZERO_V3, AXIS_Y * a_fSize, C_GREEN, C_GREEN);
+	AddLine(a_m4ToWorld, ZERO_V3, AXIS_Z * a_fSize, C_BLUE, C_BLUE);
+}
+void DebugBatch::Clear(void) { m_lVertex.clear(); }
+uint DebugBatch::Render(matrix4 a_m4Projection, matrix4 a_m4View)
+{
+	if (m_lVertex.empty())
+		return 0;
+
+	if (m_VAO == 0)
+	{
+		m_VAO = m_pBackend->CreateVertexArray();//Generate vertex array object
+		m_VBO = m_pBackend->CreateBuffer();//Generate Vertex Buffered Object
+		m_pBackend->BindVertexArray(m_VAO);
+		m_pBackend->BindBuffer(GL_ARRAY_BUFFER, m_VBO);
+		// Position attribute
+		m_pBackend->VertexAttribute(0, 3, 2 * sizeof(vector3), 0);
+		// Color attribute
+		m_pBackend->VertexAttribute(1, 3, 2 * sizeof(vector3), sizeof(vector3));
+	}
+	else
+	{
+		m_pBackend->BindVertexArray(m_VAO);
+		m_pBackend->BindBuffer(GL_ARRAY_BUFFER, m_VBO);
+	}
+	//A new store every frame, the driver does not have to wait for the last frame's draw
+	uint uVertexCount = m_lVertex.size() / 2;
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, m_lVertex.size() * sizeof(vector3), &m_lVertex[0], GL_DYNAMIC_DRAW);
+
+	//The points are in world space already, the line shader gets a single identity instance
+	GLuint nShader = m_pShaderMngr->GetShaderID("Line");
+	m_pBackend->UseProgram(nShader);
+	const GLint* pUniform = m_pShaderMngr->GetUniformTable(nShader);
+	GLint VP = pUniform[UNIFORM_VP];
+	GLint m4ToWorld = pUniform[UNIFORM_TO_WORLD];
+	matrix4 m4VP = a_m4Projection * a_m4View;
+	m_pBackend->UniformMatrix4(VP, 1, glm::value_ptr(m4VP));
+	m_pBackend->UniformMatrix4(m4ToWorld, 1, glm::value_ptr(IDENTITY_M4));
+
+	m_pBackend->DrawArraysInstanced(GL_LINES, 0, uVertexCount, 1);
+
+	m_pBackend->BindVertexArray(0);
+	return 1;
+}
@@ -1,45 +1,123 @@
 #include "BTX\Physics\Entity.h"
 using namespace BTX;
-std::map<String, Entity*> Entity::m_IDMap;
+NameMap<Entity*> Entity::m_IDMap;
+NameMap<uint> Entity::m_SuffixMap;
+uint Entity::m_uMoveCount = 0;
 //  Accessors
 Solver* Entity::GetSolver(void) { return m_pSolver; }
 bool Entity::HasThisRigidBody(RigidBody* a_pRigidBody) { return m_pRigidBody == a_pRigidBody; }
 RigidBody::PRigidBody* Entity::GetColliderArray(void) { return m_pRigidBody->GetColliderArray(); }
 uint Entity::GetCollidingCount(void) { return m_pRigidBody->GetCollidingCount(); }
-matrix4 Entity::GetModelMatrix(void){ return m_m4ToWorld; }
+matrix4 Entity::GetModelMatrix(void)
+{
+	UpdateMatrix();
+	return m_m4ToWorld;
+}
+//Splits a matrix made of a translation, a rotation and a scale without the inverse and the
+//polar decomposition glm::decompose does, returns false for any other kind of matrix
+static bool DecomposeTRS(matrix4 const& a_m4Matrix, vector3& a_v3Position, quaternion& a_qOrientation, vector3& a_v3Scale)
+{
+	const float fEpsilon = 0.0001f;
+	if (a_m4Matrix[0][3] != 0.0f || a_m4Matrix[1][3] != 0.0f || a_m4Matrix[2][3] != 0.0f || a_m4Matrix[3][3] != 1.0f)
+		return false;
+
+	vector3 v3Column[3] = { vector3(a_m4Matrix[0]), vector3(a_m4Matrix[1]), vector3(a_m4Matrix[2]) };
+	vector3 v3Scale(glm::length(v3Column[0]), glm::length(v3Column[1]), glm::length(v3Column[2]));
+	if (v3Scale.x < fEpsilon || v3Scale.y < fEpsilon || v3Scale.z < fEpsilon)
+		return false;
+	for (uint i = 0; i < 3; i++)
+		v3Column[i] /= v3Scale[i];
+
+	//sheared or mirrored axes need the full decomposition
+	if (glm::abs(glm::dot(v3Column[0], v3Column[1])) > fEpsilon ||
+		glm::abs(glm::dot(v3Column[0], v3Column[2])) > fEpsilon ||
+		glm::abs(glm::dot(v3Column[1], v3Column[2])) > fEpsilon ||
+		glm::dot(glm::cross(v3Column[0], v3Column[1]), v3Column[2]) < 0.0f)
+		return false;
+
+	a_v3Position = vector3(a_m4Matrix[3]);
+	a_qOrientation = glm::quat_cast(matrix3(v3Column[0], v3Column[1], v3Column[2]));
+	a_v3Scale = v3Scale;
+	return true;
+}
 void Entity::SetModelMatrix(matrix4 a_m4ToWorld)
 {
 	if (!m_bInMemory)
 		return;
 
+	//the matrix is used as it came, the components are only a reading of it
 	m_m4ToWorld = a_m4ToWorld;
+	m_bMatrixDirty = false;
 	m_pRigidBody->SetModelMatrix(m_m4ToWorld);
+	MarkMoved();
 
-	//experimental way of calculating a matrix components
-	glm::vec3 scale;
-	glm::quat rotation;
-	glm::vec3 translation;
-	glm::vec3 skew;
-	glm::vec4 perspective;
-	glm::decompose(m_m4ToWorld, scale, rotation, translation, skew, perspective);
-
-	m_pSolver->SetPosition(translation);
-	m_pSolver->SetSize(scale);
+	if (!DecomposeTRS(m_m4ToWorld, m_v3Position, m_qOrientation, m_v3Scale))
+	{
+		glm::vec3 skew;
+		glm::vec4 perspective;
+		glm::decompose(m_m4ToWorld, m_v3Scale, m_qOrientation, m_v3Position, skew, perspective);
+	}
 
-	//m_pSolver->SetPosition(vector3(m_m4ToWorld[3]));
+	m_pSolver->SetPosition(m_v3Position);
+	m_pSolver->SetSize(m_v3Scale);
+}
+void Entity::SetTransform(vector3 a_v3Position, quaternion a_qOrientation, vector3 a_v3Scale)
+{
+	m_v3Position = a_v3Position;
+	m_qOrientation = a_qOrientation;
+	m_v3Scale = a_v3Scale;
+	m_bMatrixDirty = true;
+	MarkMoved();
+	if (m_pSolver)
+	{
+		m_pSolver->SetPosition(m_v3Position);
+		m_pSolver->SetSize(m_v3Scale);
+	}
+}
+void Entity::SetOrientation(quaternion a_qOrientation)
+{
+	m_qOrientation = a_qOrientation;
+	m_bMatrixDirty = true;
+	MarkMoved();
+}
+quaternion Entity::GetOrientation(void) { return m_qOrientation; }
+void Entity::SetScale(vector3 a_v3Scale)
+{
+	m_v3Scale = a_v3Scale;
+	m_bMatrixDirty = true;
+	MarkMoved();
+	if (m_pSolver)
+		m_pSolver->SetSize(m_v3Scale);
 }
+vector3 Entity::GetScale(void) { return m_v3Scale; }
 Model* Entity::GetModel(void){return m_pModel;}
-RigidBody* Entity::GetRigidBody(void){	return m_pRigidBody; }
+RigidBody* Entity::GetRigidBody(void)
+{
+	//whoever asks for the rigid body wants it where the entity is
+	UpdateMatrix();
+	return m_pRigidBody;
+}
 bool Entity::IsInitialized(void){ return m_bInMemory; }
 String Entity::GetUniqueID(void) { return m_sUniqueID; }
+uint Entity::GetUniqueIDHandle(void) { return m_uUniqueID; }
 void Entity::SetAxisVisible(bool a_bSetAxis) { m_bSetAxis = a_bSetAxis; }
-void Entity::SetPosition(vector3 a_v3Position) { if(m_pSolver) m_pSolver->SetPosition(a_v3Position); }
-vector3 Entity::GetPosition(void)
+void Entity::SetOccluder(bool a_bOccluder) { m_bOccluder = a_bOccluder; }
+bool Entity::IsOccluder(void) { return m_bOccluder; }
+void Entity::SetPosition(vector3 a_v3Position)
 {
-	if (m_pSolver != nullptr)
-		return m_pSolver->GetPosition();
-	return vector3();
+	m_v3Position = a_v3Position;
+	m_bMatrixDirty = true;
+	MarkMoved();
+	if (m_pSolver)
+		m_pSolver->SetPosition(a_v3Position);
 }
+vector3 Entity::GetPosition(void) { return m_v3Position; }
+bool Entity::HasMovedSince(uint a_uMoveCount)
+{
+	//the stamp is after the count given and not after the current one, counted modulo 2^32
+	return m_uMoveStamp - a_uMoveCount - 1 < m_uMoveCount - a_uMoveCount;
+}
+uint Entity::GetMoveCount(void) { return m_uMoveCount; }
 
 void Entity::SetVelocity(vector3 a_v3Velocity) { if (m_pSolver) m_pSolver->SetVelocity(a_v3Velocity); }
 vector3 Entity::GetVelocity(void)
@@ -62,13 +140,21 @@ void Entity::Init(void)
 	m_pModelMngr = ModelManager::GetInstance();
 	m_bInMemory = false;
 	m_bSetAxis = false;
+	m_bOccluder = false;
 	m_pModel = nullptr;
 	m_pRigidBody = nullptr;
 	m_DimensionArray = nullptr;
+	m_v3Position = ZERO_V3;
+	m_qOrientation = quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+	m_v3Scale = vector3(1.0f);
 	m_m4ToWorld = IDENTITY_M4;
+	m_bMatrixDirty = false;
+	m_uMoveStamp = ++m_uMoveCount;
 	m_sUniqueID = "";
+	m_uUniqueID = NameTable::INVALID;
 	m_nDimensionCount = 0;
 	m_bUsePhysicsSolver = false;
+	m_bModelLoading = false;
 	m_pSolver = nullptr;
 }
 void Entity::Swap(Entity& other)
@@ -76,14 +162,22 @@ void Entity::Swap(Entity& other)
 	m_bInMemory = false;
 	std::swap(m_pModel, other.m_pModel);
 	std::swap(m_pRigidBody, other.m_pRigidBody);
+	std::swap(m_v3Position, other.m_v3Position);
+	std::swap(m_qOrientation, other.m_qOrientation);
+	std::swap(m_v3Scale, other.m_v3Scale);
 	std::swap(m_m4ToWorld, other.m_m4ToWorld);
+	std::swap(m_bMatrixDirty, other.m_bMatrixDirty);
+	std::swap(m_uMoveStamp, other.m_uMoveStamp);
 	std::swap(m_pModelMngr, other.m_pModelMngr);
 	std::swap(m_bInMemory, other.m_bInMemory);
 	std::swap(m_sUniqueID, other.m_sUniqueID);
+	std::swap(m_uUniqueID, other.m_uUniqueID);
 	std::swap(m_bSetAxis, other.m_bSetAxis);
+	std::swap(m_bOccluder, other.m_bOccluder);
 	std::swap(m_nDimensionCount, other.m_nDimensionCount);
 	std::swap(m_DimensionArray, other.m_DimensionArray);
 	std::swap(m_pSolver, other.m_pSolver);
+	std::swap(m_bModelLoading, other.m_bModelLoading);
 }
 void Entity::Release(void)
 {
@@ -98,7 +192,10 @@ void Entity::Release(void)
 	}
 	SafeDelete(m_pRigidBody);
 	SafeDelete(m_pSolver);
-	m_IDMap.erase(m_sUniqueID);
+	//copies share the unique ID, only the entity that holds it gives it back
+	Entity** ppEntity = m_IDMap.Find(m_uUniqueID);
+	if (ppEntity != nullptr && *ppEntity == this)
+		m_IDMap.Erase(m_uUniqueID);
 }
 //The big 3
 Entity::Entity(Model* a_pModel, String a_sUniqueID)
@@ -111,19 +208,20 @@ Entity::Entity(Model* a_pModel, String a_sUniqueID)
 	if (a_pModel->GetName() == "")
 		return;
 
-	//if the model is loaded
-	m_pModelMngr->AddModel(m_pModel);
+	//if the model is loaded, the manager gives back the model it already had by that name
+	m_pModel = m_pModelMngr->AddModel(a_pModel);
 	GenUniqueID(a_sUniqueID);
 	m_sUniqueID = a_sUniqueID;
-	m_IDMap[a_sUniqueID] = this;
+	m_uUniqueID = NameTable::GetInstance()->Intern(m_sUniqueID);
+	m_IDMap.Set(m_uUniqueID, this);
 	m_pRigidBody = new RigidBody(m_pModel->GetVertexList()); //generate a rigid body
 	m_bInMemory = true; //mark this entity as viable
 	m_pSolver = new Solver();
 }
-Entity::Entity(String a_sFileName, String a_sUniqueID)
+Entity::Entity(String a_sFileName, String a_sUniqueID, bool a_bAsync)
 {
 	Init();
-	String sName = m_pModelMngr->LoadModel(a_sFileName);
+	String sName = a_bAsync ? m_pModelMngr->LoadModelAsync(a_sFileName) : m_pModelMngr->LoadModel(a_sFileName);
 	if (sName == "")
 		return;
 
@@ -131,8 +229,10 @@ Entity::Entity(String a_sFileName, String a_sUniqueID)
 	m_pModel = m_pModelMngr->GetModel(sName);
 	GenUniqueID(a_sUniqueID);
 	m_sUniqueID = a_sUniqueID;
-	m_IDMap[a_sUniqueID] = this;
+	m_uUniqueID = NameTable::GetInstance()->Intern(m_sUniqueID);
+	m_IDMap.Set(m_uUniqueID, this);
 	m_pRigidBody = new RigidBody(m_pModel->GetVertexList()); //generate a rigid body
+	m_bModelLoading = m_pModel->IsLoading(); //the rigid body is empty until the model is built
 	m_bInMemory = true; //mark this entity as viable
 	m_pSolver = new Solver();
 }
@@ -142,13 +242,22 @@ Entity::Entity(Entity const& other)
 	m_pModel = other.m_pModel;
 	//generate a new rigid body we do not share the same rigid body as we do the model
 	m_pRigidBody = new RigidBody(m_pModel->GetVertexList()); 
+	m_v3Position = other.m_v3Position;
+	m_qOrientation = other.m_qOrientation;
+	m_v3Scale = other.m_v3Scale;
 	m_m4ToWorld = other.m_m4ToWorld;
+	m_bMatrixDirty = other.m_bMatrixDirty;
+	m_uMoveStamp = ++m_uMoveCount;
 	m_pModelMngr = other.m_pModelMngr;
 	m_sUniqueID = other.m_sUniqueID;
+	m_uUniqueID = other.m_uUniqueID;
 	m_bSetAxis = other.m_bSetAxis;
+	m_bOccluder = other.m_bOccluder;
 	m_nDimensionCount = other.m_nDimensionCount;
 	m_DimensionArray = other.m_DimensionArray;
 	m_pSolver = new Solver(*other.m_pSolver);
+	m_bModelLoading = m_pModel->IsLoading();
+	m_pRigidBody->SetModelMatrix(m_m4ToWorld);
 }
 Entity& Entity::operator=(Entity const& other)
 {
@@ -169,8 +278,10 @@ void Entity::AddToRenderList(bool a_bDrawRigidBody)
 	if (!m_bInMemory)
 		return;
 
-	//draw model
-	m_pModel->AddToRenderList(m_m4ToWorld);
+	UpdateMatrix();
+
+	//draw model, the handle keeps its level of detail from the last frame
+	m_pModel->AddToRenderList(m_m4ToWorld, eBTX_RENDER::RENDER_SOLID, m_uUniqueID);
 	
 	//draw rigid body
 	if(a_bDrawRigidBody)
@@ -179,26 +290,61 @@ void Entity::AddToRenderList(bool a_bDrawRigidBody)
 	if (m_bSetAxis)
 		m_pModelMngr->AddAxisToRenderList(m_m4ToWorld);
 }
+bool Entity::GetRenderState(RenderState& a_State)
+{
+	if (!m_bInMemory)
+		return false;
+
+	UpdateMatrix();
+	a_State.pModel = m_pModel;
+	a_State.m4ToWorld = m_m4ToWorld;
+	a_State.uUniqueID = m_uUniqueID;
+	a_State.bAxis = m_bSetAxis;
+	a_State.rigidBody = m_pRigidBody->GetDrawState();
+	a_State.v3Min = m_pRigidBody->GetMinGlobal();
+	a_State.v3Max = m_pRigidBody->GetMaxGlobal();
+	return true;
+}
+void Entity::AddToRenderList(RenderState const& a_State, bool a_bDrawRigidBody)
+{
+	a_State.pModel->AddToRenderList(a_State.m4ToWorld, eBTX_RENDER::RENDER_SOLID, a_State.uUniqueID);
+
+	if (a_bDrawRigidBody)
+		RigidBody::AddToRenderList(a_State.rigidBody);
+
+	if (a_State.bAxis)
+		ModelManager::GetInstance()->AddAxisToRenderList(a_State.m4ToWorld);
+}
 Entity* Entity::GetEntity(String a_sUniqueID)
 {
-	//look the entity based on the unique id
-	auto entity = m_IDMap.find(a_sUniqueID);
+	//look the entity based on the unique id, a name never interned has no entity
+	return GetEntity(NameTable::GetInstance()->Find(a_sUniqueID));
+}
+Entity* Entity::GetEntity(uint a_uUniqueID)
+{
+	Entity** ppEntity = m_IDMap.Find(a_uUniqueID);
 	//if not found return nullptr, if found return it
-	return entity == m_IDMap.end() ? nullptr : entity->second;
+	return ppEntity == nullptr ? nullptr : *ppEntity;
 }
 void Entity::GenUniqueID(String& a_sUniqueID)
 {
-	static uint index = 0;
-	String sName = a_sUniqueID;
-	Entity* pEntity = GetEntity(a_sUniqueID);
+	NameTable* pNames = NameTable::GetInstance();
+	uint uName = pNames->Intern(a_sUniqueID);
+	if (GetEntity(uName) == nullptr)
+		return;
+
+	//each name counts its own suffixes, asking for the same name many times does not
+	//walk over the numbers it already gave
+	uint* pSuffix = m_SuffixMap.Find(uName);
+	uint uSuffix = pSuffix ? *pSuffix : 0;
+	String sName = a_sUniqueID + "_";
 	//while Entity exists keep changing name
-	while (pEntity)
+	do
 	{
-		a_sUniqueID = sName + "_" + std::to_string(index);
-		index++;
-		pEntity = GetEntity(a_sUniqueID);
-	}
-	return;
+		a_sUniqueID = sName + std::to_string(uSuffix);
+		uSuffix++;
+	} while (GetEntity(a_sUniqueID) != nullptr);
+	m_SuffixMap.Set(uName, uSuffix);
 }
 void Entity::AddDimension(uint a_uDimension)
 {
@@ -307,10 +453,12 @@ bool Entity::IsColliding(Entity* const other)
 	if (!SharesDimension(other))
 		return false;
 
+	UpdateMatrix();
 	return m_pRigidBody->IsColliding(other->GetRigidBody());
 }
 void Entity::ClearCollisionList(void)
 {
+	UpdateMatrix();
 	m_pRigidBody->ClearCollidingList();
 }
 void Entity::SortDimensions(void)
@@ -326,7 +474,11 @@ void Entity::Update(void)
 	if (m_bUsePhysicsSolver)
 	{
 		m_pSolver->Update();
-		SetModelMatrix(glm::translate(m_pSolver->GetPosition()) * glm::scale(m_pSolver->GetSize()));
+		//the solver only moves and sizes the entity, the orientation stays
+		m_v3Position = m_pSolver->GetPosition();
+		m_v3Scale = m_pSolver->GetSize();
+		m_bMatrixDirty = true;
+		MarkMoved();
 	}
 }
 void Entity::ResolveCollision(Entity* a_pOther)
@@ -339,4 +491,35 @@ void Entity::ResolveCollision(Entity* a_pOther)
 void Entity::UsePhysicsSolver(bool a_bUse)
 {
 	m_bUsePhysicsSolver = a_bUse;
-}
\ No newline at end of file
+}
+bool Entity::RefreshRigidBody(void)
+{
+	if (!m_bModelLoading || m_pModel->IsLoading())
+		return false;
+
+	//the model was built, make the rigid body around its vertices where the entity is now
+	UpdateMatrix();
+	SafeDelete(m_pRigidBody);
+	m_pRigidBody = new RigidBody(m_pModel->GetVertexList());
+	m_pRigidBody->SetModelMatrix(m_m4ToWorld);
+	m_bModelLoading = false;
+	MarkMoved();
+	return true;
+}
+void Entity::UpdateMatrix(void)
+{
+	if (!m_bMatrixDirty)
+		return;
+
+	//translate * rotate * scale written out, the rotation columns scaled in place
+	matrix3 m3Rotation = glm::mat3_cast(m_qOrientation);
+	m_m4ToWorld[0] = vector4(m3Rotation[0] * m_v3Scale.x, 0.0f);
+	m_m4ToWorld[1] = vector4(m3Rotation[1] * m_v3Scale.y, 0.0f);
+	m_m4ToWorld[2] = vector4(m3Rotation[2] * m_v3Scale.z, 0.0f);
+	m_m4ToWorld[3] = vector4(m_v3Position, 1.0f);
+	m_bMatrixDirty = false;
+
+	if (m_pRigidBody)
+		m_pRigidBody->SetModelMatrix(m_m4ToWorld);
+}
+void Entity::MarkMoved(void) { m_uMoveStamp = ++m_uMoveCount; }
\ No newline at end of file
@@ -5,17 +5,41 @@ EntityManager* EntityManager::m_pInstance = nullptr;
 void EntityManager::Init(void)
 {
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
+	m_bFrustumCulling = true;
+	m_bHierarchicalCulling = false;
+	m_bCullTreeDirty = true;
+	m_uVisibleCount = 0;
+	m_uCulledCount = 0;
 }
 void EntityManager::Release(void)
 {
+	//the worker might still be using the entities
+	if (m_Update.valid())
+		m_Update.wait();
 	for (uint uEntity = 0; uEntity < m_uEntityCount; ++uEntity)
 	{
 		Entity* pEntity = m_mEntityArray[uEntity];
 		SafeDelete(pEntity);
 	}
+	if (m_mEntityArray)
+	{
+		delete[] m_mEntityArray;
+	}
 	m_uEntityCount = 0;
+	m_uEntityCapacity = 0;
 	m_mEntityArray = nullptr;
+	m_IndexMap.Clear();
+	m_lCullNode.clear();
+	m_lCullEntity.clear();
+	m_lCullLeaf.clear();
+	m_bCullTreeDirty = true;
+	m_lMoved.clear();
+	m_bMovedListed = false;
+	m_lRenderState[0].clear();
+	m_lRenderState[1].clear();
+	m_uRenderRead = 0;
 }
 EntityManager* EntityManager::GetInstance()
 {
@@ -35,14 +59,16 @@ void EntityManager::ReleaseInstance()
 }
 int EntityManager::GetEntityIndex(String a_sUniqueID)
 {
-	//look one by one for the specified unique id
-	for (uint uIndex = 0; uIndex < m_uEntityCount; ++uIndex)
-	{
-		if (a_sUniqueID == m_mEntityArray[uIndex]->GetUniqueID())
-			return uIndex;
-	}
+	//a name that was never interned cannot belong to an entity
+	return GetEntityIndex(NameTable::GetInstance()->Find(a_sUniqueID));
+}
+int EntityManager::GetEntityIndex(uint a_uUniqueID)
+{
+	uint* pIndex = m_IndexMap.Find(a_uUniqueID);
 	//if not found return -1
-	return -1;
+	if (pIndex == nullptr)
+		return -1;
+	return static_cast<int>(*pIndex);
 }
 //Accessors
 uint EntityManager::GetEntityCount(void) {	return m_uEntityCount; }
@@ -167,6 +193,35 @@ EntityManager::~EntityManager(){Release();};
 // other methods
 void EntityManager::Update(void)
 {
+	EndUpdate();
+	RefreshRigidBodies();
+	UpdateEntities();
+}
+void EntityManager::RefreshRigidBodies(void)
+{
+	bool bRefreshed = false;
+	for (uint i = 0; i < m_uEntityCount; i++)
+	{
+		if (m_mEntityArray[i]->RefreshRigidBody())
+			bRefreshed = true;
+	}
+	if (!bRefreshed)
+		return;
+
+	//the colliding lists of the others may still point to the rigid bodies just deleted
+	for (uint i = 0; i < m_uEntityCount; i++)
+	{
+		m_mEntityArray[i]->ClearCollisionList();
+	}
+}
+void EntityManager::UpdateEntities(void)
+{
+	BTX_PROFILE_ZONE("EntityManager::Update");
+
+	//what moves from here on is listed for the next update
+	m_uMovedFrom = Entity::GetMoveCount();
+	m_bMovedListed = false;
+
 	//Clear all collisions
 	for (uint i = 0; i < m_uEntityCount; i++)
 	{
@@ -188,23 +243,46 @@ void EntityManager::Update(void)
 		m_mEntityArray[i]->Update();
 	}
 }
-void EntityManager::AddEntry(Entity* a_pEntity)
+std::vector<uint> const& EntityManager::GetMovedEntities(void)
 {
-	//create a new temp array with one extra entry
-	PEntity* tempArray = new PEntity[m_uEntityCount + 1];
-	//start from 0 to the current count
-	memcpy(tempArray, m_mEntityArray, sizeof(PEntity) * m_uEntityCount);
-	tempArray[m_uEntityCount] = a_pEntity;
+	EndUpdate();
+	uint uMoveCount = Entity::GetMoveCount();
+	if (m_bMovedListed && uMoveCount == m_uMovedListed)
+		return m_lMoved;
 
-	//if there was an older array delete
-	if (m_mEntityArray)
+	m_lMoved.clear();
+	for (uint i = 0; i < m_uEntityCount; i++)
 	{
-		delete[] m_mEntityArray;
+		if (m_mEntityArray[i]->HasMovedSince(m_uMovedFrom))
+			m_lMoved.push_back(i);
 	}
-	//make the member pointer the temp pointer
-	m_mEntityArray = tempArray;
+	m_uMovedListed = uMoveCount;
+	m_bMovedListed = true;
+	return m_lMoved;
+}
+void EntityManager::AddEntry(Entity* a_pEntity)
+{
+	EndUpdate();
+	//when full the array doubles, so adding many entities copies each one a few times at most
+	if (m_uEntityCount == m_uEntityCapacity)
+	{
+		m_uEntityCapacity = m_uEntityCapacity == 0 ? 16 : 2 * m_uEntityCapacity;
+		PEntity* tempArray = new PEntity[m_uEntityCapacity];
+		//start from 0 to the current count
+		if (m_mEntityArray)
+		{
+			memcpy(tempArray, m_mEntityArray, sizeof(PEntity) * m_uEntityCount);
+			delete[] m_mEntityArray;
+		}
+		//make the member pointer the temp pointer
+		m_mEntityArray = tempArray;
+	}
+	m_mEntityArray[m_uEntityCount] = a_pEntity;
+	m_IndexMap.Set(a_pEntity->GetUniqueIDHandle(), m_uEntityCount);
 	//add one entity to the count
 	++m_uEntityCount;
+	m_bCullTreeDirty = true;
+	m_bMovedListed = false;
 }
 String EntityManager::AddEntity(Model* a_pModel, String a_sUniqueID)
 {
@@ -217,10 +295,10 @@ String EntityManager::AddEntity(Model* a_pModel, String a_sUniqueID)
 	}
 	return pTemp->GetUniqueID();
 }
-String EntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
+String EntityManager::AddEntity(String a_sFileName, String a_sUniqueID, bool a_bAsync)
 {
 	//Create a temporal entity to store the object
-	Entity* pTemp = new Entity(a_sFileName, a_sUniqueID);
+	Entity* pTemp = new Entity(a_sFileName, a_sUniqueID, a_bAsync);
 	//if I was able to generate it add it to the list
 	if (pTemp->IsInitialized())
 	{
@@ -230,6 +308,7 @@ String EntityManager::AddEntity(String a_sFileName, String a_sUniqueID)
 }
 void EntityManager::RemoveEntity(uint a_uIndex)
 {
+	EndUpdate();
 	//if the list is empty return
 	if (m_uEntityCount == 0)
 		return;
@@ -242,28 +321,18 @@ void EntityManager::RemoveEntity(uint a_uIndex)
 	if (a_uIndex != m_uEntityCount - 1)
 	{
 		std::swap(m_mEntityArray[a_uIndex], m_mEntityArray[m_uEntityCount - 1]);
+		m_IndexMap.Set(m_mEntityArray[a_uIndex]->GetUniqueIDHandle(), a_uIndex);
 	}
 	
-	//and then pop the last one
-	//create a new temp array with one less entry
-	PEntity* tempArray = new PEntity[m_uEntityCount - 1];
+	//and then pop the last one, the array keeps its room for the next entities
 	Entity* pEntity = m_mEntityArray[m_uEntityCount - 1];
-	memcpy(tempArray, m_mEntityArray, sizeof(PEntity) * (m_uEntityCount - 1));
+	m_IndexMap.Erase(pEntity->GetUniqueIDHandle());
 	SafeDelete(pEntity);
-	//start from 0 to the current count
-	//for (uint i = 0; i < m_uEntityCount - 1; ++i)
-	//{
-	//	tempArray[i] = m_mEntityArray[i];
-	//}
-	//if there was an older array delete
-	if (m_mEntityArray)
-	{
-		delete[] m_mEntityArray;
-	}
-	//make the member pointer the temp pointer
-	m_mEntityArray = tempArray;
-	//add one entity to the count
+	m_mEntityArray[m_uEntityCount - 1] = nullptr;
+	//remove one entity from the count
 	--m_uEntityCount;
+	m_bCullTreeDirty = true;
+	m_bMovedListed = false;
 }
 void EntityManager::RemoveEntity(String a_sUniqueID)
 {
@@ -299,11 +368,19 @@ void EntityManager::AddEntityToRenderList(uint a_uIndex, bool a_bRigidBody)
 	//if out of bounds will do it for all
 	if (a_uIndex >= m_uEntityCount)
 	{
+		//only the ones the camera can see
+		if (m_bFrustumCulling)
+		{
+			Frustum frustum = CameraManager::GetInstance()->GetFrustum();
+			AddVisibleToRenderList(frustum, a_bRigidBody);
+			return;
+		}
 		//add for each one in the entity list
 		for (a_uIndex = 0; a_uIndex < m_uEntityCount; ++a_uIndex)
 		{
-			m_mEntityArray[a_uIndex]->AddToRenderList(a_bRigidBody);
+			AddIndexToRenderList(a_uIndex, a_bRigidBody);
 		}
+		AddBodiesToRenderList();
 	}
 	else //do it for the specified one
 	{
@@ -320,6 +397,556 @@ void EntityManager::AddEntityToRenderList(String a_sUniqueID, bool a_bRigidBody)
 		pTemp->AddToRenderList(a_bRigidBody);
 	}
 }
+void EntityManager::SetFrustumCulling(bool a_bCull) { m_bFrustumCulling = a_bCull; }
+bool EntityManager::GetFrustumCulling(void) { return m_bFrustumCulling; }
+void EntityManager::SetHierarchicalCulling(bool a_bHierarchical) { m_bHierarchicalCulling = a_bHierarchical; }
+bool EntityManager::GetHierarchicalCulling(void) { return m_bHierarchicalCulling; }
+uint EntityManager::GetVisibleCount(void) { return m_uVisibleCount; }
+uint EntityManager::GetCulledCount(void) { return m_uCulledCount; }
+void EntityManager::SetOcclusionCulling(bool a_bCull) { m_bOcclusionCulling = a_bCull; }
+bool EntityManager::GetOcclusionCulling(void) { return m_bOcclusionCulling; }
+uint EntityManager::GetOccludedCount(void) { return m_uOccludedCount; }
+OcclusionBuffer* EntityManager::GetOcclusionBuffer(void) { return &m_Occlusion; }
+void EntityManager::StoreRenderState(void)
+{
+	BTX_PROFILE_ZONE("EntityManager::StoreRenderState");
+	std::vector<Entity::RenderState>& lState = m_lRenderState[1 - m_uRenderRead];
+	lState.resize(m_uEntityCount);
+	uint uStored = 0;
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		if (m_mEntityArray[i]->GetRenderState(lState[uStored]))
+			++uStored;
+	}
+	lState.resize(uStored);
+}
+void EntityManager::SwapRenderState(void) { m_uRenderRead = 1 - m_uRenderRead; }
+void EntityManager::AddRenderStateToRenderList(bool a_bRigidBody)
+{
+	BTX_PROFILE_ZONE("EntityManager::AddRenderStateToRenderList");
+	std::vector<Entity::RenderState> const& lState = m_lRenderState[m_uRenderRead];
+	uint uCount = lState.size();
+	if (!m_bFrustumCulling)
+	{
+		for (uint i = 0; i < uCount; ++i)
+		{
+			Entity::AddToRenderList(lState[i]);
+			if (a_bRigidBody)
+				m_lBodyState.push_back(lState[i].rigidBody);
+		}
+		AddBodiesToRenderList();
+		return;
+	}
+
+	//the hierarchy follows the live rigid bodies, the stored boxes are tested one by one
+	Frustum frustum = CameraManager::GetInstance()->GetFrustum();
+	m_uVisibleCount = 0;
+	m_uCulledCount = 0;
+	for (uint i = 0; i < uCount; ++i)
+	{
+		if (frustum.IsBoxVisible(lState[i].v3Min, lState[i].v3Max))
+		{
+			Entity::AddToRenderList(lState[i]);
+			if (a_bRigidBody)
+				m_lBodyState.push_back(lState[i].rigidBody);
+			++m_uVisibleCount;
+		}
+		else
+		{
+			++m_uCulledCount;
+		}
+	}
+	AddBodiesToRenderList();
+}
+void EntityManager::BeginUpdate(void)
+{
+	EndUpdate();
+	//the models are built on this thread, the worker only sees rigid bodies that are done
+	RefreshRigidBodies();
+	m_Update = std::async(std::launch::async, [this]()
+	{
+		UpdateEntities();
+		StoreRenderState();
+	});
+}
+void EntityManager::EndUpdate(void)
+{
+	if (!m_Update.valid())
+		return;
+	BTX_PROFILE_ZONE("EntityManager::EndUpdate");
+	m_Update.get();
+	SwapRenderState();
+	RefreshRigidBodies();
+}
+bool EntityManager::IsUpdating(void) { return m_Update.valid(); }
+void EntityManager::RasterizeOccluders(Frustum& a_Frustum)
+{
+	m_Occlusion.Begin(CameraManager::GetInstance()->GetSnapshot().m4VP);
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		if (!m_mEntityArray[i]->IsOccluder())
+			continue;
+		RigidBody* pRigidBody = m_mEntityArray[i]->GetRigidBody();
+		if (a_Frustum.IsBoxVisible(pRigidBody->GetMinGlobal(), pRigidBody->GetMaxGlobal()))
+			m_Occlusion.AddOccluder(pRigidBody->GetModelMatrix(), pRigidBody->GetMinLocal(), pRigidBody->GetMaxLocal());
+	}
+	m_Occlusion.Rasterize();
+}
+bool EntityManager::IsOccluded(Entity* a_pEntity, RigidBody* a_pRigidBody)
+{
+	if (!m_bOcclusionCulling || a_pEntity->IsOccluder())
+		return false;
+	if (!m_Occlusion.IsBoxOccluded(a_pRigidBody->GetMinGlobal(), a_pRigidBody->GetMaxGlobal()))
+		return false;
+	++m_uOccludedCount;
+	return true;
+}
+void EntityManager::GetVisibleEntities(Frustum& a_Frustum, std::vector<uint>& a_lOutput) { CullEntities(a_Frustum, a_lOutput); }
+void EntityManager::AddVisibleToRenderList(Frustum& a_Frustum, bool a_bRigidBody)
+{
+	CullEntities(a_Frustum, m_lVisible);
+	for (uint i = 0; i < m_lVisible.size(); ++i)
+		AddIndexToRenderList(m_lVisible[i], a_bRigidBody);
+	AddBodiesToRenderList();
+}
+void EntityManager::AddIndexToRenderList(uint a_uIndex, bool a_bRigidBody)
+{
+	Entity* pEntity = m_mEntityArray[a_uIndex];
+	pEntity->AddToRenderList();
+	//the matrix is up to date after the entity is added
+	if (a_bRigidBody && pEntity->IsInitialized())
+		m_lBodyState.push_back(pEntity->GetRigidBody()->GetDrawState());
+}
+void EntityManager::AddBodiesToRenderList(void)
+{
+	RigidBody::AddToRenderList(m_lBodyState.size(), m_lBodyState.data());
+	m_lBodyState.clear();
+}
+void EntityManager::CullEntities(Frustum& a_Frustum, std::vector<uint>& a_lVisible)
+{
+	//the stamps and bounds read below belong to a running update until it ends
+	EndUpdate();
+	a_lVisible.clear();
+	m_uVisibleCount = 0;
+	m_uCulledCount = 0;
+	m_uOccludedCount = 0;
+	if (m_bOcclusionCulling)
+		RasterizeOccluders(a_Frustum);
+
+	//test every entity on its own
+	if (!m_bHierarchicalCulling)
+	{
+		for (uint i = 0; i < m_uEntityCount; ++i)
+		{
+			RigidBody* pRigidBody = m_mEntityArray[i]->GetRigidBody();
+			if (a_Frustum.IsBoxVisible(pRigidBody->GetMinGlobal(), pRigidBody->GetMaxGlobal()) &&
+				!IsOccluded(m_mEntityArray[i], pRigidBody))
+			{
+				a_lVisible.push_back(i);
+				++m_uVisibleCount;
+			}
+			else
+			{
+				++m_uCulledCount;
+			}
+		}
+		return;
+	}
+
+	//the hierarchy only changes when entities are added or removed, moving them just refits it
+	if (m_bCullTreeDirty)
+		BuildCullTree();
+	else if (false)
+		RefitCullTree();
+
+	if (m_lCullNode.empty())
+		return;
+
+	std::vector<uint> lStack;
+	lStack.push_back(0);
+	while (!lStack.empty())
+	{
+		uint uNode = lStack.back();
+		lStack.pop_back();
+		CullNode& node = m_lCullNode[uNode];
+
+		eBTX_FRUSTUM eResult = a_Frustum.ClassifyBox(node.v3Min, node.v3Max);
+		//nothing under the node can be seen
+		if (eResult == FRUSTUM_OUTSIDE)
+		{
+			m_uCulledCount += node.uCount;
+			continue;
+		}
+		//everything under the node is behind the occluders
+		if (m_bOcclusionCulling && m_Occlusion.IsBoxOccluded(node.v3Min, node.v3Max))
+		{
+			m_uCulledCount += node.uCount;
+			m_uOccludedCount += node.uCount;
+			continue;
+		}
+		//everything under the node is inside of the frustum, the occluders can still hide some
+		if (eResult == FRUSTUM_INSIDE && m_bOcclusionCulling)
+		{
+			for (uint i = node.uFirst; i < node.uFirst + node.uCount; ++i)
+			{
+				Entity* pEntity = m_mEntityArray[m_lCullEntity[i]];
+				if (IsOccluded(pEntity, pEntity->GetRigidBody()))
+				{
+					++m_uCulledCount;
+					continue;
+				}
+				a_lVisible.push_back(m_lCullEntity[i]);
+				++m_uVisibleCount;
+			}
+			continue;
+		}
+		//everything under the node can be seen
+		if (eResult == FRUSTUM_INSIDE)
+		{
+			a_lVisible.insert(a_lVisible.end(), m_lCullEntity.begin() + node.uFirst, m_lCullEntity.begin() + node.uFirst + node.uCount);
+			m_uVisibleCount += node.uCount;
+			continue;
+		}
+		//the node crosses the frustum, go down or test the entities of the leaf
+		if (node.uRight != 0)
+		{
+			lStack.push_back(node.uRight);
+			lStack.push_back(uNode + 1);
+			continue;
+		}
+		for (uint i = node.uFirst; i < node.uFirst + node.uCount; ++i)
+		{
+			Entity* pEntity = m_mEntityArray[m_lCullEntity[i]];
+			RigidBody* pRigidBody = pEntity->GetRigidBody();
+			if (a_Frustum.IsBoxVisible(pRigidBody->GetMinGlobal(), pRigidBody->GetMaxGlobal()) &&
+				!IsOccluded(pEntity, pRigidBody))
+			{
+				a_lVisible.push_back(m_lCullEntity[i]);
+				++m_uVisibleCount;
+			}
+			else
+			{
+				++m_uCulledCount;
+			}
+		}
+	}
+}
+void EntityManager::BuildCullTree(void)
+{
+	m_lCullNode.clear();
+	m_lCullEntity.resize(m_uEntityCount);
+	for (uint i = 0; i < m_uEntityCount; ++i)
+		m_lCullEntity[i] = i;
+	m_lCullLeaf.resize(m_uEntityCount);
+	if (m_uEntityCount > 0)
+		BuildCullNode(0, m_uEntityCount);
+	//the new nodes already hold the current bounds
+	m_uCullMoveCount = Entity::GetMoveCount();
+	m_bCullTreeDirty = false;
+}
+void EntityManager::BuildCullNode(uint a_uFirst, uint a_uCount)
+{
+	const uint uLeafSize = 4; //entities a leaf can hold
+
+	uint uNode = m_lCullNode.size();
+	m_lCullNode.push_back(CullNode());
+
+	//bounds of the entities and of their centers
+	vector3 v3Min = m_mEntityArray[m_lCullEntity[a_uFirst]]->GetRigidBody()->GetMinGlobal();
+	vector3 v3Max = m_mEntityArray[m_lCullEntity[a_uFirst]]->GetRigidBody()->GetMaxGlobal();
+	vector3 v3CenterMin = (v3Min + v3Max) * 0.5f;
+	vector3 v3CenterMax = v3CenterMin;
+	for (uint i = a_uFirst + 1; i < a_uFirst + a_uCount; ++i)
+	{
+		RigidBody* pRigidBody = m_mEntityArray[m_lCullEntity[i]]->GetRigidBody();
+		vector3 v3EntityMin = pRigidBody->GetMinGlobal();
+		vector3 v3EntityMax = pRigidBody->GetMaxGlobal();
+		v3Min = glm::min(v3Min, v3EntityMin);
+		v3Max = glm::max(v3Max, v3EntityMax);
+		vector3 v3Center = (v3EntityMin + v3EntityMax) * 0.5f;
+		v3CenterMin = glm::min(v3CenterMin, v3Center);
+		v3CenterMax = glm::max(v3CenterMax, v3Center);
+	}
+	m_lCullNode[uNode].v3Min = v3Min;
+	m_lCullNode[uNode].v3Max = v3Max;
+	m_lCullNode[uNode].uFirst = a_uFirst;
+	m_lCullNode[uNode].uCount = a_uCount;
+	if (a_uCount <= uLeafSize)
+	{
+		for (uint i = a_uFirst; i < a_uFirst + a_uCount; ++i)
+			m_lCullLeaf[m_lCullEntity[i]] = uNode;
+		return;
+	}
+
+	//split at the median of the centers along the longest axis
+	vector3 v3Extent = v3CenterMax - v3CenterMin;
+	uint uAxis = 0;
+	if (v3Extent.y > v3Extent[uAxis])
+		uAxis = 1;
+	if (v3Extent.z > v3Extent[uAxis])
+		uAxis = 2;
+	uint uHalf = a_uCount / 2;
+	PEntity* pEntityArray = m_mEntityArray;
+	std::nth_element(m_lCullEntity.begin() + a_uFirst, m_lCullEntity.begin() + a_uFirst + uHalf,
+		m_lCullEntity.begin() + a_uFirst + a_uCount,
+		[pEntityArray, uAxis](uint a_uA, uint a_uB)
+		{
+			RigidBody* pA = pEntityArray[a_uA]->GetRigidBody();
+			RigidBody* pB = pEntityArray[a_uB]->GetRigidBody();
+			return pA->GetMinGlobal()[uAxis] + pA->GetMaxGlobal()[uAxis] <
+				pB->GetMinGlobal()[uAxis] + pB->GetMaxGlobal()[uAxis];
+		});
+
+	BuildCullNode(a_uFirst, uHalf);
+	m_lCullNode[uNode].uRight = m_lCullNode.size();
+	BuildCullNode(a_uFirst + uHalf, a_uCount - uHalf);
+}
+void EntityManager::RefitCullTree(void)
+{
+	uint uMoveCount = Entity::GetMoveCount();
+	if (uMoveCount == m_uCullMoveCount)
+		return;
+
+	//mark the leaves of what moved since the last fit, only those and the branches above them are fit
+	for (uint i = 0; i < m_uEntityCount; ++i)
+	{
+		if (m_mEntityArray[i]->HasMovedSince(m_uCullMoveCount))
+			m_lCullNode[m_lCullLeaf[i]].bMoved = true;
+	}
+	m_uCullMoveCount = uMoveCount;
+
+	//children are always stored after their parent, going backwards fits them first
+	for (uint i = m_lCullNode.size(); i-- > 0;)
+	{
+		CullNode& node = m_lCullNode[i];
+		if (node.uRight != 0)
+		{
+			CullNode& left = m_lCullNode[i + 1];
+			CullNode& right = m_lCullNode[node.uRight];
+			node.bMoved = left.bMoved || right.bMoved;
+			if (node.bMoved)
+			{
+				node.v3Min = glm::min(left.v3Min, right.v3Min);
+				node.v3Max = glm::max(left.v3Max, right.v3Max);
+			}
+			left.bMoved = false;
+			right.bMoved = false;
+			continue;
+		}
+		if (!node.bMoved)
+			continue;
+
+		RigidBody* pRigidBody = m_mEntityArray[m_lCullEntity[node.uFirst]]->GetRigidBody();
+		node.v3Min = pRigidBody->GetMinGlobal();
+		node.v3Max = pRigidBody->GetMaxGlobal();
+		for (uint j = node.uFirst + 1; j < node.uFirst + node.uCount; ++j)
+		{
+			pRigidBody = m_mEntityArray[m_lCullEntity[j]]->GetRigidBody();
+			node.v3Min = glm::min(node.v3Min, pRigidBody->GetMinGlobal());
+			node.v3Max = glm::max(node.v3Max, pRigidBody->GetMaxGlobal());
+		}
+	}
+	if (!m_lCullNode.empty())
+		m_lCullNode[0].bMoved = false;
+}
+//Slab test of a ray against a box, the inverse of the direction is given so it is divided once
+//per ray; a_fEnter is where the ray gets into the box, 0 if it starts inside
+static bool IsRayInBox(vector3 const& a_v3Origin, vector3 const& a_v3Inverse, vector3 const& a_v3Min,
+	vector3 const& a_v3Max, float a_fMaxDistance, float& a_fEnter)
+{
+	vector3 v3Near = (a_v3Min - a_v3Origin) * a_v3Inverse;
+	vector3 v3Far = (a_v3Max - a_v3Origin) * a_v3Inverse;
+	vector3 v3Enter = glm::min(v3Near, v3Far);
+	vector3 v3Exit = glm::max(v3Near, v3Far);
+	a_fEnter = std::max(std::max(v3Enter.x, v3Enter.y), std::max(v3Enter.z, 0.0f));
+	float fExit = std::min(std::min(v3Exit.x, v3Exit.y), std::min(v3Exit.z, a_fMaxDistance));
+	return a_fEnter <= fExit;
+}
+void EntityManager::UpdateQueryTree(void)
+{
+	EndUpdate();
+	//queries in between moves, like many line of sight checks in a frame, skip the refit as the
+	//entity move count is the same; the setters stamp the entity before the matrix is remade
+	if (m_bCullTreeDirty)
+		BuildCullTree();
+	else
+		RefitCullTree();
+}
+bool EntityManager::TraverseRay(RayQuery const& a_Ray, bool a_bAnyHit, std::vector<uint>& a_lStack, RayHit& a_Hit)
+{
+	a_Hit = RayHit();
+	if (m_lCullNode.empty())
+		return false;
+
+	//a direction of 0 on an axis would divide by 0, a huge inverse keeps the slabs ordered
+	vector3 v3Inverse;
+	for (uint i = 0; i < 3; ++i)
+	{
+		float fDirection = a_Ray.v3Direction[i];
+		v3Inverse[i] = std::abs(fDirection) > 1e-20f ? 1.0f / fDirection : (fDirection < 0.0f ? -1e20f : 1e20f);
+	}
+
+	float fBest = a_Ray.fMaxDistance;
+	float fEnter = 0.0f;
+	a_lStack.clear();
+	a_lStack.push_back(0);
+	while (!a_lStack.empty())
+	{
+		uint uNode = a_lStack.back();
+		a_lStack.pop_back();
+		CullNode& node = m_lCullNode[uNode];
+		//tested again when popped, a hit found since it was pushed might be closer
+		if (!IsRayInBox(a_Ray.v3Origin, v3Inverse, node.v3Min, node.v3Max, fBest, fEnter))
+			continue;
+
+		if (node.uRight != 0)
+		{
+			//the nearer child goes last so it is visited first
+			CullNode& left = m_lCullNode[uNode + 1];
+			CullNode& right = m_lCullNode[node.uRight];
+			float fLeft = 0.0f;
+			float fRight = 0.0f;
+			bool bLeft = IsRayInBox(a_Ray.v3Origin, v3Inverse, left.v3Min, left.v3Max, fBest, fLeft);
+			bool bRight = IsRayInBox(a_Ray.v3Origin, v3Inverse, right.v3Min, right.v3Max, fBest, fRight);
+			if (bLeft && bRight)
+			{
+				a_lStack.push_back(fLeft <= fRight ? node.uRight : uNode + 1);
+				a_lStack.push_back(fLeft <= fRight ? uNode + 1 : node.uRight);
+			}
+			else if (bLeft)
+				a_lStack.push_back(uNode + 1);
+			else if (bRight)
+				a_lStack.push_back(node.uRight);
+			continue;
+		}
+
+		for (uint i = node.uFirst; i < node.uFirst + node.uCount; ++i)
+		{
+			uint uEntity = m_lCullEntity[i];
+			if (static_cast<int>(uEntity) == a_Ray.nIgnore)
+				continue;
+			RigidBody* pRigidBody = m_mEntityArray[uEntity]->GetRigidBody();
+			//the global box is cheaper than the oriented one and rejects most misses
+			if (!IsRayInBox(a_Ray.v3Origin, v3Inverse, pRigidBody->GetMinGlobal(), pRigidBody->GetMaxGlobal(), fBest, fEnter))
+				continue;
+			float fDistance = 0.0f;
+			vector3 v3Normal;
+			if (!pRigidBody->IsIntersectingRay(a_Ray.v3Origin, a_Ray.v3Direction, fBest, fDistance, v3Normal))
+				continue;
+			fBest = fDistance;
+			a_Hit.nEntity = static_cast<int>(uEntity);
+			a_Hit.fDistance = fDistance;
+			a_Hit.v3Normal = v3Normal;
+			if (a_bAnyHit)
+				break;
+		}
+		if (a_bAnyHit && a_Hit.nEntity >= 0)
+			break;
+	}
+
+	if (a_Hit.nEntity < 0)
+		return false;
+	a_Hit.v3Point = a_Ray.v3Origin + a_Ray.v3Direction * a_Hit.fDistance;
+	return true;
+}
+bool EntityManager::CastRay(vector3 a_v3Origin, vector3 a_v3Direction, RayHit& a_Hit, float a_fMaxDistance, int a_nIgnore)
+{
+	a_Hit = RayHit();
+	float fLength = glm::length(a_v3Direction);
+	if (fLength == 0.0f)
+		return false;
+	RayQuery ray;
+	ray.v3Origin = a_v3Origin;
+	ray.v3Direction = a_v3Direction / fLength;
+	ray.fMaxDistance = a_fMaxDistance;
+	ray.nIgnore = a_nIgnore;
+	UpdateQueryTree();
+	return TraverseRay(ray, false, m_lQueryStack, a_Hit);
+}
+bool EntityManager::CastSegment(vector3 a_v3Start, vector3 a_v3End, RayHit& a_Hit, int a_nIgnore)
+{
+	return CastRay(a_v3Start, a_v3End - a_v3Start, a_Hit, glm::distance(a_v3Start, a_v3End), a_nIgnore);
+}
+uint EntityManager::CastRays(std::vector<RayQuery> const& a_lRay, std::vector<RayHit>& a_lHit, bool a_bAnyHit)
+{
+	BTX_PROFILE_ZONE("EntityManager::CastRays");
+	a_lHit.resize(a_lRay.size());
+	UpdateQueryTree();
+	uint uHits = 0;
+	for (uint i = 0; i < a_lRay.size(); ++i)
+	{
+		RayQuery ray = a_lRay[i];
+		float fLength = glm::length(ray.v3Direction);
+		if (fLength == 0.0f)
+		{
+			a_lHit[i] = RayHit();
+			continue;
+		}
+		ray.v3Direction /= fLength;
+		if (TraverseRay(ray, a_bAnyHit, m_lQueryStack, a_lHit[i]))
+			++uHits;
+	}
+	return uHits;
+}
+bool EntityManager::PickEntity(vector2 a_v2Screen, RayHit& a_Hit)
+{
+	vector3 v3Origin;
+	vector3 v3Direction;
+	CameraManager::GetInstance()->GetPickRay(a_v2Screen, v3Origin, v3Direction);
+	return CastRay(v3Origin, v3Direction, a_Hit);
+}
+template <class Test>
+uint EntityManager::Overlap(Test a_Overlap, std::vector<uint>& a_lEntity)
+{
+	a_lEntity.clear();
+	UpdateQueryTree();
+	if (m_lCullNode.empty())
+		return 0;
+
+	m_lQueryStack.clear();
+	m_lQueryStack.push_back(0);
+	while (!m_lQueryStack.empty())
+	{
+		uint uNode = m_lQueryStack.back();
+		m_lQueryStack.pop_back();
+		CullNode& node = m_lCullNode[uNode];
+		if (!a_Overlap(node.v3Min, node.v3Max))
+			continue;
+		if (node.uRight != 0)
+		{
+			m_lQueryStack.push_back(node.uRight);
+			m_lQueryStack.push_back(uNode + 1);
+			continue;
+		}
+		for (uint i = node.uFirst; i < node.uFirst + node.uCount; ++i)
+		{
+			RigidBody* pRigidBody = m_mEntityArray[m_lCullEntity[i]]->GetRigidBody();
+			if (a_Overlap(pRigidBody->GetMinGlobal(), pRigidBody->GetMaxGlobal()))
+				a_lEntity.push_back(m_lCullEntity[i]);
+		}
+	}
+	return a_lEntity.size();
+}
+uint EntityManager::OverlapSphere(vector3 a_v3Center, float a_fRadius, std::vector<uint>& a_lEntity)
+{
+	float fRadius2 = a_fRadius * a_fRadius;
+	return Overlap([a_v3Center, fRadius2](vector3 const& a_v3Min, vector3 const& a_v3Max)
+	{
+		//distance from the center to the closest point of the box
+		vector3 v3Closest = glm::clamp(a_v3Center, a_v3Min, a_v3Max);
+		vector3 v3Offset = a_v3Center - v3Closest;
+		return glm::dot(v3Offset, v3Offset) <= fRadius2;
+	}, a_lEntity);
+}
+uint EntityManager::OverlapBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity)
+{
+	return Overlap([a_v3Min, a_v3Max](vector3 const& a_v3BoxMin, vector3 const& a_v3BoxMax)
+	{
+		return	a_v3Min.x <= a_v3BoxMax.x && a_v3Max.x >= a_v3BoxMin.x &&
+				a_v3Min.y <= a_v3BoxMax.y && a_v3Max.y >= a_v3BoxMin.y &&
+				a_v3Min.z <= a_v3BoxMax.z && a_v3Max.z >= a_v3BoxMin.z;
+	}, a_lEntity);
+}
 void EntityManager::AddDimension(uint a_uIndex, uint a_uDimension)
 {
 	//if the list is empty return
@@ -510,6 +1137,27 @@ void EntityManager::SetMass(float a_fMass, uint a_uIndex)
 
 	return;
 }
+void EntityManager::SetOccluder(bool a_bOccluder, String a_sUniqueID)
+{
+	//Get the entity
+	Entity* pTemp = Entity::GetEntity(a_sUniqueID);
+
+	//if the entity does not exists return
+	if (pTemp)
+		pTemp->SetOccluder(a_bOccluder);
+}
+void EntityManager::SetOccluder(bool a_bOccluder, uint a_uIndex)
+{
+	//if the list is empty return
+	if (m_uEntityCount == 0)
+		return;
+
+	//if the index is larger than the number of entries we are asking for the last one
+	if (a_uIndex >= m_uEntityCount)
+		a_uIndex = m_uEntityCount - 1;
+
+	m_mEntityArray[a_uIndex]->SetOccluder(a_bOccluder);
+}
 void EntityManager::UsePhysicsSolver(bool a_bUse, String a_sUniqueID)
 {
 	//Get the entity
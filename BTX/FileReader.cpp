@@ -31,6 +31,8 @@ void FileReader::Init(void)
 	m_pFile = nullptr;
 	m_pSystem = SystemSingleton::GetInstance();
 	m_sFirstWord = "";
+	m_bBuffered = false;
+	m_uCursor = 0;
 }
 
 eBTX_OUTPUT FileReader::SaveBinaryFile(String a_sFileName)
@@ -54,6 +56,44 @@ eBTX_OUTPUT FileReader::ReadBinaryFile(String a_sFileName)
 
 	return OUT_ERR_NONE;
 }
+eBTX_OUTPUT FileReader::ReadFileBuffered(String a_sFileName)
+{
+	CloseFile();
+
+	std::ifstream iStream(a_sFileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (iStream.is_open() == false)
+		return OUT_ERR_FILE_MISSING;
+
+	//One read for the whole file, the null at the end lets the lines be parsed in place
+	std::streamoff nSize = iStream.tellg();
+	if (nSize < 0)
+		return OUT_ERR_FILE_MISSING;
+	m_lBuffer.assign(static_cast<size_t>(nSize) + 1, '\0');
+	iStream.seekg(0, std::ios::beg);
+	if (nSize > 0 && !iStream.read(&m_lBuffer[0], nSize))
+	{
+		std::vector<char>().swap(m_lBuffer);
+		return OUT_ERR_FILE_MISSING;
+	}
+
+	m_bBuffered = true;
+	m_uCursor = 0;
+	return OUT_ERR_NONE;
+}
+bool FileReader::IsBuffered(void) { return m_bBuffered; }
+bool FileReader::CopyFromBuffer(void* a_pData, size_t a_uSize)
+{
+	//the null at the end of the buffer is not part of the file
+	size_t uLeft = m_lBuffer.size() - 1 - m_uCursor;
+	if (a_uSize > uLeft)
+	{
+		m_uCursor += uLeft;
+		return false;
+	}
+	memcpy(a_pData, &m_lBuffer[m_uCursor], a_uSize);
+	m_uCursor += a_uSize;
+	return true;
+}
 eBTX_OUTPUT FileReader::ReadFile(String a_sFileName)
 {
 	//if(m_pFile != nullptr)
@@ -87,18 +127,29 @@ void FileReader::CloseFile(void)
 {
 	if(m_pFile != nullptr)
 		fclose(m_pFile);
+	m_pFile = nullptr;
 
 	if (m_iStream.is_open())
 		m_iStream.close();
 	
 	if (m_oStream.is_open())
 		m_oStream.close();
+
+	if (m_bBuffered)
+	{
+		std::vector<char>().swap(m_lBuffer);
+		m_bBuffered = false;
+		m_uCursor = 0;
+	}
 }
 
-void FileReader::Rewind(void) const
+void FileReader::Rewind(void)
 {
 	if(m_pFile != nullptr)
 		rewind(m_pFile);
+
+	if (m_bBuffered)
+		m_uCursor = 0;
 }
 eBTX_OUTPUT FileReader::Write(String a_sStringInput)
 {
@@ -161,7 +212,11 @@ void FileReader::WriteString(String input)
 int FileReader::ReadInt(void)
 {
 	int output = 0;
-	if (m_iStream.is_open())
+	if (m_bBuffered)
+	{
+		CopyFromBuffer(&output, sizeof(int));
+	}
+	else if (m_iStream.is_open())
 	{
 		m_iStream.read((char*)&output, sizeof(int));
 	}
@@ -171,7 +226,11 @@ int FileReader::ReadInt(void)
 float FileReader::ReadFloat(void)
 {
 	float output = 0.0f;
-	if (m_iStream.is_open())
+	if (m_bBuffered)
+	{
+		CopyFromBuffer(&output, sizeof(float));
+	}
+	else if (m_iStream.is_open())
 	{
 		m_iStream.read((char*)&output, sizeof(float));
 	}
@@ -181,7 +240,11 @@ float FileReader::ReadFloat(void)
 bool FileReader::ReadBool(void)
 {
 	bool output = false;
-	if (m_iStream.is_open())
+	if (m_bBuffered)
+	{
+		CopyFromBuffer(&output, sizeof(bool));
+	}
+	else if (m_iStream.is_open())
 	{
 		m_iStream.read((char*)&output, sizeof(bool));
 	}
@@ -190,6 +253,18 @@ bool FileReader::ReadBool(void)
 
 String FileReader::ReadString(void)
 {
+	//The characters are copied straight from the buffer into the string
+	if (m_bBuffered)
+	{
+		int nLength = 0;
+		if (!CopyFromBuffer(&nLength, sizeof(int)) || nLength <= 0)
+			return "";
+		size_t uLength = std::min(static_cast<size_t>(nLength), m_lBuffer.size() - 1 - m_uCursor);
+		String sOutput(&m_lBuffer[m_uCursor], uLength);
+		m_uCursor += uLength;
+		return sOutput;
+	}
+
 	//Create a new char array to store info into
 	int nSize = 1;
 	char* output = new char[nSize]{ '\0' };
@@ -206,9 +281,32 @@ String FileReader::ReadString(void)
 		m_iStream.read((char*)output, sizeof(char) * nSize);
 		output[nSize] = '\0';
 	}
-	return String(output);
+	String sOutput = output;
+	delete[] output;
+	return sOutput;
  }
 
+void FileReader::WriteBuffer(const void* a_pData, uint a_uSize)
+{
+	if (m_oStream.is_open() && a_uSize > 0)
+	{
+		m_oStream.write((const char*)a_pData, a_uSize);
+	}
+	return;
+}
+
+bool FileReader::ReadBuffer(void* a_pData, uint a_uSize)
+{
+	if (m_bBuffered)
+		return CopyFromBuffer(a_pData, a_uSize);
+	if (!m_iStream.is_open())
+		return false;
+	if (a_uSize == 0)
+		return true;
+	m_iStream.read((char*)a_pData, a_uSize);
+	return static_cast<uint>(m_iStream.gcount()) == a_uSize;
+}
+
 eBTX_OUTPUT FileReader::WriteLine(String a_sStringInput)
 {
 	if (!m_pFile)
@@ -245,50 +343,79 @@ eBTX_OUTPUT FileReader::RemoveTabs(String* a_sInput)
 	return eBTX_OUTPUT::OUT_ERR_NONE;
 }
 
+bool FileReader::IsComment(const char* a_szLine, uint a_uLength)
+{
+	if (a_uLength == 0 || a_szLine[0] == '#')
+		return true;
+	return a_uLength > 1 && a_szLine[0] == '/' && a_szLine[1] == '/';
+}
 eBTX_OUTPUT FileReader::ReadNextLine(bool bSkipComments)
 {
+	//a buffered file only copies the line it stops at into m_sLine
+	if (m_bBuffered)
+	{
+		LineView line;
+		eBTX_OUTPUT result = ReadNextLine(line, bSkipComments);
+		if (result == OUT_RUNNING)
+			m_sLine.assign(line.szData, line.uLength);
+		return result;
+	}
+
 	//if the file is not open return
 	if (!m_iStream.is_open())
 		return eBTX_OUTPUT::OUT_ERR_NOT_INITIALIZED;
 
-	//if we are at the end of the file return
-	if (m_iStream.eof())
-		return eBTX_OUTPUT::OUT_DONE;
+	//comments are skipped in a loop, a long block of them would run out of stack otherwise
+	for (;;)
+	{
+		//if we are at the end of the file return
+		if (m_iStream.eof())
+			return eBTX_OUTPUT::OUT_DONE;
 
-	//read the next line
-	std::getline(m_iStream, m_sLine);
-	
-	//Remove the tabs from the lines
-	//m_sLine = RemoveTabs(m_sLine);
-	
-	//Send the string to clean
-	RemoveBlanks(&m_sLine);
+		//read the next line
+		std::getline(m_iStream, m_sLine);
+
+		//Send the string to clean
+		RemoveBlanks(&m_sLine);
 
-	//if comments are skipped check for the beginning of the string
-	if(bSkipComments)
+		//if comments are skipped check for the beginning of the string
+		if (!bSkipComments || !IsComment(m_sLine.c_str(), static_cast<uint>(m_sLine.length())))
+			return OUT_RUNNING;
+	}
+};
+eBTX_OUTPUT FileReader::ReadNextLine(LineView& a_Line, bool a_bSkipComments)
+{
+	if (!m_bBuffered)
+		return eBTX_OUTPUT::OUT_ERR_NOT_INITIALIZED;
+
+	const char* szBegin = &m_lBuffer[0];
+	const char* szEnd = szBegin + m_lBuffer.size() - 1;
+	const char* szCursor = szBegin + m_uCursor;
+	while (szCursor < szEnd)
 	{
-		if(m_sLine[0] == '#')
-		{
-			if(ReadNextLine(bSkipComments) == OUT_DONE)
-				return OUT_DONE;
-		}
-		if(m_sLine[0] == '/')
-		{
-			if(m_sLine[1] == '/')
-			{
-				if(ReadNextLine(bSkipComments) == OUT_DONE)
-					return OUT_DONE;
-			}
-		}
-		if(m_sLine[0] == 0)
+		//leave out the blanks at the beginning, like RemoveBlanks does
+		while (szCursor < szEnd && (*szCursor == ' ' || *szCursor == '\t'))
+			++szCursor;
+
+		const char* szLine = szCursor;
+		const char* szNewLine = static_cast<const char*>(memchr(szLine, '\n', szEnd - szLine));
+		const char* szLineEnd = szNewLine ? szNewLine : szEnd;
+		szCursor = szNewLine ? szNewLine + 1 : szEnd;
+		if (szLineEnd > szLine && szLineEnd[-1] == '\r')
+			--szLineEnd;
+
+		uint uLength = static_cast<uint>(szLineEnd - szLine);
+		if (!a_bSkipComments || !IsComment(szLine, uLength))
 		{
-			if(ReadNextLine(bSkipComments) == OUT_DONE)
-				return OUT_DONE;
+			m_uCursor = szCursor - szBegin;
+			a_Line.szData = szLine;
+			a_Line.uLength = uLength;
+			return OUT_RUNNING;
 		}
 	}
-
-	return OUT_RUNNING;
-};
+	m_uCursor = szCursor - szBegin;
+	return OUT_DONE;
+}
 eBTX_OUTPUT FileReader::RemoveBlanks(String* a_sInput)
 {
 	if ((*a_sInput)[0] == 32 || (*a_sInput)[0] == 9)
@@ -675,4 +802,17 @@ bool FileReader::FileExists(String a_sFileName)
 	}
 
 	return output;
+}
+bool FileReader::GetFileStamp(String a_sFileName, unsigned long long* a_pSize, unsigned long long* a_pTime)
+{
+	WIN32_FILE_ATTRIBUTE_DATA oData;
+	if (!GetFileAttributesExA(a_sFileName.c_str(), GetFileExInfoStandard, &oData))
+		return false;
+
+	if (a_pSize)
+		*a_pSize = (static_cast<unsigned long long>(oData.nFileSizeHigh) << 32) | oData.nFileSizeLow;
+	if (a_pTime)
+		*a_pTime = (static_cast<unsigned long long>(oData.ftLastWriteTime.dwHighDateTime) << 32) | oData.ftLastWriteTime.dwLowDateTime;
+
+	return true;
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "BTX\Camera\Frustum.h"
+using namespace BTX;
+
+//The big 3
+Frustum::Frustum(void)
+{
+	//A plane with no normal and positive distance keeps every point inside
+	for (uint i = 0; i < 6; i++)
+		m_v4Plane[i] = vector4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+Frustum::Frustum(matrix4 a_m4ViewProjection) { SetMatrix(a_m4ViewProjection); }
+Frustum::Frustum(Frustum const& other)
+{
+	for (uint i = 0; i < 6; i++)
+		m_v4Plane[i] = other.m_v4Plane[i];
+}
+Frustum& Frustum::operator=(Frustum const& other)
+{
+	if (this != &other)
+	{
+		Frustum temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+Frustum::~Frustum(void) {}
+void Frustum::Swap(Frustum& other)
+{
+	for (uint i = 0; i < 6; i++)
+		std::swap(m_v4Plane[i], other.m_v4Plane[i]);
+}
+//Accessors
+vector4 Frustum::GetPlane(uint a_uIndex)
+{
+	if (a_uIndex >= 6)
+		a_uIndex = 5;
+	return m_v4Plane[a_uIndex];
+}
+//--- Methods
+void Frustum::SetMatrix(matrix4 a_m4ViewProjection)
+{
+	//Rows of the matrix, glm stores it by columns
+	vector4 v4Row[4];
+	for (uint i = 0; i < 4; i++)
+		v4Row[i] = vector4(a_m4ViewProjection[0][i], a_m4ViewProjection[1][i], a_m4ViewProjection[2][i], a_m4ViewProjection[3][i]);
+
+	//A clip space point is inside when -w <= x, y, z <= w
+	m_v4Plane[0] = v4Row[3] + v4Row[0]; //left
+	m_v4Plane[1] = v4Row[3] - v4Row[0]; //right
+	m_v4Plane[2] = v4Row[3] + v4Row[1]; //bottom
+	m_v4Plane[3] = v4Row[3] - v4Row[1]; //top
+	m_v4Plane[4] = v4Row[3] + v4Row[2]; //near
+	m_v4Plane[5] = v4Row[3] - v4Row[2]; //far
+
+	//Normalize so the sphere test can compare distances against the radius
+	for (uint i = 0; i < 6; i++)
+	{
+		float fLength = glm::length(vector3(m_v4Plane[i]));
+		if (fLength > 0.0f)
+			m_v4Plane[i] /= fLength;
+	}
+}
+eBTX_FRUSTUM Frustum::ClassifyBox(vector3 a_v3Min, vector3 a_v3Max)
+{
+	eBTX_FRUSTUM eResult = FRUSTUM_INSIDE;
+	for (uint i = 0; i < 6; i++)
+	{
+		const vector4& v4Plane = m_v4Plane[i];
+		//Corner furthest along the normal, if it is behind the plane the whole box is
+		vector3 v3Positive(
+			v4Plane.x >= 0.0f ? a_v3Max.x : a_v3Min.x,
+			v4Plane.y >= 0.0f ? a_v3Max.y : a_v3Min.y,
+			v4Plane.z >= 0.0f ? a_v3Max.z : a_v3Min.z);
+		if (glm::dot(vector3(v4Plane), v3Positive) + v4Plane.w < 0.0f)
+			return FRUSTUM_OUTSIDE;
+
+		//Corner furthest against the normal, if it is behind the plane the box crosses it
+		vector3 v3Negative(
+			v4Plane.x >= 0.0f ? a_v3Min.x : a_v3Max.x,
+			v4Plane.y >= 0.0f ? a_v3Min.y : a_v3Max.y,
+			v4Plane.z >= 0.0f ? a_v3Min.z : a_v3Max.z);
+		if (glm::dot(vector3(v4Plane), v3Negative) + v4Plane.w < 0.0f)
+			eResult = FRUSTUM_INTERSECT;
+	}
+	return eResult;
+}
+bool Frustum::IsBoxVisible(vector3 a_v3Min, vector3 a_v3Max)
+{
+	return ClassifyBox(a_v3Min, a_v3Max) != FRUSTUM_OUTSIDE;
+}
+bool Frustum::IsSphereVisible(vector3 a_v3Center, float a_fRadius)
+{
+	for (uint i = 0; i < 6; i++)
+	{
+		if (glm::dot(vector3(m_v4Plane[i]), a_v3Center) + m_v4Plane[i].w < -a_fRadius)
+			return false;
+	}
+	return true;
+}
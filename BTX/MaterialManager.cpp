@@ -50,7 +50,7 @@ int MaterialManager::AddMaterial(Material input)
 		Material* pMaterial = new Material(input);
 		m_materialList.push_back(pMaterial);
 		nMaterial = m_materialList.size() -1;
-		m_map[pMaterial->GetName()] = nMaterial;
+		m_map.Set(NameTable::GetInstance()->Intern(pMaterial->GetName()), nMaterial);
 	}
 	ReloadMaps();
 	return nMaterial;
@@ -66,7 +66,7 @@ int MaterialManager::AddMaterial(String a_sName)
 	//if no material was found create a new material and add it to the vector
 	Material* pMaterial = new Material(a_sName);
 	m_materialList.push_back(pMaterial);
-	m_map[pMaterial->GetName()] = static_cast<int>(m_materialList.size() -1);
+	m_map.Set(NameTable::GetInstance()->Intern(pMaterial->GetName()), static_cast<int>(m_materialList.size() -1));
 
 	//return the newly added material's index
 	return m_materialList.size() -1;
@@ -87,9 +87,9 @@ int MaterialManager::AddMaterial(String a_sName, String a_sDiffuse, String a_sNo
 }
 int MaterialManager::IdentifyMaterial(String a_sName)
 {
-	auto var = m_map.find(a_sName);
-	if(var != m_map.end())
-		return var->second;
+	int* pMaterial = m_map.Find(NameTable::GetInstance()->Find(a_sName));
+	if(pMaterial != nullptr)
+		return *pMaterial;
 
 	return -1;
 }
@@ -23,6 +23,7 @@ void Mesh::Init(void)
 
 	m_pMatMngr = MaterialManager::GetInstance();
 	m_pShaderMngr = ShaderManager::GetInstance();
+	m_pBackend = RenderBackend::GetInstance();
 	m_nShader = m_pShaderMngr->GetShaderID("Simplex");
 }
 void Mesh::Swap(Mesh& other)
@@ -50,6 +51,7 @@ void Mesh::Swap(Mesh& other)
 
 	std::swap(m_pMatMngr, other.m_pMatMngr);
 	std::swap(m_pShaderMngr, other.m_pShaderMngr);
+	std::swap(m_pBackend, other.m_pBackend);
 
 	std::swap(m_sName, other.m_sName);
 }
@@ -62,10 +64,10 @@ void Mesh::Release(void)
 		DisconnectOpenGL3X();
 
 	if (m_VBO > 0)
-		glDeleteBuffers(1, &m_VBO);
+		m_pBackend->DeleteBuffer(m_VBO);
 
 	if (m_VAO > 0)
-		glDeleteVertexArrays(1, &m_VAO);
+		m_pBackend->DeleteVertexArray(m_VAO);
 
 	m_lVertex.clear();
 	m_lVertexPos.clear();
@@ -89,6 +91,7 @@ Mesh::Mesh(Mesh& other)
 	m_pOriginal = &other;
 	m_pShaderMngr = other.m_pShaderMngr;
 	m_pMatMngr = other.m_pMatMngr;
+	m_pBackend = other.m_pBackend;
 
 	m_bLineObject = other.m_bLineObject;
 
@@ -144,6 +147,7 @@ void Mesh::Instantiate(Mesh* const other)
 
 	m_pMatMngr = other->m_pMatMngr;
 	m_pShaderMngr = other->m_pShaderMngr;
+	m_pBackend = other->m_pBackend;
 }
 Mesh::~Mesh() { Release(); }
 //Accessors
@@ -425,36 +429,30 @@ void Mesh::CompileOpenGL3X(void)
 		//Tangent
 		m_lVertex.push_back(m_lVertexTan[i]);
 	}
-	glGenVertexArrays(1, &m_VAO);//Generate vertex array object
-	glGenBuffers(1, &m_VBO);//Generate Vertex Buffered Object
+	m_VAO = m_pBackend->CreateVertexArray();//Generate vertex array object
+	m_VBO = m_pBackend->CreateBuffer();//Generate Vertex Buffered Object
 
-	glBindVertexArray(m_VAO);//Bind the VAO
-	glBindBuffer(GL_ARRAY_BUFFER, m_VBO);//Bind the VBO
-	glBufferData(GL_ARRAY_BUFFER, m_uVertexCount * 6 * sizeof(vector3), &m_lVertex[0], GL_STATIC_DRAW);//Generate space for the VBO
+	m_pBackend->BindVertexArray(m_VAO);//Bind the VAO
+	m_pBackend->BindBuffer(GL_ARRAY_BUFFER, m_VBO);//Bind the VBO
+	m_pBackend->BufferData(GL_ARRAY_BUFFER, m_uVertexCount * 6 * sizeof(vector3), &m_lVertex[0], GL_STATIC_DRAW);//Generate space for the VBO
 
 	// Position attribute
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)0);
+	m_pBackend->VertexAttribute(0, 3, 6 * sizeof(vector3), 0);
 
 	// Color attribute
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)(1 * sizeof(vector3)));
+	m_pBackend->VertexAttribute(1, 3, 6 * sizeof(vector3), 1 * sizeof(vector3));
 
 	// UV attribute
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)(2 * sizeof(vector3)));
+	m_pBackend->VertexAttribute(2, 3, 6 * sizeof(vector3), 2 * sizeof(vector3));
 
 	// Normal attribute
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)(3 * sizeof(vector3)));
+	m_pBackend->VertexAttribute(3, 3, 6 * sizeof(vector3), 3 * sizeof(vector3));
 
 	// Bi-Normal attribute
-	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)(4 * sizeof(vector3)));
+	m_pBackend->VertexAttribute(4, 3, 6 * sizeof(vector3), 4 * sizeof(vector3));
 
 	// Tangent attribute
-	glEnableVertexAttribArray(5);
-	glVertexAttribPointer(5, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(vector3), (GLvoid*)(5 * sizeof(vector3)));
+	m_pBackend->VertexAttribute(5, 3, 6 * sizeof(vector3), 5 * sizeof(vector3));
 
 	if (m_uMaterialIndex < 0)
 	{
@@ -470,10 +468,41 @@ void Mesh::CompileOpenGL3X(void)
 
 	m_bBinded = true;
 
-	glBindVertexArray(0); // Unbind VAO
+	m_pBackend->BindVertexArray(0); // Unbind VAO
 
 	return;
 }
+void Mesh::RebuildOpenGL3X(void)
+{
+	if (m_pOriginal != nullptr)
+		return;
+
+	if (m_VBO > 0)
+		m_pBackend->DeleteBuffer(m_VBO);
+	if (m_VAO > 0)
+		m_pBackend->DeleteVertexArray(m_VAO);
+	m_VAO = 0;
+	m_VBO = 0;
+	m_lVertex.clear();
+	m_bBinded = false;
+	CompileOpenGL3X();
+}
+void Mesh::AppendMesh(Mesh* a_pSource)
+{
+	if (a_pSource == nullptr || a_pSource == this || a_pSource->m_bLineObject != m_bLineObject)
+		return;
+
+	//both sides need every list as long as the positions or the attributes would shift
+	CompleteMesh();
+	a_pSource->CompleteMesh();
+	m_lVertexPos.insert(m_lVertexPos.end(), a_pSource->m_lVertexPos.begin(), a_pSource->m_lVertexPos.end());
+	m_lVertexCol.insert(m_lVertexCol.end(), a_pSource->m_lVertexCol.begin(), a_pSource->m_lVertexCol.end());
+	m_lVertexNor.insert(m_lVertexNor.end(), a_pSource->m_lVertexNor.begin(), a_pSource->m_lVertexNor.end());
+	m_lVertexBin.insert(m_lVertexBin.end(), a_pSource->m_lVertexBin.begin(), a_pSource->m_lVertexBin.end());
+	m_lVertexTan.insert(m_lVertexTan.end(), a_pSource->m_lVertexTan.begin(), a_pSource->m_lVertexTan.end());
+	m_lVertexUV.insert(m_lVertexUV.end(), a_pSource->m_lVertexUV.begin(), a_pSource->m_lVertexUV.end());
+	m_uVertexCount += a_pSource->m_uVertexCount;
+}
 GLuint Mesh::GetVAO(void)
 {
 	return m_VAO;
@@ -482,6 +511,7 @@ GLuint Mesh::GetVBO(void)
 {
 	return m_VBO;
 }
+bool Mesh::IsLineObject(void) { return m_bLineObject; }
 void Mesh::SetWireframeColor(vector3 a_v3Color) { m_v3Wireframe = a_v3Color; }
 vector3 Mesh::GetWireframeColor(void) { return m_v3Wireframe; }
 // Compile shapes
@@ -1141,11 +1171,427 @@ void Mesh::GenerateLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorSta
 	//m_sName = BTX::ToUppercase(m_sName);
 	SetShaderProgram("Line");
 }
+void Mesh::GenerateGrid(uint a_uSize, bool a_bCenterLines, vector3 a_v3Color)
+{
+	Release();
+	Init();
+
+	float fHalf = a_uSize / 2.0f;
+	for (uint i = 0; i <= a_uSize; i++)
+	{
+		float fPosition = i - fHalf;
+		if (!a_bCenterLines && fPosition == 0.0f)
+			continue;
+		//along X
+		AddVertexPosition(vector3(-fHalf, fPosition, 0.0f));
+		AddVertexPosition(vector3(fHalf, fPosition, 0.0f));
+		//along Y
+		AddVertexPosition(vector3(fPosition, -fHalf, 0.0f));
+		AddVertexPosition(vector3(fPosition, fHalf, 0.0f));
+	}
+
+	//Compile shape
+	m_bLineObject = true;
+	CompleteMesh(a_v3Color);
+	CompileOpenGL3X();
+	m_sName = "grid_(" + std::to_string(a_uSize) + "," + std::to_string(a_bCenterLines) + "," +
+		std::to_string(a_v3Color.x) + "," +
+		std::to_string(a_v3Color.y) + "," +
+		std::to_string(a_v3Color.z) + ")";
+	SetShaderProgram("Line");
+}
+//Error quadric of a vertex (Garland and Heckbert), the sum of the squared distances to the planes
+//around it kept as the upper triangle of a symmetric 4x4 matrix
+struct Quadric
+{
+	double m[10] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	void AddPlane(glm::dvec3 a_v3Normal, double a_dDistance, double a_dWeight)
+	{
+		double a = a_v3Normal.x, b = a_v3Normal.y, c = a_v3Normal.z, d = a_dDistance;
+		m[0] += a_dWeight * a * a; m[1] += a_dWeight * a * b; m[2] += a_dWeight * a * c; m[3] += a_dWeight * a * d;
+		m[4] += a_dWeight * b * b; m[5] += a_dWeight * b * c; m[6] += a_dWeight * b * d;
+		m[7] += a_dWeight * c * c; m[8] += a_dWeight * c * d;
+		m[9] += a_dWeight * d * d;
+	}
+	void Add(Quadric const& a_Other)
+	{
+		for (uint i = 0; i < 10; ++i)
+			m[i] += a_Other.m[i];
+	}
+	double Error(glm::dvec3 v) const
+	{
+		return m[0] * v.x * v.x + 2.0 * m[1] * v.x * v.y + 2.0 * m[2] * v.x * v.z + 2.0 * m[3] * v.x +
+			m[4] * v.y * v.y + 2.0 * m[5] * v.y * v.z + 2.0 * m[6] * v.y +
+			m[7] * v.z * v.z + 2.0 * m[8] * v.z + m[9];
+	}
+	//Point of least error, false if the planes do not pin one down
+	bool Minimum(glm::dvec3& a_v3Out) const
+	{
+		glm::dmat3 A = glm::dmat3(m[0], m[1], m[2], m[1], m[4], m[5], m[2], m[5], m[7]);
+		double dDeterminant = glm::determinant(A);
+		if (std::abs(dDeterminant) < 1e-12)
+			return false;
+		a_v3Out = glm::inverse(A) * -glm::dvec3(m[3], m[6], m[8]);
+		return true;
+	}
+};
+//Collapse of the edge between two vertices waiting in the heap
+struct EdgeCollapse
+{
+	double dError = 0.0; //Error the collapse adds
+	uint uA = 0, uB = 0; //Vertices of the edge, uB goes into uA
+	uint uStampA = 0, uStampB = 0; //Versions of the vertices the error was measured with
+	glm::dvec3 v3Target; //Where the merged vertex goes
+	bool operator<(EdgeCollapse const& other) const { return dError > other.dError; } //min heap
+};
+//Vertices of the triangles around a vertex, sorted and without repeats
+static void GatherNeighbors(uint a_uVertex, std::vector<uint> const& a_lTriangle, std::vector<bool> const& a_lAlive,
+	std::vector<uint> const& a_lTriangleOf, std::vector<uint>& a_lOut)
+{
+	a_lOut.clear();
+	for (uint t : a_lTriangleOf)
+	{
+		if (!a_lAlive[t])
+			continue;
+		for (uint k = 0; k < 3; ++k)
+		{
+			uint uOther = a_lTriangle[t * 3 + k];
+			if (uOther != a_uVertex)
+				a_lOut.push_back(uOther);
+		}
+	}
+	std::sort(a_lOut.begin(), a_lOut.end());
+	a_lOut.erase(std::unique(a_lOut.begin(), a_lOut.end()), a_lOut.end());
+}
+void Mesh::GenerateSimplified(Mesh* a_pSource, float a_fRatio)
+{
+	if (a_pSource == nullptr || a_pSource == this || a_pSource->m_bLineObject)
+		return;
+
+	Release();
+	Init();
+
+	//The triangles of the source are a list of corners, the corners in the same place are
+	//welded into one vertex so the collapses can walk the surface
+	std::vector<vector3> const& lCorner = a_pSource->m_lVertexPos;
+	uint uTriangleCount = lCorner.size() / 3;
+	uint uCornerCount = uTriangleCount * 3;
+	std::vector<uint> lOrder(uCornerCount);
+	for (uint i = 0; i < uCornerCount; ++i)
+		lOrder[i] = i;
+	auto less = [&lCorner](uint a, uint b)
+	{
+		if (lCorner[a].x != lCorner[b].x) return lCorner[a].x < lCorner[b].x;
+		if (lCorner[a].y != lCorner[b].y) return lCorner[a].y < lCorner[b].y;
+		return lCorner[a].z < lCorner[b].z;
+	};
+	std::sort(lOrder.begin(), lOrder.end(), less);
+	std::vector<uint> lTriangle(uCornerCount); //Vertex of each corner
+	std::vector<glm::dvec3> lPosition; //Position of each vertex
+	for (uint i = 0; i < uCornerCount; ++i)
+	{
+		if (i == 0 || less(lOrder[i - 1], lOrder[i]))
+			lPosition.push_back(glm::dvec3(lCorner[lOrder[i]]));
+		lTriangle[lOrder[i]] = lPosition.size() - 1;
+	}
+	uint uVertexCount = lPosition.size();
+
+	//Each triangle adds its plane to its vertices, weighted by its area
+	std::vector<Quadric> lQuadric(uVertexCount);
+	std::vector<std::vector<uint>> lTriangleOf(uVertexCount);
+	std::vector<bool> lAlive(uTriangleCount, true);
+	std::vector<std::pair<uint, uint>> lEdge;
+	uint uAlive = 0;
+	for (uint t = 0; t < uTriangleCount; ++t)
+	{
+		uint* pVertex = &lTriangle[t * 3];
+		glm::dvec3 v3Normal = glm::cross(lPosition[pVertex[1]] - lPosition[pVertex[0]], lPosition[pVertex[2]] - lPosition[pVertex[0]]);
+		double dLength = glm::length(v3Normal);
+		if (dLength <= 0.0 || pVertex[0] == pVertex[1] || pVertex[1] == pVertex[2] || pVertex[2] == pVertex[0])
+		{
+			lAlive[t] = false;
+			continue;
+		}
+		++uAlive;
+		v3Normal /= dLength;
+		double dDistance = -glm::dot(v3Normal, lPosition[pVertex[0]]);
+		for (uint k = 0; k < 3; ++k)
+		{
+			lQuadric[pVertex[k]].AddPlane(v3Normal, dDistance, dLength * 0.5);
+			lTriangleOf[pVertex[k]].push_back(t);
+			uint uA = pVertex[k], uB = pVertex[(k + 1) % 3];
+			lEdge.push_back(std::make_pair(std::min(uA, uB), std::max(uA, uB)));
+		}
+	}
+	//Edges used by a single triangle are borders, a steep plane through them keeps them in place
+	std::sort(lEdge.begin(), lEdge.end());
+	for (uint t = 0; t < uTriangleCount; ++t)
+	{
+		if (!lAlive[t])
+			continue;
+		uint* pVertex = &lTriangle[t * 3];
+		glm::dvec3 v3Face = glm::normalize(glm::cross(lPosition[pVertex[1]] - lPosition[pVertex[0]], lPosition[pVertex[2]] - lPosition[pVertex[0]]));
+		for (uint k = 0; k < 3; ++k)
+		{
+			uint uA = pVertex[k], uB = pVertex[(k + 1) % 3];
+			std::pair<uint, uint> edge = std::make_pair(std::min(uA, uB), std::max(uA, uB));
+			auto range = std::equal_range(lEdge.begin(), lEdge.end(), edge);
+			if (range.second - range.first != 1)
+				continue;
+			glm::dvec3 v3Side = lPosition[uB] - lPosition[uA];
+			double dLength = glm::length(v3Side);
+			glm::dvec3 v3Normal = glm::normalize(glm::cross(v3Side, v3Face));
+			double dDistance = -glm::dot(v3Normal, lPosition[uA]);
+			lQuadric[uA].AddPlane(v3Normal, dDistance, dLength * dLength * 1000.0);
+			lQuadric[uB].AddPlane(v3Normal, dDistance, dLength * dLength * 1000.0);
+		}
+	}
+	lEdge.erase(std::unique(lEdge.begin(), lEdge.end()), lEdge.end());
+
+	//Heap of the cheapest collapses, the ones measured before a vertex moved are skipped when popped
+	std::vector<uint> lStamp(uVertexCount, 0);
+	std::vector<bool> lVertexAlive(uVertexCount, true);
+	std::vector<EdgeCollapse> lHeap;
+	auto measure = [&](uint a_uA, uint a_uB)
+	{
+		EdgeCollapse collapse;
+		Quadric quadric = lQuadric[a_uA];
+		quadric.Add(lQuadric[a_uB]);
+		glm::dvec3 v3Candidate[4] = { lPosition[a_uA], lPosition[a_uB], (lPosition[a_uA] + lPosition[a_uB]) * 0.5, glm::dvec3(0.0) };
+		uint uCandidates = quadric.Minimum(v3Candidate[3]) ? 4 : 3;
+		collapse.dError = std::numeric_limits<double>::max();
+		for (uint i = 0; i < uCandidates; ++i)
+		{
+			double dError = quadric.Error(v3Candidate[i]);
+			if (dError < collapse.dError)
+			{
+				collapse.dError = dError;
+				collapse.v3Target = v3Candidate[i];
+			}
+		}
+		collapse.uA = a_uA;
+		collapse.uB = a_uB;
+		collapse.uStampA = lStamp[a_uA];
+		collapse.uStampB = lStamp[a_uB];
+		lHeap.push_back(collapse);
+		std::push_heap(lHeap.begin(), lHeap.end());
+	};
+	for (uint i = 0; i < lEdge.size(); ++i)
+		measure(lEdge[i].first, lEdge[i].second);
+
+	uint uTarget = static_cast<uint>(uAlive * glm::clamp(a_fRatio, 0.0f, 1.0f));
+	std::vector<uint> lNeighborA, lNeighborB;
+	while (uAlive > uTarget && !lHeap.empty())
+	{
+		std::pop_heap(lHeap.begin(), lHeap.end());
+		EdgeCollapse collapse = lHeap.back();
+		lHeap.pop_back();
+		uint uA = collapse.uA, uB = collapse.uB;
+		if (!lVertexAlive[uA] || !lVertexAlive[uB] || lStamp[uA] != collapse.uStampA || lStamp[uB] != collapse.uStampB)
+			continue;
+
+		//The link condition: the vertices can only share the neighbors of the triangles on the
+		//edge, otherwise the collapse pinches the surface
+		GatherNeighbors(uA, lTriangle, lAlive, lTriangleOf[uA], lNeighborA);
+		GatherNeighbors(uB, lTriangle, lAlive, lTriangleOf[uB], lNeighborB);
+		uint uShared = 0, uOnEdge = 0;
+		for (uint i = 0, j = 0; i < lNeighborA.size() && j < lNeighborB.size();)
+		{
+			if (lNeighborA[i] < lNeighborB[j]) ++i;
+			else if (lNeighborA[i] > lNeighborB[j]) ++j;
+			else { ++uShared; ++i; ++j; }
+		}
+		for (uint t : lTriangleOf[uA])
+		{
+			if (!lAlive[t])
+				continue;
+			uint* pVertex = &lTriangle[t * 3];
+			if (pVertex[0] == uB || pVertex[1] == uB || pVertex[2] == uB)
+				++uOnEdge;
+		}
+		if (uShared != uOnEdge)
+			continue;
+
+		//Triangles that would turn over once the vertices move are not allowed either
+		bool bFlips = false;
+		for (uint uSide = 0; uSide < 2 && !bFlips; ++uSide)
+		{
+			uint uMoved = uSide == 0 ? uA : uB;
+			uint uOther = uSide == 0 ? uB : uA;
+			for (uint t : lTriangleOf[uMoved])
+			{
+				if (!lAlive[t])
+					continue;
+				uint* pVertex = &lTriangle[t * 3];
+				if (pVertex[0] == uOther || pVertex[1] == uOther || pVertex[2] == uOther)
+					continue;
+				glm::dvec3 v3Before[3], v3After[3];
+				for (uint k = 0; k < 3; ++k)
+				{
+					v3Before[k] = lPosition[pVertex[k]];
+					v3After[k] = pVertex[k] == uMoved ? collapse.v3Target : v3Before[k];
+				}
+				glm::dvec3 v3NormalBefore = glm::cross(v3Before[1] - v3Before[0], v3Before[2] - v3Before[0]);
+				glm::dvec3 v3NormalAfter = glm::cross(v3After[1] - v3After[0], v3After[2] - v3After[0]);
+				if (glm::dot(v3NormalBefore, v3NormalAfter) <= 0.0)
+				{
+					bFlips = true;
+					break;
+				}
+			}
+		}
+		if (bFlips)
+			continue;
+
+		//Collapse uB into uA, the triangles on the edge go away and the rest move to uA
+		lPosition[uA] = collapse.v3Target;
+		lQuadric[uA].Add(lQuadric[uB]);
+		lVertexAlive[uB] = false;
+		++lStamp[uA];
+		for (uint t : lTriangleOf[uB])
+		{
+			if (!lAlive[t])
+				continue;
+			uint* pVertex = &lTriangle[t * 3];
+			if (pVertex[0] == uA || pVertex[1] == uA || pVertex[2] == uA)
+			{
+				lAlive[t] = false;
+				--uAlive;
+				continue;
+			}
+			for (uint k = 0; k < 3; ++k)
+			{
+				if (pVertex[k] == uB)
+					pVertex[k] = uA;
+			}
+			lTriangleOf[uA].push_back(t);
+		}
+		lTriangleOf[uB].clear();
+		GatherNeighbors(uA, lTriangle, lAlive, lTriangleOf[uA], lNeighborA);
+		for (uint uNeighbor : lNeighborA)
+			measure(uA, uNeighbor);
+	}
+
+	//Every triangle left is a triangle of the source with its corners moved, the corners keep the
+	//attributes they had; flat triangles get the normal of their new face
+	for (uint t = 0; t < uTriangleCount; ++t)
+	{
+		if (!lAlive[t])
+			continue;
+		uint uFirst = t * 3;
+		vector3 v3Position[3];
+		for (uint k = 0; k < 3; ++k)
+			v3Position[k] = vector3(lPosition[lTriangle[uFirst + k]]);
+		vector3 v3Face = glm::cross(v3Position[1] - v3Position[0], v3Position[2] - v3Position[0]);
+		bool bFlat = a_pSource->m_lVertexNor.size() > uFirst + 2 &&
+			a_pSource->m_lVertexNor[uFirst] == a_pSource->m_lVertexNor[uFirst + 1] &&
+			a_pSource->m_lVertexNor[uFirst] == a_pSource->m_lVertexNor[uFirst + 2];
+		for (uint k = 0; k < 3; ++k)
+		{
+			uint uCorner = uFirst + k;
+			AddVertexPosition(v3Position[k]);
+			if (uCorner < a_pSource->m_lVertexCol.size())
+				AddVertexColor(a_pSource->m_lVertexCol[uCorner]);
+			if (uCorner < a_pSource->m_lVertexUV.size())
+				AddVertexUV(a_pSource->m_lVertexUV[uCorner]);
+			if (bFlat && v3Face != ZERO_V3)
+				AddVertexNormal(glm::normalize(v3Face));
+			else if (uCorner < a_pSource->m_lVertexNor.size())
+				AddVertexNormal(a_pSource->m_lVertexNor[uCorner]);
+			if (uCorner < a_pSource->m_lVertexTan.size())
+				AddVertexTangent(a_pSource->m_lVertexTan[uCorner]);
+			if (uCorner < a_pSource->m_lVertexBin.size())
+				AddVertexBinormal(a_pSource->m_lVertexBin[uCorner]);
+		}
+	}
+
+	//Complete and compile the mesh, it draws with the material and shader of its source
+	m_uMaterialIndex = a_pSource->m_uMaterialIndex;
+	CompileOpenGL3X();
+	m_sName = a_pSource->m_sName;
+	m_nShader = a_pSource->m_nShader;
+	m_v3Tint = a_pSource->m_v3Tint;
+	m_v3Wireframe = a_pSource->m_v3Wireframe;
+}
 uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, matrix4 a_mWorld, vector3 a_v3CameraPosition, int a_RenderOption)
 {
 	return Render(a_mProjection, a_mView, glm::value_ptr(a_mWorld), 1, a_v3CameraPosition, a_RenderOption);
 }
-uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition, int a_RenderOption)
+void RenderState::Reset(void)
+{
+	//Nothing is ever bound to these names so the first call of each kind always goes through
+	uShader = uVAO = static_cast<GLuint>(-1);
+	uTexture[0] = uTexture[1] = uTexture[2] = static_cast<GLuint>(-1);
+	uPolygonMode = GL_NONE;
+	lFrameShader.clear();
+	uShaderBinds = uVAOBinds = uTextureBinds = uModeChanges = uDrawCalls = 0;
+}
+//Without a render state every call is made, the way meshes rendered on their own
+static void UseProgram(RenderBackend* a_pBackend, RenderState* a_pState, GLuint a_uShader)
+{
+	if (a_pState)
+	{
+		if (a_pState->uShader == a_uShader)
+			return;
+		a_pState->uShader = a_uShader;
+		a_pState->uShaderBinds++;
+	}
+	a_pBackend->UseProgram(a_uShader);
+}
+static void BindVertexArray(RenderBackend* a_pBackend, RenderState* a_pState, GLuint a_uVAO)
+{
+	if (a_pState)
+	{
+		if (a_pState->uVAO == a_uVAO)
+			return;
+		a_pState->uVAO = a_uVAO;
+		a_pState->uVAOBinds++;
+	}
+	a_pBackend->BindVertexArray(a_uVAO);
+}
+static void BindTexture(RenderBackend* a_pBackend, RenderState* a_pState, uint a_uUnit, GLuint a_uTexture)
+{
+	if (a_pState)
+	{
+		if (a_pState->uTexture[a_uUnit] == a_uTexture)
+			return;
+		a_pState->uTexture[a_uUnit] = a_uTexture;
+		a_pState->uTextureBinds++;
+	}
+	a_pBackend->BindTexture(a_uUnit, a_uTexture);
+}
+static void SetPolygonMode(RenderBackend* a_pBackend, RenderState* a_pState, GLenum a_uMode)
+{
+	if (a_pState)
+	{
+		if (a_pState->uPolygonMode == a_uMode)
+			return;
+		a_pState->uPolygonMode = a_uMode;
+		a_pState->uModeChanges++;
+	}
+	a_pBackend->PolygonMode(a_uMode);
+	if (a_uMode == GL_LINE)
+	{
+		a_pBackend->Enable(GL_POLYGON_OFFSET_LINE);
+		a_pBackend->PolygonOffset(-1.f, -1.f);
+	}
+	else
+		a_pBackend->Disable(GL_POLYGON_OFFSET_LINE);
+}
+//Camera and light uniforms are the same for the whole frame, a program only needs them once
+static bool NeedsFrameUniforms(RenderState* a_pState, GLuint a_uShader)
+{
+	if (a_pState == nullptr)
+		return true;
+	std::vector<GLuint>& lShader = a_pState->lFrameShader;
+	if (std::find(lShader.begin(), lShader.end(), a_uShader) != lShader.end())
+		return false;
+	lShader.push_back(a_uShader);
+	return true;
+}
+uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition, int a_RenderOption,
+	RenderState* a_pState)
 {
 	//check if the shape has been binded
 	if (!m_bBinded)
@@ -1161,7 +1607,7 @@ uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray,
 		wire would not be noticeable.
 	*/
 	if (m_bLineObject) //if this is a line object I just need to render it like so
-		uRenderCalls += RenderLines(a_mProjection, a_mView, a_fMatrixArray, a_nInstances);
+		uRenderCalls += RenderLines(a_mProjection, a_mView, a_fMatrixArray, a_nInstances, a_pState);
 	else //it is not a line object
 	{
 		bool solid = false;
@@ -1169,7 +1615,7 @@ uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray,
 		if (a_RenderOption & eBTX_RENDER::RENDER_SOLID)
 		{
 			solid = true;
-			uRenderCalls += RenderSolid(a_mProjection, a_mView, a_fMatrixArray, a_nInstances, a_v3CameraPosition);
+			uRenderCalls += RenderSolid(a_mProjection, a_mView, a_fMatrixArray, a_nInstances, a_v3CameraPosition, a_pState);
 		}
 		if (a_RenderOption & eBTX_RENDER::RENDER_WIRE)
 		{
@@ -1178,110 +1624,126 @@ uint Mesh::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray,
 				vector3 wireframe;
 				wireframe = m_v3Wireframe;
 				std::swap(wireframe, m_v3Wireframe);
-				RenderWire(a_mProjection, a_mView, a_fMatrixArray, a_nInstances);
+				RenderWire(a_mProjection, a_mView, a_fMatrixArray, a_nInstances, a_pState);
 				m_v3Wireframe = wireframe;
 			}
 			else
-				uRenderCalls += RenderWire(a_mProjection, a_mView, a_fMatrixArray, a_nInstances);
+				uRenderCalls += RenderWire(a_mProjection, a_mView, a_fMatrixArray, a_nInstances, a_pState);
 		}
 	}
 
 	return uRenderCalls;
 }
-uint Mesh::RenderWire(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances)
+uint Mesh::RenderWire(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, RenderState* a_pState)
 {
 	uint uRenderCalls = 0;
 	GLuint nShader = m_pShaderMngr->GetShaderID("Wireframe");
 	// Use the buffer and shader
-	glUseProgram(nShader);
+	UseProgram(m_pBackend, a_pState, nShader);
 
-	glBindVertexArray(m_VAO);
+	BindVertexArray(m_pBackend, a_pState, m_VAO);
 
-	// Get the GPU variables by their name and hook them to CPU variables
-	GLuint VP = glGetUniformLocation(nShader, "VP");
-	GLuint m4ToWorld = glGetUniformLocation(nShader, "m4ToWorld");
-	GLuint vWireframe = glGetUniformLocation(nShader, "vWireframe");
+	// Get the GPU variables, looked up by name once when the shader was made
+	const GLint* pUniform = m_pShaderMngr->GetUniformTable(nShader);
+	GLint VP = pUniform[UNIFORM_VP];
+	GLint m4ToWorld = pUniform[UNIFORM_TO_WORLD];
+	GLint vWireframe = pUniform[UNIFORM_WIREFRAME];
 
 	//Final Projection of the Camera
-	matrix4 m4VP = a_mProjection * a_mView;
-	glUniformMatrix4fv(VP, 1, GL_FALSE, glm::value_ptr(m4VP));
-	glUniform3f(vWireframe, m_v3Wireframe.x, m_v3Wireframe.y, m_v3Wireframe.z);
+	if (NeedsFrameUniforms(a_pState, nShader))
+	{
+		matrix4 m4VP = a_mProjection * a_mView;
+		m_pBackend->UniformMatrix4(VP, 1, glm::value_ptr(m4VP));
+	}
+	m_pBackend->Uniform3f(vWireframe, m_v3Wireframe.x, m_v3Wireframe.y, m_v3Wireframe.z);
 
 	//Number of Instances
 	uint nSections = a_nInstances / 250;
 	uint nRemainders = a_nInstances - (250 * nSections);
 	uint nInstances = a_nInstances;
-	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	glEnable(GL_POLYGON_OFFSET_LINE);
-	glPolygonOffset(-1.f, -1.f);
+	SetPolygonMode(m_pBackend, a_pState, GL_LINE);
 	for (uint n = 0; n < nSections; n++)
 	{
-		glUniformMatrix4fv(m4ToWorld, 250, GL_FALSE, &a_fMatrixArray[n * 250 * 16]);
+		m_pBackend->UniformMatrix4(m4ToWorld, 250, &a_fMatrixArray[n * 250 * 16]);
 		//Draw
-		glDrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, 250);
+		m_pBackend->DrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, 250);
 		uRenderCalls++;
 	}
 
-	glUniformMatrix4fv(m4ToWorld, nRemainders, GL_FALSE, &a_fMatrixArray[nSections * 250 * 16]);
-	glDrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, nRemainders);
+	m_pBackend->UniformMatrix4(m4ToWorld, nRemainders, &a_fMatrixArray[nSections * 250 * 16]);
+	m_pBackend->DrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, nRemainders);
 	uRenderCalls++;
 
-	glDisable(GL_POLYGON_OFFSET_LINE);
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);//Set rendering mode back to fill
+	//A shared state is left as it is for the next draw
+	if (a_pState)
+	{
+		a_pState->uDrawCalls += uRenderCalls;
+		return uRenderCalls;
+	}
+
+	m_pBackend->Disable(GL_POLYGON_OFFSET_LINE);
+	m_pBackend->PolygonMode(GL_FILL);//Set rendering mode back to fill
 
-	glBindVertexArray(0);
+	m_pBackend->BindVertexArray(0);
 	return uRenderCalls;
 }
-uint Mesh::RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition)
+uint Mesh::RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition,
+	RenderState* a_pState)
 {
 	uint uRenderCalls = 0;
 	GLuint nShader = GetShaderIndex();
 	// Use the buffer and shader
-	glUseProgram(nShader);
+	UseProgram(m_pBackend, a_pState, nShader);
 
-	glBindVertexArray(m_VAO);
+	BindVertexArray(m_pBackend, a_pState, m_VAO);
 
-	// Get the GPU variables by their name and hook them to CPU variables
-	GLuint VP = glGetUniformLocation(nShader, "VP");
-	GLuint m4ToWorld = glGetUniformLocation(nShader, "m4ToWorld");
-	GLuint m4ModelToWorld = glGetUniformLocation(nShader, "m4ModelToWorld");
+	// Get the GPU variables, looked up by name once when the shader was made
+	const GLint* pUniform = m_pShaderMngr->GetUniformTable(nShader);
+	GLint m4ToWorld = pUniform[UNIFORM_TO_WORLD];
 
-	GLuint TextureID = glGetUniformLocation(nShader, "TextureID");
-	GLuint NormalID = glGetUniformLocation(nShader, "NormalID");
-	GLuint SpecularID = glGetUniformLocation(nShader, "SpecularID");
-	GLuint nTexture = glGetUniformLocation(nShader, "nTexture");
+	GLint TextureID = pUniform[UNIFORM_TEXTURE];
+	GLint NormalID = pUniform[UNIFORM_NORMAL];
+	GLint SpecularID = pUniform[UNIFORM_SPECULAR];
+	GLint nTexture = pUniform[UNIFORM_TEXTURE_MASK];
+	GLint Tint = pUniform[UNIFORM_TINT];
 
-	GLuint LightPosition_W = glGetUniformLocation(nShader, "LightPosition_W");
-	GLuint LightColor = glGetUniformLocation(nShader, "LightColor");
-	GLuint LightPower = glGetUniformLocation(nShader, "LightPower");
-	GLuint AmbientColor = glGetUniformLocation(nShader, "AmbientColor");
-	GLuint AmbientPower = glGetUniformLocation(nShader, "AmbientPower");
-	GLuint Tint = glGetUniformLocation(nShader, "Tint");
+	//Camera and light only change once per frame
+	if (NeedsFrameUniforms(a_pState, nShader))
+	{
+		GLint VP = pUniform[UNIFORM_VP];
+		GLint m4ModelToWorld = pUniform[UNIFORM_MODEL_TO_WORLD];
 
-	GLuint CameraPosition_W = glGetUniformLocation(nShader, "CameraPosition_W");
-	GLuint m4CameraOnWorld = glGetUniformLocation(nShader, "m4CameraOnWorld");
+		GLint LightPosition_W = pUniform[UNIFORM_LIGHT_POSITION];
+		GLint LightColor = pUniform[UNIFORM_LIGHT_COLOR];
+		GLint LightPower = pUniform[UNIFORM_LIGHT_POWER];
+		GLint AmbientColor = pUniform[UNIFORM_AMBIENT_COLOR];
+		GLint AmbientPower = pUniform[UNIFORM_AMBIENT_POWER];
 
-	//ToWorld matrix
-	glUniformMatrix4fv(m4ModelToWorld, 1, GL_FALSE, glm::value_ptr(matrix4(1.0f)));
-	glUniformMatrix4fv(m4CameraOnWorld, 1, GL_FALSE, glm::value_ptr(glm::translate(a_v3CameraPosition)));
+		GLint CameraPosition_W = pUniform[UNIFORM_CAMERA_POSITION];
+		GLint m4CameraOnWorld = pUniform[UNIFORM_CAMERA_ON_WORLD];
 
-	//Final Projection of the Camera
-	matrix4 m4VP = a_mProjection * a_mView;
-	glUniformMatrix4fv(VP, 1, GL_FALSE, glm::value_ptr(m4VP));
+		//ToWorld matrix
+		m_pBackend->UniformMatrix4(m4ModelToWorld, 1, glm::value_ptr(matrix4(1.0f)));
+		m_pBackend->UniformMatrix4(m4CameraOnWorld, 1, glm::value_ptr(glm::translate(a_v3CameraPosition)));
+
+		//Final Projection of the Camera
+		matrix4 m4VP = a_mProjection * a_mView;
+		m_pBackend->UniformMatrix4(VP, 1, glm::value_ptr(m4VP));
 
-	vector3 v3Color = vector3(1.0f, 1.0f, 1.0f);
-	glUniform3f(AmbientColor, v3Color.r, v3Color.g, v3Color.b);
-	glUniform1f(AmbientPower, 0.75f);
+		vector3 v3Color = vector3(1.0f, 1.0f, 1.0f);
+		m_pBackend->Uniform3f(AmbientColor, v3Color.r, v3Color.g, v3Color.b);
+		m_pBackend->Uniform1f(AmbientPower, 0.75f);
 	
 	
-	//TODO: I removed the light manager for simplicity purposes so this light source is hardcoded
-	vector3 v3Position = vector3(5.0f);
-	glUniform3f(LightPosition_W, v3Position.x, v3Position.y, v3Position.z);
-	glUniform3f(LightColor, v3Color.r, v3Color.g, v3Color.b);
-	glUniform1f(LightPower, 1.0f);
-	glUniform3f(Tint, m_v3Tint.r, m_v3Tint.g, m_v3Tint.b);
+		//TODO: I removed the light manager for simplicity purposes so this light source is hardcoded
+		vector3 v3Position = vector3(5.0f);
+		m_pBackend->Uniform3f(LightPosition_W, v3Position.x, v3Position.y, v3Position.z);
+		m_pBackend->Uniform3f(LightColor, v3Color.r, v3Color.g, v3Color.b);
+		m_pBackend->Uniform1f(LightPower, 1.0f);
 
-	glUniform3f(CameraPosition_W, a_v3CameraPosition.x, a_v3CameraPosition.y, a_v3CameraPosition.z);
+		m_pBackend->Uniform3f(CameraPosition_W, a_v3CameraPosition.x, a_v3CameraPosition.y, a_v3CameraPosition.z);
+	}
+	m_pBackend->Uniform3f(Tint, m_v3Tint.r, m_v3Tint.g, m_v3Tint.b);
 
 	int nTextures = 0;
 	// Bind our texture in Texture Unit 0
@@ -1292,10 +1754,8 @@ uint Mesh::RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixA
 		//if (m_pMatMngr->m_lMaterial[nMaterialIndex]->GetDiffuseMapName() != "NULL")
 		if (index > 0)
 		{
-			glActiveTexture(GL_TEXTURE0);
-			//glBindTexture(GL_TEXTURE_2D, m_pMatMngr->m_lMaterial[nMaterialIndex]->GetDiffuseMap());
-			glBindTexture(GL_TEXTURE_2D, index);
-			glUniform1i(TextureID, 0);
+			BindTexture(m_pBackend, a_pState, 0, index);
+			m_pBackend->Uniform1i(TextureID, 0);
 			nTextures += 1;
 		}
 
@@ -1304,10 +1764,8 @@ uint Mesh::RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixA
 		//if (m_pMatMngr->m_lMaterial[nMaterialIndex]->GetNormalMapName() != "NULL")
 		if (index > 0)
 		{
-			glActiveTexture(GL_TEXTURE1);
-			//glBindTexture(GL_TEXTURE_2D, m_pMatMngr->m_lMaterial[nMaterialIndex]->GetNormalMap());
-			glBindTexture(GL_TEXTURE_2D, index);
-			glUniform1i(NormalID, 1);
+			BindTexture(m_pBackend, a_pState, 1, index);
+			m_pBackend->Uniform1i(NormalID, 1);
 			nTextures += 2;
 		}
 
@@ -1315,41 +1773,45 @@ uint Mesh::RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixA
 		index = m_pMatMngr->GetSpecularMap(nMaterialIndex);
 		//if (m_pMatMngr->m_lMaterial[nMaterialIndex]->GetSpecularMapName() != "NULL")
 		{
-			glActiveTexture(GL_TEXTURE2);
-			//glBindTexture(GL_TEXTURE_2D, m_pMatMngr->m_lMaterial[nMaterialIndex]->GetSpecularMap());
-			glBindTexture(GL_TEXTURE_2D, index);
-			glUniform1i(SpecularID, 2);
+			BindTexture(m_pBackend, a_pState, 2, index);
+			m_pBackend->Uniform1i(SpecularID, 2);
 			nTextures += 4;
 		}
 	}
-	glUniform1i(nTexture, nTextures);
+	m_pBackend->Uniform1i(nTexture, nTextures);
 
 	//Number of Instances
 	uint nSections = a_nInstances / 250;
 	uint nRemainders = a_nInstances - (250 * nSections);
 	uint nInstances = a_nInstances;
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	SetPolygonMode(m_pBackend, a_pState, GL_FILL);
 	for (uint n = 0; n < nSections; n++)
 	{
-		glUniformMatrix4fv(m4ToWorld, 250, GL_FALSE, &a_fMatrixArray[n * 250 * 16]);
-		glUseProgram(nShader);
-
-		glDrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, 250);
+		m_pBackend->UniformMatrix4(m4ToWorld, 250, &a_fMatrixArray[n * 250 * 16]);
+		m_pBackend->DrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, 250);
 		uRenderCalls++;
 	}
 
-	glUniformMatrix4fv(m4ToWorld, nRemainders, GL_FALSE, &a_fMatrixArray[nSections * 250 * 16]);
-	glDrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, nRemainders);
+	m_pBackend->UniformMatrix4(m4ToWorld, nRemainders, &a_fMatrixArray[nSections * 250 * 16]);
+	m_pBackend->DrawArraysInstanced(GL_TRIANGLES, 0, m_uVertexCount, nRemainders);
 	uRenderCalls++;
+
+	//A shared state is left as it is for the next draw
+	if (a_pState)
+	{
+		a_pState->uDrawCalls += uRenderCalls;
+		return uRenderCalls;
+	}
+
 	//For the remainder
-	glDisable(GL_TEXTURE2);
-	glDisable(GL_TEXTURE1);
-	glDisable(GL_TEXTURE0);
+	m_pBackend->Disable(GL_TEXTURE2);
+	m_pBackend->Disable(GL_TEXTURE1);
+	m_pBackend->Disable(GL_TEXTURE0);
 
-	glBindVertexArray(0);
+	m_pBackend->BindVertexArray(0);
 	return uRenderCalls;
 }
-uint Mesh::RenderLines(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances)
+uint Mesh::RenderLines(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, RenderState* a_pState)
 {
 	uint uRenderCalls = 0;
 
@@ -1358,40 +1820,47 @@ uint Mesh::RenderLines(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixA
 
 	GLuint nShader = GetShaderIndex();
 	// Use the buffer and shader
-	glUseProgram(nShader);
+	UseProgram(m_pBackend, a_pState, nShader);
 
-	glBindVertexArray(m_VAO);
+	BindVertexArray(m_pBackend, a_pState, m_VAO);
 
-	// Get the GPU variables by their name and hook them to CPU variables
-	GLuint VP = glGetUniformLocation(nShader, "VP");
-	GLuint m4ToWorld = glGetUniformLocation(nShader, "m4ToWorld");
+	// Get the GPU variables, looked up by name once when the shader was made
+	const GLint* pUniform = m_pShaderMngr->GetUniformTable(nShader);
+	GLint VP = pUniform[UNIFORM_VP];
+	GLint m4ToWorld = pUniform[UNIFORM_TO_WORLD];
 
 	//Final Projection of the Camera
-	matrix4 m4VP = a_mProjection * a_mView;
-	glUniformMatrix4fv(VP, 1, GL_FALSE, glm::value_ptr(m4VP));
+	if (NeedsFrameUniforms(a_pState, nShader))
+	{
+		matrix4 m4VP = a_mProjection * a_mView;
+		m_pBackend->UniformMatrix4(VP, 1, glm::value_ptr(m4VP));
+	}
 
 	//Number of Instances
 	uint nSections = a_nInstances / 250;
 	uint nRemainders = a_nInstances - (250 * nSections);
 	uint nInstances = a_nInstances;
-	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	glEnable(GL_POLYGON_OFFSET_LINE);
-	glPolygonOffset(-1.f, -1.f);
+	SetPolygonMode(m_pBackend, a_pState, GL_LINE);
 	for (uint n = 0; n < nSections; n++)
 	{
-		glUniformMatrix4fv(m4ToWorld, 250, GL_FALSE, &a_fMatrixArray[n * 250 * 16]);
-		glUseProgram(nShader);
-
-		glDrawArraysInstanced(GL_LINES, 0, m_uVertexCount, 250);
+		m_pBackend->UniformMatrix4(m4ToWorld, 250, &a_fMatrixArray[n * 250 * 16]);
+		m_pBackend->DrawArraysInstanced(GL_LINES, 0, m_uVertexCount, 250);
 		uRenderCalls++;
 	}
-	glUniformMatrix4fv(m4ToWorld, nRemainders, GL_FALSE, &a_fMatrixArray[nSections * 250 * 16]);
-	glDrawArraysInstanced(GL_LINES, 0, m_uVertexCount, nRemainders);
+	m_pBackend->UniformMatrix4(m4ToWorld, nRemainders, &a_fMatrixArray[nSections * 250 * 16]);
+	m_pBackend->DrawArraysInstanced(GL_LINES, 0, m_uVertexCount, nRemainders);
 	uRenderCalls++;
 
-	glDisable(GL_POLYGON_OFFSET_LINE);
-	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);//Set rendering mode back to fill
+	//A shared state is left as it is for the next draw
+	if (a_pState)
+	{
+		a_pState->uDrawCalls += uRenderCalls;
+		return uRenderCalls;
+	}
+
+	m_pBackend->Disable(GL_POLYGON_OFFSET_LINE);
+	m_pBackend->PolygonMode(GL_FILL);//Set rendering mode back to fill
 
-	glBindVertexArray(0);
+	m_pBackend->BindVertexArray(0);
 	return uRenderCalls;
 }
\ No newline at end of file
@@ -1,6 +1,519 @@
 #include "BTX\Mesh\Model.h"
 using namespace BTX;
 
+//Cooked model files start with this tag, bump the version whenever the layout changes
+static const int nCookedTag = 0x43585442; //"BTXC"
+static const int nCookedVersion = 2;
+
+static void WriteVector3List(FileReader& a_Writer, std::vector<vector3> const& a_lInput)
+{
+	int nCount = static_cast<int>(a_lInput.size());
+	a_Writer.WriteInt(nCount);
+	if (nCount > 0)
+		a_Writer.WriteBuffer(&a_lInput[0], nCount * sizeof(vector3));
+}
+static bool ReadVector3List(FileReader& a_Reader, std::vector<vector3>& a_lOutput)
+{
+	int nCount = a_Reader.ReadInt();
+	if (nCount < 0)
+		return false;
+	a_lOutput.resize(nCount);
+	if (nCount == 0)
+		return true;
+	return a_Reader.ReadBuffer(&a_lOutput[0], nCount * sizeof(vector3));
+}
+
+//OBJ parsing helpers, they work on a null terminated buffer and move the pointer they are given
+static const char* SkipBlanks(const char* a_pChar)
+{
+	while (*a_pChar == ' ' || *a_pChar == '\t' || *a_pChar == '\r')
+		a_pChar++;
+	return a_pChar;
+}
+static const char* SkipLine(const char* a_pChar)
+{
+	while (*a_pChar != '\0' && *a_pChar != '\n')
+		a_pChar++;
+	if (*a_pChar == '\n')
+		a_pChar++;
+	return a_pChar;
+}
+static String ReadToken(const char* a_pChar)
+{
+	a_pChar = SkipBlanks(a_pChar);
+	const char* pEnd = a_pChar;
+	while (*pEnd != '\0' && *pEnd != ' ' && *pEnd != '\t' && *pEnd != '\r' && *pEnd != '\n')
+		pEnd++;
+	return String(a_pChar, pEnd);
+}
+static int ParseInt(const char** a_ppChar)
+{
+	const char* pChar = SkipBlanks(*a_ppChar);
+	bool bNegative = *pChar == '-';
+	if (*pChar == '-' || *pChar == '+')
+		pChar++;
+	int nOutput = 0;
+	while (*pChar >= '0' && *pChar <= '9')
+	{
+		nOutput = nOutput * 10 + (*pChar - '0');
+		pChar++;
+	}
+	*a_ppChar = pChar;
+	return bNegative ? -nOutput : nOutput;
+}
+static float ParseFloat(const char** a_ppChar)
+{
+	static const double dPower[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+		1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* pChar = SkipBlanks(*a_ppChar);
+	bool bNegative = *pChar == '-';
+	if (*pChar == '-' || *pChar == '+')
+		pChar++;
+
+	//Accumulate all the significant digits as an integer and keep track of the decimal point
+	unsigned long long uMantissa = 0;
+	int nExponent = 0;
+	int nDigits = 0;
+	while (*pChar >= '0' && *pChar <= '9')
+	{
+		if (nDigits < 19)
+		{
+			uMantissa = uMantissa * 10 + (*pChar - '0');
+			if (uMantissa > 0)
+				nDigits++;
+		}
+		else
+			nExponent++;
+		pChar++;
+	}
+	if (*pChar == '.')
+	{
+		pChar++;
+		while (*pChar >= '0' && *pChar <= '9')
+		{
+			if (nDigits < 19)
+			{
+				uMantissa = uMantissa * 10 + (*pChar - '0');
+				if (uMantissa > 0)
+					nDigits++;
+				nExponent--;
+			}
+			pChar++;
+		}
+	}
+	if (*pChar == 'e' || *pChar == 'E')
+	{
+		pChar++;
+		nExponent += ParseInt(&pChar);
+	}
+	*a_ppChar = pChar;
+
+	double dOutput = static_cast<double>(uMantissa);
+	if (nExponent < 0)
+	{
+		while (nExponent < -22)
+		{
+			dOutput /= dPower[22];
+			nExponent += 22;
+		}
+		dOutput /= dPower[-nExponent];
+	}
+	else
+	{
+		while (nExponent > 22)
+		{
+			dOutput *= dPower[22];
+			nExponent -= 22;
+		}
+		dOutput *= dPower[nExponent];
+	}
+	return static_cast<float>(bNegative ? -dOutput : dOutput);
+}
+//Each corner keeps the indices as written in the file, relative ones are stored chunk local
+struct ObjCorner
+{
+	int nIndex[3] = { 0, 0, 0 }; //position, uv and normal
+	int nRelative = 0; //bit i is on if nIndex[i] is relative to the start of the chunk
+};
+//Material commands are replayed in file order before the face they precede
+struct ObjCommand
+{
+	uint uFace = 0; //index of the face in the chunk that follows this command
+	bool bLibrary = false; //mtllib if true, usemtl otherwise
+	String sName = "";
+};
+//A line aligned piece of an OBJ file and everything parsed from it
+struct ObjChunk
+{
+	const char* pBegin = nullptr;
+	const char* pEnd = nullptr;
+	std::vector<vector3> lPosition;
+	std::vector<vector3> lUV;
+	std::vector<vector3> lNormal;
+	std::vector<ObjCorner> lCorner; //corners of all faces, one after the other
+	std::vector<int> lFaceSize; //number of corners of each face
+	std::vector<ObjCommand> lCommand;
+	uint uPositionBase = 0; //number of positions in the chunks before this one
+	uint uUVBase = 0;
+	uint uNormalBase = 0;
+};
+//Files smaller than this per thread are parsed in fewer chunks, a chunk this size takes about a
+//millisecond to parse, far more than starting its thread does
+static const unsigned long long nMinChunkSize = 1 << 18;
+
+static int ResolveIndex(ObjCorner const& a_Corner, int a_nElement, uint a_uBase, uint a_uCount)
+{
+	//OBJ indices start at 1, negative indices are relative to the end of the list, 0 means none
+	int nIndex = a_Corner.nIndex[a_nElement];
+	if (a_Corner.nRelative & (1 << a_nElement))
+		nIndex += static_cast<int>(a_uBase);
+	else if (nIndex == 0)
+		return -1;
+	else
+		nIndex -= 1;
+	if (nIndex < 0 || nIndex >= static_cast<int>(a_uCount))
+		return -1;
+	return nIndex;
+}
+static void ParseChunk(ObjChunk* a_pChunk)
+{
+	ObjChunk& chunk = *a_pChunk;
+
+	//First pass, count the elements so each list is allocated only once
+	uint uPositionCount = 0;
+	uint uUVCount = 0;
+	uint uNormalCount = 0;
+	uint uFaceCount = 0;
+	for (const char* pLine = chunk.pBegin; pLine < chunk.pEnd; pLine = SkipLine(pLine))
+	{
+		pLine = SkipBlanks(pLine);
+		if (pLine[0] == 'f')
+			uFaceCount++;
+		else if (pLine[0] != 'v')
+			continue;
+		else if (pLine[1] == ' ' || pLine[1] == '\t')
+			uPositionCount++;
+		else if (pLine[1] == 't')
+			uUVCount++;
+		else if (pLine[1] == 'n')
+			uNormalCount++;
+	}
+	chunk.lPosition.reserve(uPositionCount);
+	chunk.lUV.reserve(uUVCount);
+	chunk.lNormal.reserve(uNormalCount);
+	chunk.lFaceSize.reserve(uFaceCount);
+	chunk.lCorner.reserve(uFaceCount * 3);
+
+	//Second pass, read the data
+	for (const char* pLine = chunk.pBegin; pLine < chunk.pEnd; pLine = SkipLine(pLine))
+	{
+		pLine = SkipBlanks(pLine);
+		const char* pChar = pLine;
+		if (pChar[0] == 'v')
+		{
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			if (pChar[1] == ' ' || pChar[1] == '\t')
+			{
+				pChar += 1;
+				x = ParseFloat(&pChar);
+				y = ParseFloat(&pChar);
+				z = ParseFloat(&pChar);
+				chunk.lPosition.push_back(vector3(x, y, z));
+			}
+			else if (pChar[1] == 't')
+			{
+				pChar += 2;
+				x = ParseFloat(&pChar);
+				y = ParseFloat(&pChar);
+				chunk.lUV.push_back(vector3(x, y, 0));
+			}
+			else if (pChar[1] == 'n')
+			{
+				pChar += 2;
+				x = ParseFloat(&pChar);
+				y = ParseFloat(&pChar);
+				z = ParseFloat(&pChar);
+				chunk.lNormal.push_back(vector3(x, y, z));
+			}
+		}
+		else if (pChar[0] == 'f' && (pChar[1] == ' ' || pChar[1] == '\t'))
+		{
+			//Read every corner of the face once, n-gons are triangulated from this list when stitching
+			int nCount[3] = { static_cast<int>(chunk.lPosition.size()),
+				static_cast<int>(chunk.lUV.size()), static_cast<int>(chunk.lNormal.size()) };
+			int nCorners = 0;
+			pChar = SkipBlanks(pChar + 1);
+			while (*pChar == '-' || *pChar == '+' || (*pChar >= '0' && *pChar <= '9'))
+			{
+				ObjCorner corner;
+				corner.nIndex[0] = ParseInt(&pChar);
+				if (*pChar == '/')
+				{
+					pChar++;
+					if (*pChar != '/')
+						corner.nIndex[1] = ParseInt(&pChar);
+					if (*pChar == '/')
+					{
+						pChar++;
+						corner.nIndex[2] = ParseInt(&pChar);
+					}
+				}
+				//negative indices count back from the last element read so far in this chunk
+				for (int i = 0; i < 3; i++)
+				{
+					if (corner.nIndex[i] < 0)
+					{
+						corner.nIndex[i] += nCount[i];
+						corner.nRelative |= 1 << i;
+					}
+				}
+				chunk.lCorner.push_back(corner);
+				nCorners++;
+				pChar = SkipBlanks(pChar);
+			}
+			chunk.lFaceSize.push_back(nCorners);
+		}
+		else if (strncmp(pChar, "usemtl", 6) == 0 || strncmp(pChar, "mtllib", 6) == 0)
+		{
+			ObjCommand command;
+			command.uFace = chunk.lFaceSize.size();
+			command.bLibrary = pChar[0] == 'm';
+			command.sName = ReadToken(pChar + 6);
+			chunk.lCommand.push_back(command);
+		}
+		/*
+		* To keep things simple groups will be handled through materials,
+		* in a regular obj a group will contain an array of faces and each
+		* face can have a separate material, in this implementation
+		* faces with the same material will be grouped together. In short
+		* each material will be a new Mesh* in the list
+		*/
+	}
+}
+//A mesh read from a cooked file, it becomes a Mesh once it is built on the main thread
+struct CookedMesh
+{
+	String sName = "";
+	String sMaterial = "";
+	String sDiffuseMap = "";
+	String sNormalMap = "";
+	String sSpecularMap = "";
+	vector3 v3Diffuse = ZERO_V3;
+	std::vector<vector3> lPosition;
+	std::vector<vector3> lColor;
+	std::vector<vector3> lUV;
+	std::vector<vector3> lNormal;
+	std::vector<vector3> lBinormal;
+	std::vector<vector3> lTangent;
+};
+namespace BTX
+{
+	//Everything read from the disk for a model, filled without touching any manager or OpenGL
+	struct ModelSource
+	{
+		String sFileName = ""; //absolute route of the source file
+		String sCookedFile = ""; //absolute route of the cooked file
+		String sResult = ""; //name of the file on success, error otherwise
+		uint uClock = 0; //clock measuring the load, only used from the main thread
+		bool bCooked = false; //was the model read from its cooked file?
+		//Cooked file
+		String sMaterialFile = "";
+		vector3 v3Min = ZERO_V3;
+		vector3 v3Max = ZERO_V3;
+		std::vector<CookedMesh> lMesh;
+		std::vector<float> lLODSize; //screen size of each level of detail
+		std::vector<std::vector<CookedMesh>> lLOD; //meshes of each level, in the order of lMesh
+		//Text file
+		unsigned long long uFileSize = 0;
+		std::vector<ObjChunk> lChunk;
+	};
+}
+static bool ReadCooked(ModelSource* a_pSource)
+{
+	BTX_PROFILE_ZONE("Model::ReadCooked");
+
+	unsigned long long uSourceSize = 0;
+	unsigned long long uSourceTime = 0;
+	if (!FileReader::GetFileStamp(a_pSource->sFileName, &uSourceSize, &uSourceTime))
+		return false;
+
+	//Read in one go, the many short strings and lists that follow are copied from memory
+	FileReader reader;
+	if (reader.ReadFileBuffered(a_pSource->sCookedFile) != eBTX_OUTPUT::OUT_ERR_NONE)
+		return false;
+
+	//The cooked file is only valid for the exact files it was made from
+	unsigned long long uSize = 0;
+	unsigned long long uTime = 0;
+	bool bValid = reader.ReadInt() == nCookedTag;
+	bValid = bValid && reader.ReadInt() == nCookedVersion;
+	bValid = bValid && reader.ReadString() == a_pSource->sFileName;
+	bValid = bValid && reader.ReadBuffer(&uSize, sizeof(uSize)) && uSize == uSourceSize;
+	bValid = bValid && reader.ReadBuffer(&uTime, sizeof(uTime)) && uTime == uSourceTime;
+	String sMaterialFile = bValid ? reader.ReadString() : "";
+	bValid = bValid && reader.ReadBuffer(&uSize, sizeof(uSize));
+	bValid = bValid && reader.ReadBuffer(&uTime, sizeof(uTime));
+	if (bValid && sMaterialFile != "")
+	{
+		unsigned long long uMaterialSize = 0;
+		unsigned long long uMaterialTime = 0;
+		bValid = FileReader::GetFileStamp(sMaterialFile, &uMaterialSize, &uMaterialTime);
+		bValid = bValid && uSize == uMaterialSize && uTime == uMaterialTime;
+	}
+	vector3 v3Min = ZERO_V3;
+	vector3 v3Max = ZERO_V3;
+	bValid = bValid && reader.ReadBuffer(&v3Min, sizeof(vector3));
+	bValid = bValid && reader.ReadBuffer(&v3Max, sizeof(vector3));
+	int nMeshCount = bValid ? reader.ReadInt() : -1;
+	if (nMeshCount < 0)
+	{
+		reader.CloseFile();
+		return false;
+	}
+
+	std::vector<CookedMesh> lMesh;
+	for (int i = 0; i < nMeshCount && bValid; i++)
+	{
+		CookedMesh mesh;
+		mesh.sName = reader.ReadString();
+		mesh.sMaterial = reader.ReadString();
+		mesh.sDiffuseMap = reader.ReadString();
+		mesh.sNormalMap = reader.ReadString();
+		mesh.sSpecularMap = reader.ReadString();
+		bValid = reader.ReadBuffer(&mesh.v3Diffuse, sizeof(vector3));
+		bValid = bValid && ReadVector3List(reader, mesh.lPosition);
+		bValid = bValid && ReadVector3List(reader, mesh.lColor);
+		bValid = bValid && ReadVector3List(reader, mesh.lUV);
+		bValid = bValid && ReadVector3List(reader, mesh.lNormal);
+		bValid = bValid && ReadVector3List(reader, mesh.lBinormal);
+		bValid = bValid && ReadVector3List(reader, mesh.lTangent);
+		if (bValid)
+			lMesh.push_back(std::move(mesh));
+	}
+
+	//Levels of detail, only good for the number of levels asked for when they were cooked
+	bValid = bValid && reader.ReadInt() == static_cast<int>(Model::GetLODLevelCount());
+	int nLODCount = bValid ? reader.ReadInt() : -1;
+	bValid = nLODCount >= 0;
+	std::vector<float> lLODSize;
+	std::vector<std::vector<CookedMesh>> lLOD;
+	for (int i = 0; i < nLODCount && bValid; i++)
+	{
+		float fSize = 0.0f;
+		bValid = reader.ReadBuffer(&fSize, sizeof(float));
+		std::vector<CookedMesh> lLevel(lMesh.size());
+		for (uint j = 0; j < lLevel.size() && bValid; j++)
+		{
+			bValid = ReadVector3List(reader, lLevel[j].lPosition);
+			bValid = bValid && ReadVector3List(reader, lLevel[j].lColor);
+			bValid = bValid && ReadVector3List(reader, lLevel[j].lUV);
+			bValid = bValid && ReadVector3List(reader, lLevel[j].lNormal);
+			bValid = bValid && ReadVector3List(reader, lLevel[j].lBinormal);
+			bValid = bValid && ReadVector3List(reader, lLevel[j].lTangent);
+		}
+		lLODSize.push_back(fSize);
+		lLOD.push_back(std::move(lLevel));
+	}
+	reader.CloseFile();
+
+	//A truncated file is discarded, the model will be parsed and cooked again
+	if (!bValid)
+		return false;
+
+	a_pSource->sMaterialFile = sMaterialFile;
+	a_pSource->v3Min = v3Min;
+	a_pSource->v3Max = v3Max;
+	a_pSource->lMesh.swap(lMesh);
+	a_pSource->lLODSize.swap(lLODSize);
+	a_pSource->lLOD.swap(lLOD);
+	return true;
+}
+static String ReadOBJ(ModelSource* a_pSource)
+{
+	BTX_PROFILE_ZONE("Model::ReadOBJ");
+
+	//Read the whole file into a single null terminated buffer, the parser works on it in place
+	FileReader reader;
+	unsigned long long uFileSize = 0;
+	if (!FileReader::GetFileStamp(a_pSource->sFileName, &uFileSize, nullptr) ||
+		reader.ReadBinaryFile(a_pSource->sFileName) != eBTX_OUTPUT::OUT_ERR_NONE)
+	{
+		printf("Model %s could not be found.\n", a_pSource->sFileName.c_str());
+		return "_|_FileNotFound";
+	}
+
+	std::vector<char> lBuffer(static_cast<size_t>(uFileSize) + 1, '\0');
+	bool bRead = reader.ReadBuffer(&lBuffer[0], static_cast<uint>(uFileSize));
+	reader.CloseFile();
+	if (!bRead)
+	{
+		printf("Model %s could not be read.\n", a_pSource->sFileName.c_str());
+		return "_|_FileNotRead";
+	}
+
+	//Split the file in line aligned chunks, small files are not worth the threads
+	uint uThreads = Model::GetLoaderThreadCount();
+	if (uThreads == 0)
+		uThreads = std::thread::hardware_concurrency();
+	uint uMaxChunks = static_cast<uint>(uFileSize / nMinChunkSize);
+	uThreads = std::max(1u, std::min(std::min(uThreads, uMaxChunks), 8u));
+
+	std::vector<ObjChunk> lChunk(uThreads);
+	const char* pBegin = &lBuffer[0];
+	const char* pEnd = pBegin + uFileSize;
+	for (uint i = 0; i < uThreads; i++)
+	{
+		lChunk[i].pBegin = (i == 0) ? pBegin : lChunk[i - 1].pEnd;
+		lChunk[i].pEnd = (i == uThreads - 1) ? pEnd : SkipLine(pBegin + (uFileSize * (i + 1)) / uThreads);
+		if (lChunk[i].pEnd < lChunk[i].pBegin)
+			lChunk[i].pEnd = lChunk[i].pBegin;
+	}
+
+	//Parse each chunk on its own thread, the calling thread takes the first one
+	std::vector<std::thread> lThread;
+	for (uint i = 1; i < uThreads; i++)
+		lThread.push_back(std::thread(ParseChunk, &lChunk[i]));
+	ParseChunk(&lChunk[0]);
+	for (uint i = 0; i < lThread.size(); i++)
+		lThread[i].join();
+
+	//The chunks keep copies of everything they need, the buffer goes away with this function
+	for (uint i = 0; i < uThreads; i++)
+		lChunk[i].pBegin = lChunk[i].pEnd = nullptr;
+	a_pSource->uFileSize = uFileSize;
+	a_pSource->lChunk.swap(lChunk);
+	return a_pSource->sFileName;
+}
+//Reads the cooked file if it is up to date and the text file otherwise, safe to call from any thread
+static bool ReadSource(ModelSource* a_pSource)
+{
+	a_pSource->bCooked = ReadCooked(a_pSource);
+	if (a_pSource->bCooked)
+		a_pSource->sResult = a_pSource->sFileName;
+	else
+		a_pSource->sResult = ReadOBJ(a_pSource);
+	return a_pSource->sResult == a_pSource->sFileName;
+}
+
+uint Model::m_uLoaderThreads = 0;
+void Model::SetLoaderThreadCount(uint a_uThreads) { m_uLoaderThreads = a_uThreads; }
+uint Model::GetLoaderThreadCount(void) { return m_uLoaderThreads; }
+uint Model::m_uLODLevels = 2;
+void Model::SetLODLevelCount(uint a_uLevels) { m_uLODLevels = a_uLevels; }
+uint Model::GetLODLevelCount(void) { return m_uLODLevels; }
+bool Model::ReadFile(String a_sFileName, bool a_bUseCooked)
+{
+	String sExtension = BTX::ToUppercase(FileReader::GetExtension(a_sFileName));
+	if (sExtension != "OBJ" || !FileReader::FileExists(a_sFileName))
+		return false;
+
+	//without a cooked file name the cooked read fails and the text is parsed
+	ModelSource source;
+	source.sFileName = a_sFileName;
+	source.sCookedFile = a_bUseCooked ? GetCookedFileName(a_sFileName) : "";
+	return ReadSource(&source);
+}
 Model::Model(Mesh* a_pMesh)
 {
 	if (!a_pMesh)
@@ -9,9 +522,10 @@ Model::Model(Mesh* a_pMesh)
 	Init();
 	m_sFileName = a_pMesh->GetName();
 	m_MeshList.push_back(a_pMesh);
+	CalculateBounds();
 }
 
-Model::Model(String a_sFileName, bool a_bIsModelFile)
+Model::Model(String a_sFileName, bool a_bIsModelFile, bool a_bAsync)
 {
 	//If we didnt provide a file to load we make an empty model
 	if (a_sFileName == "")
@@ -49,6 +563,14 @@ Model::Model(String a_sFileName, bool a_bIsModelFile)
 		return;
 	
 	Init();
+	if (a_bAsync && sExtension == "OBJ")
+	{
+		//The model keeps the name of the file while it loads so the managers can find it
+		m_sFileName = sFileName;
+		m_pSource = PrepareSource(sFileName);
+		m_Loading = std::async(std::launch::async, ReadSource, m_pSource);
+		return;
+	}
 	//Read the file
 	m_sFileName = Load(sFileName);
 
@@ -64,6 +586,13 @@ BTX::Model::~Model(void)
 }
 void BTX::Model::Release(void)
 {
+	//The background read uses the source, wait for it before letting it go
+	if (m_pSource)
+	{
+		m_Loading.wait();
+		SafeDelete(m_pSource);
+	}
+
 	//Deallocate all Mesh pointers in the list of mesh that make this model
 	uint uMeshCount = m_MeshList.size();
 	for (uint i = 0; i < uMeshCount; i++)
@@ -76,6 +605,7 @@ void BTX::Model::Release(void)
 	}
 	ClearRenderLists();
 	m_MeshList.clear();
+	ClearLOD();
 }
 void Model::Init(void)
 {
@@ -90,7 +620,11 @@ String Model::Load(String a_sFileName)
 	
 	if ("OBJ" == sExtension)
 	{
-		return LoadOBJ(a_sFileName);
+		ModelSource* pSource = PrepareSource(a_sFileName);
+		ReadSource(pSource);
+		String sOutput = Build(pSource);
+		SafeDelete(pSource);
+		return sOutput;
 	}
 	//else if ("ATO" == sExtension)
 	//{
@@ -102,11 +636,68 @@ String Model::Load(String a_sFileName)
 	//}
 	return "_|_ExtensionUnknown";
 }
+ModelSource* Model::PrepareSource(String a_sFileName)
+{
+	ModelSource* pSource = new ModelSource();
+	pSource->sFileName = a_sFileName;
+	pSource->sCookedFile = GetCookedFileName(a_sFileName);
+
+	SystemSingleton* pSystem = SystemSingleton::GetInstance();
+	pSource->uClock = pSystem->GenClock();
+	pSystem->StartClock(pSource->uClock);
+	return pSource;
+}
+String Model::Build(ModelSource* a_pSource)
+{
+	BTX_PROFILE_ZONE("Model::Build");
+
+	if (a_pSource->sResult != a_pSource->sFileName)
+		return a_pSource->sResult;
+
+	String sOutput = "";
+	if (a_pSource->bCooked)
+		sOutput = BuildCooked(a_pSource);
+	else
+	{
+		//Parsing the text and simplifying the levels of detail is slow, cook both so the next
+		//load can skip them
+		sOutput = BuildOBJ(a_pSource);
+		if (sOutput == a_pSource->sFileName)
+		{
+			if (m_uLODLevels > 0)
+				GenerateLOD(m_uLODLevels);
+			SaveCooked(a_pSource->sFileName);
+		}
+	}
+	return sOutput;
+}
+bool Model::IsLoading(void) { return m_pSource != nullptr; }
+bool Model::FinishLoading(bool a_bWait)
+{
+	if (m_pSource == nullptr)
+		return false;
+	if (!a_bWait && m_Loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
+	m_Loading.get();
+
+	//Textures of a model that loads in the background are decoded in the background as well
+	TextureManager* pTextureMngr = TextureManager::GetInstance();
+	bool bAsyncTextures = pTextureMngr->IsAsyncLoading();
+	pTextureMngr->SetAsyncLoading(true);
+	String sOutput = Build(m_pSource);
+	pTextureMngr->SetAsyncLoading(bAsyncTextures);
+
+	//The name stays as it is even if the load failed, it is the key the managers know it by
+	if (sOutput != m_sFileName)
+		printf("Model %s could not be loaded in the background.\n", m_sFileName.c_str());
+	SafeDelete(m_pSource);
+	return true;
+}
 
 void Model::LoadMTL(String a_sFileName)
 {
 	FileReader reader;
-	eBTX_OUTPUT result = reader.ReadFile(a_sFileName);
+	eBTX_OUTPUT result = reader.ReadFileBuffered(a_sFileName);
 	if (result != eBTX_OUTPUT::OUT_ERR_NONE)
 		return;
 
@@ -185,223 +776,139 @@ Mesh* Model::IdentifyMeshByMaterialIndex(uint a_uMaterialIndex)
 	}
 	return nullptr;
 }
-String Model::LoadOBJ(String a_sFileName)
+String Model::BuildOBJ(ModelSource* a_pSource)
 {
-	FileReader reader;
-	String sAbsoluteRoute = a_sFileName;
-	eBTX_OUTPUT result = reader.ReadFile(a_sFileName);
-	if (result != eBTX_OUTPUT::OUT_ERR_NONE)
+	String sAbsoluteFolder = FileReader::GetAbsoluteRoute(a_pSource->sFileName);
+	std::vector<ObjChunk>& lChunk = a_pSource->lChunk;
+	uint uThreads = lChunk.size();
+
+	//Stitch the chunks together, chunk local indices are offset by the count of the chunks before them
+	uint uPositionCount = 0;
+	uint uUVCount = 0;
+	uint uNormalCount = 0;
+	for (uint i = 0; i < uThreads; i++)
 	{
-		printf("Model %s could not be found.\n", sAbsoluteRoute.c_str());
-		reader.CloseFile();
-		return "_|_FileNotFound";
+		lChunk[i].uPositionBase = uPositionCount;
+		lChunk[i].uUVBase = uUVCount;
+		lChunk[i].uNormalBase = uNormalCount;
+		uPositionCount += lChunk[i].lPosition.size();
+		uUVCount += lChunk[i].lUV.size();
+		uNormalCount += lChunk[i].lNormal.size();
+	}
+	std::vector<vector3> lPosition; //Vector of Vertices
+	std::vector<vector3> lNormal; //Vector of Normals
+	std::vector<vector3> lUV; //vector of UVS
+	lPosition.reserve(uPositionCount);
+	lNormal.reserve(uNormalCount);
+	lUV.reserve(uUVCount);
+	for (uint i = 0; i < uThreads; i++)
+	{
+		lPosition.insert(lPosition.end(), lChunk[i].lPosition.begin(), lChunk[i].lPosition.end());
+		lUV.insert(lUV.end(), lChunk[i].lUV.begin(), lChunk[i].lUV.end());
+		lNormal.insert(lNormal.end(), lChunk[i].lNormal.begin(), lChunk[i].lNormal.end());
 	}
-	//reader.CloseFile();
-	reader.CloseFile();
-
-	result = reader.ReadBinaryFile(sAbsoluteRoute);
-	String sAbsoluteFolder = reader.GetAbsoluteRoute(sAbsoluteRoute);
-
-	SystemSingleton* pSystem = SystemSingleton::GetInstance();
-
-	uint nClock = pSystem->GenClock();
-	pSystem->StartClock(nClock);
 
-	reader.Rewind();
-	std::vector<vector3> v4Position; //Vector of Vertices
-	std::vector<vector3> vNormal; //Vector of Normals
-	std::vector<vector3> vUV; //vector of UVS
+	//Replay the material commands and faces in file order
 	int nMaterial = 0;
-	String sCurrentGroup = "";
-	String sCurrentMaterial = "";
-	String sCurrentMesh = "";
-	int nCurrentMeshIndex = -1;
-	while (reader.ReadNextLine() != OUT_DONE)
+	vector3 v3Color = C_WHITE;
+	if (m_pMatMngr->GetMaterialCount() > 0)
+		v3Color = m_pMatMngr->m_materialList[0]->GetDiffuse();
+	Mesh* pMesh = nullptr; //Mesh that receives the faces of the current material
+	std::vector<int> lCorner; //position, uv and normal indices of each corner of the current face
+	for (uint i = 0; i < uThreads; i++)
 	{
-		
-		char* sTemp = new char[reader.m_sLine.size() + 1];
-		String sWord = reader.GetFirstWord();
-		
-		
-#pragma region Material Library
-		if (sWord == "mtllib")
+		ObjChunk& chunk = lChunk[i];
+		uint uCommand = 0;
+		uint uCommandCount = chunk.lCommand.size();
+		uint uFaceCount = chunk.lFaceSize.size();
+		uint uFirstCorner = 0;
+		for (uint uFace = 0; uFace <= uFaceCount; uFace++)
 		{
-			sscanf_s(reader.m_sLine.c_str(), "mtllib %s", sTemp, reader.m_sLine.size());
-			LoadMTL(static_cast<String>(sAbsoluteFolder + sTemp));
-		}
-#pragma endregion
-#pragma region Vertex
-		else if (reader.m_sLine[0] == 'v')
-		{
-			float x = 0.0f, y = 0.0f, z = 0.0f;
-			if (reader.m_sLine[1] == ' ')
-			{
-				sscanf_s(reader.m_sLine.c_str(), "v %f %f %f", &x, &y, &z);
-				v4Position.push_back(vector3(x, y, z));
-			}
-			else if (reader.m_sLine[1] == 't')
-			{
-				sscanf_s(reader.m_sLine.c_str(), "vt %f %f", &x, &y);
-				vUV.push_back(vector3(x, y, 0));
-			}
-			else if (reader.m_sLine[1] == 'n')
-			{
-				sscanf_s(reader.m_sLine.c_str(), "vn %f %f %f", &x, &y, &z);
-				vNormal.push_back(vector3(x, y, z));
-			}
-		}
-#pragma endregion
-#pragma region Group
-		else if (reader.m_sLine[0] == 'g')
-		{
-			/*
-			* To keep things simple groups will be handled through materials,
-			* in a regular obj a group will contain an array of faces and each
-			* face can have a separate material, in this implementation
-			* faces with the same material will be grouped together. In short
-			* each material will be a new Mesh* in the list
-			*/
-		}
-
-#pragma endregion
 #pragma region Material
-		
-		else if (sWord == "usemtl")
-		{
-			//if we are reading a use material line
-			sscanf_s(reader.m_sLine.c_str(), "usemtl %s", sTemp, reader.m_sLine.size());
-			String sTempMaterial = sTemp;
-			sTempMaterial += m_sMaterialAppend;
-			sCurrentMaterial = sTempMaterial;
-			//try to find the material to use
-			nMaterial = m_pMatMngr->IdentifyMaterial(sTempMaterial);
-			//if the material was not found use the DEFAULT_V3NEG material
-			if (nMaterial < 0)
-				nMaterial = 0;
-		}
-#pragma endregion
-#pragma region Faces
-		else if (reader.m_sLine[0] == 'f')
-		{
-			/*
-			* Error control:
-			* Some OBJ files will not define the group we are working at or the material we are using
-			* we need to create a DEFAULT_V3NEG material to use. This probably happen if the mtllib
-			* was not used so no meshes would have been created at that point to.
-			*/
-						
-			//if we didnt have a material we use the DEFAULT_V3NEG one
-			if (sCurrentMaterial == "")
+			while (uCommand < uCommandCount && chunk.lCommand[uCommand].uFace == uFace)
 			{
-				if (m_MeshList.size() == 0)
+				ObjCommand& command = chunk.lCommand[uCommand++];
+				if (command.bLibrary)
 				{
-					Mesh* pMesh = new Mesh();
-					pMesh->SetMaterial(0);
-					m_MeshList.push_back(pMesh);
+					LoadMTL(sAbsoluteFolder + command.sName);
+					continue;
 				}
+				String sTempMaterial = command.sName + m_sMaterialAppend;
+				//try to find the material to use, if the material was not found use the default one
+				nMaterial = m_pMatMngr->IdentifyMaterial(sTempMaterial);
+				if (nMaterial < 0)
+					nMaterial = 0;
+				if (m_pMatMngr->GetMaterialCount() > nMaterial)
+					v3Color = m_pMatMngr->m_materialList[nMaterial]->GetDiffuse();
+				pMesh = nullptr;
 			}
-			//if we didn't have a mesh with this material we make a new one
-			Mesh* pMesh = IdentifyMeshByMaterialIndex(nMaterial);
-			if (!pMesh)
-			{
-				Mesh* pMesh = new Mesh();
-				pMesh->SetMaterial(0);
-				m_MeshList.push_back(pMesh);
-			}
-
-			int nP = 0, nT = 0, nN = 0;
-
-			String temp = reader.m_sLine.c_str();
-			int size = temp.size() + 1;
-			char* str = nullptr;
-			str = new char[size];
-			if (str == nullptr)
-			{
-				Release();
-				return "_|_Failed to reserve memory_"; //couldnt reserve memory
-			}
+#pragma endregion
+			if (uFace == uFaceCount)
+				break;
+#pragma region Faces
+			int nCorners = chunk.lFaceSize[uFace];
+			const ObjCorner* pFace = &chunk.lCorner[uFirstCorner];
+			uFirstCorner += nCorners;
 
-			//This replaces strcpy which is failing
-			for (int i = 0; i < size - 1; i++)
-				str[i] = temp[i];
-			str[size - 1] = '\0';
-
-			//Inspect how many points are given to create a face
-			//(usually just 3 but if more, this takes care of it)
-			int nVertices = 0;
-			char* pch;
-			pch = strtok(str, "f ");
-			while (pch != NULL)
+			lCorner.clear();
+			bool bValid = nCorners >= 3;
+			for (int j = 0; j < nCorners; j++)
 			{
-				nVertices++;
-				pch = strtok(NULL, "f ");
+				lCorner.push_back(ResolveIndex(pFace[j], 0, chunk.uPositionBase, uPositionCount));
+				lCorner.push_back(ResolveIndex(pFace[j], 1, chunk.uUVBase, uUVCount));
+				lCorner.push_back(ResolveIndex(pFace[j], 2, chunk.uNormalBase, uNormalCount));
+				bValid = bValid && lCorner[j * 3] >= 0;
 			}
+			if (!bValid)
+				continue;
 
-			//Now that we know how many vertices we have we know how many times we need to read the line
-			for (int j = 0; j < nVertices - 2; j++)
+			//if we didn't have a mesh with this material we make a new one
+			if (pMesh == nullptr)
 			{
-				//This replaces strcpy which is failing
-				for (int i = 0; i < size - 1; i++)
-					str[i] = temp[i];
-				str[size - 1] = '\0';
-
-				//We will divide the line in /%d/%d/%d so we can read the individual vertex info
-				//It is obvious at this point that reading triangulated models is faster (as it only needs
-				//to read each face once)
-				pch = strtok(str, "f ");
-				int nIndex = 0;
-				while (pch != NULL)
+				pMesh = IdentifyMeshByMaterialIndex(nMaterial);
+				if (pMesh == nullptr)
 				{
-					if (nIndex == 0)
-					{
-						sscanf_s(pch, "%d/%d/%d", &nP, &nT, &nN);
-						pMesh->AddVertexPosition(v4Position[nP - 1]);
-						pMesh->AddVertexColor(m_pMatMngr->m_materialList[nMaterial]->GetDiffuse());
-						pMesh->AddVertexUV(vUV[nT - 1]);
-						pMesh->AddVertexNormal(vNormal[nN - 1]);
-					}
-					else if (nIndex + j == nVertices - 2)
-					{
-						sscanf_s(pch, "%d/%d/%d", &nP, &nT, &nN);
-						pMesh->AddVertexPosition(v4Position[nP - 1]);
-						pMesh->AddVertexColor(m_pMatMngr->m_materialList[nMaterial]->GetDiffuse());
-						pMesh->AddVertexUV(vUV[nT - 1]);
-						pMesh->AddVertexNormal(vNormal[nN - 1]);
-					}
-					else if (nIndex + j == nVertices - 1)
-					{
-						sscanf_s(pch, "%d/%d/%d", &nP, &nT, &nN);
-						pMesh->AddVertexPosition(v4Position[nP - 1]);
-						pMesh->AddVertexColor(m_pMatMngr->m_materialList[nMaterial]->GetDiffuse());
-						pMesh->AddVertexUV(vUV[nT - 1]);
-						pMesh->AddVertexNormal(vNormal[nN - 1]);
-					}
-					pch = strtok(NULL, "f ");
-					nIndex++;
+					pMesh = new Mesh();
+					pMesh->SetMaterial(nMaterial);
+					m_MeshList.push_back(pMesh);
 				}
 			}
 
-			if (str != nullptr)
+			//Fan triangulation around the first corner, in the same order the
+			//line based loader used to add them: (0, n-2, n-1), (0, n-3, n-2)...
+			for (int j = nCorners - 2; j >= 1; j--)
 			{
-				delete str;
-				str = nullptr;
+				int nTriangle[3] = { 0, j, j + 1 };
+				vector3 v3FaceNormal = glm::cross(
+					lPosition[lCorner[nTriangle[1] * 3]] - lPosition[lCorner[0]],
+					lPosition[lCorner[nTriangle[2] * 3]] - lPosition[lCorner[0]]);
+				if (v3FaceNormal != ZERO_V3)
+					v3FaceNormal = glm::normalize(v3FaceNormal);
+				for (int k = 0; k < 3; k++)
+				{
+					const int* pCorner = &lCorner[nTriangle[k] * 3];
+					pMesh->AddVertexPosition(lPosition[pCorner[0]]);
+					pMesh->AddVertexColor(v3Color);
+					pMesh->AddVertexUV(pCorner[1] >= 0 ? lUV[pCorner[1]] : ZERO_V3);
+					pMesh->AddVertexNormal(pCorner[2] >= 0 ? lNormal[pCorner[2]] : v3FaceNormal);
+				}
 			}
-
-		}
 #pragma endregion
+		}
 	}
-	reader.CloseFile();
+
 	//Once we read all the file and added information on all the meshes we need to compile each of them
-	//ComposeGroups();
-	//oMutex.lock();
 	m_pMatMngr->ReloadMaps();
 	CompileMeshes();
-	//oMutex.unlock();
-	//GetModelsMap();
+	CalculateBounds();
 
-	m_sFileName = a_sFileName;
-	printf("Model: %s \n", sAbsoluteRoute.c_str());
-	printf("               loaded in %.4f seconds.\n", pSystem->GetDeltaTime(nClock));
+	m_sFileName = a_pSource->sFileName;
+	float fTime = SystemSingleton::GetInstance()->GetDeltaTime(a_pSource->uClock);
+	printf("Model: %s \n", m_sFileName.c_str());
+	if (fTime > 0.0f)
+		printf("               loaded in %.4f seconds (%.2f MB/s, %u threads).\n", fTime, a_pSource->uFileSize / (1048576.0f * fTime), uThreads);
+	else
+		printf("               loaded in %.4f seconds (%u threads).\n", fTime, uThreads);
 	return m_sFileName;
 }
 void Model::CompileMeshes(void)
@@ -412,6 +919,192 @@ void Model::CompileMeshes(void)
 		m_MeshList[i]->CompileOpenGL3X();
 	}
 }
+void Model::CalculateBounds(void)
+{
+	bool bFirst = true;
+	uint uMeshCount = m_MeshList.size();
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		std::vector<vector3> lVertex = m_MeshList[i]->GetVertexList();
+		uint uVertexCount = lVertex.size();
+		for (uint j = 0; j < uVertexCount; j++)
+		{
+			if (bFirst)
+			{
+				m_v3MinL = m_v3MaxL = lVertex[j];
+				bFirst = false;
+				continue;
+			}
+			m_v3MinL = glm::min(m_v3MinL, lVertex[j]);
+			m_v3MaxL = glm::max(m_v3MaxL, lVertex[j]);
+		}
+	}
+}
+String Model::GetCookedFileName(String a_sFileName)
+{
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	String sData = pFolder->GetFolderRoot() + pFolder->GetFolderData();
+	String sSourceFolder = sData + pFolder->GetFolderMOBJ();
+
+	//Keep the route inside of MOBJ in the name so models in different folders don't collide
+	String sName = a_sFileName;
+	if (sName.compare(0, sSourceFolder.size(), sSourceFolder) == 0)
+		sName = sName.substr(sSourceFolder.size());
+	for (uint i = 0; i < sName.size(); i++)
+	{
+		if (sName[i] == '\\' || sName[i] == '/' || sName[i] == ':')
+			sName[i] = '_';
+	}
+	return sData + pFolder->GetFolderMBTO() + FileReader::GetFileName(sName) + ".btc";
+}
+void Model::SaveCooked(String a_sFileName)
+{
+	unsigned long long uSourceSize = 0;
+	unsigned long long uSourceTime = 0;
+	if (!FileReader::GetFileStamp(a_sFileName, &uSourceSize, &uSourceTime))
+		return;
+
+	//The material library is part of the key as well, a change on it invalidates the cooked file
+	String sMaterialFile = "";
+	unsigned long long uMaterialSize = 0;
+	unsigned long long uMaterialTime = 0;
+	if (m_sMaterialAppend.size() > 1)
+	{
+		sMaterialFile = m_sMaterialAppend.substr(1);
+		FileReader::GetFileStamp(sMaterialFile, &uMaterialSize, &uMaterialTime);
+	}
+
+	String sCookedFile = GetCookedFileName(a_sFileName);
+	CreateDirectoryA(FileReader::GetAbsoluteRoute(sCookedFile).c_str(), NULL);
+
+	FileReader writer;
+	if (writer.SaveBinaryFile(sCookedFile) != eBTX_OUTPUT::OUT_ERR_NONE)
+		return;
+
+	//Header
+	writer.WriteInt(nCookedTag);
+	writer.WriteInt(nCookedVersion);
+	writer.WriteString(a_sFileName);
+	writer.WriteBuffer(&uSourceSize, sizeof(uSourceSize));
+	writer.WriteBuffer(&uSourceTime, sizeof(uSourceTime));
+	writer.WriteString(sMaterialFile);
+	writer.WriteBuffer(&uMaterialSize, sizeof(uMaterialSize));
+	writer.WriteBuffer(&uMaterialTime, sizeof(uMaterialTime));
+
+	//Bounds
+	writer.WriteBuffer(&m_v3MinL, sizeof(vector3));
+	writer.WriteBuffer(&m_v3MaxL, sizeof(vector3));
+
+	//Meshes and the material each of them uses
+	uint uMeshCount = m_MeshList.size();
+	writer.WriteInt(uMeshCount);
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		Mesh* pMesh = m_MeshList[i];
+		Material* pMaterial = m_pMatMngr->GetMaterial(static_cast<uint>(pMesh->GetMaterialIndex()));
+		vector3 v3Diffuse = pMaterial->GetDiffuse();
+
+		writer.WriteString(pMesh->GetName());
+		writer.WriteString(pMaterial->GetName());
+		writer.WriteString(pMaterial->GetDiffuseMapName());
+		writer.WriteString(pMaterial->GetNormalMapName());
+		writer.WriteString(pMaterial->GetSpecularMapName());
+		writer.WriteBuffer(&v3Diffuse, sizeof(vector3));
+
+		WriteVector3List(writer, pMesh->GetVertexList());
+		WriteVector3List(writer, pMesh->GetColorList());
+		WriteVector3List(writer, pMesh->GetUVList());
+		WriteVector3List(writer, pMesh->GetNormalList());
+		WriteVector3List(writer, pMesh->GetBitangetList());
+		WriteVector3List(writer, pMesh->GetTangentList());
+	}
+
+	//Levels of detail, each has a mesh for every mesh of the model and uses its material
+	writer.WriteInt(m_uLODLevels);
+	uint uLODCount = m_lLODMesh.size();
+	writer.WriteInt(uLODCount);
+	for (uint i = 0; i < uLODCount; i++)
+	{
+		writer.WriteBuffer(&m_lLODSize[i], sizeof(float));
+		for (uint j = 0; j < uMeshCount; j++)
+		{
+			Mesh* pMesh = m_lLODMesh[i][j];
+			WriteVector3List(writer, pMesh->GetVertexList());
+			WriteVector3List(writer, pMesh->GetColorList());
+			WriteVector3List(writer, pMesh->GetUVList());
+			WriteVector3List(writer, pMesh->GetNormalList());
+			WriteVector3List(writer, pMesh->GetBitangetList());
+			WriteVector3List(writer, pMesh->GetTangentList());
+		}
+	}
+	writer.CloseFile();
+}
+String Model::BuildCooked(ModelSource* a_pSource)
+{
+	uint uMeshCount = a_pSource->lMesh.size();
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		CookedMesh& mesh = a_pSource->lMesh[i];
+
+		//Only set the material up if it was not already known by the manager
+		int nMaterialCount = m_pMatMngr->GetMaterialCount();
+		int nMaterial = m_pMatMngr->AddMaterial(mesh.sMaterial);
+		if (nMaterial >= nMaterialCount)
+		{
+			Material* pMaterial = m_pMatMngr->GetMaterial(static_cast<uint>(nMaterial));
+			pMaterial->SetDiffuseMapName(mesh.sDiffuseMap);
+			pMaterial->SetNormalMapName(mesh.sNormalMap);
+			pMaterial->SetSpecularMapName(mesh.sSpecularMap);
+			pMaterial->SetDiffuse(mesh.v3Diffuse);
+		}
+
+		Mesh* pMesh = new Mesh();
+		pMesh->SetMaterial(nMaterial);
+		pMesh->SetName(mesh.sName);
+		pMesh->AddVertexPositionList(mesh.lPosition);
+		pMesh->AddVertexColorList(mesh.lColor);
+		pMesh->AddVertexUVList(mesh.lUV);
+		pMesh->AddVertexNormalList(mesh.lNormal);
+		pMesh->AddVertexBinormalList(mesh.lBinormal);
+		pMesh->AddVertexTangentList(mesh.lTangent);
+		m_MeshList.push_back(pMesh);
+	}
+
+	if (a_pSource->sMaterialFile != "")
+		m_sMaterialAppend = "|" + a_pSource->sMaterialFile;
+	m_v3MinL = a_pSource->v3Min;
+	m_v3MaxL = a_pSource->v3Max;
+	m_pMatMngr->ReloadMaps();
+	CompileMeshes();
+
+	//The levels of detail were simplified when the file was cooked
+	for (uint i = 0; i < a_pSource->lLOD.size(); i++)
+	{
+		std::vector<Mesh*> lMesh;
+		for (uint j = 0; j < uMeshCount; j++)
+		{
+			CookedMesh& mesh = a_pSource->lLOD[i][j];
+			Mesh* pMesh = new Mesh();
+			pMesh->SetMaterial(m_MeshList[j]->GetMaterialIndex());
+			pMesh->SetName(m_MeshList[j]->GetName());
+			pMesh->AddVertexPositionList(mesh.lPosition);
+			pMesh->AddVertexColorList(mesh.lColor);
+			pMesh->AddVertexUVList(mesh.lUV);
+			pMesh->AddVertexNormalList(mesh.lNormal);
+			pMesh->AddVertexBinormalList(mesh.lBinormal);
+			pMesh->AddVertexTangentList(mesh.lTangent);
+			pMesh->CompileOpenGL3X();
+			lMesh.push_back(pMesh);
+		}
+		AddLOD(lMesh, a_pSource->lLODSize[i]);
+	}
+
+	m_sFileName = a_pSource->sFileName;
+	printf("Model: %s \n", m_sFileName.c_str());
+	printf("               loaded from cooked file in %.4f seconds.\n",
+		SystemSingleton::GetInstance()->GetDeltaTime(a_pSource->uClock));
+	return m_sFileName;
+}
 uint Model::RenderLists(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3CameraPosition)
 {
 	//Get all the matrices sent for the model and count them
@@ -465,6 +1158,302 @@ uint Model::RenderLists(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3Ca
 	}
 	return uRenderCalls;
 }
+void Model::AddListsToQueue(RenderQueue* a_pQueue, uint a_uLayer)
+{
+	if (a_pQueue == nullptr)
+		return;
+
+	//With levels of detail each instance picks the meshes it is drawn with
+	if (!m_lLODMesh.empty())
+	{
+		AddLODToQueue(a_pQueue, m_RenderListSolid, m_RenderIDSolid, m_lLODSolid, eBTX_RENDER::RENDER_SOLID, a_uLayer);
+		AddLODToQueue(a_pQueue, m_RenderListWire, m_RenderIDWire, m_lLODWire, eBTX_RENDER::RENDER_WIRE, a_uLayer);
+		return;
+	}
+
+	//The matrices are added once and shared by all the meshes of the model
+	uint uMeshCount = m_MeshList.size();
+	uint uSolids = m_RenderListSolid.size();
+	if (uSolids > 0)
+	{
+		uint uFirst = a_pQueue->AddMatrices(m_RenderListSolid);
+		for (uint i = 0; i < uMeshCount; i++)
+			a_pQueue->AddMesh(m_MeshList[i], uFirst, uSolids, eBTX_RENDER::RENDER_SOLID, a_uLayer);
+	}
+	uint uWires = m_RenderListWire.size();
+	if (uWires > 0)
+	{
+		uint uFirst = a_pQueue->AddMatrices(m_RenderListWire);
+		for (uint i = 0; i < uMeshCount; i++)
+			a_pQueue->AddMesh(m_MeshList[i], uFirst, uWires, eBTX_RENDER::RENDER_WIRE, a_uLayer);
+	}
+}
+void Model::AddLODToQueue(RenderQueue* a_pQueue, std::vector<matrix4> const& a_lMatrix, std::vector<uint> const& a_lInstance,
+	NameMap<uint>& a_lLast, int a_nRenderOption, uint a_uLayer)
+{
+	uint uInstances = a_lMatrix.size();
+	if (uInstances == 0)
+		return;
+
+	uint uLevels = m_lLODMesh.size() + 1;
+	m_lLODBucket.resize(uLevels);
+	for (uint i = 0; i < uLevels; i++)
+		m_lLODBucket[i].clear();
+
+	//The bounding sphere of the model in local space, scaled by the largest axis of each instance
+	vector3 v3Center = (m_v3MinL + m_v3MaxL) * 0.5f;
+	float fRadius = glm::distance(m_v3MinL, m_v3MaxL) * 0.5f;
+	for (uint i = 0; i < uInstances; i++)
+	{
+		matrix4 const& m4ToWorld = a_lMatrix[i];
+		float fScale = std::max(glm::length(vector3(m4ToWorld[0])),
+			std::max(glm::length(vector3(m4ToWorld[1])), glm::length(vector3(m4ToWorld[2]))));
+		float fSize = a_pQueue->GetScreenSize(vector3(m4ToWorld * vector4(v3Center, 1.0f)), fRadius * fScale);
+		uint* pLast = a_lLast.Find(a_lInstance[i]);
+		uint uLevel = a_pQueue->SelectLOD(fSize, m_lLODSize, pLast != nullptr ? *pLast : 0);
+		if (pLast != nullptr)
+			*pLast = uLevel;
+		else
+			a_lLast.Set(a_lInstance[i], uLevel);
+		m_lLODBucket[uLevel].push_back(m4ToWorld);
+	}
+
+	for (uint uLevel = 0; uLevel < uLevels; uLevel++)
+	{
+		if (m_lLODBucket[uLevel].empty())
+			continue;
+		std::vector<Mesh*>& lMesh = uLevel == 0 ? m_MeshList : m_lLODMesh[uLevel - 1];
+		uint uCount = m_lLODBucket[uLevel].size();
+		uint uFirst = a_pQueue->AddMatrices(m_lLODBucket[uLevel]);
+		for (uint i = 0; i < lMesh.size(); i++)
+			a_pQueue->AddMesh(lMesh[i], uFirst, uCount, a_nRenderOption, a_uLayer);
+	}
+}
+void Model::AddLOD(std::vector<Mesh*> a_lMesh, float a_fScreenSize)
+{
+	if (a_lMesh.empty())
+		return;
+	if (!m_lLODSize.empty())
+		a_fScreenSize = std::min(a_fScreenSize, m_lLODSize.back());
+	m_lLODMesh.push_back(a_lMesh);
+	m_lLODSize.push_back(a_fScreenSize);
+}
+uint Model::GenerateLOD(uint a_uLevels, float a_fRatio, float a_fScreenSize)
+{
+	BTX_PROFILE_ZONE("Model::GenerateLOD");
+
+	ClearLOD();
+	uint uMeshCount = m_MeshList.size();
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		//Lines have nothing to collapse
+		if (m_MeshList[i]->IsLineObject())
+			return 0;
+	}
+
+	std::vector<Mesh*>* pLast = &m_MeshList;
+	for (uint uLevel = 0; uLevel < a_uLevels; uLevel++)
+	{
+		std::vector<Mesh*> lMesh;
+		uint uBefore = 0;
+		uint uAfter = 0;
+		for (uint i = 0; i < uMeshCount; i++)
+		{
+			Mesh* pMesh = new Mesh();
+			pMesh->GenerateSimplified((*pLast)[i], a_fRatio);
+			uBefore += (*pLast)[i]->GetVertexCount();
+			uAfter += pMesh->GetVertexCount();
+			lMesh.push_back(pMesh);
+		}
+		//A level that saves little is not worth the switch
+		if (uAfter == 0 || uAfter > uBefore * 0.9f)
+		{
+			for (uint i = 0; i < lMesh.size(); i++)
+				SafeDelete(lMesh[i]);
+			break;
+		}
+		AddLOD(lMesh, a_fScreenSize);
+		a_fScreenSize *= 0.5f;
+		pLast = &m_lLODMesh.back();
+	}
+	return m_lLODMesh.size();
+}
+void Model::ClearLOD(void)
+{
+	for (uint i = 0; i < m_lLODMesh.size(); i++)
+	{
+		for (uint j = 0; j < m_lLODMesh[i].size(); j++)
+			SafeDelete(m_lLODMesh[i][j]);
+	}
+	m_lLODMesh.clear();
+	m_lLODSize.clear();
+	m_lLODSolid.Clear();
+	m_lLODWire.Clear();
+	m_lLODBucket.clear();
+}
+uint Model::GetLODCount(void) { return m_lLODMesh.size(); }
+uint Model::GetLODVertexCount(uint a_uLevel)
+{
+	if (a_uLevel > m_lLODMesh.size())
+		return 0;
+	std::vector<Mesh*>& lMesh = a_uLevel == 0 ? m_MeshList : m_lLODMesh[a_uLevel - 1];
+	uint uVertices = 0;
+	for (uint i = 0; i < lMesh.size(); i++)
+		uVertices += lMesh[i]->GetVertexCount();
+	return uVertices;
+}
+//Source of the atlas a mesh can be moved to, -1 if its material or its UVs do not allow it
+//Gets the diffuse map a mesh would be drawn from in an atlas, empty if it can't use one
+static String GetAtlasMap(Mesh* a_pMesh, MaterialManager* a_pMatMngr)
+{
+	int nMaterial = a_pMesh->GetMaterialIndex();
+	if (a_pMesh->IsLineObject() || nMaterial < 0 || nMaterial >= a_pMatMngr->GetMaterialCount())
+		return "";
+
+	//the normal and specular maps would still tell the materials apart
+	Material* pMaterial = a_pMatMngr->GetMaterial(static_cast<uint>(nMaterial));
+	String sNormal = pMaterial->GetNormalMapName();
+	String sSpecular = pMaterial->GetSpecularMapName();
+	String sDiffuse = pMaterial->GetDiffuseMapName();
+	if ((sNormal != "NULL" && sNormal != "") || (sSpecular != "NULL" && sSpecular != "") || sDiffuse == "NULL")
+		return "";
+
+	//a tiling texture would sample its neighbors in the page
+	std::vector<vector3> lUV = a_pMesh->GetUVList();
+	for (uint i = 0; i < lUV.size(); i++)
+	{
+		if (lUV[i].x < -0.001f || lUV[i].x > 1.001f || lUV[i].y < -0.001f || lUV[i].y > 1.001f)
+			return "";
+	}
+	return sDiffuse;
+}
+static int FindAtlasSource(Mesh* a_pMesh, TextureAtlas* a_pAtlas, MaterialManager* a_pMatMngr)
+{
+	String sDiffuse = GetAtlasMap(a_pMesh, a_pMatMngr);
+	if (sDiffuse == "")
+		return -1;
+	int nSource = a_pAtlas->IdentifySource(sDiffuse);
+	if (nSource < 0 || a_pAtlas->GetRegion(nSource).nPage < 0)
+		return -1;
+	return nSource;
+}
+static void MoveToAtlas(Mesh* a_pMesh, TextureAtlas* a_pAtlas, int a_nSource)
+{
+	std::vector<vector3> lUV = a_pMesh->GetUVList();
+	for (uint i = 0; i < lUV.size(); i++)
+		lUV[i] = a_pAtlas->TransformUV(a_nSource, lUV[i]);
+	a_pMesh->SetUVList(lUV);
+	a_pMesh->SetMaterial(a_pAtlas->GetPageMaterial(a_pAtlas->GetRegion(a_nSource).nPage));
+	a_pMesh->RebuildOpenGL3X();
+}
+uint Model::ApplyAtlas(TextureAtlas* a_pAtlas, bool a_bMerge)
+{
+	BTX_PROFILE_ZONE("Model::ApplyAtlas");
+
+	if (a_pAtlas == nullptr || a_pAtlas->GetPageCount() == 0)
+		return 0;
+
+	//models made from primitives never set their manager
+	MaterialManager* pMatMngr = MaterialManager::GetInstance();
+	uint uMoved = 0;
+	uint uMeshCount = m_MeshList.size();
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		int nSource = FindAtlasSource(m_MeshList[i], a_pAtlas, pMatMngr);
+		if (nSource < 0)
+			continue;
+		MoveToAtlas(m_MeshList[i], a_pAtlas, nSource);
+		//the simplified meshes keep a subset of the UVs of their source
+		for (uint uLevel = 0; uLevel < m_lLODMesh.size(); uLevel++)
+		{
+			if (i < m_lLODMesh[uLevel].size())
+				MoveToAtlas(m_lLODMesh[uLevel][i], a_pAtlas, nSource);
+		}
+		uMoved++;
+	}
+
+	if (a_bMerge && uMoved > 0)
+		MergeMeshes();
+	return uMoved;
+}
+uint Model::AddMapsToAtlas(TextureAtlas* a_pAtlas)
+{
+	if (a_pAtlas == nullptr)
+		return 0;
+
+	MaterialManager* pMatMngr = MaterialManager::GetInstance();
+	uint uAdded = 0;
+	for (uint i = 0; i < m_MeshList.size(); i++)
+	{
+		String sDiffuse = GetAtlasMap(m_MeshList[i], pMatMngr);
+		if (sDiffuse != "" && a_pAtlas->IdentifySource(sDiffuse) < 0 && a_pAtlas->AddTexture(sDiffuse) >= 0)
+			uAdded++;
+	}
+	return uAdded;
+}
+//Appends each mesh of a list to the one it was grouped with and deletes it
+static void MergeList(std::vector<Mesh*>& a_lMesh, std::vector<uint> const& a_lTarget)
+{
+	std::vector<Mesh*> lKept;
+	std::vector<bool> lGrown(a_lMesh.size(), false);
+	for (uint i = 0; i < a_lMesh.size(); i++)
+	{
+		if (a_lTarget[i] == i)
+		{
+			lKept.push_back(a_lMesh[i]);
+			continue;
+		}
+		a_lMesh[a_lTarget[i]]->AppendMesh(a_lMesh[i]);
+		lGrown[a_lTarget[i]] = true;
+		SafeDelete(a_lMesh[i]);
+	}
+	for (uint i = 0; i < a_lMesh.size(); i++)
+	{
+		if (lGrown[i])
+			a_lMesh[i]->RebuildOpenGL3X();
+	}
+	a_lMesh = lKept;
+}
+uint Model::MergeMeshes(void)
+{
+	BTX_PROFILE_ZONE("Model::MergeMeshes");
+
+	//each mesh goes into the first one before it drawn with the same state
+	uint uMeshCount = m_MeshList.size();
+	std::vector<uint> lTarget(uMeshCount);
+	std::map<std::pair<int, GLuint>, std::vector<uint>> mGroup;
+	bool bMerged = false;
+	for (uint i = 0; i < uMeshCount; i++)
+	{
+		lTarget[i] = i;
+		Mesh* pMesh = m_MeshList[i];
+		if (pMesh->IsLineObject())
+			continue;
+		std::vector<uint>& lFirst = mGroup[std::make_pair(pMesh->GetMaterialIndex(), pMesh->GetShaderIndex())];
+		for (uint j = 0; j < lFirst.size(); j++)
+		{
+			if (m_MeshList[lFirst[j]]->GetTint() == pMesh->GetTint())
+			{
+				lTarget[i] = lFirst[j];
+				bMerged = true;
+				break;
+			}
+		}
+		if (lTarget[i] == i)
+			lFirst.push_back(i);
+	}
+	if (!bMerged)
+		return uMeshCount;
+
+	//the levels of detail have a mesh for each mesh of the model and are grouped the same way
+	MergeList(m_MeshList, lTarget);
+	for (uint uLevel = 0; uLevel < m_lLODMesh.size(); uLevel++)
+	{
+		if (m_lLODMesh[uLevel].size() == uMeshCount)
+			MergeList(m_lLODMesh[uLevel], lTarget);
+	}
+	return m_MeshList.size();
+}
 uint Model::Render(matrix4 a_mProjection, matrix4 a_mView, matrix4 a_mWorld,
 	vector3 a_v3CameraPosition, int a_RenderOption)
 {
@@ -491,14 +1480,20 @@ uint Model::Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray
 }
 String Model::GetName(void) { return m_sFileName; }
 void Model::AddToRenderList(matrix4 a_m4Transform, int a_RenderOption)
+{
+	AddToRenderList(a_m4Transform, a_RenderOption, NameTable::INVALID);
+}
+void Model::AddToRenderList(matrix4 a_m4Transform, int a_RenderOption, uint a_uInstance)
 {
 	if (a_RenderOption & eBTX_RENDER::RENDER_SOLID)
 	{
 		m_RenderListSolid.push_back(a_m4Transform);
+		m_RenderIDSolid.push_back(a_uInstance);
 	}
 	if (a_RenderOption & eBTX_RENDER::RENDER_WIRE)
 	{
 		m_RenderListWire.push_back(a_m4Transform);
+		m_RenderIDWire.push_back(a_uInstance);
 	}
 }
 std::vector<matrix4> Model::GetRenderListSolids(void) {	return m_RenderListSolid; }
@@ -507,8 +1502,20 @@ void Model::ClearRenderLists(void)
 {
 	m_RenderListSolid.clear();
 	m_RenderListWire.clear();
+	m_RenderIDSolid.clear();
+	m_RenderIDWire.clear();
 }
 void Model::SetName(String a_sName) { m_sFileName = a_sName; }
+void Model::AddMesh(Mesh* a_pMesh)
+{
+	if (a_pMesh == nullptr)
+		return;
+	m_MeshList.push_back(a_pMesh);
+	CalculateBounds();
+}
+uint Model::GetMeshCount(void) { return m_MeshList.size(); }
+vector3 Model::GetMinLocal(void) { return m_v3MinL; }
+vector3 Model::GetMaxLocal(void) { return m_v3MaxL; }
 std::vector<vector3> Model::GetVertexList()
 {
 	uint uMeshCount = m_MeshList.size();
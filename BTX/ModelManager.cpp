@@ -24,6 +24,9 @@ void ModelManager::Init(void)
 	m_pShaderMngr = ShaderManager::GetInstance();
 	m_pMatMngr = MaterialManager::GetInstance();
 	m_pCameraMngr = CameraManager::GetInstance();
+	m_pRenderQueue = new RenderQueue();
+	m_pDebugBatch = new DebugBatch();
+	m_pBoundsBatch = new BoundsBatch();
 
 	//Generate basic primitives that will be used frequently
 	//GenerateSkybox();
@@ -93,6 +96,11 @@ void ModelManager::Release(void)
 	m_pShaderMngr = nullptr;
 	m_pMatMngr = nullptr;
 	m_pCameraMngr = nullptr;
+	SafeDelete(m_pRenderQueue);
+	SafeDelete(m_pDebugBatch);
+	SafeDelete(m_pBoundsBatch);
+	m_lLoading.clear();
+	m_lAtlasPending.clear();
 	uint uModelCount = m_ModelList.size();
 	for (uint i = 0; i < uModelCount; ++i)
 	{
@@ -105,7 +113,7 @@ void ModelManager::Release(void)
 	}
 
 	m_ModelList.clear();
-	m_ModelMap.clear();
+	m_ModelMap.Clear();
 }
 ModelManager* ModelManager::GetInstance()
 {
@@ -129,6 +137,19 @@ ModelManager::ModelManager(ModelManager const& other){ }
 ModelManager& ModelManager::operator=(ModelManager const& other) { return *this; }
 ModelManager::~ModelManager(){Release();};
 //--- Generate shapes
+//Folder a model file with this name is read from when its name has no route
+static String GetDataRoute(String const& a_sName)
+{
+	String sExtension = BTX::ToUppercase(FileReader::GetExtension(a_sName));
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	String sRoute = pFolder->GetFolderRoot();
+	sRoute += pFolder->GetFolderData();
+	if (sExtension == "OBJ")
+	{
+		sRoute += pFolder->GetFolderMOBJ();
+	}
+	return sRoute;
+}
 Model* ModelManager::AddModel(Model* a_pModel)
 {
 	//check if empty pointer
@@ -146,12 +167,27 @@ Model* ModelManager::AddModel(Model* a_pModel)
 		return pModel;
 
 	//If the model was not in the list add it to it
+	uint uIndex = m_ModelList.size();
 	m_ModelList.push_back(a_pModel);
-	//Add it to the map
-	m_ModelMap.insert(std::pair<String, Model*>(sName, a_pModel));
+	//Add it to the map, the route the files are read from is stripped once here so
+	//GetModel finds loaded files by their short name without building the route
+	NameTable* pNames = NameTable::GetInstance();
+	m_ModelMap.Set(pNames->Intern(sName), uIndex);
+	String sDataRoute = GetDataRoute(sName);
+	if (sDataRoute != "" && sName.compare(0, sDataRoute.size(), sDataRoute) == 0)
+	{
+		uint uShortName = pNames->Intern(sName.substr(sDataRoute.size()));
+		if (m_ModelMap.Find(uShortName) == nullptr)
+			m_ModelMap.Set(uShortName, uIndex);
+	}
+	//Models read in the background get built by UpdateLoads
+	if (a_pModel->IsLoading())
+		m_lLoading.push_back(a_pModel);
 	//and return its name
 	return a_pModel;
 }
+//Screen sizes under which the generated primitives use their coarser tessellations
+static const float fPrimitiveLOD[2] = { 0.05f, 0.015f };
 String GenerateName(int nShape, vector3 a_v3Color)
 {
 	String sName;
@@ -251,6 +287,13 @@ Model* ModelManager::GenerateUniCone(vector3 a_v3Color)
 	pMesh->GenerateCone(0.5f, 1.0f, 12, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateCone(0.5f, 1.0f, 6, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
+	pLOD = new Mesh();
+	pLOD->GenerateCone(0.5f, 1.0f, 4, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[1]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniCylinder(vector3 a_v3Color)
@@ -268,6 +311,13 @@ Model* ModelManager::GenerateUniCylinder(vector3 a_v3Color)
 	pMesh->GenerateCylinder(0.5f, 1.0f, 12, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateCylinder(0.5f, 1.0f, 6, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
+	pLOD = new Mesh();
+	pLOD->GenerateCylinder(0.5f, 1.0f, 4, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[1]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniTube(vector3 a_v3Color)
@@ -285,6 +335,13 @@ Model* ModelManager::GenerateUniTube(vector3 a_v3Color)
 	pMesh->GenerateTube(0.5f, 0.35f, 1.0f, 12, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateTube(0.5f, 0.35f, 1.0f, 6, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
+	pLOD = new Mesh();
+	pLOD->GenerateTube(0.5f, 0.35f, 1.0f, 4, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[1]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniTorus(vector3 a_v3Color)
@@ -302,6 +359,13 @@ Model* ModelManager::GenerateUniTorus(vector3 a_v3Color)
 	pMesh->GenerateTorus(0.5f, 0.35f, 12, 12, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateTorus(0.5f, 0.35f, 8, 8, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
+	pLOD = new Mesh();
+	pLOD->GenerateTorus(0.5f, 0.35f, 4, 6, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[1]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniSphere(vector3 a_v3Color)
@@ -319,6 +383,13 @@ Model* ModelManager::GenerateUniSphere(vector3 a_v3Color)
 	pMesh->GenerateSphere(1.0f, 6, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateSphere(1.0f, 5, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
+	pLOD = new Mesh();
+	pLOD->GenerateIcosahedron(1.0f, 1, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[1]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniStar(vector3 a_v3Color)
@@ -354,6 +425,10 @@ Model* ModelManager::GenerateUniIcosahedron(vector3 a_v3Color)
 	pMesh->GenerateIcosahedron(1.0f, 2, a_v3Color);
 	pMesh->SetName(sName);//This is just a precaution, name should match anyways
 	pModel = new Model(pMesh);
+	//Coarser tessellations for the instances that are small on the screen
+	Mesh* pLOD = new Mesh();
+	pLOD->GenerateIcosahedron(1.0f, 1, a_v3Color);
+	pModel->AddLOD({ pLOD }, fPrimitiveLOD[0]);
 	return AddModel(pModel);
 }
 Model* ModelManager::GenerateUniWireCube(vector3 a_v3Color)
@@ -420,6 +495,23 @@ Model* ModelManager::GenerateLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_
 	pModel = new Model(pMesh);
 	return AddModel(pModel);
 }
+Model* ModelManager::GenerateGrid(bool a_bCenterLines)
+{
+	//Try to find a model with this name
+	String sName = a_bCenterLines ? "grid_(100,1)" : "grid_(100,0)";
+	Model* pModel = GetModel(sName);
+
+	//if it exists return that model
+	if (pModel)
+		return pModel;
+
+	//Else construct a new model based on this new mesh
+	Mesh* pMesh = new Mesh();
+	pMesh->GenerateGrid(100, a_bCenterLines, C_WHITE);
+	pMesh->SetName(sName);
+	pModel = new Model(pMesh);
+	return AddModel(pModel);
+}
 Model* ModelManager::GenerateSkybox(void)
 {
 	//There can only be one skybox, if needed we would change texture 
@@ -604,86 +696,8 @@ void ModelManager::AddWireSphereToRenderList(matrix4 a_m4ToWorld, vector3 a_v3Co
 }
 void ModelManager::AddLineToRenderList(matrix4 a_m4ToWorld, vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart, vector3 a_v3ColorEnd)
 {
-	//We calculate the orientation of the line and magnify it according to start and end
-	//calculate the orientation
-	vector3 vDirection = glm::normalize(a_v3End - a_v3Start);
-	//Position
-	vector3 v3Middle = (a_v3Start + a_v3End);
-	//Size
-	float fMagnitude = glm::distance(a_v3Start, a_v3End);
-	//Orientation
-	//quaternion qOrientation = glm::angleAxis(vDirection);// quaternion(vDirection);
-	//qOrientation = glm::normalize(qOrientation);
-
-	//http://stackoverflow.com/questions/20923232/how-to-rotate-a-vector-by-a-given-direction
-	matrix3 transform;
-	if (vDirection.y == 0 && vDirection.z == 0)
-	{
-		if (vDirection.x < 0) // rotate 180 degrees
-			transform = matrix3(vector3(-1.0f, 0.0f, 0.0f),
-				vector3(0.0f, -1.0f, 0.0f),
-				vector3(0.0f, 0.0f, 1.0f));
-
-		// else if direction.y >= 0, leave transform as the identity matrix.
-	}
-	else
-	{
-		vector3 new_x = glm::normalize(vDirection);
-		vector3 new_z;
-		if (new_x != AXIS_Y)
-			new_z = glm::normalize(glm::cross(new_x, AXIS_Y));
-		else
-			new_z = AXIS_Z;
-		vector3 new_y = glm::normalize(glm::cross(new_z, new_x));
-
-		transform = matrix3(new_x, new_y, new_z);
-	}
-
-	//Final scale and orientation
-	matrix4 m4ToWorld = glm::translate(IDENTITY_M4, a_v3Start) * matrix4(transform) * glm::scale(IDENTITY_M4, vector3(fMagnitude));
-
-	//Use the default line
-	Model* pModel = m_ModelList[ModelOrder::LINE];
-	String sName = pModel->GetName();
-	
-	//See if we are not using a default white line
-	if (a_v3ColorStart != C_WHITE ||
-		a_v3ColorEnd != C_WHITE )
-	{
-		//If we are not then we may have to make a new line or look for one which is slower
-		//instead of making all possible lines based on two points and two colors we create a 
-		//unit length line based on two colors, and then we scale and orient it.
-		sName = "line_(" +
-			std::to_string(0.0f) + "," +
-			std::to_string(0.0f) + "," +
-			std::to_string(0.0f) + "," +
-			std::to_string(1.0f) + "," +
-			std::to_string(0.0f) + "," +
-			std::to_string(0.0f) + "," +
-			std::to_string(a_v3ColorStart.x) + "," +
-			std::to_string(a_v3ColorStart.y) + "," +
-			std::to_string(a_v3ColorStart.z) + "," +
-			std::to_string(a_v3ColorEnd.x) + "," +
-			std::to_string(a_v3ColorEnd.y) + "," +
-			std::to_string(a_v3ColorEnd.z) + ")";
-		//sName = BTX::ToUppercase(sName);
-		//Try to find a model with this name
-		pModel = GetModel(sName);
-		//if the model does not exist create it
-		if (!pModel)
-			pModel = GenerateLine(vector3(0.0f), vector3(1.0f, 0.0f, 0.0f), a_v3ColorStart, a_v3ColorEnd);
-
-		//This is a non white to white line so we will need to look for the mesh index before printing
-		AddModelToRenderList(pModel, a_m4ToWorld * m4ToWorld, RENDER_WIRE);
-		return;
-	}
-	
-	//We will send the pointer to the line model without checking to remove overhead
-	//this is potentially an issue if we can't be sure of the index in the array of our line
-	//but that is what the enum help us with.
-	
-	//this will remove the overhead of checking if its the right model
-	m_ModelList[ModelOrder::LINE]->AddToRenderList(a_m4ToWorld * m4ToWorld, RENDER_WIRE);
+	//Lines are not models anymore, they go to the debug batch and draw in a single call
+	m_pDebugBatch->AddLine(a_m4ToWorld, a_v3Start, a_v3End, a_v3ColorStart, a_v3ColorEnd);
 }
 void ModelManager::AddAxisToRenderList(matrix4 a_m4ToWorld)
 {
@@ -696,80 +710,32 @@ void ModelManager::AddAxisToRenderList(matrix4 a_m4ToWorld)
 }
 void ModelManager::AddGridToRenderList(matrix4 a_m4ToWorld)
 {
-	//TODO: this is really slow as we are indexing the model of a line 200 times,
-	//repace with a single model created
-	float fSize = 100.0f;
-	float fStart = -fSize/2.0f;
-	for (uint i = 0; i < 101; i++)
-	{
-		AddLineToRenderList(a_m4ToWorld * glm::translate(vector3(0.0f, fStart, 0.0f)), -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_WHITE, C_WHITE);
-		AddLineToRenderList(a_m4ToWorld * glm::translate(vector3(fStart, 0.0f, 0.0f)), -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_WHITE, C_WHITE);
-		fStart += 1.0f;
-	}
+	AddModelToRenderList(GenerateGrid(true), a_m4ToWorld, RENDER_WIRE);
 }
 void ModelManager::AddGridToRenderList()
 {
-	//TODO: this is really slow as we are indexing the model of a line 200 times,
-	//repace with a single model created
 	float fSize = 100.0f;
-	float fStart = -fSize / 2.0f;
-	
+	//The grid model is on the XY plane, the axis lines replace its center lines
 	BTXs::eCAMERAMODE mode = m_pCameraMngr->GetCameraMode();
 	switch (mode)
 	{
 	default:
 	case BTXs::eCAMERAMODE::CAM_PERSP:
 	case BTXs::eCAMERAMODE::CAM_ORTHO_Z:
-		for (uint i = 0; i < 50; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, fStart, 0.0f)), -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(fStart, 0.0f, 0.0f)), -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_RED, C_RED);
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_GREEN, C_GREEN);
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
-		fStart += 1.0f;
-		for (uint i = 51; i < 101; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, fStart, 0.0f)), -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(fStart, 0.0f, 0.0f)), -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
+		AddModelToRenderList(GenerateGrid(false), IDENTITY_M4, RENDER_WIRE);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_RED, C_RED);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_GREEN, C_GREEN);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
 		break;
 	case BTXs::eCAMERAMODE::CAM_ORTHO_Y:
-		for (uint i = 0; i < 50; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, 0.0f, fStart)), -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(fStart, 0.0f, 0.0f)), -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_RED, C_RED);
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
-		fStart += 1.0f;
-		for (uint i = 51; i < 101; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, 0.0f, fStart)), -fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(fStart, 0.0f, 0.0f)), -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
+		AddModelToRenderList(GenerateGrid(false), glm::rotate(IDENTITY_M4, 1.5708f, AXIS_X), RENDER_WIRE);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_X, fSize / 2.0f * AXIS_X, C_RED, C_RED);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
 		break;
 	case BTXs::eCAMERAMODE::CAM_ORTHO_X:
-		for (uint i = 0; i < 50; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, fStart, 0.0f)), -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(0.0f, 0.0f, fStart)), -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_GREEN, C_GREEN);
-		AddLineToRenderList(IDENTITY_M4, -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
-		fStart += 1.0f;
-		for (uint i = 51; i < 101; i++)
-		{
-			AddLineToRenderList(glm::translate(vector3(0.0f, fStart, 0.0f)), -fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_WHITE, C_WHITE);
-			AddLineToRenderList(glm::translate(vector3(0.0f, 0.0f, fStart)), -fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_WHITE, C_WHITE);
-			fStart += 1.0f;
-		}
+		AddModelToRenderList(GenerateGrid(false), glm::rotate(IDENTITY_M4, 1.5708f, AXIS_Y), RENDER_WIRE);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_Y, fSize / 2.0f * AXIS_Y, C_GREEN, C_GREEN);
+		m_pDebugBatch->AddLine(-fSize / 2.0f * AXIS_Z, fSize / 2.0f * AXIS_Z, C_BLUE, C_BLUE);
 		break;
 	}
 }
@@ -852,23 +818,20 @@ bool ModelManager::IsModelInMap(String a_sName)
 bool ModelManager::IsModelInMap(Model* pModel)
 {
 	//look for the value instead of the key
-	for (auto it = m_ModelMap.begin(); it != m_ModelMap.end(); ++it)
-		if (it->second == pModel)
+	uint uCount = GetModelCount();
+	for (uint i = 0; i < uCount; ++i)
+		if (m_ModelList[i] == pModel)
 			return true;
 	return false;
 }
 int ModelManager::GetModelIndex(String a_sName)
 {
-	//Get the count of the model to iterate one by one
-	uint uCount = GetModelCount();
-	for (uint i = 0; i < uCount; ++i)
-	{
-		//If we find the model with that name return the index
-		if (m_ModelList[i]->GetName() == a_sName)
-			return static_cast<int>(i);
-	}
+	//a name that was never interned cannot belong to a model
+	uint* pIndex = m_ModelMap.Find(NameTable::GetInstance()->Find(a_sName));
 	//we couldnt find it return -1
-	return -1;
+	if (pIndex == nullptr)
+		return -1;
+	return static_cast<int>(*pIndex);
 }
 Model* ModelManager::GetModel(String a_sName)
 {
@@ -876,48 +839,11 @@ Model* ModelManager::GetModel(String a_sName)
 	if (a_sName == "")
 		return nullptr;
 
-	//a_sName = BTX::ToUppercase(a_sName);
-
-	//Look for the name in the model map
-	auto it = m_ModelMap.find(a_sName);
-	//If found
-	if (it != m_ModelMap.end())
-	{
-		//return the entry
-		return it->second;
-	}
-
-	//If you couldn't find the model it might be missing the full
-	//address of the model so check for that
-	//Get the extension of the file and send it to uppercase
-	String sExtension = FileReader::GetExtension(a_sName);
-	sExtension = BTX::ToUppercase(sExtension);
-
-	//Check if the file exists and is a known format
-	FolderSingleton* pFolder = FolderSingleton::GetInstance();
-	String sFileName = pFolder->GetFolderRoot();
-	sFileName += pFolder->GetFolderData();
-	if (sExtension == "OBJ")
-	{
-		sFileName += pFolder->GetFolderMOBJ();
-	}
-	//else if (sExtension == "BTO" || sExtension == "ATO")
-	//{
-	//	sFileName += pFolder->GetFolderMBTO();
-	//}
-
-	sFileName += a_sName;
-
-	//sFileName = BTX::ToUppercase(sFileName);
-	it = m_ModelMap.find(sFileName);
-	//If found
-	if (it != m_ModelMap.end())
-	{
-		//return the entry
-		return it->second;
-	}
-
-	return nullptr;
+	//Files are also in the map by their name without the data folder
+	int nIndex = GetModelIndex(a_sName);
+	if (nIndex < 0)
+		return nullptr;
+	return m_ModelList[nIndex];
 }
 uint ModelManager::GetModelCount(void) { return m_ModelList.size(); }
 void ModelManager::ClearRenderList(void)
@@ -927,6 +853,8 @@ void ModelManager::ClearRenderList(void)
 	{
 		m_ModelList[i]->ClearRenderLists();
 	}
+	m_pDebugBatch->Clear();
+	m_pBoundsBatch->Clear();
 	//for (auto it = m_renderOptionsList.begin(); it != m_renderOptionsList.end(); ++it)
 	//{
 	//	(*it)->clear();
@@ -967,9 +895,18 @@ String ModelManager::LoadModel(String a_sFileName)
 	//Check if model exists already
 	Model* pModel = GetModel(a_sFileName);
 	
-	//If it does just return its name
+	//If it does just return its name, wait for it if it is being read in the background
 	if(pModel)
+	{
+		if (pModel->FinishLoading(true))
+		{
+			auto loading = std::find(m_lLoading.begin(), m_lLoading.end(), pModel);
+			if (loading != m_lLoading.end())
+				m_lLoading.erase(loading);
+			m_lAtlasPending.push_back(pModel);
+		}
 		return pModel->GetName();
+	}
 	
 	//If it doesn't, make a new model and load it 
 	pModel = new Model(a_sFileName);
@@ -980,28 +917,115 @@ String ModelManager::LoadModel(String a_sFileName)
 
 	//Add this model pointer to the list
 	pModel = AddModel(pModel);
+	m_lAtlasPending.push_back(pModel);
 
 	//return the name of the model
 	return pModel->GetName();
 }
+String ModelManager::LoadModelAsync(String a_sFileName)
+{
+	//Check if model exists already
+	Model* pModel = GetModel(a_sFileName);
+	if (pModel)
+		return pModel->GetName();
+
+	//The model only knows its name for now, the file is read in the background
+	pModel = new Model(a_sFileName, true, true);
+	if (pModel->GetName() == "")
+	{
+		SafeDelete(pModel);
+		return "";
+	}
+
+	pModel = AddModel(pModel);
+	return pModel->GetName();
+}
+uint ModelManager::UpdateLoads(void)
+{
+	uint uBuilt = 0;
+	for (uint i = 0; i < m_lLoading.size() && uBuilt < m_uLoadBudget;)
+	{
+		if (!m_lLoading[i]->FinishLoading())
+		{
+			++i;
+			continue;
+		}
+		m_lAtlasPending.push_back(m_lLoading[i]);
+		m_lLoading.erase(m_lLoading.begin() + i);
+		++uBuilt;
+	}
+	TextureManager::GetInstance()->UpdateLoads();
+	return m_lLoading.size();
+}
+RenderQueue* ModelManager::GetRenderQueue(void) { return m_pRenderQueue; }
+DebugBatch* ModelManager::GetDebugBatch(void) { return m_pDebugBatch; }
+BoundsBatch* ModelManager::GetBoundsBatch(void) { return m_pBoundsBatch; }
+void ModelManager::SetLoadBudget(uint a_uBudget) { m_uLoadBudget = std::max(a_uBudget, 1u); }
+uint ModelManager::GetLoadBudget(void) { return m_uLoadBudget; }
+void ModelManager::SetLODLevels(uint a_uLevels) { Model::SetLODLevelCount(a_uLevels); }
+uint ModelManager::GetLODLevels(void) { return Model::GetLODLevelCount(); }
+void ModelManager::SetLoadAtlas(bool a_bAtlas) { m_bLoadAtlas = a_bAtlas; }
+bool ModelManager::GetLoadAtlas(void) { return m_bLoadAtlas; }
+uint ModelManager::PackAtlas(void)
+{
+	BTX_PROFILE_ZONE("ModelManager::PackAtlas");
+
+	TextureAtlas atlas("ModelAtlas" + std::to_string(m_uAtlasCount));
+	for (uint i = 0; i < m_lAtlasPending.size(); ++i)
+		m_lAtlasPending[i]->AddMapsToAtlas(&atlas);
+
+	//a single map is already a single texture
+	uint uMoved = 0;
+	if (atlas.GetSourceCount() > 1 && atlas.Pack() > 0)
+	{
+		for (uint i = 0; i < m_lAtlasPending.size(); ++i)
+			uMoved += m_lAtlasPending[i]->ApplyAtlas(&atlas);
+		++m_uAtlasCount;
+	}
+	m_lAtlasPending.clear();
+	return uMoved;
+}
 uint ModelManager::Render(void)
 {
-	//If no custom matrices where provided we use the camera manager's
-	matrix4 m4Projection = m_pCameraMngr->GetProjectionMatrix();
-	matrix4 m4View = m_pCameraMngr->GetViewMatrix();
-	vector3 v3CameraPosition = m_pCameraMngr->GetPosition();
-	return Render(m4Projection, m4View, v3CameraPosition);
+	//If no custom matrices where provided we use the camera manager's, every camera that moved
+	//this frame gets its matrices made once here
+	m_pCameraMngr->UpdateCameras();
+	CameraSnapshot const& camera = m_pCameraMngr->GetSnapshot();
+	return Render(camera.m4Projection, camera.m4View, camera.v3Position);
 }
 uint ModelManager::Render(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3CameraPosition)
 {
+	BTX_PROFILE_ZONE("ModelManager::Render");
+
 	//TODO: sort skyboxes first otherwise semi transp models dont render using that data
 	uint uRenderCalls = 0;
+
+	//Models still loading render as a wire cube where they were asked to be
+	UpdateLoads();
+	if (m_bLoadAtlas && m_lLoading.empty() && !m_lAtlasPending.empty())
+		PackAtlas();
+	for (uint i = 0; i < m_lLoading.size(); ++i)
+	{
+		std::vector<matrix4> lSolid = m_lLoading[i]->GetRenderListSolids();
+		std::vector<matrix4> lWire = m_lLoading[i]->GetRenderListWires();
+		for (uint j = 0; j < lSolid.size(); ++j)
+			m_pDebugBatch->AddWireBox(lSolid[j], C_GRAY);
+		for (uint j = 0; j < lWire.size(); ++j)
+			m_pDebugBatch->AddWireBox(lWire[j], C_GRAY);
+		m_lLoading[i]->ClearRenderLists();
+	}
+
+	//Batch everything and draw it sorted by state, the skybox goes on its own layer before the rest;
+	//the queue gets the camera first so the models can pick the level of detail of each instance
+	m_pRenderQueue->SetView(a_m4Projection, a_m4View);
 	uint uCount = GetModelCount();
-	// Render Solids
 	for (uint i = 0; i < uCount; ++i)
 	{
-		uRenderCalls += m_ModelList[i]->RenderLists(a_m4Projection, a_m4View, a_v3CameraPosition);
+		m_ModelList[i]->AddListsToQueue(m_pRenderQueue, i == ModelOrder::SKYBOX ? 0 : 1);
 	}
+	uRenderCalls += m_pRenderQueue->Render(a_m4Projection, a_m4View, a_v3CameraPosition);
+	uRenderCalls += m_pDebugBatch->Render(a_m4Projection, a_m4View);
+	uRenderCalls += m_pBoundsBatch->Render(a_m4Projection, a_m4View);
 
 	return uRenderCalls;
 }
@@ -0,0 +1,113 @@
+#include "BTX\System\NameTable.h"
+using namespace BTX;
+
+//Name given back for handles that are not valid
+static const String sNoName = "";
+
+NameTable* NameTable::m_pInstance = nullptr;
+NameTable* NameTable::GetInstance(void)
+{
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new NameTable();
+	}
+	return m_pInstance;
+}
+void NameTable::ReleaseInstance(void)
+{
+	if (m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+}
+//The big 3
+NameTable::NameTable(void) { Init(); }
+NameTable::NameTable(NameTable const& other) { }
+NameTable& NameTable::operator=(NameTable const& other) { return *this; }
+NameTable::~NameTable(void) { Release(); }
+void NameTable::Release(void)
+{
+	m_lName.clear();
+	m_lHash.clear();
+	m_lSlot.clear();
+	m_uMask = 0;
+}
+void NameTable::Init(void)
+{
+	m_lSlot.assign(1024, INVALID);
+	m_uMask = static_cast<uint>(m_lSlot.size()) - 1;
+	//the empty name is always the first handle
+	Intern(sNoName);
+}
+//Accessors
+uint NameTable::GetCount(void) { return m_lName.size(); }
+String const& NameTable::GetName(uint a_uHandle)
+{
+	if (a_uHandle >= m_lName.size())
+		return sNoName;
+	return m_lName[a_uHandle];
+}
+unsigned long long NameTable::GetHash(uint a_uHandle)
+{
+	if (a_uHandle >= m_lHash.size())
+		return 0;
+	return m_lHash[a_uHandle];
+}
+//--- Methods
+unsigned long long NameTable::Hash(String const& a_sName)
+{
+	unsigned long long uHash = 14695981039346656037ULL;
+	for (size_t i = 0; i < a_sName.size(); ++i)
+	{
+		uHash ^= static_cast<unsigned char>(a_sName[i]);
+		uHash *= 1099511628211ULL;
+	}
+	return uHash;
+}
+uint NameTable::FindSlot(String const& a_sName, unsigned long long a_uHash)
+{
+	//the strings are only compared when the whole hash matches
+	uint uSlot = static_cast<uint>(a_uHash) & m_uMask;
+	while (m_lSlot[uSlot] != INVALID)
+	{
+		uint uHandle = m_lSlot[uSlot];
+		if (m_lHash[uHandle] == a_uHash && m_lName[uHandle] == a_sName)
+			break;
+		uSlot = (uSlot + 1) & m_uMask;
+	}
+	return uSlot;
+}
+void NameTable::Grow(void)
+{
+	m_lSlot.assign(2 * m_lSlot.size(), INVALID);
+	m_uMask = static_cast<uint>(m_lSlot.size()) - 1;
+	for (uint uHandle = 0; uHandle < m_lHash.size(); ++uHandle)
+	{
+		uint uSlot = static_cast<uint>(m_lHash[uHandle]) & m_uMask;
+		while (m_lSlot[uSlot] != INVALID)
+			uSlot = (uSlot + 1) & m_uMask;
+		m_lSlot[uSlot] = uHandle;
+	}
+}
+uint NameTable::Find(String const& a_sName)
+{
+	return m_lSlot[FindSlot(a_sName, Hash(a_sName))];
+}
+uint NameTable::Intern(String const& a_sName)
+{
+	unsigned long long uHash = Hash(a_sName);
+	uint uSlot = FindSlot(a_sName, uHash);
+	if (m_lSlot[uSlot] != INVALID)
+		return m_lSlot[uSlot];
+
+	uint uHandle = m_lName.size();
+	m_lName.push_back(a_sName);
+	m_lHash.push_back(uHash);
+	//keeps at least half of the slots empty so the runs stay short
+	if (2 * m_lName.size() > m_lSlot.size())
+		Grow();
+	else
+		m_lSlot[uSlot] = uHandle;
+	return uHandle;
+}
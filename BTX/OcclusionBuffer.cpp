@@ -0,0 +1,370 @@
+#include "BTX\Camera\OcclusionBuffer.h"
+using namespace BTX;
+
+//Corners of a box closer than this to the plane of the camera are treated as behind it
+static const float fOcclusionMinW = 0.00001f;
+//Rows each thread draws at least, thinner bands are not worth the thread
+static const uint uOcclusionMinBandRows = 16;
+//Faces of a box as corners (bit 0 is x, bit 1 is y and bit 2 is z of the maximum corner),
+//counter clockwise seen from outside
+static const uint uOcclusionFace[6][4] = {
+	{ 0, 4, 6, 2 }, { 1, 3, 7, 5 }, //-X, +X
+	{ 0, 1, 5, 4 }, { 2, 6, 7, 3 }, //-Y, +Y
+	{ 0, 2, 3, 1 }, { 4, 5, 7, 6 }  //-Z, +Z
+};
+
+//Projects the corners of a box to pixels of the buffer with the inverse of their w as depth,
+//false if any is behind the near plane. 1 / w is linear across the screen like z / w but keeps
+//its precision far from the near plane, so it is the depth of the buffer: larger is nearer
+static bool ProjectBox(matrix4 const& a_m4Clip, vector3 const& a_v3Min, vector3 const& a_v3Max,
+	float a_fWidth, float a_fHeight, vector3* a_pCorner)
+{
+	//the matrix is linear, the corners are the minimum plus the columns scaled by the size;
+	//one list per component so the compiler can make the eight corners at once
+	vector3 v3Size = a_v3Max - a_v3Min;
+	vector4 v4Base = a_m4Clip * vector4(a_v3Min, 1.0f);
+	float fClip[4][8];
+	for (uint c = 0; c < 4; ++c)
+	{
+		float fX = a_m4Clip[0][c] * v3Size.x;
+		float fY = a_m4Clip[1][c] * v3Size.y;
+		float fZ = a_m4Clip[2][c] * v3Size.z;
+		fClip[c][0] = v4Base[c];
+		fClip[c][1] = v4Base[c] + fX;
+		fClip[c][2] = v4Base[c] + fY;
+		fClip[c][3] = v4Base[c] + fX + fY;
+		for (uint i = 0; i < 4; ++i)
+			fClip[c][i + 4] = fClip[c][i] + fZ;
+	}
+	bool bInFront = true;
+	for (uint i = 0; i < 8; ++i)
+		bInFront &= fClip[3][i] > fOcclusionMinW && fClip[2][i] >= -fClip[3][i];
+	if (!bInFront)
+		return false;
+	float fHalfWidth = a_fWidth * 0.5f;
+	float fHalfHeight = a_fHeight * 0.5f;
+	for (uint i = 0; i < 8; ++i)
+	{
+		float fInvW = 1.0f / fClip[3][i];
+		a_pCorner[i].x = (fClip[0][i] * fInvW + 1.0f) * fHalfWidth;
+		a_pCorner[i].y = (fClip[1][i] * fInvW + 1.0f) * fHalfHeight;
+		a_pCorner[i].z = fInvW;
+	}
+	return true;
+}
+//Twice the signed area of a triangle in pixels, positive if counter clockwise
+static float Cross2D(vector3 const& a_v3A, vector3 const& a_v3B, vector3 const& a_v3C)
+{
+	return (a_v3B.x - a_v3A.x) * (a_v3C.y - a_v3A.y) - (a_v3B.y - a_v3A.y) * (a_v3C.x - a_v3A.x);
+}
+
+//The big 3
+OcclusionBuffer::OcclusionBuffer(uint a_uWidth, uint a_uHeight)
+{
+	Init();
+	SetResolution(a_uWidth, a_uHeight);
+}
+OcclusionBuffer::OcclusionBuffer(OcclusionBuffer const& other)
+{
+	Init();
+	m_uWidth = other.m_uWidth;
+	m_uHeight = other.m_uHeight;
+	m_uThreads = other.m_uThreads;
+	m_m4ViewProjection = other.m_m4ViewProjection;
+	m_lOccluder = other.m_lOccluder;
+	m_lLevel = other.m_lLevel;
+	m_lLevelWidth = other.m_lLevelWidth;
+	m_lLevelHeight = other.m_lLevelHeight;
+}
+OcclusionBuffer& OcclusionBuffer::operator=(OcclusionBuffer const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		OcclusionBuffer temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+OcclusionBuffer::~OcclusionBuffer(void) { Release(); }
+void OcclusionBuffer::Swap(OcclusionBuffer& other)
+{
+	std::swap(m_uWidth, other.m_uWidth);
+	std::swap(m_uHeight, other.m_uHeight);
+	std::swap(m_uThreads, other.m_uThreads);
+	std::swap(m_m4ViewProjection, other.m_m4ViewProjection);
+	std::swap(m_lOccluder, other.m_lOccluder);
+	std::swap(m_lLevel, other.m_lLevel);
+	std::swap(m_lLevelWidth, other.m_lLevelWidth);
+	std::swap(m_lLevelHeight, other.m_lLevelHeight);
+}
+void OcclusionBuffer::Release(void)
+{
+	m_lOccluder.clear();
+	m_lLevel.clear();
+	m_lLevelWidth.clear();
+	m_lLevelHeight.clear();
+}
+void OcclusionBuffer::Init(void) { }
+//Accessors
+uint OcclusionBuffer::GetWidth(void) { return m_uWidth; }
+uint OcclusionBuffer::GetHeight(void) { return m_uHeight; }
+void OcclusionBuffer::SetThreadCount(uint a_uThreads) { m_uThreads = a_uThreads; }
+uint OcclusionBuffer::GetThreadCount(void) { return m_uThreads; }
+uint OcclusionBuffer::GetOccluderCount(void) { return m_lOccluder.size(); }
+float OcclusionBuffer::GetDepth(uint a_uX, uint a_uY)
+{
+	if (a_uX >= m_uWidth || a_uY >= m_uHeight)
+		return 0.0f;
+	return m_lLevel[0][a_uY * m_uWidth + a_uX];
+}
+void OcclusionBuffer::SetResolution(uint a_uWidth, uint a_uHeight)
+{
+	m_uWidth = std::max(a_uWidth, 1u);
+	m_uHeight = std::max(a_uHeight, 1u);
+	m_lLevel.clear();
+	m_lLevelWidth.clear();
+	m_lLevelHeight.clear();
+	uint uWidth = m_uWidth;
+	uint uHeight = m_uHeight;
+	for (;;)
+	{
+		m_lLevel.push_back(std::vector<float>(uWidth * uHeight, 0.0f));
+		m_lLevelWidth.push_back(uWidth);
+		m_lLevelHeight.push_back(uHeight);
+		if (uWidth == 1 && uHeight == 1)
+			break;
+		uWidth = (uWidth + 1) / 2;
+		uHeight = (uHeight + 1) / 2;
+	}
+	m_lOccluder.clear();
+}
+//--- Methods
+void OcclusionBuffer::Begin(matrix4 a_m4ViewProjection)
+{
+	m_m4ViewProjection = a_m4ViewProjection;
+	m_lOccluder.clear();
+}
+bool OcclusionBuffer::AddOccluder(matrix4 a_m4ToWorld, vector3 a_v3Min, vector3 a_v3Max)
+{
+	vector3 v3Corner[8];
+	if (!ProjectBox(m_m4ViewProjection * a_m4ToWorld, a_v3Min, a_v3Max,
+		static_cast<float>(m_uWidth), static_cast<float>(m_uHeight), v3Corner))
+		return false;
+
+	//outline of the box, the convex hull of its corners counter clockwise (monotone chain)
+	vector3 v3Sorted[8];
+	std::copy(v3Corner, v3Corner + 8, v3Sorted);
+	std::sort(v3Sorted, v3Sorted + 8, [](vector3 const& a_v3A, vector3 const& a_v3B)
+	{
+		return a_v3A.x < a_v3B.x || (a_v3A.x == a_v3B.x && a_v3A.y < a_v3B.y);
+	});
+	vector3 v3Hull[16];
+	int nHull = 0;
+	for (int i = 0; i < 8; ++i)
+	{
+		while (nHull >= 2 && Cross2D(v3Hull[nHull - 2], v3Hull[nHull - 1], v3Sorted[i]) <= 0.0f)
+			--nHull;
+		v3Hull[nHull++] = v3Sorted[i];
+	}
+	for (int i = 6, nLower = nHull + 1; i >= 0; --i)
+	{
+		while (nHull >= nLower && Cross2D(v3Hull[nHull - 2], v3Hull[nHull - 1], v3Sorted[i]) <= 0.0f)
+			--nHull;
+		v3Hull[nHull++] = v3Sorted[i];
+	}
+	--nHull; //the first point closes the loop
+	//a box outline has six sides at most, more means rounding got in the way
+	if (nHull < 3 || nHull > 6)
+		return false;
+
+	Occluder occluder;
+	float fRowMin = v3Hull[0].y;
+	float fRowMax = v3Hull[0].y;
+	for (int i = 0; i < nHull; ++i)
+	{
+		vector3 const& v3A = v3Hull[i];
+		vector3 const& v3B = v3Hull[(i + 1) % nHull];
+		//left of the edge is inside, the corner of the pixel furthest out has to be inside too
+		float fA = v3A.y - v3B.y;
+		float fB = v3B.x - v3A.x;
+		float fC = -(fA * v3A.x + fB * v3A.y);
+		fC += 0.5f * (fA + fB) - 0.5f * (std::abs(fA) + std::abs(fB));
+		occluder.v3Edge[occluder.uEdges++] = vector3(fA, fB, fC);
+		fRowMin = std::min(fRowMin, v3A.y);
+		fRowMax = std::max(fRowMax, v3A.y);
+	}
+
+	//a ray enters a convex box through the farthest of the front faces it crosses, their
+	//depths are planes in the buffer so the depth of a pixel is the farthest of the planes
+	float fMirror = glm::determinant(matrix3(a_m4ToWorld)) < 0.0f ? -1.0f : 1.0f;
+	for (uint i = 0; i < 6 && occluder.uPlanes < 3; ++i)
+	{
+		vector3 const& v3A = v3Corner[uOcclusionFace[i][0]];
+		vector3 const& v3B = v3Corner[uOcclusionFace[i][1]];
+		vector3 const& v3C = v3Corner[uOcclusionFace[i][2]];
+		vector3 v3Normal = glm::cross(v3B - v3A, v3C - v3A);
+		//faces seen from behind or edge on
+		if (v3Normal.z * fMirror <= 0.01f)
+			continue;
+		float fA = -v3Normal.x / v3Normal.z;
+		float fB = -v3Normal.y / v3Normal.z;
+		float fC = v3A.z - fA * v3A.x - fB * v3A.y;
+		fC += 0.5f * (fA + fB) - 0.5f * (std::abs(fA) + std::abs(fB));
+		occluder.v3Plane[occluder.uPlanes++] = vector3(fA, fB, fC);
+	}
+	if (occluder.uPlanes == 0)
+		return false;
+	//unused planes repeat the first one so every pixel takes the farthest of three
+	for (uint i = occluder.uPlanes; i < 3; ++i)
+		occluder.v3Plane[i] = occluder.v3Plane[0];
+
+	occluder.nRowMin = std::max(static_cast<int>(std::floor(fRowMin)), 0);
+	occluder.nRowMax = std::min(static_cast<int>(std::floor(fRowMax)), static_cast<int>(m_uHeight) - 1);
+	if (occluder.nRowMin > occluder.nRowMax)
+		return false;
+	m_lOccluder.push_back(occluder);
+	return true;
+}
+void OcclusionBuffer::RasterizeBand(int a_nRowBegin, int a_nRowEnd)
+{
+	float* pDepth = m_lLevel[0].data();
+	int nWidth = static_cast<int>(m_uWidth);
+	std::fill(pDepth + a_nRowBegin * nWidth, pDepth + a_nRowEnd * nWidth, 0.0f);
+
+	for (uint i = 0; i < m_lOccluder.size(); ++i)
+	{
+		Occluder const& occluder = m_lOccluder[i];
+		int nRowBegin = std::max(occluder.nRowMin, a_nRowBegin);
+		int nRowEnd = std::min(occluder.nRowMax + 1, a_nRowEnd);
+		for (int y = nRowBegin; y < nRowEnd; ++y)
+		{
+			float fY = static_cast<float>(y);
+			//the edges are straight so the covered pixels of a row are a single span
+			float fLeft = 0.0f;
+			float fRight = static_cast<float>(nWidth - 1);
+			for (uint j = 0; j < occluder.uEdges; ++j)
+			{
+				vector3 const& v3Edge = occluder.v3Edge[j];
+				float fValue = v3Edge.y * fY + v3Edge.z;
+				if (v3Edge.x > 0.0f)
+					fLeft = std::max(fLeft, std::ceil(-fValue / v3Edge.x));
+				else if (v3Edge.x < 0.0f)
+					fRight = std::min(fRight, std::floor(-fValue / v3Edge.x));
+				else if (fValue < 0.0f)
+					fRight = -1.0f;
+			}
+			if (fLeft > fRight)
+				continue;
+
+			//no branches in the span, the compiler can write several pixels per instruction
+			int nLeft = static_cast<int>(fLeft);
+			int nRight = static_cast<int>(fRight);
+			float* pRow = pDepth + y * nWidth;
+			float fA0 = occluder.v3Plane[0].x, fK0 = occluder.v3Plane[0].y * fY + occluder.v3Plane[0].z;
+			float fA1 = occluder.v3Plane[1].x, fK1 = occluder.v3Plane[1].y * fY + occluder.v3Plane[1].z;
+			float fA2 = occluder.v3Plane[2].x, fK2 = occluder.v3Plane[2].y * fY + occluder.v3Plane[2].z;
+			for (int x = nLeft; x <= nRight; ++x)
+			{
+				float fX = static_cast<float>(x);
+				float fDepth = std::min(std::min(fA0 * fX + fK0, fA1 * fX + fK1), fA2 * fX + fK2);
+				pRow[x] = std::max(pRow[x], fDepth);
+			}
+		}
+	}
+}
+void OcclusionBuffer::BuildPyramid(void)
+{
+	for (uint l = 1; l < m_lLevel.size(); ++l)
+	{
+		float const* pBelow = m_lLevel[l - 1].data();
+		float* pLevel = m_lLevel[l].data();
+		uint uBelowWidth = m_lLevelWidth[l - 1];
+		uint uBelowHeight = m_lLevelHeight[l - 1];
+		uint uWidth = m_lLevelWidth[l];
+		uint uHeight = m_lLevelHeight[l];
+		for (uint y = 0; y < uHeight; ++y)
+		{
+			//odd sizes repeat the last row or column
+			float const* pRow0 = pBelow + (y * 2) * uBelowWidth;
+			float const* pRow1 = pBelow + std::min(y * 2 + 1, uBelowHeight - 1) * uBelowWidth;
+			float* pRow = pLevel + y * uWidth;
+			uint uPairs = uBelowWidth / 2;
+			for (uint x = 0; x < uPairs; ++x)
+				pRow[x] = std::min(std::min(pRow0[x * 2], pRow0[x * 2 + 1]), std::min(pRow1[x * 2], pRow1[x * 2 + 1]));
+			if (uPairs < uWidth)
+				pRow[uPairs] = std::min(pRow0[uBelowWidth - 1], pRow1[uBelowWidth - 1]);
+		}
+	}
+}
+void OcclusionBuffer::Rasterize(void)
+{
+	BTX_PROFILE_ZONE("OcclusionBuffer::Rasterize");
+	uint uThreads = m_uThreads;
+	if (uThreads == 0)
+		uThreads = std::thread::hardware_concurrency();
+	uThreads = std::max(1u, std::min(std::min(uThreads, m_uHeight / uOcclusionMinBandRows), 8u));
+	if (m_lOccluder.empty())
+		uThreads = 1;
+
+	//each thread owns a band of rows and draws every occluder that touches it, the calling
+	//thread takes the first band
+	int nHeight = static_cast<int>(m_uHeight);
+	std::vector<std::thread> lThread;
+	for (uint i = 1; i < uThreads; ++i)
+	{
+		int nBegin = (nHeight * static_cast<int>(i)) / static_cast<int>(uThreads);
+		int nEnd = (nHeight * static_cast<int>(i + 1)) / static_cast<int>(uThreads);
+		lThread.push_back(std::thread(&OcclusionBuffer::RasterizeBand, this, nBegin, nEnd));
+	}
+	RasterizeBand(0, nHeight / static_cast<int>(uThreads));
+	for (uint i = 0; i < lThread.size(); ++i)
+		lThread[i].join();
+
+	BuildPyramid();
+}
+bool OcclusionBuffer::IsBoxOccluded(vector3 a_v3Min, vector3 a_v3Max)
+{
+	if (m_lOccluder.empty())
+		return false;
+	vector3 v3Corner[8];
+	if (!ProjectBox(m_m4ViewProjection, a_v3Min, a_v3Max,
+		static_cast<float>(m_uWidth), static_cast<float>(m_uHeight), v3Corner))
+		return false;
+
+	float fMinX = v3Corner[0].x, fMaxX = v3Corner[0].x;
+	float fMinY = v3Corner[0].y, fMaxY = v3Corner[0].y;
+	float fNearest = v3Corner[0].z;
+	for (uint i = 1; i < 8; ++i)
+	{
+		fMinX = std::min(fMinX, v3Corner[i].x);
+		fMaxX = std::max(fMaxX, v3Corner[i].x);
+		fMinY = std::min(fMinY, v3Corner[i].y);
+		fMaxY = std::max(fMaxY, v3Corner[i].y);
+		fNearest = std::max(fNearest, v3Corner[i].z);
+	}
+	//the part off the screen cannot be seen anyway, only the pixels on it are tested
+	int nX0 = std::max(static_cast<int>(std::floor(fMinX)), 0);
+	int nY0 = std::max(static_cast<int>(std::floor(fMinY)), 0);
+	int nX1 = std::min(static_cast<int>(std::floor(fMaxX)), static_cast<int>(m_uWidth) - 1);
+	int nY1 = std::min(static_cast<int>(std::floor(fMaxY)), static_cast<int>(m_uHeight) - 1);
+	if (nX0 > nX1 || nY0 > nY1)
+		return false;
+
+	//the level where the outline spans two texels at most each way
+	uint uLevel = 0;
+	while (uLevel + 1 < m_lLevel.size() && ((nX1 >> uLevel) - (nX0 >> uLevel) > 1 || (nY1 >> uLevel) - (nY0 >> uLevel) > 1))
+		++uLevel;
+	std::vector<float> const& lLevel = m_lLevel[uLevel];
+	uint uWidth = m_lLevelWidth[uLevel];
+	for (int y = nY0 >> uLevel; y <= (nY1 >> uLevel); ++y)
+	{
+		for (int x = nX0 >> uLevel; x <= (nX1 >> uLevel); ++x)
+		{
+			if (fNearest >= lLevel[y * uWidth + x])
+				return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,251 @@
+#include "BTX\System\Profiler.h"
+using namespace BTX;
+
+//Events of one thread; only its thread pushes them and only EndFrame pops them
+struct BTX::ProfileBuffer
+{
+	static const uint uCapacity = 4096; //Events that fit before new ones are dropped
+	SPSCQueue<ProfileEvent> lEvent; //Events recorded by the thread and not read yet
+	std::atomic<uint> uDropped; //Events the thread dropped because the queue was full
+	uint uThread = 0; //Index of the thread in the trace
+	ProfileBuffer(void) : lEvent(uCapacity), uDropped(0) {}
+};
+
+static std::atomic<uint> uProfilerGeneration(1); //Changes every time the singleton is released
+static const std::chrono::steady_clock::time_point ProfilerClockStart = std::chrono::steady_clock::now();
+
+//Buffer of the calling thread and the singleton it belongs to
+static thread_local ProfileBuffer* pThreadBuffer = nullptr;
+static thread_local uint uThreadGeneration = 0;
+
+Profiler* Profiler::m_pInstance = nullptr;
+std::atomic<bool> Profiler::m_bEnabled(false);
+Profiler* Profiler::GetInstance(void)
+{
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new Profiler();
+	}
+	return m_pInstance;
+}
+void Profiler::ReleaseInstance(void)
+{
+	m_bEnabled = false;
+	if (m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+	//the threads will make new buffers if a new profiler is made
+	uProfilerGeneration++;
+}
+//The big 3
+Profiler::Profiler(void) { Init(); }
+Profiler::Profiler(Profiler const& other) {}
+Profiler& Profiler::operator=(Profiler const& other) { return *this; }
+Profiler::~Profiler(void) { Release(); }
+void Profiler::Init(void)
+{
+	m_uHistorySize = 120;
+	m_bCapturing = false;
+	m_uCaptureLimit = 1000000;
+	m_uDropped = 0;
+	m_uFrameStart = GetTime();
+}
+void Profiler::Release(void)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (uint i = 0; i < m_lBuffer.size(); i++)
+	{
+		SafeDelete(m_lBuffer[i]);
+	}
+	m_lBuffer.clear();
+	m_lZone.clear();
+	m_mZonePointer.clear();
+	m_mZoneName.clear();
+	m_lCapture.clear();
+}
+//Accessors
+void Profiler::SetEnabled(bool a_bEnabled)
+{
+	if (a_bEnabled)
+		GetInstance()->m_uFrameStart = GetTime();
+	m_bEnabled = a_bEnabled;
+}
+unsigned long long Profiler::GetTime(void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - ProfilerClockStart).count();
+}
+uint Profiler::GetZoneCount(void) { return m_lZone.size(); }
+ProfileStat Profiler::GetZoneStat(uint a_uIndex)
+{
+	if (a_uIndex >= m_lZone.size())
+		return ProfileStat();
+	return m_lZone[a_uIndex].stat;
+}
+void Profiler::SetHistorySize(uint a_uFrames)
+{
+	if (a_uFrames < 1)
+		a_uFrames = 1;
+	m_uHistorySize = a_uFrames;
+	for (uint i = 0; i < m_lZone.size(); i++)
+	{
+		m_lZone[i].lFrameMs.clear();
+		m_lZone[i].uNext = 0;
+	}
+}
+uint Profiler::GetDroppedCount(void) { return m_uDropped; }
+void Profiler::StartCapture(uint a_uLimit)
+{
+	m_lCapture.clear();
+	m_uCaptureLimit = a_uLimit;
+	m_bCapturing = true;
+}
+void Profiler::StopCapture(void) { m_bCapturing = false; }
+bool Profiler::IsCapturing(void) { return m_bCapturing; }
+uint Profiler::GetCaptureSize(void) { return m_lCapture.size(); }
+//--- Methods
+ProfileBuffer* Profiler::GetThreadBuffer(void)
+{
+	uint uGeneration = uProfilerGeneration.load(std::memory_order_relaxed);
+	if (pThreadBuffer != nullptr && uThreadGeneration == uGeneration)
+		return pThreadBuffer;
+
+	//first zone of this thread, the buffer belongs to the profiler so it outlives the thread
+	ProfileBuffer* pBuffer = new ProfileBuffer();
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		pBuffer->uThread = m_lBuffer.size();
+		m_lBuffer.push_back(pBuffer);
+	}
+	pThreadBuffer = pBuffer;
+	uThreadGeneration = uGeneration;
+	return pBuffer;
+}
+void Profiler::Record(const char* a_sName, unsigned long long a_uStart, unsigned long long a_uEnd)
+{
+	if (!IsEnabled() || m_pInstance == nullptr)
+		return;
+
+	ProfileBuffer* pBuffer = m_pInstance->GetThreadBuffer();
+	ProfileEvent event;
+	event.sName = a_sName;
+	event.uStart = a_uStart;
+	event.uEnd = a_uEnd;
+	event.uThread = pBuffer->uThread;
+	//the queue publishes the event once it is complete and never writes over one EndFrame has not read
+	if (!pBuffer->lEvent.TryPush(event))
+		pBuffer->uDropped.fetch_add(1, std::memory_order_relaxed);
+}
+uint Profiler::GetZoneIndex(const char* a_sName)
+{
+	auto pointer = m_mZonePointer.find(a_sName);
+	if (pointer != m_mZonePointer.end())
+		return pointer->second;
+
+	//the same name can live at different addresses in different modules
+	String sName = a_sName;
+	uint uIndex;
+	auto name = m_mZoneName.find(sName);
+	if (name != m_mZoneName.end())
+	{
+		uIndex = name->second;
+	}
+	else
+	{
+		uIndex = m_lZone.size();
+		ZoneHistory zone;
+		zone.sName = sName;
+		zone.stat.sName = sName;
+		m_lZone.push_back(zone);
+		m_mZoneName[sName] = uIndex;
+	}
+	m_mZonePointer[a_sName] = uIndex;
+	return uIndex;
+}
+void Profiler::EndFrame(void)
+{
+	if (!IsEnabled())
+		return;
+
+	unsigned long long uNow = GetTime();
+	Record("Frame", m_uFrameStart, uNow);
+	m_uFrameStart = uNow;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (uint b = 0; b < m_lBuffer.size(); b++)
+	{
+		ProfileBuffer* pBuffer = m_lBuffer[b];
+		m_uDropped += pBuffer->uDropped.exchange(0, std::memory_order_relaxed);
+
+		//only the events that were there when the frame closed, a thread that keeps recording
+		//leaves the rest for the next frame
+		size_t uCount = pBuffer->lEvent.GetSize();
+		ProfileEvent event;
+		for (size_t i = 0; i < uCount && pBuffer->lEvent.TryPop(event); i++)
+		{
+			ZoneHistory& zone = m_lZone[GetZoneIndex(event.sName)];
+			zone.uCalls++;
+			zone.dFrameMs += (event.uEnd - event.uStart) / 1000000.0;
+			if (m_bCapturing && m_lCapture.size() < m_uCaptureLimit)
+				m_lCapture.push_back(event);
+		}
+	}
+
+	//close the frame of every zone, the ones that were not entered count as 0
+	for (uint i = 0; i < m_lZone.size(); i++)
+	{
+		ZoneHistory& zone = m_lZone[i];
+		float fFrameMs = static_cast<float>(zone.dFrameMs);
+		if (zone.lFrameMs.size() < m_uHistorySize)
+			zone.lFrameMs.push_back(fFrameMs);
+		else
+			zone.lFrameMs[zone.uNext] = fFrameMs;
+		zone.uNext = (zone.uNext + 1) % m_uHistorySize;
+
+		float fTotal = 0.0f;
+		float fMax = 0.0f;
+		for (uint j = 0; j < zone.lFrameMs.size(); j++)
+		{
+			fTotal += zone.lFrameMs[j];
+			fMax = std::max(fMax, zone.lFrameMs[j]);
+		}
+		zone.stat.uCalls = zone.uCalls;
+		zone.stat.fLastMs = fFrameMs;
+		zone.stat.fAverageMs = fTotal / zone.lFrameMs.size();
+		zone.stat.fMaxMs = fMax;
+
+		zone.uCalls = 0;
+		zone.dFrameMs = 0.0;
+	}
+}
+eBTX_OUTPUT Profiler::SaveChromeTrace(String a_sFileName)
+{
+	std::ofstream file(a_sFileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return OUT_ERR_FILE;
+
+	//Trace Event Format, complete events with times in microseconds
+	file << "{\"traceEvents\":[\n";
+	char sLine[512];
+	for (uint i = 0; i < m_lCapture.size(); i++)
+	{
+		ProfileEvent& event = m_lCapture[i];
+		String sName = event.sName;
+		for (uint c = 0; c < sName.size(); c++)
+		{
+			if (sName[c] == '"' || sName[c] == '\\')
+				sName[c] = '_';
+		}
+		snprintf(sLine, sizeof(sLine), "{\"name\":\"%s\",\"cat\":\"BTX\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}%s\n",
+			sName.c_str(), event.uStart / 1000.0, (event.uEnd - event.uStart) / 1000.0, event.uThread,
+			i + 1 < m_lCapture.size() ? "," : "");
+		file << sLine;
+	}
+	file << "],\"displayTimeUnit\":\"ms\"}\n";
+	file.close();
+	return OUT_ERR_NONE;
+}
+//ProfileZone
+ProfileZone::ProfileZone(ProfileZone const& other) {}
+ProfileZone& ProfileZone::operator=(ProfileZone const& other) { return *this; }
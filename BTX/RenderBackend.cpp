@@ -0,0 +1,415 @@
+#include "BTX\System\RenderBackend.h"
+using namespace BTX;
+
+//Format of the binaries the null backend gives, no driver uses it
+static const GLenum eNullBinaryFormat = 0x4C4C554E; //"NULL"
+
+//RenderBackend
+RenderBackend* RenderBackend::m_pInstance = nullptr;
+RenderBackend* RenderBackend::GetInstance(void)
+{
+	if (m_pInstance == nullptr)
+	{
+		m_pInstance = new GLRenderBackend();
+	}
+	return m_pInstance;
+}
+void RenderBackend::ReleaseInstance(void)
+{
+	if (m_pInstance != nullptr)
+	{
+		delete m_pInstance;
+		m_pInstance = nullptr;
+	}
+}
+void RenderBackend::SetBackend(eBTX_BACKEND a_eBackend)
+{
+	if (m_pInstance != nullptr && m_pInstance->GetType() == a_eBackend)
+		return;
+
+	ReleaseInstance();
+	if (a_eBackend == BACKEND_NULL)
+		m_pInstance = new NullRenderBackend();
+	else
+		m_pInstance = new GLRenderBackend();
+}
+//GLRenderBackend
+eBTX_BACKEND GLRenderBackend::GetType(void) { return BACKEND_OPENGL; }
+GLuint GLRenderBackend::CreateVertexArray(void)
+{
+	GLuint uVertexArray = 0;
+	glGenVertexArrays(1, &uVertexArray);
+	return uVertexArray;
+}
+void GLRenderBackend::DeleteVertexArray(GLuint a_uVertexArray) { glDeleteVertexArrays(1, &a_uVertexArray); }
+GLuint GLRenderBackend::CreateBuffer(void)
+{
+	GLuint uBuffer = 0;
+	glGenBuffers(1, &uBuffer);
+	return uBuffer;
+}
+void GLRenderBackend::DeleteBuffer(GLuint a_uBuffer) { glDeleteBuffers(1, &a_uBuffer); }
+GLuint GLRenderBackend::CreateTexture(void)
+{
+	GLuint uTexture = 0;
+	glGenTextures(1, &uTexture);
+	return uTexture;
+}
+void GLRenderBackend::DeleteTexture(GLuint a_uTexture) { glDeleteTextures(1, &a_uTexture); }
+GLuint GLRenderBackend::CreateProgram(String a_sVertexSource, String a_sFragmentSource)
+{
+	// Compile Vertex Shader
+	GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
+	char const * VertexSourcePointer = a_sVertexSource.c_str();
+	glShaderSource(VertexShaderID, 1, &VertexSourcePointer, NULL);
+	glCompileShader(VertexShaderID);
+
+	// Compile Fragment Shader
+	GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+	char const * FragmentSourcePointer = a_sFragmentSource.c_str();
+	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer, NULL);
+	glCompileShader(FragmentShaderID);
+
+	//Link the program
+	GLuint ProgramID = glCreateProgram();
+	glAttachShader(ProgramID, VertexShaderID);
+	glAttachShader(ProgramID, FragmentShaderID);
+	//Ask the driver to keep the binary so the shader cache can save it
+	if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+		glProgramParameteri(ProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(ProgramID);
+
+	// Check the program
+	GLint Result = GL_FALSE;
+	int InfoLogLength;
+	glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
+	glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if (InfoLogLength > 0)
+	{
+		std::vector<char> ProgramErrorMessage(InfoLogLength + 1);
+		glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
+		printf("%s\n", &ProgramErrorMessage[0]);
+	}
+
+	glDeleteShader(VertexShaderID);
+	glDeleteShader(FragmentShaderID);
+
+	return ProgramID;
+}
+void GLRenderBackend::DeleteProgram(GLuint a_uProgram) { glDeleteProgram(a_uProgram); }
+String GLRenderBackend::GetDriverID(void)
+{
+	const char* sVendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+	const char* sRenderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+	const char* sVersion = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	String sDriver = sVendor ? sVendor : "";
+	sDriver += "|";
+	sDriver += sRenderer ? sRenderer : "";
+	sDriver += "|";
+	sDriver += sVersion ? sVersion : "";
+	return sDriver;
+}
+bool GLRenderBackend::GetProgramBinary(GLuint a_uProgram, std::vector<char>& a_lBinary, GLenum& a_eFormat)
+{
+	a_lBinary.clear();
+	if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+		return false;
+
+	//A driver can support the extension and still have no format to give
+	GLint nFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &nFormats);
+	GLint nLength = 0;
+	glGetProgramiv(a_uProgram, GL_PROGRAM_BINARY_LENGTH, &nLength);
+	if (nFormats <= 0 || nLength <= 0)
+		return false;
+
+	GLsizei nWritten = 0;
+	a_lBinary.resize(nLength);
+	glGetProgramBinary(a_uProgram, nLength, &nWritten, &a_eFormat, &a_lBinary[0]);
+	a_lBinary.resize(nWritten);
+	return nWritten > 0;
+}
+GLuint GLRenderBackend::CreateProgramFromBinary(GLenum a_eFormat, const void* a_pBinary, uint a_uBytes)
+{
+	if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+		return 0;
+
+	GLuint ProgramID = glCreateProgram();
+	glProgramBinary(ProgramID, a_eFormat, a_pBinary, a_uBytes);
+
+	//A driver update can reject binaries it made before, the caller compiles from source then
+	GLint Result = GL_FALSE;
+	glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
+	if (Result == GL_FALSE)
+	{
+		glDeleteProgram(ProgramID);
+		return 0;
+	}
+	return ProgramID;
+}
+void GLRenderBackend::BindBuffer(GLenum a_eTarget, GLuint a_uBuffer) { glBindBuffer(a_eTarget, a_uBuffer); }
+void GLRenderBackend::BufferData(GLenum a_eTarget, uint a_uBytes, const void* a_pData, GLenum a_eUsage)
+{
+	glBufferData(a_eTarget, a_uBytes, a_pData, a_eUsage);
+}
+void GLRenderBackend::VertexAttribute(GLuint a_uIndex, GLint a_nComponents, GLsizei a_nStride, uint a_uOffset)
+{
+	glEnableVertexAttribArray(a_uIndex);
+	glVertexAttribPointer(a_uIndex, a_nComponents, GL_FLOAT, GL_FALSE, a_nStride, (GLvoid*)(size_t)a_uOffset);
+}
+void GLRenderBackend::VertexDivisor(GLuint a_uIndex, GLuint a_uDivisor) { glVertexAttribDivisor(a_uIndex, a_uDivisor); }
+bool GLRenderBackend::TextureImage(GLuint a_uTexture, int a_nWidth, int a_nHeight, const void* a_pPixels, uint a_uLevels,
+	GLenum a_eFormat)
+{
+	glBindTexture(GL_TEXTURE_2D, a_uTexture); //Set the active texture
+	//BGRA is what the driver keeps internally, it takes it without swizzling
+	const GLubyte* pLevel = static_cast<const GLubyte*>(a_pPixels);
+	int nWidth = a_nWidth;
+	int nHeight = a_nHeight;
+	for (uint uLevel = 0; uLevel < a_uLevels; ++uLevel)
+	{
+		glTexImage2D(GL_TEXTURE_2D, uLevel, GL_RGBA, nWidth, nHeight, 0, a_eFormat, GL_UNSIGNED_BYTE, (GLvoid*)pLevel); //Set the data
+		pLevel += 4 * nWidth * nHeight;
+		nWidth = std::max(nWidth / 2, 1);
+		nHeight = std::max(nHeight / 2, 1);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, a_uLevels > 0 ? a_uLevels - 1 : 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, a_uLevels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return glGetError() == GL_NO_ERROR;
+}
+void GLRenderBackend::UseProgram(GLuint a_uProgram) { glUseProgram(a_uProgram); }
+void GLRenderBackend::BindVertexArray(GLuint a_uVertexArray) { glBindVertexArray(a_uVertexArray); }
+void GLRenderBackend::BindTexture(uint a_uUnit, GLuint a_uTexture)
+{
+	glActiveTexture(GL_TEXTURE0 + a_uUnit);
+	glBindTexture(GL_TEXTURE_2D, a_uTexture);
+}
+void GLRenderBackend::PolygonMode(GLenum a_eMode) { glPolygonMode(GL_FRONT_AND_BACK, a_eMode); }
+void GLRenderBackend::PolygonOffset(float a_fFactor, float a_fUnits) { glPolygonOffset(a_fFactor, a_fUnits); }
+void GLRenderBackend::Enable(GLenum a_eCapability) { glEnable(a_eCapability); }
+void GLRenderBackend::Disable(GLenum a_eCapability) { glDisable(a_eCapability); }
+GLint GLRenderBackend::GetUniformLocation(GLuint a_uProgram, const char* a_sName) { return glGetUniformLocation(a_uProgram, a_sName); }
+void GLRenderBackend::Uniform1i(GLint a_nLocation, int a_nValue) { glUniform1i(a_nLocation, a_nValue); }
+void GLRenderBackend::Uniform1f(GLint a_nLocation, float a_fValue) { glUniform1f(a_nLocation, a_fValue); }
+void GLRenderBackend::Uniform3f(GLint a_nLocation, float a_fX, float a_fY, float a_fZ) { glUniform3f(a_nLocation, a_fX, a_fY, a_fZ); }
+void GLRenderBackend::UniformMatrix4(GLint a_nLocation, uint a_uCount, const float* a_pMatrix)
+{
+	glUniformMatrix4fv(a_nLocation, a_uCount, GL_FALSE, a_pMatrix);
+}
+void GLRenderBackend::DrawArraysInstanced(GLenum a_ePrimitive, uint a_uFirst, uint a_uVertices, uint a_uInstances)
+{
+	glDrawArraysInstanced(a_ePrimitive, a_uFirst, a_uVertices, a_uInstances);
+}
+//NullRenderBackend
+void NullRenderBackend::SetRecording(bool a_bRecording)
+{
+	if (a_bRecording && !m_bRecording)
+		m_lCommand.clear();
+	m_bRecording = a_bRecording;
+}
+bool NullRenderBackend::IsRecording(void) { return m_bRecording; }
+uint NullRenderBackend::GetCommandCount(void) { return m_lCommand.size(); }
+RenderCommand NullRenderBackend::GetCommand(uint a_uIndex)
+{
+	if (a_uIndex >= m_lCommand.size())
+		return RenderCommand();
+	return m_lCommand[a_uIndex];
+}
+void NullRenderBackend::ClearCommands(void) { m_lCommand.clear(); }
+void NullRenderBackend::Record(eBTX_COMMAND a_eType, uint a_uObject, uint a_uValue, uint a_uCount)
+{
+	if (!m_bRecording)
+		return;
+	RenderCommand command;
+	command.eType = a_eType;
+	command.uObject = a_uObject;
+	command.uValue = a_uValue;
+	command.uCount = a_uCount;
+	m_lCommand.push_back(command);
+}
+eBTX_BACKEND NullRenderBackend::GetType(void) { return BACKEND_NULL; }
+RenderStats NullRenderBackend::GetStats(void) { return m_Stats; }
+void NullRenderBackend::ResetStats(void) { m_Stats = RenderStats(); }
+GLuint NullRenderBackend::CreateVertexArray(void)
+{
+	m_Stats.uObjectsCreated++;
+	Record(COMMAND_CREATE, m_uNextName, 0);
+	return m_uNextName++;
+}
+void NullRenderBackend::DeleteVertexArray(GLuint a_uVertexArray)
+{
+	m_Stats.uObjectsDeleted++;
+	Record(COMMAND_DELETE, a_uVertexArray, 0);
+}
+GLuint NullRenderBackend::CreateBuffer(void)
+{
+	m_Stats.uObjectsCreated++;
+	Record(COMMAND_CREATE, m_uNextName, 1);
+	return m_uNextName++;
+}
+void NullRenderBackend::DeleteBuffer(GLuint a_uBuffer)
+{
+	m_Stats.uObjectsDeleted++;
+	Record(COMMAND_DELETE, a_uBuffer, 1);
+}
+GLuint NullRenderBackend::CreateTexture(void)
+{
+	m_Stats.uObjectsCreated++;
+	Record(COMMAND_CREATE, m_uNextName, 3);
+	return m_uNextName++;
+}
+void NullRenderBackend::DeleteTexture(GLuint a_uTexture)
+{
+	//like OpenGL, deleting 0 does nothing
+	if (a_uTexture == 0)
+		return;
+	m_Stats.uObjectsDeleted++;
+	Record(COMMAND_DELETE, a_uTexture, 3);
+}
+GLuint NullRenderBackend::CreateProgram(String a_sVertexSource, String a_sFragmentSource)
+{
+	m_Stats.uObjectsCreated++;
+	m_Stats.uProgramsCompiled++;
+	Record(COMMAND_CREATE, m_uNextName, 2);
+	return m_uNextName++;
+}
+void NullRenderBackend::DeleteProgram(GLuint a_uProgram)
+{
+	m_Stats.uObjectsDeleted++;
+	Record(COMMAND_DELETE, a_uProgram, 2);
+}
+String NullRenderBackend::GetDriverID(void) { return "null"; }
+bool NullRenderBackend::GetProgramBinary(GLuint a_uProgram, std::vector<char>& a_lBinary, GLenum& a_eFormat)
+{
+	//The binary only has to come back to this backend, the name of the program is enough
+	a_eFormat = eNullBinaryFormat;
+	a_lBinary.resize(sizeof(GLuint));
+	memcpy(&a_lBinary[0], &a_uProgram, sizeof(GLuint));
+	return true;
+}
+GLuint NullRenderBackend::CreateProgramFromBinary(GLenum a_eFormat, const void* a_pBinary, uint a_uBytes)
+{
+	if (a_eFormat != eNullBinaryFormat || a_pBinary == nullptr || a_uBytes != sizeof(GLuint))
+		return 0;
+	m_Stats.uObjectsCreated++;
+	m_Stats.uProgramsLoaded++;
+	Record(COMMAND_CREATE, m_uNextName, 2);
+	return m_uNextName++;
+}
+void NullRenderBackend::BindBuffer(GLenum a_eTarget, GLuint a_uBuffer)
+{
+	m_Stats.uBufferBinds++;
+	Record(COMMAND_BIND_BUFFER, a_uBuffer, a_eTarget);
+}
+void NullRenderBackend::BufferData(GLenum a_eTarget, uint a_uBytes, const void* a_pData, GLenum a_eUsage)
+{
+	m_Stats.uBufferUploads++;
+	m_Stats.uBufferBytes += a_uBytes;
+	Record(COMMAND_BUFFER_DATA, a_eTarget, a_uBytes);
+}
+void NullRenderBackend::VertexAttribute(GLuint a_uIndex, GLint a_nComponents, GLsizei a_nStride, uint a_uOffset)
+{
+	Record(COMMAND_VERTEX_ATTRIBUTE, a_uIndex, a_nComponents, a_uOffset);
+}
+void NullRenderBackend::VertexDivisor(GLuint a_uIndex, GLuint a_uDivisor)
+{
+	Record(COMMAND_VERTEX_DIVISOR, a_uIndex, a_uDivisor);
+}
+bool NullRenderBackend::TextureImage(GLuint a_uTexture, int a_nWidth, int a_nHeight, const void* a_pPixels, uint a_uLevels,
+	GLenum a_eFormat)
+{
+	uint uBytes = 0;
+	int nWidth = a_nWidth;
+	int nHeight = a_nHeight;
+	for (uint uLevel = 0; uLevel < a_uLevels; ++uLevel)
+	{
+		uBytes += static_cast<uint>(4 * nWidth * nHeight);
+		nWidth = std::max(nWidth / 2, 1);
+		nHeight = std::max(nHeight / 2, 1);
+	}
+	m_Stats.uTextureUploads++;
+	m_Stats.uTextureBytes += uBytes;
+	Record(COMMAND_TEXTURE_IMAGE, a_uTexture, uBytes, a_uLevels);
+	return true;
+}
+void NullRenderBackend::UseProgram(GLuint a_uProgram)
+{
+	m_Stats.uProgramBinds++;
+	Record(COMMAND_USE_PROGRAM, a_uProgram);
+}
+void NullRenderBackend::BindVertexArray(GLuint a_uVertexArray)
+{
+	m_Stats.uVertexArrayBinds++;
+	Record(COMMAND_BIND_VERTEX_ARRAY, a_uVertexArray);
+}
+void NullRenderBackend::BindTexture(uint a_uUnit, GLuint a_uTexture)
+{
+	m_Stats.uTextureBinds++;
+	Record(COMMAND_BIND_TEXTURE, a_uTexture, a_uUnit);
+}
+void NullRenderBackend::PolygonMode(GLenum a_eMode)
+{
+	m_Stats.uStateChanges++;
+	Record(COMMAND_POLYGON_MODE, a_eMode);
+}
+void NullRenderBackend::PolygonOffset(float a_fFactor, float a_fUnits)
+{
+	m_Stats.uStateChanges++;
+	Record(COMMAND_POLYGON_OFFSET);
+}
+void NullRenderBackend::Enable(GLenum a_eCapability)
+{
+	m_Stats.uStateChanges++;
+	Record(COMMAND_ENABLE, a_eCapability);
+}
+void NullRenderBackend::Disable(GLenum a_eCapability)
+{
+	m_Stats.uStateChanges++;
+	Record(COMMAND_DISABLE, a_eCapability);
+}
+GLint NullRenderBackend::GetUniformLocation(GLuint a_uProgram, const char* a_sName)
+{
+	m_Stats.uUniformLookups++;
+	//the same name always gets the same location, whatever the program
+	auto location = m_mUniform.find(a_sName);
+	if (location != m_mUniform.end())
+		return location->second;
+	GLint nLocation = static_cast<GLint>(m_mUniform.size());
+	m_mUniform[a_sName] = nLocation;
+	return nLocation;
+}
+void NullRenderBackend::Uniform1i(GLint a_nLocation, int a_nValue)
+{
+	m_Stats.uUniformUploads++;
+	m_Stats.uUniformBytes += sizeof(int);
+	Record(COMMAND_UNIFORM, a_nLocation, sizeof(int), 1);
+}
+void NullRenderBackend::Uniform1f(GLint a_nLocation, float a_fValue)
+{
+	m_Stats.uUniformUploads++;
+	m_Stats.uUniformBytes += sizeof(float);
+	Record(COMMAND_UNIFORM, a_nLocation, sizeof(float), 1);
+}
+void NullRenderBackend::Uniform3f(GLint a_nLocation, float a_fX, float a_fY, float a_fZ)
+{
+	m_Stats.uUniformUploads++;
+	m_Stats.uUniformBytes += 3 * sizeof(float);
+	Record(COMMAND_UNIFORM, a_nLocation, 3 * sizeof(float), 1);
+}
+void NullRenderBackend::UniformMatrix4(GLint a_nLocation, uint a_uCount, const float* a_pMatrix)
+{
+	uint uBytes = a_uCount * 16 * sizeof(float);
+	m_Stats.uUniformUploads++;
+	m_Stats.uUniformBytes += uBytes;
+	Record(COMMAND_UNIFORM, a_nLocation, uBytes, a_uCount);
+}
+void NullRenderBackend::DrawArraysInstanced(GLenum a_ePrimitive, uint a_uFirst, uint a_uVertices, uint a_uInstances)
+{
+	m_Stats.uDrawCalls++;
+	m_Stats.uInstances += a_uInstances;
+	m_Stats.uVertices += static_cast<unsigned long long>(a_uVertices) * a_uInstances;
+	Record(COMMAND_DRAW, a_ePrimitive, a_uVertices, a_uInstances);
+}
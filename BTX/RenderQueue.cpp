@@ -0,0 +1,231 @@
+#include "BTX\Mesh\RenderQueue.h"
+using namespace BTX;
+
+//Key layout, from the most significant bits: layer | shader | material | mesh | mode
+static const uint uModeBits = 8;
+static const uint uMeshBits = 20;
+static const uint uMaterialBits = 16;
+static const uint uShaderBits = 16;
+static const uint uLayerBits = 4;
+
+//The big 3
+RenderQueue::RenderQueue(void) { Init(); }
+RenderQueue::RenderQueue(RenderQueue const& other)
+{
+	m_lItem = other.m_lItem;
+	m_lEntry = other.m_lEntry;
+	m_lMatrix = other.m_lMatrix;
+	m_State = other.m_State;
+	m_bSorted = other.m_bSorted;
+	m_m4View = other.m_m4View;
+	m_fProjectionScale = other.m_fProjectionScale;
+	m_bPerspective = other.m_bPerspective;
+	m_fLODHysteresis = other.m_fLODHysteresis;
+}
+RenderQueue& RenderQueue::operator=(RenderQueue const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		RenderQueue temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+RenderQueue::~RenderQueue(void) { Release(); }
+void RenderQueue::Swap(RenderQueue& other)
+{
+	std::swap(m_lItem, other.m_lItem);
+	std::swap(m_lEntry, other.m_lEntry);
+	std::swap(m_lScratch, other.m_lScratch);
+	std::swap(m_lMatrix, other.m_lMatrix);
+	std::swap(m_State, other.m_State);
+	std::swap(m_bSorted, other.m_bSorted);
+	std::swap(m_m4View, other.m_m4View);
+	std::swap(m_fProjectionScale, other.m_fProjectionScale);
+	std::swap(m_bPerspective, other.m_bPerspective);
+	std::swap(m_fLODHysteresis, other.m_fLODHysteresis);
+}
+void RenderQueue::Release(void) { Clear(); }
+void RenderQueue::Init(void)
+{
+	m_bSorted = true;
+	m_State.Reset();
+}
+//Accessors
+uint RenderQueue::GetItemCount(void) { return m_lEntry.size(); }
+unsigned long long RenderQueue::GetKey(uint a_uIndex)
+{
+	if (a_uIndex >= m_lEntry.size())
+		return 0;
+	return m_lEntry[a_uIndex].uKey;
+}
+RenderState RenderQueue::GetStats(void) { return m_State; }
+void RenderQueue::SetLODHysteresis(float a_fHysteresis) { m_fLODHysteresis = std::max(a_fHysteresis, 0.0f); }
+float RenderQueue::GetLODHysteresis(void) { return m_fLODHysteresis; }
+//--- Methods
+unsigned long long RenderQueue::MakeKey(uint a_uLayer, uint a_uShader, uint a_uMaterial, uint a_uMesh, uint a_uMode)
+{
+	unsigned long long uKey = a_uLayer & ((1u << uLayerBits) - 1);
+	uKey = (uKey << uShaderBits) | (a_uShader & ((1u << uShaderBits) - 1));
+	uKey = (uKey << uMaterialBits) | (a_uMaterial & ((1u << uMaterialBits) - 1));
+	uKey = (uKey << uMeshBits) | (a_uMesh & ((1u << uMeshBits) - 1));
+	uKey = (uKey << uModeBits) | (a_uMode & ((1u << uModeBits) - 1));
+	return uKey;
+}
+uint RenderQueue::AddMatrices(std::vector<matrix4> const& a_lMatrix)
+{
+	uint uFirst = m_lMatrix.size() / 16;
+	uint uCount = a_lMatrix.size();
+	if (uCount == 0)
+		return uFirst;
+	const float* pMatrix = glm::value_ptr(a_lMatrix[0]);
+	m_lMatrix.insert(m_lMatrix.end(), pMatrix, pMatrix + 16 * uCount);
+	return uFirst;
+}
+void RenderQueue::AddItem(unsigned long long a_uKey, Mesh* a_pMesh, uint a_uFirstMatrix, uint a_uMatrixCount, int a_nRenderOption)
+{
+	if (a_pMesh == nullptr || a_uMatrixCount == 0)
+		return;
+
+	RenderItem item;
+	item.pMesh = a_pMesh;
+	item.uFirstMatrix = a_uFirstMatrix;
+	item.uMatrixCount = a_uMatrixCount;
+	item.nRenderOption = a_nRenderOption;
+
+	RenderEntry entry;
+	entry.uKey = a_uKey;
+	entry.uItem = m_lItem.size();
+
+	m_lItem.push_back(item);
+	m_lEntry.push_back(entry);
+	m_bSorted = false;
+}
+void RenderQueue::AddMesh(Mesh* a_pMesh, uint a_uFirstMatrix, uint a_uMatrixCount, int a_nRenderOption, uint a_uLayer)
+{
+	if (a_pMesh == nullptr)
+		return;
+
+	uint uMesh = a_pMesh->GetVAO();
+	uint uMaterial = static_cast<uint>(a_pMesh->GetMaterialIndex());
+
+	//Lines ignore the render option, they always draw as lines with their own shader
+	if (a_pMesh->IsLineObject())
+	{
+		AddItem(MakeKey(a_uLayer, a_pMesh->GetShaderIndex(), uMaterial, uMesh, 2),
+			a_pMesh, a_uFirstMatrix, a_uMatrixCount, a_nRenderOption);
+		return;
+	}
+	if (a_nRenderOption & eBTX_RENDER::RENDER_SOLID)
+	{
+		AddItem(MakeKey(a_uLayer, a_pMesh->GetShaderIndex(), uMaterial, uMesh, 0),
+			a_pMesh, a_uFirstMatrix, a_uMatrixCount, eBTX_RENDER::RENDER_SOLID);
+	}
+	if (a_nRenderOption & eBTX_RENDER::RENDER_WIRE)
+	{
+		//The wire pass has no textures, the material does not matter to it
+		GLuint uWireframe = ShaderManager::GetInstance()->GetShaderID("Wireframe");
+		AddItem(MakeKey(a_uLayer, uWireframe, 0, uMesh, 1),
+			a_pMesh, a_uFirstMatrix, a_uMatrixCount, eBTX_RENDER::RENDER_WIRE);
+	}
+}
+void RenderQueue::SetView(matrix4 a_m4Projection, matrix4 a_m4View)
+{
+	m_m4View = a_m4View;
+	m_fProjectionScale = a_m4Projection[1][1];
+	//An orthographic projection has no perspective divide, its w row is (0, 0, 0, 1)
+	m_bPerspective = a_m4Projection[2][3] != 0.0f;
+}
+float RenderQueue::GetScreenSize(vector3 a_v3Center, float a_fRadius)
+{
+	if (!m_bPerspective)
+		return a_fRadius * m_fProjectionScale;
+
+	//The distance instead of the depth so turning the camera does not change the levels
+	float fDistance = glm::length(vector3(m_m4View * vector4(a_v3Center, 1.0f)));
+	if (fDistance <= a_fRadius)
+		return std::numeric_limits<float>::max();
+	return a_fRadius * m_fProjectionScale / fDistance;
+}
+uint RenderQueue::SelectLOD(float a_fScreenSize, std::vector<float> const& a_lThreshold, uint a_uLast)
+{
+	uint uLevels = a_lThreshold.size();
+	uint uLevel = std::min(a_uLast, uLevels);
+	//Go to coarser levels while the instance is well under their threshold
+	while (uLevel < uLevels && a_fScreenSize < a_lThreshold[uLevel] * (1.0f - m_fLODHysteresis))
+		++uLevel;
+	//and back to finer levels while it is well over the threshold of the one it is on
+	while (uLevel > 0 && a_fScreenSize > a_lThreshold[uLevel - 1] * (1.0f + m_fLODHysteresis))
+		--uLevel;
+	return uLevel;
+}
+void RenderQueue::Sort(void)
+{
+	if (m_bSorted)
+		return;
+
+	//Least significant digit radix sort, 8 bits per pass; it is stable so batches
+	//with the same key keep the order they were added in
+	uint uCount = m_lEntry.size();
+	m_lScratch.resize(uCount);
+	RenderEntry* pFrom = m_lEntry.data();
+	RenderEntry* pTo = m_lScratch.data();
+	for (uint uShift = 0; uShift < 64; uShift += 8)
+	{
+		uint uHistogram[256] = { 0 };
+		for (uint i = 0; i < uCount; i++)
+			uHistogram[(pFrom[i].uKey >> uShift) & 0xFF]++;
+
+		//Most of the high bits are the same for every key, skip the passes that would not move anything
+		if (uHistogram[(pFrom[0].uKey >> uShift) & 0xFF] == uCount)
+			continue;
+
+		uint uOffset = 0;
+		for (uint i = 0; i < 256; i++)
+		{
+			uint uBucket = uHistogram[i];
+			uHistogram[i] = uOffset;
+			uOffset += uBucket;
+		}
+		for (uint i = 0; i < uCount; i++)
+			pTo[uHistogram[(pFrom[i].uKey >> uShift) & 0xFF]++] = pFrom[i];
+		std::swap(pFrom, pTo);
+	}
+	if (pFrom != m_lEntry.data())
+		m_lEntry.swap(m_lScratch);
+	m_bSorted = true;
+}
+uint RenderQueue::Render(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3CameraPosition)
+{
+	m_State.Reset();
+	if (m_lEntry.empty())
+		return 0;
+
+	Sort();
+	uint uRenderCalls = 0;
+	uint uCount = m_lEntry.size();
+	for (uint i = 0; i < uCount; i++)
+	{
+		RenderItem& item = m_lItem[m_lEntry[i].uItem];
+		uRenderCalls += item.pMesh->Render(a_m4Projection, a_m4View, &m_lMatrix[item.uFirstMatrix * 16],
+			item.uMatrixCount, a_v3CameraPosition, item.nRenderOption, &m_State);
+	}
+
+	//Leave OpenGL the way a mesh rendered on its own does
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	pBackend->Disable(GL_POLYGON_OFFSET_LINE);
+	pBackend->PolygonMode(GL_FILL);
+	pBackend->BindVertexArray(0);
+
+	Clear();
+	return uRenderCalls;
+}
+void RenderQueue::Clear(void)
+{
+	m_lItem.clear();
+	m_lEntry.clear();
+	m_lMatrix.clear();
+	m_bSorted = true;
+}
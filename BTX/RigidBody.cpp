@@ -3,12 +3,13 @@ using namespace BTX;
 //Allocation
 void RigidBody::Init(void)
 {
-	m_pModelMngr = ModelManager::GetInstance();
+	m_pModelMngr = nullptr; //only needed to draw, got the first time the body is drawn
 	m_bVisibleBS = false;
 	m_bVisibleOBB = true;
 	m_bVisibleARBB = false;
 
 	m_fRadius = 0.0f;
+	m_fRadiusG = 0.0f;
 
 	m_v3ColorColliding = C_RED;
 	m_v3ColorNotColliding = C_WHITE;
@@ -25,6 +26,7 @@ void RigidBody::Init(void)
 	m_v3ARBBSize = ZERO_V3;
 
 	m_m4ToWorld = IDENTITY_M4;
+	m_bGlobalDirty = true;
 
 	m_uCollidingCount = 0;
 	m_CollidingArray = nullptr;
@@ -37,6 +39,7 @@ void RigidBody::Swap(RigidBody& other)
 	std::swap(m_bVisibleARBB, other.m_bVisibleARBB);
 
 	std::swap(m_fRadius, other.m_fRadius);
+	std::swap(m_fRadiusG, other.m_fRadiusG);
 
 	std::swap(m_v3ColorColliding, other.m_v3ColorColliding);
 	std::swap(m_v3ColorNotColliding, other.m_v3ColorNotColliding);
@@ -53,6 +56,7 @@ void RigidBody::Swap(RigidBody& other)
 	std::swap(m_v3ARBBSize, other.m_v3ARBBSize);
 
 	std::swap(m_m4ToWorld, other.m_m4ToWorld);
+	std::swap(m_bGlobalDirty, other.m_bGlobalDirty);
 
 	std::swap(m_uCollidingCount, other.m_uCollidingCount);
 	std::swap(m_CollidingArray, other.m_CollidingArray);
@@ -70,6 +74,11 @@ void RigidBody::SetVisibleOBB(bool a_bVisible) { m_bVisibleOBB = a_bVisible; }
 bool RigidBody::GetVisibleARBB(void) { return m_bVisibleARBB; }
 void RigidBody::SetVisibleARBB(bool a_bVisible) { m_bVisibleARBB = a_bVisible; }
 float RigidBody::GetRadius(void) { return m_fRadius; }
+float RigidBody::GetRadiusGlobal(void)
+{
+	UpdateGlobal();
+	return m_fRadiusG;
+}
 vector3 RigidBody::GetColorColliding(void) { return m_v3ColorColliding; }
 vector3 RigidBody::GetColorNotColliding(void) { return m_v3ColorNotColliding; }
 void RigidBody::SetColorColliding(vector3 a_v3Color) { m_v3ColorColliding = a_v3Color; }
@@ -77,9 +86,21 @@ void RigidBody::SetColorNotColliding(vector3 a_v3Color) { m_v3ColorNotColliding
 vector3 RigidBody::GetCenterLocal(void) { return m_v3CenterL; }
 vector3 RigidBody::GetMinLocal(void) { return m_v3MinL; }
 vector3 RigidBody::GetMaxLocal(void) { return m_v3MaxL; }
-vector3 RigidBody::GetCenterGlobal(void){ return m_v3CenterG; }
-vector3 RigidBody::GetMinGlobal(void) { return m_v3MinG; }
-vector3 RigidBody::GetMaxGlobal(void) { return m_v3MaxG; }
+vector3 RigidBody::GetCenterGlobal(void)
+{
+	UpdateGlobal();
+	return m_v3CenterG;
+}
+vector3 RigidBody::GetMinGlobal(void)
+{
+	UpdateGlobal();
+	return m_v3MinG;
+}
+vector3 RigidBody::GetMaxGlobal(void)
+{
+	UpdateGlobal();
+	return m_v3MaxG;
+}
 vector3 RigidBody::GetHalfWidth(void) { return m_v3HalfWidth; }
 matrix4 RigidBody::GetModelMatrix(void) { return m_m4ToWorld; }
 RigidBody::PRigidBody* RigidBody::GetColliderArray(void) { return m_CollidingArray; }
@@ -90,49 +111,33 @@ void RigidBody::SetModelMatrix(matrix4 a_m4ModelMatrix)
 	if (a_m4ModelMatrix == m_m4ToWorld)
 		return;
 
-	//Assign the model matrix
+	//Assign the model matrix, the global information is updated when someone asks for it
 	m_m4ToWorld = a_m4ModelMatrix;
+	m_bGlobalDirty = true;
+}
+void RigidBody::UpdateGlobal(void)
+{
+	if (!m_bGlobalDirty)
+		return;
 
-	m_v3CenterG = vector3(m_m4ToWorld * vector4(m_v3CenterL, 1.0f));
-
-	//Calculate the 8 corners of the cube
-	vector3 v3Corner[8];
-	//Back square
-	v3Corner[0] = m_v3MinL;
-	v3Corner[1] = vector3(m_v3MaxL.x, m_v3MinL.y, m_v3MinL.z);
-	v3Corner[2] = vector3(m_v3MinL.x, m_v3MaxL.y, m_v3MinL.z);
-	v3Corner[3] = vector3(m_v3MaxL.x, m_v3MaxL.y, m_v3MinL.z);
-
-	//Front square
-	v3Corner[4] = vector3(m_v3MinL.x, m_v3MinL.y, m_v3MaxL.z);
-	v3Corner[5] = vector3(m_v3MaxL.x, m_v3MinL.y, m_v3MaxL.z);
-	v3Corner[6] = vector3(m_v3MinL.x, m_v3MaxL.y, m_v3MaxL.z);
-	v3Corner[7] = m_v3MaxL;
-
-	//Place them in world space
-	for (uint uIndex = 0; uIndex < 8; ++uIndex)
-	{
-		v3Corner[uIndex] = vector3(m_m4ToWorld * vector4(v3Corner[uIndex], 1.0f));
-	}
-
-	//Identify the max and min as the first corner
-	m_v3MaxG = m_v3MinG = v3Corner[0];
-
-	//get the new max and min for the global box
-	for (uint i = 1; i < 8; ++i)
-	{
-		if (m_v3MaxG.x < v3Corner[i].x) m_v3MaxG.x = v3Corner[i].x;
-		else if (m_v3MinG.x > v3Corner[i].x) m_v3MinG.x = v3Corner[i].x;
+	matrix3 m3Rotation = matrix3(m_m4ToWorld);
+	m_v3CenterG = m3Rotation * m_v3CenterL + vector3(m_m4ToWorld[3]);
 
-		if (m_v3MaxG.y < v3Corner[i].y) m_v3MaxG.y = v3Corner[i].y;
-		else if (m_v3MinG.y > v3Corner[i].y) m_v3MinG.y = v3Corner[i].y;
+	//Each axis of the box adds the absolute value of its column scaled by the half width,
+	//this is the same box the 8 transformed corners would give
+	vector3 v3Extent =
+		glm::abs(m3Rotation[0]) * m_v3HalfWidth.x +
+		glm::abs(m3Rotation[1]) * m_v3HalfWidth.y +
+		glm::abs(m3Rotation[2]) * m_v3HalfWidth.z;
+	m_v3MinG = m_v3CenterG - v3Extent;
+	m_v3MaxG = m_v3CenterG + v3Extent;
+	m_v3ARBBSize = v3Extent * 2.0f;
 
-		if (m_v3MaxG.z < v3Corner[i].z) m_v3MaxG.z = v3Corner[i].z;
-		else if (m_v3MinG.z > v3Corner[i].z) m_v3MinG.z = v3Corner[i].z;
-	}
+	//the sphere grows with the largest scale of the matrix
+	float fScale = glm::max(glm::length(m3Rotation[0]), glm::max(glm::length(m3Rotation[1]), glm::length(m3Rotation[2])));
+	m_fRadiusG = m_fRadius * fScale;
 
-	//we calculate the distance between min and max vectors
-	m_v3ARBBSize = m_v3MaxG - m_v3MinG;
+	m_bGlobalDirty = false;
 }
 //The big 3
 RigidBody::RigidBody(std::vector<vector3> a_pointList)
@@ -161,10 +166,6 @@ RigidBody::RigidBody(std::vector<vector3> a_pointList)
 		else if (m_v3MinL.z > a_pointList[i].z) m_v3MinL.z = a_pointList[i].z;
 	}
 
-	//with model matrix being the identity, local and global are the same
-	m_v3MinG = m_v3MinL;
-	m_v3MaxG = m_v3MaxL;
-
 	//with the max and the min we calculate the center
 	m_v3CenterL = (m_v3MaxL + m_v3MinL) / 2.0f;
 
@@ -173,6 +174,9 @@ RigidBody::RigidBody(std::vector<vector3> a_pointList)
 
 	//Get the distance between the center and either the min or the max
 	m_fRadius = glm::distance(m_v3CenterL, m_v3MinL);
+
+	//global information will be made from the identity the first time it is needed
+	m_bGlobalDirty = true;
 }
 RigidBody::RigidBody(RigidBody const& other)
 {
@@ -183,6 +187,7 @@ RigidBody::RigidBody(RigidBody const& other)
 	m_bVisibleARBB = other.m_bVisibleARBB;
 
 	m_fRadius = other.m_fRadius;
+	m_fRadiusG = other.m_fRadiusG;
 
 	m_v3ColorColliding = other.m_v3ColorColliding;
 	m_v3ColorNotColliding = other.m_v3ColorNotColliding;
@@ -199,6 +204,7 @@ RigidBody::RigidBody(RigidBody const& other)
 	m_v3ARBBSize = other.m_v3ARBBSize;
 
 	m_m4ToWorld = other.m_m4ToWorld;
+	m_bGlobalDirty = other.m_bGlobalDirty;
 
 	m_uCollidingCount = other.m_uCollidingCount;
 	m_CollidingArray = other.m_CollidingArray;
@@ -283,6 +289,9 @@ void RigidBody::ClearCollidingList(void)
 
 uint RigidBody::SAT(RigidBody* const a_pOther)
 {
+	UpdateGlobal();
+	a_pOther->UpdateGlobal();
+
 	//Backup matrices and halfwidths
 	matrix4 mToWorldA = m_m4ToWorld;
 	vector3 v3HalfWidthA = m_v3HalfWidth;
@@ -296,8 +305,11 @@ uint RigidBody::SAT(RigidBody* const a_pOther)
 
 bool RigidBody::IsColliding(RigidBody* const other)
 {
+	UpdateGlobal();
+	other->UpdateGlobal();
+
 	//check if spheres are colliding
-	bool bColliding = (glm::distance(m_v3CenterG, other->m_v3CenterG) < m_fRadius + other->m_fRadius);
+	bool bColliding = (glm::distance(m_v3CenterG, other->m_v3CenterG) < m_fRadiusG + other->m_fRadiusG);
 	if (bColliding) 
 	{	
 		//they failed the pretest, use specialized test
@@ -322,29 +334,131 @@ bool RigidBody::IsColliding(RigidBody* const other)
 	return bColliding;
 }
 
-void RigidBody::AddToRenderList(void)
+bool RigidBody::IsIntersectingRay(vector3 a_v3Origin, vector3 a_v3Direction, float a_fMaxDistance, float& a_fDistance, vector3& a_v3Normal)
 {
-	if (m_bVisibleBS)
+	//the ray goes into the space of the box, its direction is not normalized there so the
+	//distances along it stay the same as in global space
+	matrix3 m3ToWorld = matrix3(m_m4ToWorld);
+	if (glm::determinant(m3ToWorld) == 0.0f)
+		return false;
+	matrix3 m3ToLocal = glm::inverse(m3ToWorld);
+	vector3 v3Origin = m3ToLocal * (a_v3Origin - vector3(m_m4ToWorld[3]));
+	vector3 v3Direction = m3ToLocal * a_v3Direction;
+
+	//slabs of the box, the entry is the latest of the near planes and the exit the earliest far one
+	float fEnter = 0.0f;
+	float fExit = a_fMaxDistance;
+	int nAxis = -1;
+	float fSide = 0.0f;
+	for (int i = 0; i < 3; ++i)
 	{
-		if (m_uCollidingCount > 0)
-			m_pModelMngr->AddWireSphereToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(vector3(m_fRadius)), C_BLUE_CORNFLOWER);
-		else
-			m_pModelMngr->AddWireSphereToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(vector3(m_fRadius)), C_BLUE_CORNFLOWER);
+		if (v3Direction[i] == 0.0f)
+		{
+			if (v3Origin[i] < m_v3MinL[i] || v3Origin[i] > m_v3MaxL[i])
+				return false;
+			continue;
+		}
+		float fInverse = 1.0f / v3Direction[i];
+		float fNear = (m_v3MinL[i] - v3Origin[i]) * fInverse;
+		float fFar = (m_v3MaxL[i] - v3Origin[i]) * fInverse;
+		float fNearSide = -1.0f;
+		if (fNear > fFar)
+		{
+			std::swap(fNear, fFar);
+			fNearSide = 1.0f;
+		}
+		if (fNear > fEnter)
+		{
+			fEnter = fNear;
+			nAxis = i;
+			fSide = fNearSide;
+		}
+		fExit = std::min(fExit, fFar);
+		if (fEnter > fExit)
+			return false;
 	}
+
+	a_fDistance = fEnter;
+	if (nAxis < 0)
+	{
+		//the ray starts inside of the box
+		a_v3Normal = -a_v3Direction;
+		return true;
+	}
+	//normals go back with the inverse transpose so scaled boxes keep them perpendicular
+	vector3 v3Normal = ZERO_V3;
+	v3Normal[nAxis] = fSide;
+	a_v3Normal = glm::normalize(glm::transpose(m3ToLocal) * v3Normal);
+	return true;
+}
+void RigidBody::AddToRenderList(void)
+{
+	AddToRenderList(GetDrawState());
+}
+RigidBody::DrawState RigidBody::GetDrawState(void)
+{
+	UpdateGlobal();
+	DrawState state;
+	state.bSphere = m_bVisibleBS;
+	state.bOBB = m_bVisibleOBB;
+	state.bARBB = m_bVisibleARBB;
+	state.v3Center = m_v3CenterG;
+	state.fRadius = m_fRadiusG;
 	if (m_bVisibleOBB)
 	{
-		if (m_uCollidingCount > 0)
-			m_pModelMngr->AddWireCubeToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(m_v3HalfWidth * 2.0f), m_v3ColorColliding);
-		else
-			m_pModelMngr->AddWireCubeToRenderList(glm::translate(m_m4ToWorld, m_v3CenterL) * glm::scale(m_v3HalfWidth * 2.0f), m_v3ColorNotColliding);
+		//the scale of the matrix goes to the extent and its rotation to the orientation
+		matrix3 m3Rotation = matrix3(m_m4ToWorld);
+		vector3 v3Scale = vector3(glm::length(m3Rotation[0]), glm::length(m3Rotation[1]), glm::length(m3Rotation[2]));
+		for (uint i = 0; i < 3; ++i)
+		{
+			if (v3Scale[i] > 0.0f)
+				m3Rotation[i] /= v3Scale[i];
+		}
+		state.v3OBBExtent = m_v3HalfWidth * v3Scale;
+		state.qOBBOrientation = glm::quat_cast(m3Rotation);
+		state.v3OBBColor = m_uCollidingCount > 0 ? m_v3ColorColliding : m_v3ColorNotColliding;
 	}
-	if (m_bVisibleARBB)
+	state.v3ARBBExtent = m_v3ARBBSize * 0.5f;
+	return state;
+}
+void RigidBody::AddToRenderList(DrawState const& a_State) { AddToRenderList(1, &a_State); }
+void RigidBody::AddToRenderList(uint a_uCount, DrawState const* a_pState)
+{
+	//The volumes are gathered per kind and go to the bounds batch as arrays, drawn instanced;
+	//the arrays are kept between calls so a frame does not allocate
+	static std::vector<vector3> lSphereCenter, lSphereColor, lOBBCenter, lOBBExtent, lOBBColor, lARBBCenter, lARBBExtent;
+	static std::vector<float> lSphereRadius;
+	static std::vector<quaternion> lOBBOrientation;
+	lSphereCenter.clear(); lSphereRadius.clear(); lSphereColor.clear();
+	lOBBCenter.clear(); lOBBExtent.clear(); lOBBOrientation.clear(); lOBBColor.clear();
+	lARBBCenter.clear(); lARBBExtent.clear();
+	for (uint i = 0; i < a_uCount; ++i)
 	{
-		if (m_uCollidingCount > 0)
-			m_pModelMngr->AddWireCubeToRenderList(glm::translate(m_v3CenterG) * glm::scale(m_v3ARBBSize), C_YELLOW);
-		else
-			m_pModelMngr->AddWireCubeToRenderList(glm::translate(m_v3CenterG) * glm::scale(m_v3ARBBSize), C_YELLOW);
+		DrawState const& state = a_pState[i];
+		if (state.bSphere)
+		{
+			lSphereCenter.push_back(state.v3Center);
+			lSphereRadius.push_back(state.fRadius);
+			lSphereColor.push_back(C_BLUE_CORNFLOWER);
+		}
+		if (state.bOBB)
+		{
+			lOBBCenter.push_back(state.v3Center);
+			lOBBExtent.push_back(state.v3OBBExtent);
+			lOBBOrientation.push_back(state.qOBBOrientation);
+			lOBBColor.push_back(state.v3OBBColor);
+		}
+		if (state.bARBB)
+		{
+			lARBBCenter.push_back(state.v3Center);
+			lARBBExtent.push_back(state.v3ARBBExtent);
+		}
 	}
+
+	BoundsBatch* pBatch = ModelManager::GetInstance()->GetBoundsBatch();
+	pBatch->AddSpheres(lSphereCenter.size(), lSphereCenter.data(), lSphereRadius.data(), lSphereColor.data());
+	pBatch->AddBoxes(lOBBCenter.size(), lOBBCenter.data(), lOBBExtent.data(), lOBBOrientation.data(), lOBBColor.data());
+	pBatch->AddBoxes(lARBBCenter.size(), lARBBCenter.data(), lARBBExtent.data(), C_YELLOW);
 }
 bool RigidBody::IsInCollidingArray(RigidBody* a_pEntry)
 {
@@ -1,11 +1,19 @@
 #include "BTX\System\Shader.h"
 using namespace BTX;
+//Names of the engine uniforms in the shaders, in the order of eBTX_UNIFORM
+static const char* sUniformName[UNIFORM_COUNT] = {
+	"VP", "m4ToWorld", "vWireframe", "TextureID", "NormalID", "SpecularID", "nTexture", "Tint",
+	"m4ModelToWorld", "LightPosition_W", "LightColor", "LightPower", "AmbientColor", "AmbientPower",
+	"CameraPosition_W", "m4CameraOnWorld" };
+
 void Shader::Init(void)
 {
 	m_sProgramName = "";
 	m_sVertexShaderName = "";
 	m_sFragmentShaderName = "";
 	m_nProgram = -1;
+	for (uint i = 0; i < UNIFORM_COUNT; ++i)
+		m_nUniform[i] = -1;
 }
 void Shader::Swap(Shader& other)
 {
@@ -13,12 +21,13 @@ void Shader::Swap(Shader& other)
 	std::swap( m_sVertexShaderName, other.m_sVertexShaderName);
 	std::swap( m_sFragmentShaderName, other.m_sFragmentShaderName);
 	std::swap( m_nProgram, other.m_nProgram);
+	std::swap( m_nUniform, other.m_nUniform);
 }
 void Shader::Release(void)
 {
 	if(m_nProgram >= 0 )
 	{
-		glDeleteProgram(m_nProgram);
+		RenderBackend::GetInstance()->DeleteProgram(m_nProgram);
 		m_nProgram = -1;
 	}
 }
@@ -31,6 +40,8 @@ Shader::Shader(const Shader& other)
 	m_sVertexShaderName = other.m_sVertexShaderName;
 	m_sFragmentShaderName = other.m_sFragmentShaderName;
 	m_nProgram = other.m_nProgram;
+	for (uint i = 0; i < UNIFORM_COUNT; ++i)
+		m_nUniform[i] = other.m_nUniform[i];
 }
 Shader& Shader::operator=(const Shader& other)
 {
@@ -47,7 +58,7 @@ Shader::~Shader(void)
 	//Release();
 }
 
-GLuint Shader::CompileShader(String a_sVertexShader, String a_sFragmentShader, String a_sName)
+GLuint Shader::CompileShader(String a_sVertexShader, String a_sFragmentShader, String a_sName, String a_sCacheFile)
 {
 	if(a_sName != "")
 		m_sProgramName = a_sName;
@@ -56,13 +67,34 @@ GLuint Shader::CompileShader(String a_sVertexShader, String a_sFragmentShader, S
 	
 	m_sVertexShaderName = a_sVertexShader;
 	m_sFragmentShaderName = a_sFragmentShader;
-	m_nProgram = LoadShaders( m_sVertexShaderName.c_str(), m_sFragmentShaderName.c_str() );
+	m_nProgram = LoadShaders( m_sVertexShaderName.c_str(), m_sFragmentShaderName.c_str(),
+		a_sCacheFile != "" ? a_sCacheFile.c_str() : nullptr );
+	ResolveUniforms();
 
 	return m_nProgram;
 }
+void Shader::ResolveUniforms(void)
+{
+	for (uint i = 0; i < UNIFORM_COUNT; ++i)
+		m_nUniform[i] = -1;
+	if (m_nProgram == 0 || m_nProgram == static_cast<GLuint>(-1))
+		return;
+
+	//Once per program instead of once per draw, -1 is ignored by glUniform like an unused name
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	for (uint i = 0; i < UNIFORM_COUNT; ++i)
+		m_nUniform[i] = pBackend->GetUniformLocation(m_nProgram, sUniformName[i]);
+}
 
 //Attributes
 String Shader::GetProgramName() { return m_sProgramName; }
 String Shader::GetVertexShaderName() { return m_sVertexShaderName; }
 String Shader::GetFragmentShaderName() { return m_sFragmentShaderName; }
 int Shader::GetProgramID() { return m_nProgram; }
+GLint Shader::GetUniform(eBTX_UNIFORM a_eUniform)
+{
+	if (a_eUniform < 0 || a_eUniform >= UNIFORM_COUNT)
+		return -1;
+	return m_nUniform[a_eUniform];
+}
+const GLint* Shader::GetUniformTable(void) { return m_nUniform; }
@@ -1,75 +1,118 @@
 #include "BTX\System\ShaderCompiler.h"
+#include "BTX\System\FileReader.h"
 
-GLuint BTX::LoadShaders( const char * vertex_file_path, const char * fragment_file_path)
+static const int nShaderCacheTag = 0x53585442; //"BTXS"
+static const int nShaderCacheVersion = 1;
+
+//FNV-1a, continues from the hash given so several texts make a single key
+static unsigned long long HashText(BTX::String const& a_sText, unsigned long long a_uHash)
 {
-	// Create the shaders
-	GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-	GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
-	
-	// Read the Vertex Shader code from the file
-	String VertexShaderCode;
-	std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
-	if(VertexShaderStream.is_open())
+	for (size_t i = 0; i < a_sText.size(); ++i)
 	{
-		String Line = "";
-		while(getline(VertexShaderStream, Line))
-			VertexShaderCode += "\n" + Line;
-		VertexShaderStream.close();
+		a_uHash ^= static_cast<unsigned char>(a_sText[i]);
+		a_uHash *= 1099511628211ULL;
 	}
-	else
+	return a_uHash;
+}
+//Reads a whole shader file, each line after a line break like the compiler always got it
+static bool ReadShaderFile(const char* a_sFileName, BTX::String& a_sCode)
+{
+	std::ifstream stream(a_sFileName, std::ios::in);
+	if (!stream.is_open())
+		return false;
+	BTX::String Line = "";
+	while (getline(stream, Line))
+		a_sCode += "\n" + Line;
+	stream.close();
+	return true;
+}
+//Makes the program from the cache file if it was saved for the same key and driver
+static GLuint LoadCachedProgram(const char* a_sCacheFile, unsigned long long a_uKey, BTX::String const& a_sDriver)
+{
+	BTX::FileReader reader;
+	if (reader.ReadBinaryFile(a_sCacheFile) != BTX::eBTX_OUTPUT::OUT_ERR_NONE)
+		return 0;
+
+	unsigned long long uKey = 0;
+	bool bValid = reader.ReadInt() == nShaderCacheTag;
+	bValid = bValid && reader.ReadInt() == nShaderCacheVersion;
+	bValid = bValid && reader.ReadBuffer(&uKey, sizeof(uKey)) && uKey == a_uKey;
+	bValid = bValid && reader.ReadString() == a_sDriver;
+	GLenum eFormat = bValid ? static_cast<GLenum>(reader.ReadInt()) : 0;
+	int nBytes = bValid ? reader.ReadInt() : 0;
+	std::vector<char> lBinary;
+	if (bValid && nBytes > 0)
+	{
+		lBinary.resize(nBytes);
+		bValid = reader.ReadBuffer(&lBinary[0], static_cast<BTX::uint>(nBytes));
+	}
+	reader.CloseFile();
+	if (!bValid || lBinary.empty())
+		return 0;
+
+	return BTX::RenderBackend::GetInstance()->CreateProgramFromBinary(eFormat, &lBinary[0], lBinary.size());
+}
+//Saves the binary of a linked program, nothing is saved if the driver gives none
+static void SaveCachedProgram(const char* a_sCacheFile, unsigned long long a_uKey, BTX::String const& a_sDriver, GLuint a_uProgram)
+{
+	std::vector<char> lBinary;
+	GLenum eFormat = 0;
+	if (!BTX::RenderBackend::GetInstance()->GetProgramBinary(a_uProgram, lBinary, eFormat) || lBinary.empty())
+		return;
+
+	CreateDirectoryA(BTX::FileReader::GetAbsoluteRoute(a_sCacheFile).c_str(), NULL);
+	BTX::FileReader writer;
+	if (writer.SaveBinaryFile(a_sCacheFile) != BTX::eBTX_OUTPUT::OUT_ERR_NONE)
+		return;
+	writer.WriteInt(nShaderCacheTag);
+	writer.WriteInt(nShaderCacheVersion);
+	writer.WriteBuffer(&a_uKey, sizeof(a_uKey));
+	writer.WriteString(a_sDriver);
+	writer.WriteInt(static_cast<int>(eFormat));
+	writer.WriteInt(static_cast<int>(lBinary.size()));
+	writer.WriteBuffer(&lBinary[0], lBinary.size());
+	writer.CloseFile();
+}
+
+GLuint BTX::LoadShaders( const char * vertex_file_path, const char * fragment_file_path, const char * cache_file_path)
+{
+	// Read the Vertex Shader code from the file
+	String VertexShaderCode;
+	if(!ReadShaderFile(vertex_file_path, VertexShaderCode))
 	{
 		printf("Impossible to open %s. Are you in the right directory?\n", vertex_file_path);
-		getchar();
+		//nobody is there to read the message without a window
+		if (RenderBackend::GetInstance()->GetType() == BACKEND_OPENGL)
+			getchar();
 		return 0;
 	}
 
 	// Read the Fragment Shader code from the file
 	String FragmentShaderCode;
-	std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
-	if(FragmentShaderStream.is_open())
+	ReadShaderFile(fragment_file_path, FragmentShaderCode);
+
+	// The cache is keyed by both sources and the driver, any change to them compiles again
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	String sDriver = "";
+	unsigned long long uKey = 14695981039346656037ULL;
+	if (cache_file_path != nullptr)
 	{
-		String Line = "";
-		while(getline(FragmentShaderStream, Line))
-			FragmentShaderCode += "\n" + Line;
-		FragmentShaderStream.close();
+		sDriver = pBackend->GetDriverID();
+		uKey = HashText(VertexShaderCode, uKey);
+		uKey = HashText(FragmentShaderCode, uKey);
+		uKey = HashText(sDriver, uKey);
+		GLuint ProgramID = LoadCachedProgram(cache_file_path, uKey, sDriver);
+		if (ProgramID != 0)
+			return ProgramID;
 	}
-	
-	GLint Result = GL_FALSE;
-	int InfoLogLength;
-	
-	// Compile Vertex Shader
+
+	// Compile and link through the backend, it prints the log if there is one
 	printf("	Vertex: %s", vertex_file_path);
-	char const * VertexSourcePointer = VertexShaderCode.c_str();
-	glShaderSource(VertexShaderID, 1, &VertexSourcePointer , NULL);
-	glCompileShader(VertexShaderID);
-	
-	//printf("\n");
-	// Compile Fragment Shader
 	printf("	Fragment: %s", fragment_file_path);
-	char const * FragmentSourcePointer = FragmentShaderCode.c_str();
-	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer , NULL);
-	glCompileShader(FragmentShaderID);
-
-	//Link the program
-	GLuint ProgramID = glCreateProgram();
-	glAttachShader(ProgramID, VertexShaderID);
-	glAttachShader(ProgramID, FragmentShaderID);
-	glLinkProgram(ProgramID);
-	//printf("\n	Program linked.\n");
 	printf("\n");
-	
-	// Check the program
-	glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
-	glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-	if ( InfoLogLength > 0 )
-	{
-		std::vector<char> ProgramErrorMessage(InfoLogLength+1);
-		glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
-		printf("%s\n", &ProgramErrorMessage[0]);
-	}	
+	GLuint ProgramID = pBackend->CreateProgram(VertexShaderCode, FragmentShaderCode);
 
-	glDeleteShader(VertexShaderID);
-	glDeleteShader(FragmentShaderID);
-	
+	if (cache_file_path != nullptr && ProgramID != 0)
+		SaveCachedProgram(cache_file_path, uKey, sDriver, ProgramID);
 	return ProgramID;
-}
\ No newline at end of file
+}
@@ -30,6 +30,9 @@ void ShaderManager::Init(void)
 
 	//Compile Line shader
 	CompileShader(pFolder->GetFolderShaders() + "Line.vs", pFolder->GetFolderShaders() + "Line.fs", "Line");
+
+	//Compile Bounds shader, instanced wire boxes and spheres
+	CompileShader(pFolder->GetFolderShaders() + "Bounds.vs", pFolder->GetFolderShaders() + "Line.fs", "Bounds");
 			
 	printf("\n");
 }
@@ -42,6 +45,9 @@ void ShaderManager::Release(void)
 	}
 
 	m_vShader.clear();
+	m_map.Clear();
+	m_mProgram.clear();
+	m_uShaderCount = 0;
 }
 ShaderManager* ShaderManager::GetInstance()
 {
@@ -73,18 +79,23 @@ GLuint ShaderManager::CompileShader(String a_sVertexShader, String a_sFragmentSh
 
 	Shader vShader;
 	printf("Compiling shader: %s\n", a_sName.c_str());
-	nShader = vShader.CompileShader(a_sVertexShader, a_sFragmentShader, a_sName);
+	String sCacheFile = "";
+	if (m_bBinaryCache)
+		sCacheFile = GetCacheFileName(a_sName != "" ? a_sName : a_sVertexShader + "||" + a_sFragmentShader);
+	nShader = vShader.CompileShader(a_sVertexShader, a_sFragmentShader, a_sName, sCacheFile);
 	m_vShader.push_back(vShader);
-	m_map[vShader.GetProgramName()] = m_uShaderCount;
+	m_map.Set(NameTable::GetInstance()->Intern(vShader.GetProgramName()), m_uShaderCount);
+	if (nShader != 0)
+		m_mProgram[nShader] = m_uShaderCount;
 	m_uShaderCount++;
 
 	return nShader;
 }
 int ShaderManager::IdentifyShader(String a_sName)
 {
-	auto var = m_map.find(a_sName);
-	if(var != m_map.end())
-		return var->second;
+	int* pShader = m_map.Find(NameTable::GetInstance()->Find(a_sName));
+	if(pShader != nullptr)
+		return *pShader;
 	return -1;
 }
 GLuint ShaderManager::GetShaderID(String a_sName)
@@ -96,6 +107,26 @@ GLuint ShaderManager::GetShaderID(String a_sName)
 		return m_vShader[nIndex].GetProgramID();
 }
 
+const GLint* ShaderManager::GetUniformTable(GLuint a_uProgram)
+{
+	static const std::vector<GLint> lUnknown(UNIFORM_COUNT, -1);
+	auto var = m_mProgram.find(a_uProgram);
+	if (var == m_mProgram.end())
+		return &lUnknown[0];
+	return m_vShader[var->second].GetUniformTable();
+}
+void ShaderManager::SetBinaryCache(bool a_bCache) { m_bBinaryCache = a_bCache; }
+bool ShaderManager::GetBinaryCache(void) { return m_bBinaryCache; }
+String ShaderManager::GetCacheFileName(String a_sName)
+{
+	//The name may be made of the file routes, keep it flat
+	for (uint i = 0; i < a_sName.size(); i++)
+	{
+		if (a_sName[i] == '\\' || a_sName[i] == '/' || a_sName[i] == ':' || a_sName[i] == '|')
+			a_sName[i] = '_';
+	}
+	return FolderSingleton::GetInstance()->GetFolderShaders() + "Cache\\" + a_sName + ".bsc";
+}
 GLuint ShaderManager::GetShaderID(uint a_uIndex)
 {
 	if(a_uIndex < 0 || a_uIndex >= m_uShaderCount)
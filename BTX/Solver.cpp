@@ -90,6 +90,8 @@ vector3 RoundSmallVelocity(vector3 a_v3Velocity, float minVelocity = 0.01f)
 }
 void Solver::Update(void)
 {
+	BTX_PROFILE_ZONE("Solver::Update");
+
 	ApplyForce(vector3(0.0f, -0.035f, 0.0f));
 
 	m_v3Velocity += m_v3Acceleration;
@@ -266,6 +266,10 @@ void SystemSingleton::Update()
 		dLastTime = GetTickCount();	// Refresh the value of frames
 	}
 	uFrameCount++;					// Increment the frame count
+
+	//close the frame of the profiler so its statistics follow the frames
+	if (Profiler::IsEnabled())
+		Profiler::GetInstance()->EndFrame();
 	return;
 }
 void SystemSingleton::StartClock(uint a_nClock)
@@ -1,6 +1,11 @@
 #include "BTX\Materials\Texture.h"
 using namespace BTX;
 
+static const int nCookedTag = 0x54585442; //"BTXT"
+static const int nCookedVersion = 1;
+//FreeImage gives 32 bit pixels in the order of the platform, the upload takes them as they are
+static const GLenum eDecodedFormat = (FREEIMAGE_COLORORDER == FREEIMAGE_COLORORDER_BGR) ? GL_BGRA : GL_RGBA;
+
 Texture::Texture(void) { Init(); }
 Texture::Texture(const Texture& other) { }
 Texture& Texture::operator=(const Texture& other) { return *this; }
@@ -8,15 +13,40 @@ Texture::~Texture(void) { Release(); }
 
 void Texture::Release(void)
 {
-	glDeleteTextures(1, &m_nTextureID);
+	RenderBackend::GetInstance()->DeleteTexture(m_nTextureID);
+	if (m_pPixels)
+	{
+		delete[] m_pPixels;
+		m_pPixels = nullptr;
+	}
 }
 void Texture::Init(void)
 {
 	m_nTextureID = 0;
 	m_pSystem = SystemSingleton::GetInstance();
 	m_sAbsoluteRoute = "";
+	m_pPixels = nullptr;
+	m_nWidth = 0;
+	m_nHeight = 0;
+	m_uLevels = 0;
+	m_eFormat = GL_RGBA;
 }
-bool Texture::LoadTexture(String a_sFileName)
+bool Texture::LoadTexture(String a_sFileName, bool a_bUseCooked)
+{
+	if (!ResolveFileName(a_sFileName))
+		return false;
+
+	if (!Decode(a_bUseCooked))
+		return false;
+
+	if (m_nTextureID > 0)// if the texture is already binded
+	{
+		RenderBackend::GetInstance()->DeleteTexture(m_nTextureID);
+		m_nTextureID = 0;
+	}
+	return Upload();
+}
+bool Texture::ResolveFileName(String a_sFileName)
 {
 	if (a_sFileName == "NULL")
 		return false;
@@ -38,82 +68,245 @@ bool Texture::LoadTexture(String a_sFileName)
 		m_sFileName += m_sName;
 	}
 	// Check for file existence
-	if (!FileReader::FileExists(m_sFileName))
-		return false;
+	return FileReader::FileExists(m_sFileName);
+}
+void Texture::SetName(String a_sName)
+{
+	m_sName = a_sName;
+	m_sAbsoluteRoute = m_pSystem->m_pFolder->GetFolderRoot();
+	m_sAbsoluteRoute += m_pSystem->m_pFolder->GetFolderData();
+	m_sAbsoluteRoute += m_pSystem->m_pFolder->GetFolderTextures();
+	m_sFileName = m_sAbsoluteRoute + m_sName;
+}
+bool Texture::Decode(bool a_bUseCooked)
+{
+	if (a_bUseCooked && ReadCooked())
+		return true;
 
 	//Based on Raul's implementation: http://www.raul-art.blogspot.com
 	FREE_IMAGE_FORMAT eFormat = FreeImage_GetFileType(m_sFileName.c_str(), 0);//Detect the file format
 	FIBITMAP* image = FreeImage_Load(eFormat, m_sFileName.c_str()); //Load the file as FreeImage imagefile
-	image = FreeImage_ConvertTo32Bits(image); //convert to 32bits
+	if (image == nullptr)
+	{
+		std::cout << "There was an error decoding the texture " << m_sFileName << std::endl;
+		return false;
+	}
+	FIBITMAP* image32 = FreeImage_ConvertTo32Bits(image); //convert to 32bits
+	FreeImage_Unload(image);
 
-	int w = FreeImage_GetWidth(image);
-	int h = FreeImage_GetHeight(image);
+	int w = FreeImage_GetWidth(image32);
+	int h = FreeImage_GetHeight(image32);
 #ifdef DEBUG
 	std::cout << "Tex: " << m_sFileName.c_str() << std::endl; //Some debugging code
 	std::cout << "               loaded with size [ " << w << " * " << h << "]" << std::endl;
 #endif
-	GLubyte* tempGLTexture = new GLubyte[4 * w * h];//Create a new texture to hold the information onto
-	char* pixeles = (char*)FreeImage_GetBits(image);//Create a pixel container
-							 //FreeImage loads in BGRA format, so you need to swap some bytes (Or use GL_BGR).
-	for (int nPixel = 0; nPixel < (w * h); nPixel++)
-	{
-		tempGLTexture[nPixel * 4 + 0] = pixeles[nPixel * 4 + 2];
-		tempGLTexture[nPixel * 4 + 1] = pixeles[nPixel * 4 + 1];
-		tempGLTexture[nPixel * 4 + 2] = pixeles[nPixel * 4 + 0];
-		tempGLTexture[nPixel * 4 + 3] = pixeles[nPixel * 4 + 3];
-	}
-	FreeImage_Unload(image); //OUT_DONE with the image, unload it
+	//32 bit rows are never padded, the bits go to the first level in a single copy
+	SetPixels(w, h, FreeImage_GetBits(image32), eDecodedFormat);
+	FreeImage_Unload(image32); //OUT_DONE with the image, unload it
 
-	if (m_nTextureID > 0)// if the texture is already binded
-	{
-		glDeleteTextures(1, &m_nTextureID);
-		/*#if _MSC_VER == 1800 //If visual studio 2013
-				 /*m_nTextureID = SOIL_load_OGL_texture
-				(
-					m_sFileName.c_str(),
-					SOIL_LOAD_AUTO,
-					SOIL_CREATE_NEW_ID,
-					SOIL_FLAG_INVERT_Y
-				);
-		#elif _MSC_VER == 1900 //If visual studio 2015
-
-
-		//#endif*/
-	}
-	//else
-	//{
-	//	m_nTextureID = SOIL_load_OGL_texture
-	//	(
-	//		m_sFileName.c_str(),
-	//		SOIL_LOAD_AUTO,
-	//		m_nTextureID,
-	//		SOIL_FLAG_INVERT_Y
-	//	);
-	//}
-
-	//Now generate the OpenGL texture object 
-	glGenTextures(1, &m_nTextureID); //Generate a container
-	glBindTexture(GL_TEXTURE_2D, m_nTextureID); //Set the active texture
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)tempGLTexture); //Set the data
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	if (a_bUseCooked)
+		SaveCooked();
+	return true;
+}
+void Texture::SetPixels(int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat, bool a_bMips)
+{
+	if (m_pPixels)
+		delete[] m_pPixels;
+	m_nWidth = a_nWidth;
+	m_nHeight = a_nHeight;
+	m_eFormat = a_eFormat;
+	m_uLevels = a_bMips ? GetMipCount(a_nWidth, a_nHeight) : 1;
+	m_pPixels = new GLubyte[GetMipChainSize(a_nWidth, a_nHeight, m_uLevels)];
+	memcpy(m_pPixels, a_pPixels, 4 * a_nWidth * a_nHeight);
+	GenerateMips(m_pPixels, a_nWidth, a_nHeight, m_uLevels);
+}
+void Texture::ReserveGLTextureID(void)
+{
+	if (m_nTextureID == 0)
+		m_nTextureID = RenderBackend::GetInstance()->CreateTexture();
+}
+bool Texture::Upload(void)
+{
+	if (m_pPixels == nullptr)
+		return false;
+
+	//Now generate the OpenGL texture object, reuse the name if it was reserved
+	ReserveGLTextureID(); //Generate a container
+	bool bSent = RenderBackend::GetInstance()->TextureImage(m_nTextureID, m_nWidth, m_nHeight, m_pPixels, m_uLevels, m_eFormat); //Set the data
 
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-	if (glGetError())
+	//OpenGL keeps its own copy of the pixels
+	delete[] m_pPixels;
+	m_pPixels = nullptr;
+
+	if (!bSent)
 	{
 		std::cout << "There was an error loading the texture" << std::endl;
 		return false;
 	}
 	return true;
 }
+uint Texture::GetMipCount(int a_nWidth, int a_nHeight)
+{
+	uint uLevels = 1;
+	int nSize = std::max(a_nWidth, a_nHeight);
+	while (nSize > 1)
+	{
+		nSize /= 2;
+		uLevels++;
+	}
+	return uLevels;
+}
+uint Texture::GetMipChainSize(int a_nWidth, int a_nHeight, uint a_uLevels)
+{
+	uint uBytes = 0;
+	for (uint uLevel = 0; uLevel < a_uLevels; ++uLevel)
+	{
+		uBytes += 4 * a_nWidth * a_nHeight;
+		a_nWidth = std::max(a_nWidth / 2, 1);
+		a_nHeight = std::max(a_nHeight / 2, 1);
+	}
+	return uBytes;
+}
+void Texture::GenerateMips(GLubyte* a_pChain, int a_nWidth, int a_nHeight, uint a_uLevels)
+{
+	GLubyte* pSource = a_pChain;
+	int nWidth = a_nWidth;
+	int nHeight = a_nHeight;
+	for (uint uLevel = 1; uLevel < a_uLevels; ++uLevel)
+	{
+		int nLevelWidth = std::max(nWidth / 2, 1);
+		int nLevelHeight = std::max(nHeight / 2, 1);
+		GLubyte* pTarget = pSource + 4 * nWidth * nHeight;
+		for (int y = 0; y < nLevelHeight; ++y)
+		{
+			//a side of 1 has nothing to pair with, it is averaged with itself
+			const GLubyte* pRow0 = pSource + 4 * nWidth * std::min(2 * y, nHeight - 1);
+			const GLubyte* pRow1 = pSource + 4 * nWidth * std::min(2 * y + 1, nHeight - 1);
+			GLubyte* pOut = pTarget + 4 * nLevelWidth * y;
+			for (int x = 0; x < nLevelWidth; ++x)
+			{
+				int nX0 = 4 * std::min(2 * x, nWidth - 1);
+				int nX1 = 4 * std::min(2 * x + 1, nWidth - 1);
+				for (int c = 0; c < 4; ++c)
+				{
+					uint uSum = pRow0[nX0 + c] + pRow0[nX1 + c] + pRow1[nX0 + c] + pRow1[nX1 + c];
+					pOut[4 * x + c] = static_cast<GLubyte>((uSum + 2) >> 2);
+				}
+			}
+		}
+		pSource = pTarget;
+		nWidth = nLevelWidth;
+		nHeight = nLevelHeight;
+	}
+}
+String Texture::GetCookedFileName(String a_sFileName)
+{
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	String sTextures = pFolder->GetFolderRoot() + pFolder->GetFolderData() + pFolder->GetFolderTextures();
+
+	//Keep the route inside of Textures in the name so textures in different folders don't collide
+	String sName = a_sFileName;
+	if (sName.compare(0, sTextures.size(), sTextures) == 0)
+		sName = sName.substr(sTextures.size());
+	for (uint i = 0; i < sName.size(); i++)
+	{
+		if (sName[i] == '\\' || sName[i] == '/' || sName[i] == ':')
+			sName[i] = '_';
+	}
+	return sTextures + "Cache\\" + sName + ".btt";
+}
+bool Texture::SaveCooked(void)
+{
+	unsigned long long uSourceSize = 0;
+	unsigned long long uSourceTime = 0;
+	if (m_pPixels == nullptr || !FileReader::GetFileStamp(m_sFileName, &uSourceSize, &uSourceTime))
+		return false;
+
+	String sCookedFile = GetCookedFileName(m_sFileName);
+	CreateDirectoryA(FileReader::GetAbsoluteRoute(sCookedFile).c_str(), NULL);
+
+	FileReader writer;
+	if (writer.SaveBinaryFile(sCookedFile) != eBTX_OUTPUT::OUT_ERR_NONE)
+		return false;
+
+	//Header
+	writer.WriteInt(nCookedTag);
+	writer.WriteInt(nCookedVersion);
+	writer.WriteString(m_sFileName);
+	writer.WriteBuffer(&uSourceSize, sizeof(uSourceSize));
+	writer.WriteBuffer(&uSourceTime, sizeof(uSourceTime));
+
+	//Levels
+	writer.WriteInt(m_nWidth);
+	writer.WriteInt(m_nHeight);
+	writer.WriteInt(m_uLevels);
+	writer.WriteInt(m_eFormat);
+	writer.WriteBuffer(m_pPixels, GetMipChainSize(m_nWidth, m_nHeight, m_uLevels));
+	writer.CloseFile();
+	return true;
+}
+bool Texture::ReadCooked(void)
+{
+	unsigned long long uSourceSize = 0;
+	unsigned long long uSourceTime = 0;
+	if (!FileReader::GetFileStamp(m_sFileName, &uSourceSize, &uSourceTime))
+		return false;
+
+	FileReader reader;
+	if (reader.ReadBinaryFile(GetCookedFileName(m_sFileName)) != eBTX_OUTPUT::OUT_ERR_NONE)
+		return false;
+
+	//A cooked file of another version or of an older source is ignored and made again
+	unsigned long long uSize = 0;
+	unsigned long long uTime = 0;
+	bool bValid = reader.ReadInt() == nCookedTag;
+	bValid = bValid && reader.ReadInt() == nCookedVersion;
+	bValid = bValid && reader.ReadString() == m_sFileName;
+	bValid = bValid && reader.ReadBuffer(&uSize, sizeof(uSize)) && uSize == uSourceSize;
+	bValid = bValid && reader.ReadBuffer(&uTime, sizeof(uTime)) && uTime == uSourceTime;
+	int nWidth = bValid ? reader.ReadInt() : 0;
+	int nHeight = bValid ? reader.ReadInt() : 0;
+	uint uLevels = bValid ? reader.ReadInt() : 0;
+	GLenum eFormat = bValid ? static_cast<GLenum>(reader.ReadInt()) : 0;
+	bValid = bValid && nWidth > 0 && nHeight > 0 && uLevels > 0 && uLevels <= GetMipCount(nWidth, nHeight);
+	bValid = bValid && (eFormat == GL_RGBA || eFormat == GL_BGRA);
+	if (!bValid)
+	{
+		reader.CloseFile();
+		return false;
+	}
+
+	uint uBytes = GetMipChainSize(nWidth, nHeight, uLevels);
+	GLubyte* pPixels = new GLubyte[uBytes];
+	if (!reader.ReadBuffer(pPixels, uBytes))
+	{
+		delete[] pPixels;
+		reader.CloseFile();
+		return false;
+	}
+	reader.CloseFile();
+
+	if (m_pPixels)
+		delete[] m_pPixels;
+	m_pPixels = pPixels;
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	m_uLevels = uLevels;
+	m_eFormat = eFormat;
+	return true;
+}
 
 //Accessors
 GLuint Texture::GetGLTextureID(void) { return m_nTextureID; }
 String Texture::GetName(void) { return m_sName; }
 String Texture::GetFileName(void) { return m_sFileName; }
 String Texture::GetAbsoluteRoute(void) { return m_sAbsoluteRoute; }
+int Texture::GetWidth(void) { return m_nWidth; }
+int Texture::GetHeight(void) { return m_nHeight; }
+uint Texture::GetLevelCount(void) { return m_uLevels; }
+const GLubyte* Texture::GetPixels(void) { return m_pPixels; }
+GLenum Texture::GetFormat(void) { return m_eFormat; }
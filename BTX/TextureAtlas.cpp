@@ -0,0 +1,252 @@
+#include "BTX\Materials\TextureAtlas.h"
+//imgui keeps its own static copy of the packer, the atlas gets another one
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui\stb_rect_pack.h"
+using namespace BTX;
+
+//The big 3
+TextureAtlas::TextureAtlas(String a_sName, int a_nMaxSize, int a_nGutter)
+{
+	Init();
+	m_sName = a_sName;
+	//the packer keeps its coordinates in 16 bits
+	m_nMaxSize = std::max(std::min(a_nMaxSize, 65535), 1);
+	m_nGutter = std::max(a_nGutter, 0);
+}
+TextureAtlas::TextureAtlas(TextureAtlas const& other)
+{
+	Init();
+	m_sName = other.m_sName;
+	m_nMaxSize = other.m_nMaxSize;
+	m_nGutter = other.m_nGutter;
+	m_eFormat = other.m_eFormat;
+	m_lSource = other.m_lSource;
+	m_map = other.m_map;
+	m_lRegion = other.m_lRegion;
+	m_lPageTexture = other.m_lPageTexture;
+	m_lPageMaterial = other.m_lPageMaterial;
+}
+TextureAtlas& TextureAtlas::operator=(TextureAtlas const& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Init();
+		TextureAtlas temp(other);
+		Swap(temp);
+	}
+	return *this;
+}
+TextureAtlas::~TextureAtlas(void) { Release(); }
+void TextureAtlas::Swap(TextureAtlas& other)
+{
+	std::swap(m_sName, other.m_sName);
+	std::swap(m_nMaxSize, other.m_nMaxSize);
+	std::swap(m_nGutter, other.m_nGutter);
+	std::swap(m_eFormat, other.m_eFormat);
+	std::swap(m_lSource, other.m_lSource);
+	std::swap(m_map, other.m_map);
+	std::swap(m_lRegion, other.m_lRegion);
+	std::swap(m_lPageTexture, other.m_lPageTexture);
+	std::swap(m_lPageMaterial, other.m_lPageMaterial);
+	std::swap(m_pTextureMngr, other.m_pTextureMngr);
+	std::swap(m_pMatMngr, other.m_pMatMngr);
+}
+void TextureAtlas::Release(void)
+{
+	m_lSource.clear();
+	m_map.Clear();
+	m_lRegion.clear();
+	m_lPageTexture.clear();
+	m_lPageMaterial.clear();
+}
+void TextureAtlas::Init(void)
+{
+	m_pTextureMngr = TextureManager::GetInstance();
+	m_pMatMngr = MaterialManager::GetInstance();
+}
+//Accessors
+uint TextureAtlas::GetSourceCount(void) { return m_lSource.size(); }
+uint TextureAtlas::GetPageCount(void) { return m_lPageTexture.size(); }
+String TextureAtlas::GetPageName(uint a_uPage) { return m_sName + "_" + std::to_string(a_uPage); }
+int TextureAtlas::GetPageMaterial(uint a_uPage)
+{
+	if (a_uPage >= m_lPageMaterial.size())
+		return -1;
+	return m_lPageMaterial[a_uPage];
+}
+String TextureAtlas::GetName(void) { return m_sName; }
+TextureAtlas::Region TextureAtlas::GetRegion(uint a_uSource)
+{
+	if (a_uSource >= m_lRegion.size())
+		return Region();
+	return m_lRegion[a_uSource];
+}
+//--- Methods
+int TextureAtlas::IdentifySource(String a_sName)
+{
+	NameTable* pNames = NameTable::GetInstance();
+	int* pSource = m_map.Find(pNames->Find(a_sName));
+	if (pSource == nullptr)
+		pSource = m_map.Find(pNames->Find(FileReader::GetFileNameAndExtension(a_sName)));
+	if (pSource != nullptr)
+		return *pSource;
+	return -1;
+}
+int TextureAtlas::AddTexture(String a_sFileName)
+{
+	Texture texture;
+	if (!texture.ResolveFileName(a_sFileName))
+		return -1;
+	if (!texture.Decode(m_pTextureMngr->IsCookedTextures()))
+		return -1;
+	//only the first level is packed, the pages make their own mip levels
+	return AddPixels(texture.GetName(), texture.GetWidth(), texture.GetHeight(), texture.GetPixels(), texture.GetFormat());
+}
+int TextureAtlas::AddPixels(String a_sName, int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat)
+{
+	if (a_pPixels == nullptr || a_nWidth < 1 || a_nHeight < 1)
+		return -1;
+	if (a_nWidth + 2 * m_nGutter > m_nMaxSize || a_nHeight + 2 * m_nGutter > m_nMaxSize)
+		return -1;
+
+	//a source with the same name gets the new pixels
+	uint uName = NameTable::GetInstance()->Intern(a_sName);
+	int nSource = -1;
+	int* pSource = m_map.Find(uName);
+	if (pSource != nullptr)
+		nSource = *pSource;
+	else
+	{
+		nSource = m_lSource.size();
+		m_lSource.push_back(Source());
+		m_map.Set(uName, nSource);
+	}
+
+	if (m_eFormat == GL_NONE)
+		m_eFormat = a_eFormat;
+	Source& source = m_lSource[nSource];
+	source.sName = a_sName;
+	source.nWidth = a_nWidth;
+	source.nHeight = a_nHeight;
+	source.lPixels.assign(a_pPixels, a_pPixels + 4 * a_nWidth * a_nHeight);
+	//a page has a single channel order, the sources that differ swap red and blue
+	if (a_eFormat != m_eFormat)
+	{
+		for (uint i = 0; i < source.lPixels.size(); i += 4)
+			std::swap(source.lPixels[i], source.lPixels[i + 2]);
+	}
+	return nSource;
+}
+void TextureAtlas::CopySource(Source const& a_Source, GLubyte* a_pPage, int a_nPageWidth, int a_nX, int a_nY)
+{
+	int nWidth = a_Source.nWidth;
+	int nHeight = a_Source.nHeight;
+	for (int y = 0; y < nHeight + 2 * m_nGutter; ++y)
+	{
+		//the gutter repeats the closest row and column of the source
+		int nRow = std::min(std::max(y - m_nGutter, 0), nHeight - 1);
+		const GLubyte* pRow = &a_Source.lPixels[4 * nWidth * nRow];
+		GLubyte* pOut = a_pPage + 4 * (a_nPageWidth * (a_nY + y) + a_nX);
+		for (int x = 0; x < m_nGutter; ++x)
+		{
+			memcpy(pOut + 4 * x, pRow, 4);
+			memcpy(pOut + 4 * (m_nGutter + nWidth + x), pRow + 4 * (nWidth - 1), 4);
+		}
+		memcpy(pOut + 4 * m_nGutter, pRow, 4 * nWidth);
+	}
+}
+uint TextureAtlas::Pack(void)
+{
+	BTX_PROFILE_ZONE("TextureAtlas::Pack");
+
+	uint uSources = m_lSource.size();
+	m_lRegion.assign(uSources, Region());
+	m_lPageTexture.clear();
+	m_lPageMaterial.clear();
+
+	std::vector<stbrp_rect> lPending(uSources);
+	for (uint i = 0; i < uSources; i++)
+	{
+		lPending[i].id = i;
+		lPending[i].w = static_cast<stbrp_coord>(m_lSource[i].nWidth + 2 * m_nGutter);
+		lPending[i].h = static_cast<stbrp_coord>(m_lSource[i].nHeight + 2 * m_nGutter);
+	}
+
+	//every page takes as many of the sources left as it can, AddPixels made sure each one fits
+	std::vector<stbrp_node> lNode(m_nMaxSize);
+	std::vector<stbrp_rect> lLeft;
+	while (!lPending.empty())
+	{
+		stbrp_context context;
+		stbrp_init_target(&context, m_nMaxSize, m_nMaxSize, &lNode[0], lNode.size());
+		stbrp_pack_rects(&context, &lPending[0], lPending.size());
+
+		//the page only needs to reach the furthest source, rounded up to a power of two
+		int nUsedWidth = 1;
+		int nUsedHeight = 1;
+		lLeft.clear();
+		for (uint i = 0; i < lPending.size(); i++)
+		{
+			stbrp_rect const& rect = lPending[i];
+			if (!rect.was_packed)
+			{
+				lLeft.push_back(rect);
+				continue;
+			}
+			nUsedWidth = std::max(nUsedWidth, rect.x + rect.w);
+			nUsedHeight = std::max(nUsedHeight, rect.y + rect.h);
+		}
+		if (lLeft.size() == lPending.size())
+			break;
+		int nWidth = 1;
+		while (nWidth < nUsedWidth)
+			nWidth *= 2;
+		int nHeight = 1;
+		while (nHeight < nUsedHeight)
+			nHeight *= 2;
+		nWidth = std::min(nWidth, m_nMaxSize);
+		nHeight = std::min(nHeight, m_nMaxSize);
+
+		uint uPage = m_lPageTexture.size();
+		std::vector<GLubyte> lPixels(4 * nWidth * nHeight, 0);
+		for (uint i = 0; i < lPending.size(); i++)
+		{
+			stbrp_rect const& rect = lPending[i];
+			if (!rect.was_packed)
+				continue;
+			Source const& source = m_lSource[rect.id];
+			CopySource(source, &lPixels[0], nWidth, rect.x, rect.y);
+			Region& region = m_lRegion[rect.id];
+			region.nPage = uPage;
+			region.v2Offset = vector2(static_cast<float>(rect.x + m_nGutter) / nWidth, static_cast<float>(rect.y + m_nGutter) / nHeight);
+			region.v2Scale = vector2(static_cast<float>(source.nWidth) / nWidth, static_cast<float>(source.nHeight) / nHeight);
+		}
+		m_lPageTexture.push_back(m_pTextureMngr->AddTexture(GetPageName(uPage), nWidth, nHeight, &lPixels[0], m_eFormat));
+		lPending.swap(lLeft);
+	}
+
+	//one material per page, a page made again keeps its texture name so the material stays valid
+	for (uint uPage = 0; uPage < m_lPageTexture.size(); uPage++)
+	{
+		String sPage = GetPageName(uPage);
+		int nMaterial = m_pMatMngr->IdentifyMaterial(sPage);
+		if (nMaterial < 0)
+		{
+			Material material(sPage);
+			material.SetDiffuseMapName(sPage);
+			nMaterial = m_pMatMngr->AddMaterial(material);
+		}
+		m_lPageMaterial.push_back(nMaterial);
+	}
+	return m_lPageTexture.size();
+}
+vector3 TextureAtlas::TransformUV(uint a_uSource, vector3 a_v3UV)
+{
+	if (a_uSource >= m_lRegion.size() || m_lRegion[a_uSource].nPage < 0)
+		return a_v3UV;
+	Region const& region = m_lRegion[a_uSource];
+	vector2 v2UV = region.v2Offset + vector2(a_v3UV) * region.v2Scale;
+	return vector3(v2UV, a_v3UV.z);
+}
@@ -24,6 +24,11 @@ void TextureManager::ReleaseInstance()
 //--- Non Standard Singleton Methods
 void TextureManager::Release(void)
 {
+	//The decoders write into the textures, wait for them before deleting anything
+	for (uint i = 0; i < m_lPending.size(); i++)
+		m_lPending[i].Decoded.wait();
+	m_lPending.clear();
+
 	int nTextures = static_cast<int>(m_textureList.size());
 	for(int nTexture = 0; nTexture < nTextures; nTexture++)
 	{
@@ -49,9 +54,9 @@ int TextureManager::IdentifyTexure(String a_sName)
 		a_sName = sName + a_sName;
 	}
 
-	auto var = m_map.find(a_sName);
-	if(var != m_map.end())
-		return var->second;
+	int* pTexture = m_map.Find(NameTable::GetInstance()->Find(a_sName));
+	if(pTexture != nullptr)
+		return *pTexture;
 	return -1;
 }
 int TextureManager::LoadTexture(String a_sName)
@@ -62,11 +67,21 @@ int TextureManager::LoadTexture(String a_sName)
 	if(nTexture == -1)
 	{
 		Texture* pTextureTemp = new Texture();
-		if (pTextureTemp->LoadTexture(a_sName))
+		//in the background we only need to know that the file is there
+		bool bLoaded = m_bAsync ? pTextureTemp->ResolveFileName(a_sName) : pTextureTemp->LoadTexture(a_sName, m_bCooked);
+		if (bLoaded)
 		{
 			m_textureList.push_back(pTextureTemp);
 			nTexture = GetTextureCount() - 1;
-			m_map[pTextureTemp->GetFileName()] = nTexture;
+			m_map.Set(NameTable::GetInstance()->Intern(pTextureTemp->GetFileName()), nTexture);
+			if (m_bAsync)
+			{
+				pTextureTemp->ReserveGLTextureID();
+				PendingTexture pending;
+				pending.nIndex = nTexture;
+				pending.Decoded = std::async(std::launch::async, &Texture::Decode, pTextureTemp, m_bCooked);
+				m_lPending.push_back(std::move(pending));
+			}
 		}
 		else
 		{
@@ -80,11 +95,69 @@ int TextureManager::LoadTexture(String a_sName)
 	}
 	return nTexture;
 }
+int TextureManager::AddTexture(String a_sName, int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat,
+	bool a_bMips)
+{
+	if (a_pPixels == nullptr || a_nWidth < 1 || a_nHeight < 1)
+		return -1;
+
+	int nTexture = IdentifyTexure(a_sName);
+	if (nTexture == -1)
+	{
+		Texture* pTexture = new Texture();
+		pTexture->SetName(a_sName);
+		m_textureList.push_back(pTexture);
+		nTexture = GetTextureCount() - 1;
+		m_map.Set(NameTable::GetInstance()->Intern(pTexture->GetFileName()), nTexture);
+	}
+	else
+	{
+		//a decode still running would write over the new pixels
+		for (uint i = 0; i < m_lPending.size(); i++)
+		{
+			if (m_lPending[i].nIndex != nTexture)
+				continue;
+			m_lPending[i].Decoded.wait();
+			m_lPending.erase(m_lPending.begin() + i);
+			break;
+		}
+	}
+	Texture* pTexture = m_textureList[nTexture];
+	pTexture->SetPixels(a_nWidth, a_nHeight, a_pPixels, a_eFormat, a_bMips);
+	return pTexture->Upload() ? nTexture : -1;
+}
+void TextureManager::SetAsyncLoading(bool a_bAsync) { m_bAsync = a_bAsync; }
+bool TextureManager::IsAsyncLoading(void) { return m_bAsync; }
+void TextureManager::SetCookedTextures(bool a_bCooked) { m_bCooked = a_bCooked; }
+bool TextureManager::IsCookedTextures(void) { return m_bCooked; }
+uint TextureManager::UpdateLoads(uint a_uBudget)
+{
+	uint uUploaded = 0;
+	for (uint i = 0; i < m_lPending.size() && uUploaded < a_uBudget;)
+	{
+		PendingTexture& pending = m_lPending[i];
+		if (pending.Decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++i;
+			continue;
+		}
+		//a texture that could not be decoded keeps its empty name and samples as black
+		if (pending.Decoded.get())
+			m_textureList[pending.nIndex]->Upload();
+		m_lPending.erase(m_lPending.begin() + i);
+		++uUploaded;
+	}
+	return m_lPending.size();
+}
 void TextureManager::SaveScreenshot(String a_sTextureName)
 {
 	//TODO: remove tint in the texture.
 	//Based on http://stackoverflow.com/questions/5844858/how-to-take-screenshot-in-opengl
 
+	//There is no window to read without OpenGL
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_OPENGL)
+		return;
+
 	// Make the BYTE array, factor of 3 because it's RBG.
 	SystemSingleton* pSystem = SystemSingleton::GetInstance();
 	GLubyte* pixels = new GLubyte[4 * pSystem->GetWindowWidth() * pSystem->GetWindowHeight()];
@@ -0,0 +1,183 @@
+#include "Benchmark.h"
+#include <crtdbg.h>
+
+#ifdef _DEBUG
+//The debug runtime is shared by the executable and the dlls, its hook sees all of their allocations
+static std::atomic<unsigned long long> uAllocationCount(0);
+static int AllocationHook(int a_nType, void* a_pData, size_t a_uSize, int a_nBlockType, long a_lRequest,
+	const unsigned char* a_sFile, int a_nLine)
+{
+	if ((a_nType == _HOOK_ALLOC || a_nType == _HOOK_REALLOC) && a_nBlockType != _CRT_BLOCK)
+		uAllocationCount++;
+	return TRUE;
+}
+#endif
+
+unsigned long long Benchmark::GetAllocationCount(void)
+{
+#ifdef _DEBUG
+	return uAllocationCount.load();
+#else
+	return 0;
+#endif
+}
+bool Benchmark::CountsAllocations(void)
+{
+#ifdef _DEBUG
+	return true;
+#else
+	return false;
+#endif
+}
+Benchmark::Benchmark(void)
+{
+#ifdef _DEBUG
+	_CrtSetAllocHook(AllocationHook);
+#endif
+}
+Benchmark::Benchmark(Benchmark const& other) {}
+Benchmark& Benchmark::operator=(Benchmark const& other) { return *this; }
+Benchmark::~Benchmark(void)
+{
+	for (uint i = 0; i < m_lScenario.size(); i++)
+	{
+		SafeDelete(m_lScenario[i]);
+	}
+	m_lScenario.clear();
+}
+void Benchmark::AddScenario(Scenario* a_pScenario)
+{
+	if (a_pScenario)
+		m_lScenario.push_back(a_pScenario);
+}
+void Benchmark::SetIterations(uint a_uIterations, uint a_uWarmup)
+{
+	m_uIterations = std::max(a_uIterations, 1u);
+	m_uWarmup = a_uWarmup;
+}
+void Benchmark::SetFilter(String a_sFilter) { m_sFilter = a_sFilter; }
+void Benchmark::Run(void)
+{
+	m_lResult.clear();
+	for (uint i = 0; i < m_lScenario.size(); i++)
+	{
+		Scenario* pScenario = m_lScenario[i];
+		if (m_sFilter != "" && pScenario->GetName().find(m_sFilter) == String::npos)
+			continue;
+		std::cerr << "Running " << pScenario->GetName() << " " << pScenario->GetParameters() << std::endl;
+		m_lResult.push_back(Measure(pScenario));
+	}
+}
+uint Benchmark::GetFailureCount(void)
+{
+	uint uFailures = 0;
+	for (uint i = 0; i < m_lResult.size(); i++)
+	{
+		if (m_lResult[i].sError != "")
+			uFailures++;
+	}
+	return uFailures;
+}
+//Value under which a_dPercent of the sorted samples fall, nearest rank
+static double Percentile(std::vector<double> const& a_lSorted, double a_dPercent)
+{
+	uint uRank = static_cast<uint>(std::ceil(a_dPercent / 100.0 * a_lSorted.size()));
+	if (uRank > 0)
+		uRank--;
+	return a_lSorted[std::min<uint>(uRank, a_lSorted.size() - 1)];
+}
+BenchmarkResult Benchmark::Measure(Scenario* a_pScenario)
+{
+	BenchmarkResult result;
+	result.sName = a_pScenario->GetName();
+	result.sParameters = a_pScenario->GetParameters();
+	result.uOperations = std::max(a_pScenario->GetOperations(), 1u);
+	if (!a_pScenario->Setup())
+	{
+		result.bSkipped = true;
+		a_pScenario->Teardown();
+		return result;
+	}
+
+	for (uint i = 0; i < m_uWarmup; i++)
+		a_pScenario->Run();
+
+	std::vector<double> lSample(m_uIterations);
+	unsigned long long uAllocations = GetAllocationCount();
+	for (uint i = 0; i < m_uIterations; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		a_pScenario->Run();
+		auto end = std::chrono::steady_clock::now();
+		lSample[i] = std::chrono::duration<double, std::nano>(end - start).count() / result.uOperations;
+	}
+	uAllocations = GetAllocationCount() - uAllocations;
+	result.sCounters = a_pScenario->GetCounters();
+	result.sError = a_pScenario->GetError();
+	a_pScenario->Teardown();
+
+	double dTotal = 0.0;
+	for (uint i = 0; i < lSample.size(); i++)
+		dTotal += lSample[i];
+	std::sort(lSample.begin(), lSample.end());
+	result.uIterations = m_uIterations;
+	result.dMean = dTotal / lSample.size();
+	result.dMin = lSample.front();
+	result.dP50 = Percentile(lSample, 50.0);
+	result.dP90 = Percentile(lSample, 90.0);
+	result.dP99 = Percentile(lSample, 99.0);
+	result.dMax = lSample.back();
+	if (CountsAllocations())
+		result.dAllocations = static_cast<double>(uAllocations) / (static_cast<double>(m_uIterations) * result.uOperations);
+	return result;
+}
+String Benchmark::ToJSON(void)
+{
+	std::stringstream stream;
+	stream << "{\n";
+#ifdef _DEBUG
+	stream << "  \"configuration\": \"debug\",\n";
+#else
+	stream << "  \"configuration\": \"release\",\n";
+#endif
+	stream << "  \"iterations\": " << m_uIterations << ",\n";
+	stream << "  \"warmup\": " << m_uWarmup << ",\n";
+	stream << "  \"benchmarks\": [\n";
+	for (uint i = 0; i < m_lResult.size(); i++)
+	{
+		BenchmarkResult& result = m_lResult[i];
+		stream << "    {\"name\": \"" << result.sName << "\", \"parameters\": " << result.sParameters;
+		if (result.bSkipped)
+		{
+			stream << ", \"skipped\": true}";
+		}
+		else
+		{
+			stream << std::fixed;
+			stream.precision(1);
+			stream << ", \"iterations\": " << result.uIterations
+				<< ", \"operations\": " << result.uOperations
+				<< ", \"ns_per_op\": " << result.dMean
+				<< ", \"min\": " << result.dMin
+				<< ", \"p50\": " << result.dP50
+				<< ", \"p90\": " << result.dP90
+				<< ", \"p99\": " << result.dP99
+				<< ", \"max\": " << result.dMax;
+			stream.precision(3);
+			stream << ", \"allocations_per_op\": ";
+			if (result.dAllocations < 0.0)
+				stream << "null";
+			else
+				stream << result.dAllocations;
+			if (result.sCounters != "")
+				stream << ", \"counters\": " << result.sCounters;
+			if (result.sError != "")
+				stream << ", \"error\": \"" << result.sError << "\"";
+			stream << "}";
+			stream.unsetf(std::ios::floatfield);
+		}
+		stream << (i + 1 < m_lResult.size() ? ",\n" : "\n");
+	}
+	stream << "  ]\n}\n";
+	return stream.str();
+}
@@ -0,0 +1,178 @@
+#ifndef __BENCHMARK_H_
+#define __BENCHMARK_H_
+
+#include "BTX\BTX.h"
+
+using namespace BTX;
+
+//A measured piece of work, only Run is timed
+class Scenario
+{
+protected:
+	String m_sName = ""; //Name of the scenario, used by the filter
+	String m_sParameters = "{}"; //JSON object with the parameters of the scenario
+	uint m_uOperations = 1; //Operations done by each call to Run, the times are reported per operation
+	String m_sError = ""; //Why the results of the scenario are wrong, empty while they are right
+
+public:
+	/*
+	USAGE: Destructor
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	virtual ~Scenario(void) {}
+	/*
+	USAGE: Gets the name of the scenario
+	ARGUMENTS: ---
+	OUTPUT: name
+	*/
+	String GetName(void) { return m_sName; }
+	/*
+	USAGE: Gets the parameters of the scenario
+	ARGUMENTS: ---
+	OUTPUT: JSON object
+	*/
+	String GetParameters(void) { return m_sParameters; }
+	/*
+	USAGE: Gets the operations done by each call to Run
+	ARGUMENTS: ---
+	OUTPUT: operation count
+	*/
+	uint GetOperations(void) { return m_uOperations; }
+	/*
+	USAGE: Gets why the results of the scenario are wrong, asked before Teardown
+	ARGUMENTS: ---
+	OUTPUT: description of the failed check, empty if every check passed
+	*/
+	String GetError(void) { return m_sError; }
+	/*
+	USAGE: Gets the values the scenario counted during the last Run, asked before Teardown
+	ARGUMENTS: ---
+	OUTPUT: JSON object, empty if the scenario counts nothing
+	*/
+	virtual String GetCounters(void) { return ""; }
+	/*
+	USAGE: Makes the data the scenario works on, not timed
+	ARGUMENTS: ---
+	OUTPUT: can the scenario run? (missing files and the like skip it)
+	*/
+	virtual bool Setup(void) { return true; }
+	/*
+	USAGE: Does the measured work once
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	virtual void Run(void) = 0;
+	/*
+	USAGE: Releases the data of the scenario, not timed
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	virtual void Teardown(void) {}
+};
+
+//Measurements of a scenario, times in nanoseconds per operation
+struct BenchmarkResult
+{
+	String sName = ""; //Name of the scenario
+	String sParameters = "{}"; //Parameters of the scenario
+	String sCounters = ""; //Values counted by the scenario in its last Run
+	String sError = ""; //Check the scenario failed, empty if it passed
+	bool bSkipped = false; //Did Setup refuse to run?
+	uint uIterations = 0; //Timed calls to Run
+	uint uOperations = 0; //Operations per call to Run
+	double dMean = 0.0;
+	double dMin = 0.0;
+	double dP50 = 0.0;
+	double dP90 = 0.0;
+	double dP99 = 0.0;
+	double dMax = 0.0;
+	double dAllocations = -1.0; //Heap allocations per operation, negative when they could not be counted
+};
+
+//Runs scenarios and reports them as JSON
+class Benchmark
+{
+	std::vector<Scenario*> m_lScenario; //Scenarios to run, owned by the benchmark
+	std::vector<BenchmarkResult> m_lResult; //Results of the last Run
+	uint m_uWarmup = 3; //Untimed calls to Run before measuring
+	uint m_uIterations = 30; //Timed calls to Run
+	String m_sFilter = ""; //Only the scenarios with this in their name run, empty runs all
+
+public:
+	/*
+	USAGE: Constructor
+	ARGUMENTS: ---
+	OUTPUT: class object instance
+	*/
+	Benchmark(void);
+	/*
+	USAGE: Destructor, deletes the scenarios
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	~Benchmark(void);
+	/*
+	USAGE: Adds a scenario, the benchmark deletes it
+	ARGUMENTS: Scenario* a_pScenario -> scenario to add
+	OUTPUT: ---
+	*/
+	void AddScenario(Scenario* a_pScenario);
+	/*
+	USAGE: Sets the timed and untimed calls to Run of each scenario
+	ARGUMENTS:
+	-	uint a_uIterations -> timed calls, at least 1
+	-	uint a_uWarmup -> untimed calls made first
+	OUTPUT: ---
+	*/
+	void SetIterations(uint a_uIterations, uint a_uWarmup);
+	/*
+	USAGE: Only runs the scenarios with the filter in their name
+	ARGUMENTS: String a_sFilter -> text to look for, empty runs all
+	OUTPUT: ---
+	*/
+	void SetFilter(String a_sFilter);
+	/*
+	USAGE: Runs the scenarios that pass the filter
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void Run(void);
+	/*
+	USAGE: Writes the results of the last Run
+	ARGUMENTS: ---
+	OUTPUT: JSON document
+	*/
+	String ToJSON(void);
+	/*
+	USAGE: Gets the number of scenarios of the last Run that failed one of their checks
+	ARGUMENTS: ---
+	OUTPUT: failed scenarios
+	*/
+	uint GetFailureCount(void);
+	/*
+	USAGE: Gets the heap allocations made so far by every module sharing the C runtime,
+		only the debug runtime can count them
+	ARGUMENTS: ---
+	OUTPUT: allocations, 0 if they are not counted
+	*/
+	static unsigned long long GetAllocationCount(void);
+	/*
+	USAGE: Asks if the allocations are being counted
+	ARGUMENTS: ---
+	OUTPUT: counted?
+	*/
+	static bool CountsAllocations(void);
+
+private:
+	Benchmark(Benchmark const& other);
+	Benchmark& operator=(Benchmark const& other);
+	/*
+	USAGE: Measures a single scenario
+	ARGUMENTS: Scenario* a_pScenario -> scenario to measure
+	OUTPUT: results
+	*/
+	BenchmarkResult Measure(Scenario* a_pScenario);
+};
+
+#endif //__BENCHMARK_H_
@@ -0,0 +1,58 @@
+// Include standard headers
+#include "Main.h"
+
+int main(int argc, char* argv[])
+{
+	String sFilter = "";
+	String sOutput = "";
+	uint uIterations = 30;
+	uint uWarmup = 3;
+	uint uThreads = std::thread::hardware_concurrency();
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		String sArgument = argv[i];
+		String sValue = argv[i + 1];
+		if (sArgument == "--filter")
+			sFilter = sValue;
+		else if (sArgument == "--out")
+			sOutput = sValue;
+		else if (sArgument == "--iterations")
+			uIterations = static_cast<uint>(std::atoi(sValue.c_str()));
+		else if (sArgument == "--warmup")
+			uWarmup = static_cast<uint>(std::atoi(sValue.c_str()));
+		else if (sArgument == "--threads")
+			uThreads = static_cast<uint>(std::atoi(sValue.c_str()));
+		else
+			std::cerr << "Unknown argument " << sArgument << std::endl;
+	}
+
+	//there is no window, the scenarios that render count the calls instead of making them
+	RenderBackend::SetBackend(BACKEND_NULL);
+
+	Benchmark* pBenchmark = new Benchmark();
+	pBenchmark->SetIterations(uIterations, uWarmup);
+	pBenchmark->SetFilter(sFilter);
+	AddScenarios(pBenchmark, uThreads);
+	pBenchmark->Run();
+
+	String sJSON = pBenchmark->ToJSON();
+	if (sOutput == "")
+	{
+		std::cout << sJSON;
+	}
+	else
+	{
+		std::ofstream file(sOutput.c_str(), std::ios::out | std::ios::trunc);
+		file << sJSON;
+		file.close();
+	}
+
+	//a scenario whose results are wrong fails the run, so scripts can use the benchmark as a check
+	uint uFailures = pBenchmark->GetFailureCount();
+	if (uFailures > 0)
+		std::cerr << uFailures << " scenarios failed their checks" << std::endl;
+
+	SafeDelete(pBenchmark);
+	ReleaseAllSingletons();
+	return uFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,17 @@
+#ifndef __MAIN_H_
+#define __MAIN_H_
+#include "Scenarios.h"
+
+//Define and libraries to use memory allocation check
+#define _CRTDBG_MAP_ALLOC
+#include <cstdlib>
+#include <crtdbg.h>
+
+#endif //__MAIN_H_
+
+/*
+USAGE: BTX_Benchmark.exe [--filter text] [--iterations n] [--warmup n] [--threads n] [--out file.json]
+	Runs the scenarios and writes their results as JSON, to the console if no file is given
+ARGUMENTS: ---
+OUTPUT: ---
+*/
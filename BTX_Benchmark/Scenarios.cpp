@@ -0,0 +1,2183 @@
+#include "Scenarios.h"
+
+//Same seed on every run so every run measures the same scene
+static std::mt19937 RandomEngine(309);
+//Uniform point on the surface of a sphere, like glm::sphericalRand but with our own engine
+static vector3 SphericalRand(float a_fRadius)
+{
+	std::uniform_real_distribution<float> height(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> angle(0.0f, static_cast<float>(2.0 * PI));
+	float fZ = height(RandomEngine);
+	float fAngle = angle(RandomEngine);
+	float fRing = std::sqrt(1.0f - fZ * fZ);
+	return vector3(fRing * std::cos(fAngle), fRing * std::sin(fAngle), fZ) * a_fRadius;
+}
+//Corners of Minecraft\Cube.obj, a unit cube with a corner at the origin
+static std::vector<vector3> CubePoints(void)
+{
+	std::vector<vector3> lPoint;
+	for (uint i = 0; i < 8; i++)
+		lPoint.push_back(vector3(static_cast<float>(i & 1), static_cast<float>((i >> 1) & 1), static_cast<float>((i >> 2) & 1)));
+	return lPoint;
+}
+//Calls the null backend counted, as a JSON object
+static String StatsToJSON(RenderStats const& a_Stats)
+{
+	std::stringstream stream;
+	stream << "{\"draws\": " << a_Stats.uDrawCalls
+		<< ", \"instances\": " << a_Stats.uInstances
+		<< ", \"vertices\": " << a_Stats.uVertices
+		<< ", \"program_binds\": " << a_Stats.uProgramBinds
+		<< ", \"vertex_array_binds\": " << a_Stats.uVertexArrayBinds
+		<< ", \"texture_binds\": " << a_Stats.uTextureBinds
+		<< ", \"state_changes\": " << a_Stats.uStateChanges
+		<< ", \"uniform_lookups\": " << a_Stats.uUniformLookups
+		<< ", \"uniform_bytes\": " << a_Stats.uUniformBytes
+		<< ", \"buffer_uploads\": " << a_Stats.uBufferUploads
+		<< ", \"buffer_bytes\": " << a_Stats.uBufferBytes
+		<< ", \"texture_bytes\": " << a_Stats.uTextureBytes << "}";
+	return stream.str();
+}
+static void DeleteBodies(std::vector<RigidBody*>& a_lBody)
+{
+	for (uint i = 0; i < a_lBody.size(); i++)
+	{
+		SafeDelete(a_lBody[i]);
+	}
+	a_lBody.clear();
+}
+//RigidBodyBuildScenario
+RigidBodyBuildScenario::RigidBodyBuildScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "RigidBody/Build";
+	m_sParameters = "{\"bodies\": " + std::to_string(a_uCount) + "}";
+	m_uOperations = a_uCount;
+}
+bool RigidBodyBuildScenario::Setup(void)
+{
+	m_lPoint = CubePoints();
+	return true;
+}
+void RigidBodyBuildScenario::Run(void)
+{
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		RigidBody* pBody = new RigidBody(m_lPoint);
+		SafeDelete(pBody);
+	}
+}
+//RigidBodyMoveScenario
+RigidBodyMoveScenario::RigidBodyMoveScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "RigidBody/Move";
+	m_sParameters = "{\"bodies\": " + std::to_string(a_uCount) + "}";
+	m_uOperations = a_uCount;
+}
+bool RigidBodyMoveScenario::Setup(void)
+{
+	std::vector<vector3> lPoint = CubePoints();
+	for (uint i = 0; i < m_uCount; i++)
+		m_lBody.push_back(new RigidBody(lPoint));
+	m_uFrame = 0;
+	m_v3Sum = ZERO_V3;
+	return true;
+}
+void RigidBodyMoveScenario::Run(void)
+{
+	float fAngle = static_cast<float>(m_uFrame++);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		matrix4 m4Model = glm::translate(vector3(static_cast<float>(i), 0.0f, 0.0f)) *
+			glm::rotate(IDENTITY_M4, glm::radians(fAngle + i), AXIS_Y);
+		m_lBody[i]->SetModelMatrix(m4Model);
+		m_v3Sum += m_lBody[i]->GetMinGlobal();
+	}
+}
+void RigidBodyMoveScenario::Teardown(void) { DeleteBodies(m_lBody); }
+//BroadphaseScenario
+BroadphaseScenario::BroadphaseScenario(String a_sName, uint a_uCount, float a_fRadius)
+{
+	m_uCount = a_uCount;
+	m_fRadius = a_fRadius;
+	m_sName = a_sName;
+	m_sParameters = "{\"bodies\": " + std::to_string(a_uCount) + ", \"radius\": " + std::to_string(static_cast<int>(a_fRadius)) + "}";
+	m_uOperations = a_uCount * (a_uCount - 1) / 2;
+}
+bool BroadphaseScenario::Setup(void)
+{
+	RandomEngine.seed(309);
+	std::vector<vector3> lPoint = CubePoints();
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		RigidBody* pBody = new RigidBody(lPoint);
+		pBody->SetModelMatrix(glm::translate(SphericalRand(m_fRadius)));
+		m_lBody.push_back(pBody);
+	}
+	return true;
+}
+void BroadphaseScenario::Run(void)
+{
+	for (uint i = 0; i < m_uCount; i++)
+		m_lBody[i]->ClearCollidingList();
+
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		for (uint j = i + 1; j < m_uCount; j++)
+		{
+			m_lBody[i]->IsColliding(m_lBody[j]);
+		}
+	}
+}
+void BroadphaseScenario::Teardown(void) { DeleteBodies(m_lBody); }
+//OctreeScenario
+OctreeScenario::OctreeScenario(String a_sName, uint a_uCount, bool a_bOctree, uint a_uLevels, uint a_uMoving)
+{
+	m_uCount = a_uCount;
+	m_bOctree = a_bOctree;
+	m_uLevels = a_uLevels;
+	m_uMoving = a_uMoving;
+	m_sName = a_sName;
+	m_sParameters = "{\"cubes\": " + std::to_string(a_uCount) + ", \"octree\": " + (a_bOctree ? "true" : "false") +
+		", \"levels\": " + std::to_string(a_uLevels) + ", \"moving\": " + std::to_string(a_uMoving) + "}";
+	m_uOperations = a_uCount * (a_uCount - 1) / 2;
+}
+bool OctreeScenario::Setup(void)
+{
+	Model* pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (pModel == nullptr)
+		return false;
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(pModel, "Cube");
+		pEntityMngr->SetModelMatrix(glm::translate(SphericalRand(34.0f)));
+	}
+	if (m_bOctree)
+		m_pRoot = new Octant(m_uLevels, 5);
+	pEntityMngr->Update();
+
+	//the pairs the update finds have to be all of them, also after the octree placed the moved cubes again
+	m_uMismatch = 0;
+	for (uint i = 0; i < 4; i++)
+	{
+		Frame();
+		if (CountUpdatePairs() != CountAllPairs())
+			m_uMismatch++;
+	}
+	if (m_uMismatch > 0)
+		m_sError = std::to_string(m_uMismatch) + " frames missed colliding pairs";
+	return true;
+}
+void OctreeScenario::Frame(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	std::uniform_int_distribution<uint> index(0, m_uCount - 1);
+	for (uint i = 0; i < m_uMoving; i++)
+		pEntityMngr->SetPosition(SphericalRand(34.0f), index(RandomEngine));
+	if (m_pRoot != nullptr)
+		m_pRoot->UpdateEntities(pEntityMngr->GetMovedEntities());
+	pEntityMngr->Update();
+}
+uint OctreeScenario::CountUpdatePairs(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	uint uCount = 0;
+	for (uint i = 0; i < m_uCount; i++)
+		uCount += pEntityMngr->GetEntity(i)->GetCollidingCount();
+	return uCount / 2;
+}
+uint OctreeScenario::CountAllPairs(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	uint uCount = 0;
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		for (uint j = i + 1; j < m_uCount; j++)
+		{
+			if (pEntityMngr->GetEntity(i)->GetRigidBody()->IsColliding(pEntityMngr->GetEntity(j)->GetRigidBody()))
+				uCount++;
+		}
+	}
+	return uCount;
+}
+void OctreeScenario::Run(void)
+{
+	Frame();
+	m_uPairs = CountUpdatePairs();
+}
+void OctreeScenario::Teardown(void)
+{
+	SafeDelete(m_pRoot);
+	EntityManager::ReleaseInstance();
+}
+String OctreeScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"colliding_pairs\": " << m_uPairs << ", \"octants\": " << (m_pRoot ? m_pRoot->GetOctantCount() : 0)
+		<< ", \"mismatch\": " << m_uMismatch << "}";
+	return stream.str();
+}
+//PhysicsScenario
+PhysicsScenario::PhysicsScenario(uint a_uCount, uint a_uFrames)
+{
+	m_uCount = a_uCount;
+	m_uFrames = a_uFrames;
+	m_sName = "Physics/C22";
+	m_sParameters = "{\"cubes\": " + std::to_string(a_uCount) + ", \"frames\": " + std::to_string(a_uFrames) + "}";
+	m_uOperations = a_uFrames;
+}
+bool PhysicsScenario::Setup(void)
+{
+	std::vector<vector3> lPoint = CubePoints();
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		m_lBody.push_back(new RigidBody(lPoint));
+		m_lSolver.push_back(new Solver());
+	}
+	return true;
+}
+void PhysicsScenario::Run(void)
+{
+	//every run drops the same cubes from the same places
+	RandomEngine.seed(309);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		vector3 v3Position = SphericalRand(12.0f);
+		v3Position.y = 0.0f;
+		m_lSolver[i]->SetPosition(v3Position);
+		m_lSolver[i]->SetSize(vector3(2.0f));
+		m_lSolver[i]->SetVelocity(ZERO_V3);
+		m_lBody[i]->SetModelMatrix(glm::translate(v3Position) * glm::scale(vector3(2.0f)));
+	}
+
+	for (uint f = 0; f < m_uFrames; f++)
+	{
+		//what EntityManager::Update does for entities using the solver
+		for (uint i = 0; i < m_uCount; i++)
+			m_lBody[i]->ClearCollidingList();
+
+		for (uint i = 0; i < m_uCount; i++)
+		{
+			for (uint j = i + 1; j < m_uCount; j++)
+			{
+				if (m_lBody[i]->IsColliding(m_lBody[j]))
+					m_lSolver[i]->ResolveCollision(m_lSolver[j]);
+			}
+			m_lSolver[i]->Update();
+			m_lBody[i]->SetModelMatrix(glm::translate(m_lSolver[i]->GetPosition()) * glm::scale(m_lSolver[i]->GetSize()));
+		}
+	}
+}
+void PhysicsScenario::Teardown(void)
+{
+	DeleteBodies(m_lBody);
+	for (uint i = 0; i < m_lSolver.size(); i++)
+	{
+		SafeDelete(m_lSolver[i]);
+	}
+	m_lSolver.clear();
+}
+//ModelReadScenario
+ModelReadScenario::ModelReadScenario(String a_sName, String a_sFileName, uint a_uLoaderThreads)
+{
+	m_sFileName = a_sFileName;
+	m_uLoaderThreads = std::max(a_uLoaderThreads, 1u);
+	m_sName = a_sName;
+	m_sParameters = "{\"loader_threads\": " + std::to_string(m_uLoaderThreads) + "}";
+	m_uOperations = 1;
+}
+bool ModelReadScenario::Setup(void)
+{
+	if (!FileReader::GetFileStamp(m_sFileName, &m_uBytes, nullptr))
+		return false;
+	Model::SetLoaderThreadCount(m_uLoaderThreads);
+	return true;
+}
+void ModelReadScenario::Run(void)
+{
+	auto start = std::chrono::steady_clock::now();
+	Model::ReadFile(m_sFileName, false);
+	auto end = std::chrono::steady_clock::now();
+	m_dSeconds = std::chrono::duration<double>(end - start).count();
+}
+void ModelReadScenario::Teardown(void) { Model::SetLoaderThreadCount(0); }
+String ModelReadScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"bytes\": " << m_uBytes
+		<< ", \"mb_per_s\": " << (m_dSeconds > 0.0 ? m_uBytes / m_dSeconds / 1e6 : 0.0) << "}";
+	return stream.str();
+}
+//Writes a sphere with positions, uvs, normals and triangles to an obj file, the size grows with
+//the square of the segments (256 makes a file of about 12 MB)
+static bool WriteSphereOBJ(String a_sFileName, uint a_uSegments)
+{
+	FILE* pFile = nullptr;
+	fopen_s(&pFile, a_sFileName.c_str(), "w");
+	if (pFile == nullptr)
+		return false;
+
+	fprintf(pFile, "# Sphere of %u segments made by BTX_Benchmark\n", a_uSegments);
+	uint uRow = a_uSegments + 1;
+	for (uint i = 0; i <= a_uSegments; i++)
+	{
+		float fTheta = static_cast<float>(PI * i / a_uSegments);
+		for (uint j = 0; j <= a_uSegments; j++)
+		{
+			float fPhi = static_cast<float>(2.0 * PI * j / a_uSegments);
+			vector3 v3Normal(std::sin(fTheta) * std::cos(fPhi), std::cos(fTheta), std::sin(fTheta) * std::sin(fPhi));
+			fprintf(pFile, "v %f %f %f\n", v3Normal.x * 2.0f, v3Normal.y * 2.0f, v3Normal.z * 2.0f);
+			fprintf(pFile, "vt %f %f\n", static_cast<float>(j) / a_uSegments, static_cast<float>(i) / a_uSegments);
+			fprintf(pFile, "vn %f %f %f\n", v3Normal.x, v3Normal.y, v3Normal.z);
+		}
+	}
+	fprintf(pFile, "g Sphere\n");
+	for (uint i = 0; i < a_uSegments; i++)
+	{
+		for (uint j = 0; j < a_uSegments; j++)
+		{
+			uint a = i * uRow + j + 1;
+			uint b = a + uRow;
+			fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, a + 1, a + 1, a + 1);
+			fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a + 1, a + 1, a + 1, b, b, b, b + 1, b + 1, b + 1);
+		}
+	}
+	fclose(pFile);
+	return true;
+}
+//The FileReader, sscanf_s and strtok loop Model::LoadOBJ used before the scanner, kept as the
+//reference the scanner is measured against; the corners go to lists instead of meshes
+static bool LegacyParseOBJ(String a_sFileName, std::vector<vector3>& a_lCorner)
+{
+	FileReader reader;
+	if (reader.ReadBinaryFile(a_sFileName) != eBTX_OUTPUT::OUT_ERR_NONE)
+		return false;
+
+	std::vector<vector3> lPosition;
+	std::vector<vector3> lNormal;
+	std::vector<vector3> lUV;
+	a_lCorner.clear();
+	while (reader.ReadNextLine() != OUT_DONE)
+	{
+		char* sTemp = new char[reader.m_sLine.size() + 1];
+		String sWord = reader.GetFirstWord();
+		if (reader.m_sLine[0] == 'v')
+		{
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			if (reader.m_sLine[1] == ' ')
+			{
+				sscanf_s(reader.m_sLine.c_str(), "v %f %f %f", &x, &y, &z);
+				lPosition.push_back(vector3(x, y, z));
+			}
+			else if (reader.m_sLine[1] == 't')
+			{
+				sscanf_s(reader.m_sLine.c_str(), "vt %f %f", &x, &y);
+				lUV.push_back(vector3(x, y, 0));
+			}
+			else if (reader.m_sLine[1] == 'n')
+			{
+				sscanf_s(reader.m_sLine.c_str(), "vn %f %f %f", &x, &y, &z);
+				lNormal.push_back(vector3(x, y, z));
+			}
+		}
+		else if (reader.m_sLine[0] == 'f')
+		{
+			String temp = reader.m_sLine;
+			int size = static_cast<int>(temp.size()) + 1;
+			char* str = new char[size];
+			for (int i = 0; i < size - 1; i++)
+				str[i] = temp[i];
+			str[size - 1] = '\0';
+
+			//count the corners, then read the line again for every triangle of the fan
+			int nVertices = 0;
+			char* pch = strtok(str, "f ");
+			while (pch != NULL)
+			{
+				nVertices++;
+				pch = strtok(NULL, "f ");
+			}
+			for (int j = 0; j < nVertices - 2; j++)
+			{
+				for (int i = 0; i < size - 1; i++)
+					str[i] = temp[i];
+				str[size - 1] = '\0';
+
+				pch = strtok(str, "f ");
+				int nIndex = 0;
+				while (pch != NULL)
+				{
+					if (nIndex == 0 || nIndex + j == nVertices - 2 || nIndex + j == nVertices - 1)
+					{
+						int nP = 0, nT = 0, nN = 0;
+						sscanf_s(pch, "%d/%d/%d", &nP, &nT, &nN);
+						a_lCorner.push_back(lPosition[nP - 1]);
+						a_lCorner.push_back(lUV[nT - 1]);
+						a_lCorner.push_back(lNormal[nN - 1]);
+					}
+					pch = strtok(NULL, "f ");
+					nIndex++;
+				}
+			}
+			delete[] str;
+		}
+		delete[] sTemp;
+	}
+	reader.CloseFile();
+	return true;
+}
+//ObjParseScenario
+ObjParseScenario::ObjParseScenario(String a_sName, bool a_bLegacy, uint a_uSegments)
+{
+	m_bLegacy = a_bLegacy;
+	m_uSegments = a_uSegments;
+	m_sName = a_sName;
+	m_sParameters = "{\"segments\": " + std::to_string(a_uSegments) + ", \"legacy\": " + (a_bLegacy ? "true" : "false") + "}";
+	m_uOperations = 1;
+}
+bool ObjParseScenario::Setup(void)
+{
+	m_sFileName = FolderSingleton::GetInstance()->GetFolderRoot() + "BenchSphere.obj";
+	if (!WriteSphereOBJ(m_sFileName, m_uSegments))
+		return false;
+	if (!FileReader::GetFileStamp(m_sFileName, &m_uBytes, nullptr))
+		return false;
+	//the scanner on a single thread, splitting the file in chunks is measured on its own
+	Model::SetLoaderThreadCount(1);
+	return true;
+}
+void ObjParseScenario::Run(void)
+{
+	auto start = std::chrono::steady_clock::now();
+	if (m_bLegacy)
+	{
+		std::vector<vector3> lCorner;
+		m_bRead = LegacyParseOBJ(m_sFileName, lCorner);
+	}
+	else
+		m_bRead = Model::ReadFile(m_sFileName, false);
+	auto end = std::chrono::steady_clock::now();
+	m_dSeconds = std::chrono::duration<double>(end - start).count();
+}
+void ObjParseScenario::Teardown(void)
+{
+	Model::SetLoaderThreadCount(0);
+	remove(m_sFileName.c_str());
+}
+String ObjParseScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"read\": " << (m_bRead ? "true" : "false") << ", \"bytes\": " << m_uBytes
+		<< ", \"mb_per_s\": " << (m_dSeconds > 0.0 ? m_uBytes / m_dSeconds / 1e6 : 0.0) << "}";
+	return stream.str();
+}
+//ModelCookedLODScenario
+ModelCookedLODScenario::ModelCookedLODScenario(uint a_uSegments)
+{
+	m_uSegments = a_uSegments;
+	m_sName = "Model/CookedLOD";
+	m_sParameters = "{\"segments\": " + std::to_string(a_uSegments) + "}";
+	m_uOperations = 1;
+}
+bool ModelCookedLODScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	m_sFileName = pFolder->GetFolderRoot() + pFolder->GetFolderData() + pFolder->GetFolderMOBJ() + "BenchLOD.obj";
+	if (!WriteSphereOBJ(m_sFileName, m_uSegments))
+		return false;
+	remove(Model::GetCookedFileName(m_sFileName).c_str());
+	//the file has no material library, its faces use the first material of the manager
+	MaterialManager::GetInstance()->AddMaterial("BenchLOD");
+
+	//the first load parses the file, simplifies the levels and cooks them
+	Model* pModel = new Model("BenchLOD.obj");
+	m_uLevels = pModel->GetLODCount();
+	m_uVertices = pModel->GetLODVertexCount(m_uLevels);
+	SafeDelete(pModel);
+	if (m_uLevels == 0 || !FileReader::FileExists(Model::GetCookedFileName(m_sFileName)))
+		m_sError = "the levels of detail were not made and cooked";
+	return true;
+}
+void ModelCookedLODScenario::Run(void)
+{
+	Model* pModel = new Model("BenchLOD.obj");
+	if (pModel->GetLODCount() != m_uLevels || pModel->GetLODVertexCount(m_uLevels) != m_uVertices)
+	{
+		++m_uMismatch;
+		m_sError = "the cooked levels of detail differ from the ones made on the first load";
+	}
+	SafeDelete(pModel);
+}
+void ModelCookedLODScenario::Teardown(void)
+{
+	remove(Model::GetCookedFileName(m_sFileName).c_str());
+	remove(m_sFileName.c_str());
+}
+String ModelCookedLODScenario::GetCounters(void)
+{
+	return "{\"levels\": " + std::to_string(m_uLevels) + ", \"coarsest_vertices\": " + std::to_string(m_uVertices) +
+		", \"mismatch\": " + std::to_string(m_uMismatch) + "}";
+}
+//MeshGenerateScenario
+MeshGenerateScenario::MeshGenerateScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "Mesh/Generate";
+	m_sParameters = "{\"meshes\": " + std::to_string(a_uCount) + "}";
+	m_uOperations = a_uCount;
+}
+bool MeshGenerateScenario::Setup(void)
+{
+	return RenderBackend::GetInstance()->GetType() == BACKEND_NULL;
+}
+void MeshGenerateScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	pBackend->ResetStats();
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		//the primitives ModelManager makes, with its subdivisions
+		Mesh* pMesh = new Mesh();
+		switch (i % 4)
+		{
+		case 0:
+			pMesh->GenerateCube(1.0f);
+			break;
+		case 1:
+			pMesh->GenerateSphere(0.5f, 5);
+			break;
+		case 2:
+			pMesh->GenerateCylinder(0.5f, 1.0f, 10);
+			break;
+		default:
+			pMesh->GenerateTorus(0.5f, 0.35f, 10, 10);
+			break;
+		}
+		SafeDelete(pMesh);
+	}
+	m_Stats = pBackend->GetStats();
+}
+String MeshGenerateScenario::GetCounters(void) { return StatsToJSON(m_Stats); }
+//MeshSimplifyScenario
+MeshSimplifyScenario::MeshSimplifyScenario(uint a_uRings)
+{
+	m_uRings = a_uRings;
+	m_sName = "Mesh/Simplify";
+	m_sParameters = "{\"rings\": " + std::to_string(a_uRings) + ", \"ratio\": 0.25}";
+	m_uOperations = 1;
+}
+bool MeshSimplifyScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	//A latitude and longitude sphere, the quads of the poles have a triangle of no area
+	auto point = [this](uint a_uRing, uint a_uSegment)
+	{
+		float fTheta = static_cast<float>(PI * a_uRing / m_uRings);
+		float fPhi = static_cast<float>(2.0 * PI * a_uSegment / m_uRings);
+		return vector3(std::sin(fTheta) * std::cos(fPhi), std::cos(fTheta), std::sin(fTheta) * std::sin(fPhi));
+	};
+	m_pSource = new Mesh();
+	for (uint i = 0; i < m_uRings; i++)
+	{
+		for (uint j = 0; j < m_uRings; j++)
+			m_pSource->AddQuad(point(i + 1, j), point(i + 1, j + 1), point(i, j), point(i, j + 1));
+	}
+	m_pSource->CompileOpenGL3X();
+	return true;
+}
+void MeshSimplifyScenario::Run(void)
+{
+	Mesh* pMesh = new Mesh();
+	pMesh->GenerateSimplified(m_pSource, 0.25f);
+	m_uTriangles = pMesh->GetVertexCount() / 3;
+	SafeDelete(pMesh);
+}
+void MeshSimplifyScenario::Teardown(void) { SafeDelete(m_pSource); }
+String MeshSimplifyScenario::GetCounters(void)
+{
+	return "{\"source_triangles\": " + std::to_string(m_pSource->GetVertexCount() / 3) +
+		", \"triangles\": " + std::to_string(m_uTriangles) + "}";
+}
+//RenderScenario
+RenderScenario::RenderScenario(String a_sName, uint a_uCount, uint a_uKinds, int a_nRender)
+{
+	m_uCount = a_uCount;
+	m_uKinds = std::max(std::min(a_uKinds, 4u), 1u);
+	m_nRender = a_nRender;
+	m_sName = a_sName;
+	m_sParameters = "{\"instances\": " + std::to_string(a_uCount) + ", \"primitives\": " + std::to_string(m_uKinds) +
+		", \"wire\": " + ((a_nRender & RENDER_WIRE) ? "true" : "false") + "}";
+	m_uOperations = a_uCount;
+}
+bool RenderScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+
+	RandomEngine.seed(309);
+	for (uint i = 0; i < m_uCount; i++)
+		m_lMatrix.push_back(glm::translate(SphericalRand(34.0f)));
+	return true;
+}
+void RenderScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	pBackend->ResetStats();
+	//the primitives are added interleaved, the way a scene adds them entity by entity
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		switch (i % m_uKinds)
+		{
+		case 0:
+			pModelMngr->AddCubeToRenderList(m_lMatrix[i], C_WHITE, m_nRender);
+			break;
+		case 1:
+			pModelMngr->AddSphereToRenderList(m_lMatrix[i], C_WHITE, m_nRender);
+			break;
+		case 2:
+			pModelMngr->AddConeToRenderList(m_lMatrix[i], C_WHITE, m_nRender);
+			break;
+		default:
+			pModelMngr->AddTorusToRenderList(m_lMatrix[i], C_WHITE, m_nRender);
+			break;
+		}
+	}
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 0.0f, 100.0f);
+	pModelMngr->Render(m4Projection, glm::lookAt(v3Camera, ZERO_V3, AXIS_Y), v3Camera);
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+}
+void RenderScenario::Teardown(void) { m_lMatrix.clear(); }
+String RenderScenario::GetCounters(void) { return StatsToJSON(m_Stats); }
+//LODScenario
+LODScenario::LODScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "Render/LOD";
+	m_sParameters = "{\"instances\": " + std::to_string(a_uCount) + "}";
+	m_uOperations = a_uCount;
+}
+bool LODScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	//rows of 40 tori two units apart, a row every ten units away from the camera
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		vector3 v3Position = vector3((static_cast<float>(i % 40) - 20.0f) * 2.0f, 0.0f, -10.0f * (i / 40));
+		m_lMatrix.push_back(glm::translate(v3Position) * glm::rotate(IDENTITY_M4, 1.5708f, AXIS_X));
+	}
+	Model* pModel = ModelManager::GetInstance()->GenerateUniTorus(C_WHITE);
+	m_uFullVertices = pModel->GetLODVertexCount(0) * m_uCount;
+	return true;
+}
+void LODScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	pBackend->ResetStats();
+	for (uint i = 0; i < m_uCount; i++)
+		pModelMngr->AddTorusToRenderList(m_lMatrix[i], C_WHITE);
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 5.0f, 20.0f);
+	pModelMngr->Render(m4Projection, glm::lookAt(v3Camera, vector3(0.0f, 0.0f, -100.0f), AXIS_Y), v3Camera);
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+}
+void LODScenario::Teardown(void) { m_lMatrix.clear(); }
+String LODScenario::GetCounters(void)
+{
+	String sStats = StatsToJSON(m_Stats);
+	return sStats.substr(0, sStats.size() - 1) + ", \"full_vertices\": " + std::to_string(m_uFullVertices) + "}";
+}
+//DebugDrawScenario
+DebugDrawScenario::DebugDrawScenario(uint a_uBoxes)
+{
+	m_uBoxes = a_uBoxes;
+	m_sName = "Render/Debug";
+	m_sParameters = "{\"grids\": 3, \"boxes\": " + std::to_string(a_uBoxes) + "}";
+	m_uOperations = 1;
+}
+bool DebugDrawScenario::Setup(void)
+{
+	return RenderBackend::GetInstance()->GetType() == BACKEND_NULL;
+}
+void DebugDrawScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	DebugBatch* pBatch = pModelMngr->GetDebugBatch();
+	pBackend->ResetStats();
+	pModelMngr->AddGridToRenderList(glm::rotate(IDENTITY_M4, 1.5708f, AXIS_Y));
+	pModelMngr->AddGridToRenderList(glm::translate(vector3(-17.0f, 0.0f, 0.0f)) * glm::rotate(IDENTITY_M4, 1.5708f, AXIS_Y));
+	pModelMngr->AddGridToRenderList(glm::translate(vector3(17.0f, 0.0f, 0.0f)) * glm::rotate(IDENTITY_M4, 1.5708f, AXIS_Y));
+	pModelMngr->AddAxisToRenderList(IDENTITY_M4);
+	//an octree of 34 units split in cells of one unit
+	for (uint i = 0; i < m_uBoxes; i++)
+	{
+		vector3 v3Center = vector3(static_cast<float>(i % 34), static_cast<float>((i / 34) % 34), static_cast<float>(i / 1156)) - vector3(17.0f);
+		pBatch->AddWireBox(v3Center, vector3(0.5f), C_YELLOW);
+	}
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 0.0f, 100.0f);
+	pModelMngr->Render(m4Projection, glm::lookAt(v3Camera, ZERO_V3, AXIS_Y), v3Camera);
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+}
+String DebugDrawScenario::GetCounters(void) { return StatsToJSON(m_Stats); }
+//BoundsScenario
+BoundsScenario::BoundsScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "Render/Bounds";
+	m_sParameters = "{\"bodies\": " + std::to_string(a_uCount) + "}";
+	m_uOperations = a_uCount;
+}
+bool BoundsScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	std::vector<vector3> lPoint = CubePoints();
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		RigidBody* pBody = new RigidBody(lPoint);
+		pBody->SetVisibleBS(true);
+		pBody->SetVisibleARBB(true);
+		pBody->SetModelMatrix(glm::translate(SphericalRand(50.0f)) *
+			glm::rotate(IDENTITY_M4, glm::radians(static_cast<float>(i)), glm::normalize(vector3(1.0f, 1.0f, 0.0f))));
+		m_lBody.push_back(pBody);
+	}
+	return true;
+}
+void BoundsScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	pBackend->ResetStats();
+	m_lState.clear();
+	for (uint i = 0; i < m_uCount; i++)
+		m_lState.push_back(m_lBody[i]->GetDrawState());
+	RigidBody::AddToRenderList(m_lState.size(), m_lState.data());
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 0.0f, 100.0f);
+	pModelMngr->Render(m4Projection, glm::lookAt(v3Camera, ZERO_V3, AXIS_Y), v3Camera);
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+}
+void BoundsScenario::Teardown(void)
+{
+	DeleteBodies(m_lBody);
+	m_lState.clear();
+}
+String BoundsScenario::GetCounters(void) { return StatsToJSON(m_Stats); }
+//ShaderCacheScenario
+ShaderCacheScenario::ShaderCacheScenario(String a_sName, uint a_uCount, bool a_bWarm)
+{
+	m_uCount = a_uCount;
+	m_bWarm = a_bWarm;
+	m_sName = a_sName;
+	m_sParameters = "{\"programs\": " + std::to_string(a_uCount) + ", \"warm\": " + (a_bWarm ? "true" : "false") + "}";
+	m_uOperations = a_uCount;
+}
+bool ShaderCacheScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+
+	//the size of Basic.vs and Basic.fs, each program a little different so no two share a key
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		String sName = "BenchShader" + std::to_string(i);
+		m_lFile.push_back(sName + ".vs");
+		m_lFile.push_back(sName + ".fs");
+		m_lFile.push_back(sName + ".bsc");
+		std::ofstream vertex((sName + ".vs").c_str(), std::ios::out | std::ios::trunc);
+		std::ofstream fragment((sName + ".fs").c_str(), std::ios::out | std::ios::trunc);
+		if (!vertex.is_open() || !fragment.is_open())
+			return false;
+		vertex << "#version 330\nlayout(location = 0) in vec3 Position_b;\nuniform mat4 VP;\n";
+		for (uint j = 0; j < 40; j++)
+			vertex << "uniform mat4 m4Bone" << j << ";\n";
+		vertex << "void main()\n{\n\tgl_Position = VP * vec4(Position_b * " << (i + 1) << ".0, 1);\n}\n";
+		fragment << "#version 330\nout vec4 Fragment;\nvoid main()\n{\n\tFragment = vec4(1, 1, 1, 1);\n}\n";
+	}
+	if (m_bWarm)
+	{
+		RenderBackend* pBackend = RenderBackend::GetInstance();
+		for (uint i = 0; i < m_lFile.size(); i += 3)
+			pBackend->DeleteProgram(LoadShaders(m_lFile[i].c_str(), m_lFile[i + 1].c_str(), m_lFile[i + 2].c_str()));
+	}
+	return true;
+}
+void ShaderCacheScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	pBackend->ResetStats();
+	for (uint i = 0; i < m_lFile.size(); i += 3)
+	{
+		if (!m_bWarm)
+			remove(m_lFile[i + 2].c_str());
+		pBackend->DeleteProgram(LoadShaders(m_lFile[i].c_str(), m_lFile[i + 1].c_str(), m_lFile[i + 2].c_str()));
+	}
+	m_Stats = pBackend->GetStats();
+}
+void ShaderCacheScenario::Teardown(void)
+{
+	for (uint i = 0; i < m_lFile.size(); i++)
+		remove(m_lFile[i].c_str());
+	m_lFile.clear();
+}
+String ShaderCacheScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"compiled\": " << m_Stats.uProgramsCompiled
+		<< ", \"loaded\": " << m_Stats.uProgramsLoaded << "}";
+	return stream.str();
+}
+//Fills the first level of a texture with a pattern that changes on every pixel
+static void FillPattern(GLubyte* a_pPixels, int a_nSize)
+{
+	for (int y = 0; y < a_nSize; y++)
+	{
+		for (int x = 0; x < a_nSize; x++)
+		{
+			GLubyte* pPixel = a_pPixels + 4 * (y * a_nSize + x);
+			pPixel[0] = static_cast<GLubyte>(x);
+			pPixel[1] = static_cast<GLubyte>(y);
+			pPixel[2] = static_cast<GLubyte>(x ^ y);
+			pPixel[3] = 255;
+		}
+	}
+}
+//TextureMipsScenario
+TextureMipsScenario::TextureMipsScenario(int a_nSize)
+{
+	m_nSize = a_nSize;
+	m_sName = "Texture/Mips";
+	m_sParameters = "{\"size\": " + std::to_string(a_nSize) + "}";
+	m_uOperations = 1;
+}
+bool TextureMipsScenario::Setup(void)
+{
+	m_lChain.resize(Texture::GetMipChainSize(m_nSize, m_nSize, Texture::GetMipCount(m_nSize, m_nSize)));
+	FillPattern(&m_lChain[0], m_nSize);
+	return true;
+}
+void TextureMipsScenario::Run(void)
+{
+	Texture::GenerateMips(&m_lChain[0], m_nSize, m_nSize, Texture::GetMipCount(m_nSize, m_nSize));
+}
+void TextureMipsScenario::Teardown(void) { m_lChain.clear(); }
+String TextureMipsScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"levels\": " << Texture::GetMipCount(m_nSize, m_nSize)
+		<< ", \"bytes\": " << m_lChain.size() << "}";
+	return stream.str();
+}
+//TextureCookedScenario
+TextureCookedScenario::TextureCookedScenario(int a_nSize)
+{
+	m_nSize = a_nSize;
+	m_sName = "Texture/Cooked";
+	m_sParameters = "{\"size\": " + std::to_string(a_nSize) + "}";
+	m_uOperations = 1;
+}
+bool TextureCookedScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+
+	//the cooked file is valid as long as the source keeps its stamp, its contents are never read
+	m_sFileName = FolderSingleton::GetInstance()->GetFolderRoot() + "BenchTexture.png";
+	std::ofstream source(m_sFileName.c_str(), std::ios::out | std::ios::trunc);
+	source << "BenchTexture";
+	source.close();
+
+	std::vector<GLubyte> lPixels(4 * m_nSize * m_nSize);
+	FillPattern(&lPixels[0], m_nSize);
+	m_pTexture = new Texture();
+	if (!m_pTexture->ResolveFileName(m_sFileName))
+		return false;
+	m_pTexture->SetPixels(m_nSize, m_nSize, &lPixels[0], GL_BGRA);
+	return m_pTexture->SaveCooked();
+}
+void TextureCookedScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	pBackend->ResetStats();
+	if (m_pTexture->Decode(true))
+		m_pTexture->Upload();
+	m_Stats = pBackend->GetStats();
+}
+void TextureCookedScenario::Teardown(void)
+{
+	SafeDelete(m_pTexture);
+	remove(Texture::GetCookedFileName(m_sFileName).c_str());
+	remove(m_sFileName.c_str());
+}
+String TextureCookedScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"texture_uploads\": " << m_Stats.uTextureUploads
+		<< ", \"texture_bytes\": " << m_Stats.uTextureBytes << "}";
+	return stream.str();
+}
+//AtlasScenario
+AtlasScenario::AtlasScenario(String a_sName, uint a_uBlocks, bool a_bAtlas)
+{
+	m_uBlocks = a_uBlocks;
+	m_bAtlas = a_bAtlas;
+	m_sName = a_sName;
+	m_sParameters = "{\"blocks\": " + std::to_string(a_uBlocks) + ", \"texture_size\": 16, \"atlas\": " +
+		(a_bAtlas ? "true" : "false") + "}";
+	m_uOperations = a_uBlocks;
+}
+bool AtlasScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+
+	TextureManager* pTextureMngr = TextureManager::GetInstance();
+	MaterialManager* pMatMngr = MaterialManager::GetInstance();
+	TextureAtlas atlas("BenchAtlas");
+	uint uSide = static_cast<uint>(std::ceil(std::sqrt(static_cast<float>(m_uBlocks))));
+	std::vector<GLubyte> lPixels(4 * 16 * 16);
+	for (uint i = 0; i < m_uBlocks; i++)
+	{
+		//a checker of two colors that no other block has
+		for (uint p = 0; p < 16 * 16; p++)
+		{
+			bool bDark = ((p % 16) / 4 + (p / 64)) % 2 == 0;
+			lPixels[4 * p + 0] = static_cast<GLubyte>(i * 37 / (bDark ? 2 : 1));
+			lPixels[4 * p + 1] = static_cast<GLubyte>(i * 11 / (bDark ? 2 : 1));
+			lPixels[4 * p + 2] = static_cast<GLubyte>(i / (bDark ? 2 : 1));
+			lPixels[4 * p + 3] = 255;
+		}
+		String sTexture = "BenchBlock" + std::to_string(i) + ".png";
+		pTextureMngr->AddTexture(sTexture, 16, 16, &lPixels[0]);
+		Material material(sTexture);
+		material.SetDiffuseMapName(sTexture);
+		int nMaterial = pMatMngr->AddMaterial(material);
+		if (m_bAtlas)
+			atlas.AddPixels(sTexture, 16, 16, &lPixels[0]);
+
+		Mesh* pMesh = new Mesh();
+		pMesh->GenerateCube(1.0f, C_WHITE, glm::translate(vector3(static_cast<float>(i % uSide), 0.0f, static_cast<float>(i / uSide))));
+		pMesh->SetMaterial(nMaterial);
+		pMesh->SetShaderProgram("Simplex");
+		if (m_pModel == nullptr)
+			m_pModel = new Model(pMesh);
+		else
+			m_pModel->AddMesh(pMesh);
+	}
+	if (m_bAtlas)
+	{
+		m_uPages = atlas.Pack();
+		m_pModel->ApplyAtlas(&atlas);
+	}
+	return true;
+}
+void AtlasScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	RenderQueue* pQueue = ModelManager::GetInstance()->GetRenderQueue();
+	pBackend->ResetStats();
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 20.0f, 40.0f);
+	matrix4 m4View = glm::lookAt(v3Camera, ZERO_V3, AXIS_Y);
+	pQueue->SetView(m4Projection, m4View);
+	m_pModel->AddToRenderList(IDENTITY_M4);
+	m_pModel->AddListsToQueue(pQueue);
+	pQueue->Render(m4Projection, m4View, v3Camera);
+	m_pModel->ClearRenderLists();
+	m_Stats = pBackend->GetStats();
+}
+void AtlasScenario::Teardown(void) { SafeDelete(m_pModel); }
+String AtlasScenario::GetCounters(void)
+{
+	String sStats = StatsToJSON(m_Stats);
+	return sStats.substr(0, sStats.size() - 1) + ", \"meshes\": " + std::to_string(m_pModel ? m_pModel->GetMeshCount() : 0) +
+		", \"pages\": " + std::to_string(m_uPages) + "}";
+}
+//AtlasLoadScenario
+AtlasLoadScenario::AtlasLoadScenario(String a_sName, uint a_uModels, uint a_uInstances, bool a_bAtlas)
+{
+	m_uModels = a_uModels;
+	m_uInstances = a_uInstances;
+	m_bAtlas = a_bAtlas;
+	m_sName = a_sName;
+	m_sParameters = "{\"models\": " + std::to_string(a_uModels) + ", \"instances\": " + std::to_string(a_uInstances) +
+		", \"atlas\": " + (a_bAtlas ? "true" : "false") + "}";
+	m_uOperations = a_uModels * a_uInstances;
+}
+bool AtlasLoadScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	String sData = pFolder->GetFolderRoot() + pFolder->GetFolderData();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	pModelMngr->SetLoadAtlas(m_bAtlas);
+	std::vector<GLubyte> lPixels(4 * 16 * 16);
+	for (uint i = 0; i < m_uModels; i++)
+	{
+		//the skin is only read from its cooked file, the source is a stand in for its stamp
+		String sName = "BenchSkin" + String(m_bAtlas ? "P" : "S") + std::to_string(i);
+		String sTexture = sData + pFolder->GetFolderTextures() + sName + ".png";
+		std::ofstream source(sTexture.c_str(), std::ios::out | std::ios::trunc);
+		source << sName;
+		source.close();
+		FillPattern(&lPixels[0], 16);
+		lPixels[0] = static_cast<GLubyte>(i);
+		Texture texture;
+		if (!texture.ResolveFileName(sName + ".png"))
+			return false;
+		texture.SetPixels(16, 16, &lPixels[0], GL_BGRA);
+		texture.SaveCooked();
+
+		//a cube with the whole skin on each face
+		String sOBJ = sData + pFolder->GetFolderMOBJ() + sName + ".obj";
+		String sMTL = sData + pFolder->GetFolderMOBJ() + sName + ".mtl";
+		std::ofstream mtl(sMTL.c_str(), std::ios::out | std::ios::trunc);
+		mtl << "newmtl " << sName << "\nKd 1.00 1.00 1.00\nmap_Kd " << sName << ".png\n";
+		mtl.close();
+		std::ofstream obj(sOBJ.c_str(), std::ios::out | std::ios::trunc);
+		obj << "mtllib " << sName << ".mtl\n"
+			<< "v -0.5 -0.5 0.5\nv 0.5 -0.5 0.5\nv 0.5 0.5 0.5\nv -0.5 0.5 0.5\n"
+			<< "v -0.5 -0.5 -0.5\nv 0.5 -0.5 -0.5\nv 0.5 0.5 -0.5\nv -0.5 0.5 -0.5\n"
+			<< "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+			<< "usemtl " << sName << "\n"
+			<< "f 1/1 2/2 3/3 4/4\nf 6/1 5/2 8/3 7/4\nf 2/1 6/2 7/3 3/4\n"
+			<< "f 5/1 1/2 4/3 8/4\nf 4/1 3/2 7/3 8/4\nf 5/1 6/2 2/3 1/4\n";
+		obj.close();
+		m_lFile.push_back(sTexture);
+		m_lFile.push_back(Texture::GetCookedFileName(sTexture));
+		m_lFile.push_back(sOBJ);
+		m_lFile.push_back(sMTL);
+		m_lFile.push_back(Model::GetCookedFileName(sOBJ));
+
+		String sModel = pModelMngr->LoadModel(sName + ".obj");
+		if (sModel == "")
+			return false;
+		m_lModel.push_back(sModel);
+	}
+	//the first frame after the loads packs the skins
+	Run();
+	return true;
+}
+void AtlasLoadScenario::Run(void)
+{
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	pBackend->ResetStats();
+	for (uint i = 0; i < m_lModel.size(); i++)
+	{
+		for (uint j = 0; j < m_uInstances; j++)
+			pModelMngr->AddModelToRenderList(m_lModel[i], glm::translate(vector3(2.0f * i, 0.0f, -2.0f * j)));
+	}
+	matrix4 m4Projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.01f, 1000.0f);
+	vector3 v3Camera = vector3(0.0f, 20.0f, 40.0f);
+	pModelMngr->Render(m4Projection, glm::lookAt(v3Camera, ZERO_V3, AXIS_Y), v3Camera);
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+}
+void AtlasLoadScenario::Teardown(void)
+{
+	ModelManager::GetInstance()->SetLoadAtlas(true);
+	for (uint i = 0; i < m_lFile.size(); i++)
+		remove(m_lFile[i].c_str());
+	m_lFile.clear();
+	m_lModel.clear();
+}
+String AtlasLoadScenario::GetCounters(void) { return StatsToJSON(m_Stats); }
+//EntitySpawnScenario
+EntitySpawnScenario::EntitySpawnScenario(uint a_uCount)
+{
+	m_uCount = a_uCount;
+	m_sName = "Entity/Spawn";
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"name\": \"Block\"}";
+	m_uOperations = a_uCount;
+}
+bool EntitySpawnScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	m_pModel = ModelManager::GetInstance()->GenerateUniCube();
+	m_lUniqueID.reserve(m_uCount);
+	return m_pModel != nullptr;
+}
+void EntitySpawnScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	m_lUniqueID.clear();
+	for (uint i = 0; i < m_uCount; i++)
+		m_lUniqueID.push_back(pEntityMngr->AddEntity(m_pModel, "Block"));
+	m_uFound = 0;
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		if (pEntityMngr->GetEntityIndex(m_lUniqueID[i]) == static_cast<int>(i))
+			m_uFound++;
+	}
+	EntityManager::ReleaseInstance();
+}
+void EntitySpawnScenario::Teardown(void)
+{
+	EntityManager::ReleaseInstance();
+	m_lUniqueID.clear();
+}
+String EntitySpawnScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"found\": " << m_uFound
+		<< ", \"interned_names\": " << NameTable::GetInstance()->GetCount() << "}";
+	return stream.str();
+}
+//TransformScenario
+TransformScenario::TransformScenario(String a_sName, eTRANSFORM_PATH a_ePath, uint a_uCount)
+{
+	m_ePath = a_ePath;
+	m_uCount = a_uCount;
+	m_sName = a_sName;
+	const char* sPath[] = { "trs", "matrix", "legacy" };
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"path\": \"" + sPath[a_ePath] + "\"}";
+	m_uOperations = a_uCount;
+}
+bool TransformScenario::Setup(void)
+{
+	Model* pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (pModel == nullptr)
+		return false;
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	m_lBase.clear();
+	m_lAxis.clear();
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(pModel, "Cube");
+		m_lBase.push_back(SphericalRand(40.0f));
+		m_lAxis.push_back(glm::normalize(SphericalRand(1.0f) + vector3(0.001f)));
+	}
+	m_uFrame = 0;
+	return true;
+}
+void TransformScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	float fTime = m_uFrame++ / 60.0f;
+	m_v3Center = ZERO_V3;
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		Entity* pEntity = pEntityMngr->GetEntity(i);
+		float fPhase = fTime + i * 0.01f;
+		vector3 v3Position = m_lBase[i] + vector3(0.0f, std::sin(fPhase), 0.0f);
+		quaternion qOrientation = glm::angleAxis(fPhase, m_lAxis[i]);
+		vector3 v3Scale = vector3(1.0f + 0.5f * std::cos(fPhase));
+		switch (m_ePath)
+		{
+		case TRANSFORM_TRS:
+			pEntity->SetPosition(v3Position);
+			pEntity->SetOrientation(qOrientation);
+			pEntity->SetScale(v3Scale);
+			break;
+		case TRANSFORM_MATRIX:
+			pEntity->SetModelMatrix(glm::translate(v3Position) * glm::toMat4(qOrientation) * glm::scale(v3Scale));
+			break;
+		default:
+		{
+			//what Entity::SetModelMatrix did before: the matrix pushed as given and split again
+			matrix4 m4ToWorld = glm::translate(v3Position) * glm::toMat4(qOrientation) * glm::scale(v3Scale);
+			pEntity->GetRigidBody()->SetModelMatrix(m4ToWorld);
+			glm::vec3 scale;
+			glm::quat rotation;
+			glm::vec3 translation;
+			glm::vec3 skew;
+			glm::vec4 perspective;
+			glm::decompose(m4ToWorld, scale, rotation, translation, skew, perspective);
+			pEntity->GetSolver()->SetPosition(translation);
+			pEntity->GetSolver()->SetSize(scale);
+			break;
+		}
+		}
+		m_v3Center += pEntity->GetRigidBody()->GetCenterGlobal();
+	}
+}
+void TransformScenario::Teardown(void) { EntityManager::ReleaseInstance(); }
+String TransformScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"center_sum\": [" << m_v3Center.x << ", " << m_v3Center.y << ", " << m_v3Center.z << "]}";
+	return stream.str();
+}
+//CameraFrameScenario
+CameraFrameScenario::CameraFrameScenario(String a_sName, uint a_uCameras, uint a_uReads, bool a_bCached)
+{
+	m_uCameras = a_uCameras;
+	m_uReads = a_uReads;
+	m_bCached = a_bCached;
+	m_sName = a_sName;
+	m_sParameters = "{\"cameras\": " + std::to_string(a_uCameras) + ", \"reads\": " + std::to_string(a_uReads) +
+		", \"cached\": " + (a_bCached ? "true" : "false") + "}";
+	m_uOperations = a_uReads;
+}
+bool CameraFrameScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	//the manager cannot remove cameras, the ones added by an earlier setup are reused
+	CameraManager* pCameraMngr = CameraManager::GetInstance();
+	while (pCameraMngr->GetCameraCount() < m_uCameras)
+	{
+		float fSide = static_cast<float>(pCameraMngr->GetCameraCount());
+		pCameraMngr->AddCamera(vector3(fSide, 5.0f, 10.0f), ZERO_V3, AXIS_Y);
+	}
+	pCameraMngr->SetActiveCamera(0);
+	return true;
+}
+void CameraFrameScenario::Run(void)
+{
+	CameraManager* pCameraMngr = CameraManager::GetInstance();
+	Camera* pCamera = pCameraMngr->GetCamera();
+	uint uBuilds = 0;
+	for (uint i = 0; i < m_uCameras; i++)
+		uBuilds += pCameraMngr->GetCamera(i)->GetMatrixBuildCount();
+
+	pCamera->MoveForward(0.01f);
+	if (m_bCached)
+		pCameraMngr->UpdateCameras();
+	matrix4 m4Sum = IDENTITY_M4;
+	for (uint i = 0; i < m_uReads; i++)
+	{
+		if (!m_bCached)
+		{
+			pCamera->CalculateView();
+			pCamera->CalculateProjection();
+		}
+		m4Sum += pCameraMngr->GetViewMatrix();
+		m4Sum += pCameraMngr->GetProjectionMatrix();
+		m4Sum[0] += pCameraMngr->GetFrustum().GetPlane(0);
+	}
+	m_m4Sum = m4Sum;
+
+	m_uBuilds = 0;
+	for (uint i = 0; i < m_uCameras; i++)
+		m_uBuilds += pCameraMngr->GetCamera(i)->GetMatrixBuildCount();
+	m_uBuilds -= uBuilds;
+}
+void CameraFrameScenario::Teardown(void) { CameraManager::GetInstance()->SetActiveCamera(0); }
+String CameraFrameScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"matrix_builds\": " << m_uBuilds << "}";
+	return stream.str();
+}
+//AnimationScenario
+//Clips shared by the instances and keys in each track
+static const uint uAnimationClips = 8;
+static const uint uAnimationKeys = 16;
+static const float fAnimationStep = 1.0f / 60.0f;
+AnimationScenario::AnimationScenario(String a_sName, uint a_uCount, eBTX_INTERPOLATION a_eInterpolation, bool a_bBatch, bool a_bEntities)
+{
+	m_uCount = a_uCount;
+	m_eInterpolation = a_eInterpolation;
+	m_bBatch = a_bBatch;
+	m_bEntities = a_bEntities;
+	m_sName = a_sName;
+	m_sParameters = "{\"instances\": " + std::to_string(a_uCount) + ", \"clips\": " + std::to_string(uAnimationClips) +
+		", \"keys\": " + std::to_string(uAnimationKeys) + ", \"interpolation\": " + std::to_string(a_eInterpolation) +
+		", \"batch\": " + (a_bBatch ? "true" : "false") + ", \"entities\": " + (a_bEntities ? "true" : "false") + "}";
+	m_uOperations = a_uCount;
+}
+bool AnimationScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	AnimationManager::ReleaseInstance();
+	AnimationManager* pAnimationMngr = AnimationManager::GetInstance();
+	std::uniform_real_distribution<float> angle(0.0f, static_cast<float>(2.0 * PI));
+	std::uniform_real_distribution<float> size(0.5f, 2.0f);
+	for (uint c = 0; c < uAnimationClips; c++)
+	{
+		AnimationClip clip("Clip" + std::to_string(c));
+		for (uint k = 0; k < uAnimationKeys; k++)
+		{
+			float fTime = 0.25f * static_cast<float>(k);
+			clip.AddPositionKey(fTime, SphericalRand(10.0f));
+			clip.AddRotationKey(fTime, glm::angleAxis(angle(RandomEngine), glm::normalize(SphericalRand(1.0f))));
+			clip.AddScaleKey(fTime, vector3(size(RandomEngine)));
+		}
+		clip.SetInterpolation(m_eInterpolation, m_eInterpolation, m_eInterpolation);
+		pAnimationMngr->AddClip(clip);
+	}
+
+	Model* pModel = nullptr;
+	if (m_bEntities)
+	{
+		pModel = ModelManager::GetInstance()->GenerateUniCube();
+		if (pModel == nullptr)
+			return false;
+	}
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	std::uniform_real_distribution<float> start(0.0f, 0.25f * uAnimationKeys);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		String sUniqueID = m_bEntities ? pEntityMngr->AddEntity(pModel, "Animated") : "";
+		uint uClip = i % uAnimationClips;
+		float fTime = start(RandomEngine);
+		if (m_bBatch)
+			pAnimationMngr->AddInstance(uClip, sUniqueID, fTime);
+		else
+		{
+			m_lClip.push_back(uClip);
+			m_lTime.push_back(fTime);
+			m_lEntity.push_back(m_bEntities ? NameTable::GetInstance()->Find(sUniqueID) : NameTable::INVALID);
+		}
+	}
+	return true;
+}
+void AnimationScenario::Run(void)
+{
+	AnimationManager* pAnimationMngr = AnimationManager::GetInstance();
+	vector3 v3Sum = ZERO_V3;
+	if (m_bBatch)
+	{
+		pAnimationMngr->Update(fAnimationStep);
+		m_uApplied = pAnimationMngr->GetAppliedCount();
+		for (uint i = 0; i < m_uCount; i++)
+			v3Sum += pAnimationMngr->GetPosition(i);
+	}
+	else
+	{
+		m_uApplied = 0;
+		for (uint i = 0; i < m_uCount; i++)
+		{
+			AnimationClip* pClip = pAnimationMngr->GetClip(m_lClip[i]);
+			m_lTime[i] = pClip->WrapTime(m_lTime[i] + fAnimationStep);
+			vector3 v3Position = ZERO_V3;
+			quaternion qRotation;
+			vector3 v3Scale = vector3(1.0f);
+			pClip->Sample(m_lTime[i], v3Position, qRotation, v3Scale);
+			Entity* pEntity = Entity::GetEntity(m_lEntity[i]);
+			if (pEntity != nullptr)
+			{
+				pEntity->SetTransform(v3Position, qRotation, v3Scale);
+				m_uApplied++;
+			}
+			v3Sum += v3Position;
+		}
+	}
+	m_v3Sum = v3Sum;
+}
+void AnimationScenario::Teardown(void)
+{
+	AnimationManager::ReleaseInstance();
+	EntityManager::ReleaseInstance();
+	m_lTime.clear();
+	m_lClip.clear();
+	m_lEntity.clear();
+}
+String AnimationScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"applied\": " << m_uApplied << "}";
+	return stream.str();
+}
+//PipelineScenario
+PipelineScenario::PipelineScenario(String a_sName, uint a_uCount, bool a_bPipelined)
+{
+	m_uCount = a_uCount;
+	m_bPipelined = a_bPipelined;
+	m_sName = a_sName;
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"pipelined\": " + (a_bPipelined ? "true" : "false") + "}";
+	m_uOperations = 1;
+}
+bool PipelineScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	m_pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (m_pModel == nullptr)
+		return false;
+	CameraManager::GetInstance()->SetPositionTargetAndUpward(vector3(0.0f, 15.0f, 30.0f), ZERO_V3, AXIS_Y);
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(m_pModel, "Cube");
+		vector3 v3Position = SphericalRand(12.0f);
+		v3Position.y = 0.0f;
+		pEntityMngr->SetModelMatrix(glm::translate(v3Position) * glm::scale(vector3(2.0f)));
+		pEntityMngr->UsePhysicsSolver();
+	}
+	pEntityMngr->StoreRenderState();
+	pEntityMngr->SwapRenderState();
+	return true;
+}
+void PipelineScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	if (!m_bPipelined)
+	{
+		pEntityMngr->Update();
+		pEntityMngr->AddEntityToRenderList(-1, true);
+		pModelMngr->Render();
+		pModelMngr->ClearRenderList();
+		m_uDrawn = pEntityMngr->GetVisibleCount();
+		return;
+	}
+
+	pEntityMngr->BeginUpdate();
+	pEntityMngr->AddRenderStateToRenderList(true);
+	pModelMngr->Render();
+	pModelMngr->ClearRenderList();
+	m_uDrawn = pEntityMngr->GetVisibleCount();
+	auto start = std::chrono::steady_clock::now();
+	pEntityMngr->EndUpdate();
+	m_dWait = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+void PipelineScenario::Teardown(void) { EntityManager::ReleaseInstance(); }
+String PipelineScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"drawn\": " << m_uDrawn << ", \"wait_us\": " << m_dWait << "}";
+	return stream.str();
+}
+//OcclusionScenario
+OcclusionScenario::OcclusionScenario(String a_sName, uint a_uCount, bool a_bOcclusion, bool a_bHierarchical, uint a_uThreads)
+{
+	m_uCount = a_uCount;
+	m_bOcclusion = a_bOcclusion;
+	m_bHierarchical = a_bHierarchical;
+	m_uThreads = a_uThreads;
+	m_sName = a_sName;
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"occlusion\": " + (a_bOcclusion ? "true" : "false") +
+		", \"hierarchical\": " + (a_bHierarchical ? "true" : "false") + ", \"threads\": " + std::to_string(a_uThreads) + "}";
+	m_uOperations = a_uCount;
+}
+bool OcclusionScenario::Setup(void)
+{
+	if (RenderBackend::GetInstance()->GetType() != BACKEND_NULL)
+		return false;
+	m_pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (m_pModel == nullptr)
+		return false;
+	//the default camera, the sphere is put 100 units in front of it
+	vector3 v3Camera = vector3(0.0f, 0.0f, 5.0f);
+	vector3 v3Center = vector3(0.0f, 0.0f, -95.0f);
+	CameraManager::GetInstance()->SetPositionTargetAndUpward(v3Camera, ZERO_V3, AXIS_Y);
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(m_pModel, "Cube");
+		pEntityMngr->SetModelMatrix(glm::translate(v3Center + SphericalRand(34.0f)));
+	}
+	pEntityMngr->AddEntity(m_pModel, "Core");
+	pEntityMngr->SetModelMatrix(glm::translate(v3Center) * glm::scale(vector3(48.0f)));
+	pEntityMngr->SetOccluder(true);
+	pEntityMngr->Update();
+	pEntityMngr->SetHierarchicalCulling(m_bHierarchical);
+	pEntityMngr->SetOcclusionCulling(m_bOcclusion);
+	pEntityMngr->GetOcclusionBuffer()->SetThreadCount(m_uThreads);
+
+	//every cube the buffer hides must have no corner the camera can see past the core
+	m_uFalseOccluded = 0;
+	if (m_bOcclusion)
+	{
+		Run();
+		Frustum frustum = CameraManager::GetInstance()->GetFrustum();
+		OcclusionBuffer* pOcclusion = pEntityMngr->GetOcclusionBuffer();
+		for (uint i = 0; i < m_uCount; i++)
+		{
+			RigidBody* pRigidBody = pEntityMngr->GetRigidBody(i);
+			vector3 v3Min = pRigidBody->GetMinGlobal();
+			vector3 v3Max = pRigidBody->GetMaxGlobal();
+			if (!frustum.IsBoxVisible(v3Min, v3Max) || !pOcclusion->IsBoxOccluded(v3Min, v3Max))
+				continue;
+			for (uint j = 0; j < 8; j++)
+			{
+				vector3 v3Corner((j & 1) ? v3Max.x : v3Min.x, (j & 2) ? v3Max.y : v3Min.y, (j & 4) ? v3Max.z : v3Min.z);
+				//a segment that stops short of the corner, a cube touching it does not count
+				vector3 v3End = v3Corner + glm::normalize(v3Camera - v3Corner) * 0.01f;
+				RayHit hit;
+				if (!pEntityMngr->CastSegment(v3Camera, v3End, hit, static_cast<int>(i)))
+				{
+					++m_uFalseOccluded;
+					break;
+				}
+			}
+		}
+	}
+	return true;
+}
+void OcclusionScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	ModelManager* pModelMngr = ModelManager::GetInstance();
+	RenderBackend* pBackend = RenderBackend::GetInstance();
+	pBackend->ResetStats();
+	pEntityMngr->AddEntityToRenderList(-1, false);
+	pModelMngr->Render();
+	pModelMngr->ClearRenderList();
+	m_Stats = pBackend->GetStats();
+	m_uVisible = pEntityMngr->GetVisibleCount();
+	m_uOccluded = pEntityMngr->GetOccludedCount();
+}
+void OcclusionScenario::Teardown(void) { EntityManager::ReleaseInstance(); }
+String OcclusionScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"visible\": " << m_uVisible << ", \"occluded\": " << m_uOccluded
+		<< ", \"false_occluded\": " << m_uFalseOccluded << ", \"render\": " << StatsToJSON(m_Stats) << "}";
+	return stream.str();
+}
+//CullingScenario
+CullingScenario::CullingScenario(String a_sName, bool a_bHierarchical, uint a_uCount, uint a_uCameras)
+{
+	m_bHierarchical = a_bHierarchical;
+	m_uCount = a_uCount;
+	m_lFrustum.resize(a_uCameras);
+	m_sName = a_sName;
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"cameras\": " + std::to_string(a_uCameras) +
+		", \"hierarchical\": " + (a_bHierarchical ? "true" : "false") + "}";
+	m_uOperations = a_uCameras;
+}
+bool CullingScenario::Setup(void)
+{
+	Model* pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (pModel == nullptr)
+		return false;
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(pModel, "Cube");
+		quaternion qOrientation = glm::angleAxis(glm::radians(angle(RandomEngine)), glm::normalize(SphericalRand(1.0f) + vector3(0.001f)));
+		vector3 v3Scale = vector3(0.5f + 2.0f * unit(RandomEngine));
+		pEntityMngr->SetModelMatrix(glm::translate(SphericalRand(60.0f * unit(RandomEngine))) * glm::toMat4(qOrientation) * glm::scale(v3Scale));
+	}
+	pEntityMngr->Update();
+
+	//cameras inside and around the field looking every way, some with a short far plane
+	for (uint i = 0; i < m_lFrustum.size(); i++)
+	{
+		vector3 v3Eye = SphericalRand(90.0f * unit(RandomEngine));
+		vector3 v3Target = SphericalRand(40.0f * unit(RandomEngine)) + vector3(0.01f);
+		float fFOV = glm::radians(30.0f + 60.0f * unit(RandomEngine));
+		float fFar = 20.0f + 180.0f * unit(RandomEngine);
+		matrix4 m4View = glm::lookAt(v3Eye, v3Target, AXIS_Y);
+		m_lFrustum[i].SetMatrix(glm::perspective(fFOV, 16.0f / 9.0f, 0.1f, fFar) * m4View);
+	}
+
+	//the hierarchy built from the first positions and refit after half of the cubes moved
+	m_uMismatch = CountMismatches();
+	for (uint i = 0; i < m_uCount; i += 2)
+		pEntityMngr->SetModelMatrix(glm::translate(SphericalRand(60.0f * unit(RandomEngine))), i);
+	pEntityMngr->Update();
+	m_uMismatch += CountMismatches();
+	//moved again after the update
+	for (uint i = 1; i < m_uCount; i += 4)
+		pEntityMngr->SetPosition(SphericalRand(60.0f * unit(RandomEngine)), i);
+	m_uMismatch += CountMismatches();
+	if (m_uMismatch > 0)
+		m_sError = std::to_string(m_uMismatch) + " cameras saw different entities through the hierarchy";
+
+	pEntityMngr->SetHierarchicalCulling(m_bHierarchical);
+	return true;
+}
+uint CullingScenario::CountMismatches(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	std::vector<uint> lFlat;
+	std::vector<uint> lTree;
+	uint uMismatch = 0;
+	for (uint i = 0; i < m_lFrustum.size(); i++)
+	{
+		pEntityMngr->SetHierarchicalCulling(false);
+		pEntityMngr->GetVisibleEntities(m_lFrustum[i], lFlat);
+		pEntityMngr->SetHierarchicalCulling(true);
+		pEntityMngr->GetVisibleEntities(m_lFrustum[i], lTree);
+		std::sort(lTree.begin(), lTree.end());
+		if (lFlat != lTree)
+			uMismatch++;
+	}
+	return uMismatch;
+}
+void CullingScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	m_uVisible = 0;
+	for (uint i = 0; i < m_lFrustum.size(); i++)
+	{
+		pEntityMngr->GetVisibleEntities(m_lFrustum[i], m_lVisible);
+		m_uVisible += m_lVisible.size();
+	}
+}
+void CullingScenario::Teardown(void) { EntityManager::ReleaseInstance(); }
+String CullingScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"visible\": " << m_uVisible << ", \"entities_seen\": " << m_uVisible * 1.0 / (m_uCount * m_lFrustum.size())
+		<< ", \"mismatch\": " << m_uMismatch << "}";
+	return stream.str();
+}
+//QueryScenario
+QueryScenario::QueryScenario(String a_sName, eQUERY_KIND a_eKind, uint a_uCount, uint a_uRays)
+{
+	m_eKind = a_eKind;
+	m_uCount = a_uCount;
+	m_lRay.resize(a_uRays);
+	m_sName = a_sName;
+	m_sParameters = "{\"entities\": " + std::to_string(a_uCount) + ", \"queries\": " + std::to_string(a_uRays) + "}";
+	m_uOperations = a_uRays;
+}
+bool QueryScenario::Setup(void)
+{
+	Model* pModel = ModelManager::GetInstance()->GenerateUniCube();
+	if (pModel == nullptr)
+		return false;
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	RandomEngine.seed(309);
+	std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		pEntityMngr->AddEntity(pModel, "Cube");
+		quaternion qOrientation = glm::angleAxis(glm::radians(angle(RandomEngine)), glm::normalize(SphericalRand(1.0f) + vector3(0.001f)));
+		pEntityMngr->SetModelMatrix(glm::translate(SphericalRand(40.0f)) * glm::toMat4(qOrientation));
+	}
+	//lines of sight between points in the field, like agents looking at each other
+	for (uint i = 0; i < m_lRay.size(); i++)
+	{
+		m_lRay[i].v3Origin = SphericalRand(45.0f);
+		vector3 v3Target = SphericalRand(45.0f);
+		m_lRay[i].v3Direction = v3Target - m_lRay[i].v3Origin;
+		m_lRay[i].fMaxDistance = glm::length(m_lRay[i].v3Direction);
+	}
+
+	//the tree has to find the same closest entity as testing all of them, also after the
+	//entities are moved through their setters in between queries
+	m_uMismatch = CheckAgainstBruteForce();
+	for (uint i = 0; i < m_uCount; i += 2)
+	{
+		Entity* pEntity = pEntityMngr->GetEntity(i);
+		pEntity->SetPosition(pEntity->GetPosition() + SphericalRand(8.0f));
+	}
+	m_uMismatch += CheckAgainstBruteForce();
+	for (uint i = 1; i < m_uCount; i += 2)
+	{
+		quaternion qOrientation = glm::angleAxis(glm::radians(angle(RandomEngine)), glm::normalize(SphericalRand(1.0f) + vector3(0.001f)));
+		pEntityMngr->GetEntity(i)->SetOrientation(qOrientation);
+	}
+	m_uMismatch += CheckAgainstBruteForce();
+	if (m_uMismatch > 0)
+		m_sError = std::to_string(m_uMismatch) + " rays hit a different entity through the hierarchy";
+	m_uHits = CastBruteForce();
+	return true;
+}
+uint QueryScenario::CheckAgainstBruteForce(void)
+{
+	//the tree goes first, testing every entity remakes the matrices the setters left behind
+	EntityManager::GetInstance()->CastRays(m_lRay, m_lHit);
+	std::vector<RayHit> lTree = m_lHit;
+	CastBruteForce();
+	uint uMismatch = 0;
+	int nT=0,nB=0,nD=0; for (uint i = 0; i < m_lRay.size(); i++){ nT+=lTree[i].nEntity>=0; nB+=m_lHit[i].nEntity>=0; nD+=lTree[i].nEntity!=m_lHit[i].nEntity;}
+	fprintf(stderr,"DBG %d %d %d\n",nT,nB,nD);
+	for (uint i = 0; i < m_lRay.size(); i++)
+	{
+		if (m_lHit[i].nEntity != lTree[i].nEntity && std::abs(m_lHit[i].fDistance - lTree[i].fDistance) > 0.001f)
+			++uMismatch;
+	}
+	return uMismatch;
+}
+uint QueryScenario::CastBruteForce(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	uint uEntities = pEntityMngr->GetEntityCount();
+	uint uHits = 0;
+	m_lHit.resize(m_lRay.size());
+	for (uint i = 0; i < m_lRay.size(); i++)
+	{
+		RayQuery const& ray = m_lRay[i];
+		vector3 v3Direction = glm::normalize(ray.v3Direction);
+		RayHit& hit = m_lHit[i];
+		hit = RayHit();
+		float fBest = ray.fMaxDistance;
+		for (uint j = 0; j < uEntities; j++)
+		{
+			float fDistance = 0.0f;
+			vector3 v3Normal;
+			if (pEntityMngr->GetRigidBody(j)->IsIntersectingRay(ray.v3Origin, v3Direction, fBest, fDistance, v3Normal))
+			{
+				fBest = fDistance;
+				hit.nEntity = static_cast<int>(j);
+				hit.fDistance = fDistance;
+				hit.v3Normal = v3Normal;
+			}
+		}
+		if (hit.nEntity >= 0)
+		{
+			hit.v3Point = ray.v3Origin + v3Direction * hit.fDistance;
+			++uHits;
+		}
+	}
+	return uHits;
+}
+void QueryScenario::Run(void)
+{
+	EntityManager* pEntityMngr = EntityManager::GetInstance();
+	switch (m_eKind)
+	{
+	case QUERY_BRUTE:
+		m_uHits = CastBruteForce();
+		break;
+	case QUERY_ANY:
+		m_uHits = pEntityMngr->CastRays(m_lRay, m_lHit, true);
+		break;
+	case QUERY_SPHERE:
+		m_uHits = 0;
+		//the origins brought onto the shell the cubes are on, like an explosion among them
+		for (uint i = 0; i < m_lRay.size(); i++)
+			m_uHits += pEntityMngr->OverlapSphere(m_lRay[i].v3Origin * (40.0f / 45.0f), 3.0f, m_lOverlap);
+		break;
+	default:
+		m_uHits = pEntityMngr->CastRays(m_lRay, m_lHit);
+		break;
+	}
+}
+void QueryScenario::Teardown(void) { EntityManager::ReleaseInstance(); }
+String QueryScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"hits\": " << m_uHits << ", \"mismatch\": " << m_uMismatch << "}";
+	return stream.str();
+}
+//QueueScenario
+//The std::deque of HW01_STDQueue shared by threads the usual way, with a mutex
+template <class T>
+class LockedDeque
+{
+	std::deque<T> m_Queue; //Objects
+	std::mutex m_Mutex; //Guards m_Queue
+
+public:
+	bool TryPush(T&& a_Value)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Queue.push_back(std::move(a_Value));
+		return true;
+	}
+	bool TryPop(T& a_Out)
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_Queue.empty())
+			return false;
+		a_Out = std::move(m_Queue.front());
+		m_Queue.pop_front();
+		return true;
+	}
+};
+//Makes the payload for a number and reads the number back
+template <class T> static T MakePayload(int a_nValue);
+template <> int MakePayload<int>(int a_nValue) { return a_nValue; }
+template <> Foo MakePayload<Foo>(int a_nValue) { return Foo(a_nValue); }
+template <> AlbertoClass MakePayload<AlbertoClass>(int a_nValue) { return AlbertoClass(a_nValue); }
+template <> std::unique_ptr<AlbertoClass> MakePayload<std::unique_ptr<AlbertoClass>>(int a_nValue)
+{
+	return std::unique_ptr<AlbertoClass>(new AlbertoClass(a_nValue));
+}
+static int PayloadValue(int& a_nValue) { return a_nValue; }
+static int PayloadValue(Foo& a_Foo) { return a_Foo.content; }
+static int PayloadValue(AlbertoClass& a_Alberto) { return a_Alberto.GetAge(); }
+static int PayloadValue(std::unique_ptr<AlbertoClass>& a_pAlberto) { return a_pAlberto ? a_pAlberto->GetAge() : 0; }
+//Pushes a_uCount numbers from the producers and pops them all from the consumers
+template <class Q, class T>
+static long long HandOver(Q& a_Queue, uint a_uCount, uint a_uProducers, uint a_uConsumers)
+{
+	std::atomic<uint> uPopped(0);
+	std::atomic<long long> nSum(0);
+	std::vector<std::thread> lThread;
+	for (uint p = 0; p < a_uProducers; p++)
+	{
+		lThread.push_back(std::thread([&a_Queue, a_uCount, a_uProducers, p]()
+		{
+			for (uint i = p; i < a_uCount; i += a_uProducers)
+			{
+				T value = MakePayload<T>(static_cast<int>(i));
+				while (!a_Queue.TryPush(std::move(value)))
+					std::this_thread::yield();
+			}
+		}));
+	}
+	for (uint c = 0; c < a_uConsumers; c++)
+	{
+		lThread.push_back(std::thread([&a_Queue, &uPopped, &nSum, a_uCount]()
+		{
+			long long nLocal = 0;
+			T value = MakePayload<T>(0);
+			while (uPopped.load(std::memory_order_relaxed) < a_uCount)
+			{
+				if (!a_Queue.TryPop(value))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				nLocal += PayloadValue(value);
+				uPopped.fetch_add(1, std::memory_order_relaxed);
+			}
+			nSum += nLocal;
+		}));
+	}
+	for (uint i = 0; i < lThread.size(); i++)
+		lThread[i].join();
+	return nSum.load();
+}
+QueueScenario::QueueScenario(String a_sName, eQUEUE_KIND a_eKind, eQUEUE_PAYLOAD a_ePayload, uint a_uCount, uint a_uProducers, uint a_uConsumers)
+{
+	m_eKind = a_eKind;
+	m_ePayload = a_ePayload;
+	m_uCount = a_uCount;
+	m_uProducers = a_uProducers;
+	m_uConsumers = a_uConsumers;
+	m_sName = a_sName;
+	static const char* sKind[] = { "deque", "spsc", "mpmc" };
+	static const char* sPayload[] = { "int", "Foo", "AlbertoClass", "unique_ptr<AlbertoClass>" };
+	m_sParameters = "{\"queue\": \"" + String(sKind[a_eKind]) + "\", \"payload\": \"" + sPayload[a_ePayload] +
+		"\", \"objects\": " + std::to_string(a_uCount) + ", \"producers\": " + std::to_string(a_uProducers) +
+		", \"consumers\": " + std::to_string(a_uConsumers) + ", \"capacity\": " + std::to_string(m_uCapacity) + "}";
+	m_uOperations = a_uCount;
+}
+bool QueueScenario::Setup(void)
+{
+	//the single producer queue is only correct with one thread on each side
+	return m_eKind != QUEUE_SPSC || (m_uProducers == 1 && m_uConsumers == 1);
+}
+template <class T>
+void QueueScenario::RunPayload(void)
+{
+	switch (m_eKind)
+	{
+	case QUEUE_SPSC:
+	{
+		SPSCQueue<T> queue(m_uCapacity);
+		m_nSum = HandOver<SPSCQueue<T>, T>(queue, m_uCount, m_uProducers, m_uConsumers);
+		break;
+	}
+	case QUEUE_MPMC:
+	{
+		MPMCQueue<T> queue(m_uCapacity);
+		m_nSum = HandOver<MPMCQueue<T>, T>(queue, m_uCount, m_uProducers, m_uConsumers);
+		break;
+	}
+	default:
+	{
+		LockedDeque<T> queue;
+		m_nSum = HandOver<LockedDeque<T>, T>(queue, m_uCount, m_uProducers, m_uConsumers);
+		break;
+	}
+	}
+}
+void QueueScenario::Run(void)
+{
+	switch (m_ePayload)
+	{
+	case PAYLOAD_FOO: RunPayload<Foo>(); break;
+	case PAYLOAD_ALBERTO: RunPayload<AlbertoClass>(); break;
+	case PAYLOAD_UNIQUE: RunPayload<std::unique_ptr<AlbertoClass>>(); break;
+	default: RunPayload<int>(); break;
+	}
+}
+void QueueScenario::Teardown(void) { }
+String QueueScenario::GetCounters(void)
+{
+	//every number from 0 to count - 1 popped once
+	long long nExpected = static_cast<long long>(m_uCount) * (m_uCount - 1) / 2;
+	std::stringstream stream;
+	stream << "{\"sum_ok\": " << (m_nSum == nExpected ? "true" : "false") << "}";
+	return stream.str();
+}
+//ProfilerScenario
+ProfilerScenario::ProfilerScenario(String a_sName, bool a_bEnabled, uint a_uThreads, uint a_uZones)
+{
+	m_bEnabled = a_bEnabled;
+	m_uThreads = a_uThreads;
+	m_uZones = a_uZones;
+	m_sName = a_sName;
+	m_sParameters = "{\"threads\": " + std::to_string(a_uThreads) + ", \"zones\": " + std::to_string(a_uZones) +
+		", \"enabled\": " + (a_bEnabled ? "true" : "false") + "}";
+	m_uOperations = a_uThreads * a_uZones;
+}
+bool ProfilerScenario::Setup(void)
+{
+	Profiler::ReleaseInstance();
+	Profiler::SetEnabled(m_bEnabled);
+	return true;
+}
+void ProfilerScenario::CountFrame(void)
+{
+	Profiler* pProfiler = Profiler::GetInstance();
+	pProfiler->EndFrame();
+	for (uint i = 0; i < pProfiler->GetZoneCount(); i++)
+	{
+		ProfileStat stat = pProfiler->GetZoneStat(i);
+		if (stat.sName == "Benchmark::Zone")
+			m_uRead += stat.uCalls;
+	}
+}
+void ProfilerScenario::Run(void)
+{
+	Profiler* pProfiler = Profiler::GetInstance();
+	uint uDropped = pProfiler->GetDroppedCount();
+	m_uRead = 0;
+	std::atomic<uint> uDone(0);
+	std::vector<std::thread> lThread;
+	for (uint t = 0; t < m_uThreads; t++)
+	{
+		lThread.emplace_back([this, &uDone]()
+			{
+				volatile uint uSink = 0;
+				for (uint i = 0; i < m_uZones; i++)
+				{
+					BTX_PROFILE_ZONE("Benchmark::Zone");
+					uSink = uSink + i;
+				}
+				uDone++;
+			});
+	}
+	while (uDone.load() < m_uThreads)
+	{
+		CountFrame();
+		std::this_thread::yield();
+	}
+	for (uint t = 0; t < m_uThreads; t++)
+		lThread[t].join();
+	CountFrame();
+	m_uDropped = pProfiler->GetDroppedCount() - uDropped;
+
+	uint uExpected = m_bEnabled ? m_uThreads * m_uZones : 0;
+	if (m_uRead + m_uDropped != uExpected)
+		m_sError = std::to_string(m_uRead + m_uDropped) + " zones read or dropped out of " + std::to_string(uExpected);
+}
+void ProfilerScenario::Teardown(void) { Profiler::ReleaseInstance(); }
+String ProfilerScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"read\": " << m_uRead << ", \"dropped\": " << m_uDropped << "}";
+	return stream.str();
+}
+//FileReadScenario
+FileReadScenario::FileReadScenario(String a_sName, eFILE_READ a_eRead, bool a_bBinary, uint a_uCount)
+{
+	m_eRead = a_eRead;
+	m_bBinary = a_bBinary;
+	m_uCount = a_uCount;
+	m_sName = a_sName;
+	m_sParameters = "{\"values\": " + std::to_string(a_uCount) + ", \"binary\": " + (a_bBinary ? "true" : "false") + "}";
+	m_uOperations = a_uCount;
+}
+bool FileReadScenario::Setup(void)
+{
+	if (m_bBinary && m_eRead == FILE_VIEW)
+		return false;
+
+	m_sFileName = FolderSingleton::GetInstance()->GetFolderRoot() + (m_bBinary ? "BenchFile.bin" : "BenchFile.txt");
+	if (m_bBinary)
+	{
+		FileReader writer;
+		if (writer.SaveBinaryFile(m_sFileName) != eBTX_OUTPUT::OUT_ERR_NONE)
+			return false;
+		for (uint i = 0; i < m_uCount; i += 2)
+		{
+			writer.WriteInt(static_cast<int>(i));
+			writer.WriteFloat(static_cast<float>(i + 1));
+		}
+		writer.CloseFile();
+		return true;
+	}
+
+	//the counted lines are vertices and faces, the comments and blanks between them are skipped
+	std::ofstream file(m_sFileName.c_str(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+	file << "# BenchFile\n";
+	for (uint i = 0; i < 20000; i++)
+		file << "# comment block that used to be skipped one call deeper per line\n";
+	std::mt19937 engine(309); //own engine, every way of reading gets the same file
+	std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+	for (uint i = 0; i < m_uCount; i++)
+	{
+		if (i % 16 == 0)
+			file << "\n// group " << i / 16 << "\n";
+		if (i % 2 == 0)
+			file << "\tv " << coordinate(engine) << " " << coordinate(engine) << " " << coordinate(engine) << "\n";
+		else
+			file << "f " << i << "/" << i << "/" << i << " " << i + 1 << "/" << i + 1 << "/" << i + 1 << " " << i + 2 << "/" << i + 2 << "/" << i + 2 << "\n";
+	}
+	return true;
+}
+void FileReadScenario::Run(void)
+{
+	m_uRead = 0;
+	m_nSum = 0;
+	FileReader reader;
+	eBTX_OUTPUT result = eBTX_OUTPUT::OUT_ERR_NONE;
+	if (m_eRead == FILE_STREAM)
+		result = m_bBinary ? reader.ReadBinaryFile(m_sFileName) : reader.ReadFile(m_sFileName);
+	else
+		result = reader.ReadFileBuffered(m_sFileName);
+	if (result != eBTX_OUTPUT::OUT_ERR_NONE)
+		return;
+
+	if (m_bBinary)
+	{
+		for (uint i = 0; i < m_uCount; i += 2)
+		{
+			m_nSum += reader.ReadInt();
+			m_nSum += static_cast<long long>(reader.ReadFloat());
+			m_uRead += 2;
+		}
+	}
+	else if (m_eRead == FILE_VIEW)
+	{
+		LineView line;
+		while (reader.ReadNextLine(line) == eBTX_OUTPUT::OUT_RUNNING)
+		{
+			m_nSum += line.uLength;
+			m_uRead++;
+		}
+	}
+	else
+	{
+		//the stream keeps the carriage returns a text mode stream would have taken out
+		while (reader.ReadNextLine() == eBTX_OUTPUT::OUT_RUNNING)
+		{
+			uint uLength = static_cast<uint>(reader.m_sLine.length());
+			if (uLength > 0 && reader.m_sLine[uLength - 1] == '\r')
+				uLength--;
+			m_nSum += uLength;
+			m_uRead++;
+		}
+	}
+	reader.CloseFile();
+}
+void FileReadScenario::Teardown(void) { remove(m_sFileName.c_str()); }
+String FileReadScenario::GetCounters(void)
+{
+	std::stringstream stream;
+	stream << "{\"read\": " << m_uRead << ", \"sum\": " << m_nSum << "}";
+	return stream.str();
+}
+void AddScenarios(Benchmark* a_pBenchmark, uint a_uThreads)
+{
+	a_pBenchmark->AddScenario(new RigidBodyBuildScenario(500));
+	a_pBenchmark->AddScenario(new RigidBodyMoveScenario(500));
+	//the scenes of C21_Octree and HW05_Octree without the octree
+	a_pBenchmark->AddScenario(new BroadphaseScenario("Broadphase/C21", 484, 34.0f));
+	a_pBenchmark->AddScenario(new BroadphaseScenario("Broadphase/HW05", 1849, 34.0f));
+	//HW05_Octree itself: the Entity Manager update with every pair, then with the octree of 1 and 3 levels
+	a_pBenchmark->AddScenario(new OctreeScenario("Broadphase/HW05/Entities", 1849, false, 0, 20));
+	a_pBenchmark->AddScenario(new OctreeScenario("Broadphase/HW05/Octree1", 1849, true, 1, 20));
+	a_pBenchmark->AddScenario(new OctreeScenario("Broadphase/HW05/Octree3", 1849, true, 3, 20));
+	a_pBenchmark->AddScenario(new PhysicsScenario(100, 60));
+	a_pBenchmark->AddScenario(new MeshGenerateScenario(100));
+	a_pBenchmark->AddScenario(new MeshSimplifyScenario(64));
+	//the cubes of C21_Octree, then a scene mixing primitives
+	a_pBenchmark->AddScenario(new RenderScenario("Render/C21", 484, 1, RENDER_SOLID));
+	a_pBenchmark->AddScenario(new RenderScenario("Render/Mixed", 2000, 4, RENDER_SOLID | RENDER_WIRE));
+	//a crowd going away from the camera, drawn with the levels of detail of the torus
+	a_pBenchmark->AddScenario(new LODScenario(2000));
+	a_pBenchmark->AddScenario(new DebugDrawScenario(1000));
+	//the debug view of a large simulation, sphere, box and aligned box of every body
+	a_pBenchmark->AddScenario(new BoundsScenario(20000));
+	//the startup of ShaderManager with and without the binaries of a previous run
+	a_pBenchmark->AddScenario(new ShaderCacheScenario("Shader/Compile", 16, false));
+	a_pBenchmark->AddScenario(new ShaderCacheScenario("Shader/Cached", 16, true));
+	//a 1024 texture, what FreeImage is skipped for once it is cooked
+	a_pBenchmark->AddScenario(new TextureMipsScenario(1024));
+	a_pBenchmark->AddScenario(new TextureCookedScenario(1024));
+	//a layer of blocks with a texture each, a draw per block or one per atlas page
+	a_pBenchmark->AddScenario(new AtlasScenario("Atlas/Separate", 256, false));
+	a_pBenchmark->AddScenario(new AtlasScenario("Atlas/Packed", 256, true));
+	a_pBenchmark->AddScenario(new AtlasLoadScenario("Atlas/Loaded/Separate", 6, 64, false));
+	a_pBenchmark->AddScenario(new AtlasLoadScenario("Atlas/Loaded/Packed", 6, 64, true));
+	//entities that all ask for the same name, the unique IDs are made and found again by name
+	a_pBenchmark->AddScenario(new EntitySpawnScenario(10000));
+	a_pBenchmark->AddScenario(new EntitySpawnScenario(100000));
+	//moving entities every frame with the setters, with a matrix and the way matrices were split before
+	a_pBenchmark->AddScenario(new TransformScenario("Transform/Setters", TRANSFORM_TRS, 10000));
+	a_pBenchmark->AddScenario(new TransformScenario("Transform/Matrix", TRANSFORM_MATRIX, 10000));
+	a_pBenchmark->AddScenario(new TransformScenario("Transform/Legacy", TRANSFORM_LEGACY, 10000));
+	//the reads of the matrices in the render loop of C16, once per mesh
+	a_pBenchmark->AddScenario(new CameraFrameScenario("Camera/Uncached", 4, 1000, false));
+	a_pBenchmark->AddScenario(new CameraFrameScenario("Camera/Cached", 4, 1000, true));
+
+	a_pBenchmark->AddScenario(new AnimationScenario("Animation/Search", 10000, INTERPOLATION_LINEAR, false, false));
+	a_pBenchmark->AddScenario(new AnimationScenario("Animation/Batch", 10000, INTERPOLATION_LINEAR, true, false));
+	a_pBenchmark->AddScenario(new AnimationScenario("Animation/BatchCubic", 10000, INTERPOLATION_CUBIC, true, false));
+	a_pBenchmark->AddScenario(new AnimationScenario("Animation/SearchEntities", 2000, INTERPOLATION_LINEAR, false, true));
+	a_pBenchmark->AddScenario(new AnimationScenario("Animation/BatchEntities", 2000, INTERPOLATION_LINEAR, true, true));
+
+	a_pBenchmark->AddScenario(new PipelineScenario("Pipeline/Serial", 400, false));
+	a_pBenchmark->AddScenario(new PipelineScenario("Pipeline/Overlapped", 400, true));
+
+	//the cubes of HW05_Octree around an opaque core, the core hides the far side of the sphere
+	a_pBenchmark->AddScenario(new OcclusionScenario("Occlusion/FrustumOnly", 1849, false, false, a_uThreads));
+	a_pBenchmark->AddScenario(new OcclusionScenario("Occlusion/Culled", 1849, true, false, a_uThreads));
+	a_pBenchmark->AddScenario(new OcclusionScenario("Occlusion/CulledHierarchical", 1849, true, true, a_uThreads));
+
+	//the same cameras with and without the hierarchy, the sets they see are checked to be equal
+	a_pBenchmark->AddScenario(new CullingScenario("Culling/Flat", false, 5000, 256));
+	a_pBenchmark->AddScenario(new CullingScenario("Culling/Hierarchical", true, 5000, 256));
+	//line of sight between agents spread through the field
+	a_pBenchmark->AddScenario(new QueryScenario("Query/BruteForce", QUERY_BRUTE, 2000, 4096));
+	a_pBenchmark->AddScenario(new QueryScenario("Query/Closest", QUERY_CLOSEST, 2000, 4096));
+	a_pBenchmark->AddScenario(new QueryScenario("Query/AnyHit", QUERY_ANY, 2000, 4096));
+	a_pBenchmark->AddScenario(new QueryScenario("Query/Sphere", QUERY_SPHERE, 2000, 4096));
+
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/Deque/int", QUEUE_DEQUE, PAYLOAD_INT, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/SPSC/int", QUEUE_SPSC, PAYLOAD_INT, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/Deque/Foo", QUEUE_DEQUE, PAYLOAD_FOO, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/SPSC/Foo", QUEUE_SPSC, PAYLOAD_FOO, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/Deque/Alberto", QUEUE_DEQUE, PAYLOAD_ALBERTO, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/SPSC/Alberto", QUEUE_SPSC, PAYLOAD_ALBERTO, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/Deque/UniqueAlberto", QUEUE_DEQUE, PAYLOAD_UNIQUE, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/SPSC/UniqueAlberto", QUEUE_SPSC, PAYLOAD_UNIQUE, 200000, 1, 1));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/DequeMany/Alberto", QUEUE_DEQUE, PAYLOAD_ALBERTO, 200000, 4, 4));
+	a_pBenchmark->AddScenario(new QueueScenario("Queue/MPMC/Alberto", QUEUE_MPMC, PAYLOAD_ALBERTO, 200000, 4, 4));
+
+	//zones on worker threads read while they are being recorded, and what a zone costs when the profiler is off
+	a_pBenchmark->AddScenario(new ProfilerScenario("Profiler/Disabled", false, a_uThreads, 200000));
+	a_pBenchmark->AddScenario(new ProfilerScenario("Profiler/Enabled", true, a_uThreads, 200000));
+
+	//the same lines and values through the stream, copied out of memory or looked at in place
+	a_pBenchmark->AddScenario(new FileReadScenario("FileRead/Lines/Stream", FILE_STREAM, false, 200000));
+	a_pBenchmark->AddScenario(new FileReadScenario("FileRead/Lines/Buffered", FILE_BUFFERED, false, 200000));
+	a_pBenchmark->AddScenario(new FileReadScenario("FileRead/Lines/View", FILE_VIEW, false, 200000));
+	a_pBenchmark->AddScenario(new FileReadScenario("FileRead/Binary/Stream", FILE_STREAM, true, 200000));
+	a_pBenchmark->AddScenario(new FileReadScenario("FileRead/Binary/Buffered", FILE_BUFFERED, true, 200000));
+
+	//the same 12 MB file through the scanner and through the loop it replaced
+	a_pBenchmark->AddScenario(new ObjParseScenario("ObjParse/Scanner", false, 256));
+	a_pBenchmark->AddScenario(new ObjParseScenario("ObjParse/Legacy", true, 256));
+	a_pBenchmark->AddScenario(new ModelCookedLODScenario(64));
+
+	FolderSingleton* pFolder = FolderSingleton::GetInstance();
+	String sFolder = pFolder->GetFolderRoot() + pFolder->GetFolderData() + pFolder->GetFolderMOBJ();
+	a_pBenchmark->AddScenario(new ModelReadScenario("ModelRead/Cube", sFolder + "Minecraft\\Cube.obj", 1));
+	a_pBenchmark->AddScenario(new ModelReadScenario("ModelRead/Steve", sFolder + "Minecraft\\Steve.obj", 1));
+	//a 2 MB file, large enough to be split in a chunk per thread
+	for (uint uThreads = 1; uThreads <= 8; uThreads *= 2)
+		a_pBenchmark->AddScenario(new ModelReadScenario("ModelRead/Bowser/" + std::to_string(uThreads), sFolder + "Bowser.obj", uThreads));
+}
@@ -0,0 +1,580 @@
+#ifndef __SCENARIOS_H_
+#define __SCENARIOS_H_
+
+#include "Benchmark.h"
+#include "BTX\System\RingQueue.h"
+#include "..\HW01_STDQueue\Alberto.h"
+#include "..\HW01_STDQueue\Foo.h"
+#include "..\HW05_Octree\Octant.h"
+#include <memory>
+#include <random>
+
+/*
+Scenarios made after the lessons, with a fixed seed so every run measures the same data.
+None of them needs a window or an OpenGL context, the ones that make meshes or render
+need the null render backend and count what they sent to it.
+*/
+
+//Makes rigid bodies out of the vertices of a cube
+class RigidBodyBuildScenario : public Scenario
+{
+	uint m_uCount = 0; //Bodies made per run
+	std::vector<vector3> m_lPoint; //Vertices of the cube
+
+public:
+	RigidBodyBuildScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+};
+
+//Moves rigid bodies and asks for their global bounds, as the entities do every frame
+class RigidBodyMoveScenario : public Scenario
+{
+	uint m_uCount = 0; //Bodies moved per run
+	uint m_uFrame = 0; //Runs so far, changes the matrices
+	vector3 m_v3Sum = ZERO_V3; //Sum of the bounds, keeps them from being optimized away
+	std::vector<RigidBody*> m_lBody; //Bodies to move
+
+public:
+	RigidBodyMoveScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+};
+
+//Tests every pair of bodies against each other, as EntityManager::Update does
+class BroadphaseScenario : public Scenario
+{
+	uint m_uCount = 0; //Bodies in the scene
+	float m_fRadius = 0.0f; //Radius of the sphere the bodies are placed in
+	std::vector<RigidBody*> m_lBody; //Bodies of the scene
+
+public:
+	BroadphaseScenario(String a_sName, uint a_uCount, float a_fRadius);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+};
+
+//The cubes of HW05_Octree going through EntityManager::Update, each one tested against every
+//other one or only against the ones sharing an octant with it; some cubes move every frame and
+//the octree only places those again, taking them from the moved entities of the update
+class OctreeScenario : public Scenario
+{
+	uint m_uCount = 0; //Cubes in the scene
+	bool m_bOctree = false; //Are the cubes split into octants?
+	uint m_uLevels = 0; //Levels of the octree
+	uint m_uMoving = 0; //Cubes moved every frame
+	Octant* m_pRoot = nullptr; //Root of the octree, owned by the scenario
+	uint m_uPairs = 0; //Colliding pairs found by the last update
+	uint m_uMismatch = 0; //Frames of Setup in which the update and testing every pair disagreed
+
+public:
+	OctreeScenario(String a_sName, uint a_uCount, bool a_bOctree, uint a_uLevels, uint a_uMoving);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+
+private:
+	//Moves some cubes to new places on the sphere, places them again in the octree and updates the manager
+	void Frame(void);
+	//Counts the colliding pairs the last update found
+	uint CountUpdatePairs(void);
+	//Counts the colliding pairs by testing every pair
+	uint CountAllPairs(void);
+};
+
+//Drops cubes on the floor with the solver, the scene of C22_Physics
+class PhysicsScenario : public Scenario
+{
+	uint m_uCount = 0; //Cubes in the scene
+	uint m_uFrames = 0; //Frames simulated per run
+	std::vector<RigidBody*> m_lBody; //Collision shape of each cube
+	std::vector<Solver*> m_lSolver; //Physics of each cube
+
+public:
+	PhysicsScenario(uint a_uCount, uint a_uFrames);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+};
+
+//Parses an obj file without building it, a single load split in chunks over the loader threads
+class ModelReadScenario : public Scenario
+{
+	String m_sFileName = ""; //Absolute route of the file
+	uint m_uLoaderThreads = 1; //Threads the chunks of the file are parsed on
+	unsigned long long m_uBytes = 0; //Size of the file
+	double m_dSeconds = 0.0; //Time taken by the last run
+
+public:
+	ModelReadScenario(String a_sName, String a_sFileName, uint a_uLoaderThreads);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Parses a large generated obj file, either with the scanner of Model or with the FileReader and
+//sscanf loop Model used before it, and reports the throughput of each
+class ObjParseScenario : public Scenario
+{
+	bool m_bLegacy = false; //Parse with the old loop?
+	uint m_uSegments = 0; //Rings and slices of the sphere written to the file
+	String m_sFileName = ""; //File written by Setup
+	unsigned long long m_uBytes = 0; //Size of the file
+	double m_dSeconds = 0.0; //Time taken by the last run
+	bool m_bRead = false; //Was the file read by the last run?
+
+public:
+	ObjParseScenario(String a_sName, bool a_bLegacy, uint a_uSegments);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Loads a sphere from its cooked file, the levels of detail simplified when it was cooked come
+//back with it; fails if they do not match the ones made on the first load
+class ModelCookedLODScenario : public Scenario
+{
+	uint m_uSegments = 0; //Rings and slices of the sphere written to the file
+	String m_sFileName = ""; //File written by Setup
+	uint m_uLevels = 0; //Levels of detail made on the first load
+	uint m_uVertices = 0; //Vertices of the coarsest level made on the first load
+	uint m_uMismatch = 0; //Runs whose levels did not match the first load
+
+public:
+	ModelCookedLODScenario(uint a_uSegments);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Generates the primitives of ModelManager and sends their vertices to the backend
+class MeshGenerateScenario : public Scenario
+{
+	uint m_uCount = 0; //Meshes made per run
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	MeshGenerateScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	String GetCounters(void) override;
+};
+
+//Simplifies a finely tessellated sphere to a quarter of its triangles
+class MeshSimplifyScenario : public Scenario
+{
+	uint m_uRings = 0; //Rings and segments of the sphere
+	Mesh* m_pSource = nullptr; //Sphere to simplify
+	uint m_uTriangles = 0; //Triangles left by the last run
+
+public:
+	MeshSimplifyScenario(uint a_uRings);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Draws instances of a few primitives through ModelManager::Render
+class RenderScenario : public Scenario
+{
+	uint m_uCount = 0; //Instances drawn per run
+	uint m_uKinds = 0; //Different primitives the instances cycle through
+	int m_nRender = 0; //Solid, wire or both
+	std::vector<matrix4> m_lMatrix; //Where each instance goes
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	RenderScenario(String a_sName, uint a_uCount, uint a_uKinds, int a_nRender);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Draws a field of tori going away from the camera, each instance picks its level of detail
+class LODScenario : public Scenario
+{
+	uint m_uCount = 0; //Instances drawn per run
+	std::vector<matrix4> m_lMatrix; //Where each instance goes
+	uint m_uFullVertices = 0; //Vertices the instances would draw without levels of detail
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	LODScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Draws the three grids of C21_SpatialOptimization and the wire boxes of its octree
+class DebugDrawScenario : public Scenario
+{
+	uint m_uBoxes = 0; //Wire boxes added per run
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	DebugDrawScenario(uint a_uBoxes);
+	bool Setup(void) override;
+	void Run(void) override;
+	String GetCounters(void) override;
+};
+
+//Draws the bounding volumes of a field of rotated rigid bodies through the bounds batch
+class BoundsScenario : public Scenario
+{
+	uint m_uCount = 0; //Bodies drawn per run
+	std::vector<RigidBody*> m_lBody; //Bodies of the field
+	std::vector<RigidBody::DrawState> m_lState; //Volumes of the bodies, sent in one call per run
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	BoundsScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Makes programs through the shader binary cache, either compiling them and saving their
+//binaries or loading the binaries saved by Setup
+class ShaderCacheScenario : public Scenario
+{
+	uint m_uCount = 0; //Programs made per run
+	bool m_bWarm = false; //Are the binaries there before the run?
+	std::vector<String> m_lFile; //Vertex, fragment and cache file of each program
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	ShaderCacheScenario(String a_sName, uint a_uCount, bool a_bWarm);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Makes the mip levels of a square texture on the CPU
+class TextureMipsScenario : public Scenario
+{
+	int m_nSize = 0; //Width and height of the first level
+	std::vector<GLubyte> m_lChain; //Mip chain, the first level is a fixed pattern
+
+public:
+	TextureMipsScenario(int a_nSize);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Loads a square texture and its mip levels from its cooked file and uploads them
+class TextureCookedScenario : public Scenario
+{
+	int m_nSize = 0; //Width and height of the first level
+	String m_sFileName = ""; //Stand in for the source image, only its stamp is read
+	Texture* m_pTexture = nullptr; //Texture loaded
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	TextureCookedScenario(int a_nSize);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//A layer of blocks that each have their own small texture, drawn as they are or packed in an atlas
+class AtlasScenario : public Scenario
+{
+	uint m_uBlocks = 0; //Number of blocks, each with its own texture and material
+	bool m_bAtlas = false; //Are the textures packed and the blocks merged before the runs?
+	uint m_uPages = 0; //Pages the textures were packed in
+	Model* m_pModel = nullptr; //Blocks, a mesh each unless they were merged
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	AtlasScenario(String a_sName, uint a_uBlocks, bool a_bAtlas);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Models loaded from files that each have their own skin, like the Minecraft ones, drawn with
+//the skins as they are or packed by the Model Manager in the atlas they share
+class AtlasLoadScenario : public Scenario
+{
+	uint m_uModels = 0; //Models loaded, each with its own skin
+	uint m_uInstances = 0; //Instances of each model drawn per run
+	bool m_bAtlas = false; //Does the Model Manager pack the skins?
+	std::vector<String> m_lFile; //Files written by Setup
+	std::vector<String> m_lModel; //Names of the models loaded
+	RenderStats m_Stats; //Calls made to the backend by the last run
+
+public:
+	AtlasLoadScenario(String a_sName, uint a_uModels, uint a_uInstances, bool a_bAtlas);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Spawns entities that all ask for the same name, so each one gets a generated unique ID,
+//finds every one of them again by that name and releases them
+class EntitySpawnScenario : public Scenario
+{
+	uint m_uCount = 0; //Entities spawned per run
+	Model* m_pModel = nullptr; //Model shared by the entities, owned by the Model Manager
+	std::vector<String> m_lUniqueID; //Unique IDs given in the last run
+	uint m_uFound = 0; //Entities found by their unique ID in the last run
+
+public:
+	EntitySpawnScenario(uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+enum eTRANSFORM_PATH { TRANSFORM_TRS = 0, TRANSFORM_MATRIX = 1, TRANSFORM_LEGACY = 2 };
+//A frame that spins and bobs every entity and then reads its rigid body, the way the collision
+//and render passes do; the entity is moved with the position, orientation and scale setters,
+//with a translate * rotate * scale matrix given to SetModelMatrix, or the way SetModelMatrix
+//worked before the entity kept its components, a matrix product and glm::decompose per move
+class TransformScenario : public Scenario
+{
+	eTRANSFORM_PATH m_ePath = TRANSFORM_TRS; //How the entities are moved
+	uint m_uCount = 0; //Entities moved per run
+	uint m_uFrame = 0; //Runs so far, the time of the animation
+	std::vector<vector3> m_lBase; //Position each entity bobs around
+	std::vector<vector3> m_lAxis; //Axis each entity spins around
+	vector3 m_v3Center = ZERO_V3; //Sum of the rigid body centers after the last run
+
+public:
+	TransformScenario(String a_sName, eTRANSFORM_PATH a_ePath, uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//A frame that moves one of several cameras and then reads the matrices and frustum of the
+//active one once per mesh, the way the render loops of the projects do; uncached reads make
+//the matrices on every read like the getters used to
+class CameraFrameScenario : public Scenario
+{
+	uint m_uCameras = 0; //Cameras in the Camera Manager
+	uint m_uReads = 0; //Reads of the active camera per frame
+	bool m_bCached = true; //Are the reads served from the cache?
+	uint m_uBuilds = 0; //Matrices made by the last frame
+	matrix4 m_m4Sum = IDENTITY_M4; //Keeps the reads from being optimized away
+
+public:
+	CameraFrameScenario(String a_sName, uint a_uCameras, uint a_uReads, bool a_bCached);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//A frame of keyframe animation over many instances of a few clips: batched plays them through
+//the Animation Manager with cached cursors, otherwise each instance samples its clip with a
+//binary search for its keys the way a lone object would
+class AnimationScenario : public Scenario
+{
+	uint m_uCount = 0; //Instances played
+	eBTX_INTERPOLATION m_eInterpolation = INTERPOLATION_LINEAR; //Interpolation of every track
+	bool m_bBatch = true; //Played through the Animation Manager?
+	bool m_bEntities = false; //Are the instances bound to entities?
+	std::vector<float> m_lTime; //Time of each instance when not batched
+	std::vector<uint> m_lClip; //Clip of each instance when not batched
+	std::vector<uint> m_lEntity; //Name Table handle of the entity of each instance when not batched
+	uint m_uApplied = 0; //Entities written to by the last frame
+	vector3 m_v3Sum = ZERO_V3; //Keeps the samples from being optimized away
+
+public:
+	AnimationScenario(String a_sName, uint a_uCount, eBTX_INTERPOLATION a_eInterpolation, bool a_bBatch, bool a_bEntities);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//A frame of the C22_Physics scene: the entity update followed by building and submitting the
+//render lists, or pipelined with the update of the next frame running on a worker while the
+//lists are built from the stored render state
+class PipelineScenario : public Scenario
+{
+	uint m_uCount = 0; //Entities in the scene
+	bool m_bPipelined = false; //Does the update overlap the render?
+	Model* m_pModel = nullptr; //Model shared by the entities, owned by the Model Manager
+	double m_dWait = 0.0; //Microseconds the last frame waited for the worker at its end
+	uint m_uDrawn = 0; //Entities added to the render list by the last frame
+
+public:
+	PipelineScenario(String a_sName, uint a_uCount, bool a_bPipelined);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//A field of rotated cubes culled by many random cameras, testing every entity or going through
+//the hierarchy; Setup checks that both give exactly the same entities, also after half of the
+//cubes move, and fails the scenario if they do not
+class CullingScenario : public Scenario
+{
+	bool m_bHierarchical = false; //Is the hierarchy used by the runs?
+	uint m_uCount = 0; //Entities in the scene
+	std::vector<Frustum> m_lFrustum; //Frustum of each random camera
+	std::vector<uint> m_lVisible; //Entities seen by one camera
+	uint m_uVisible = 0; //Entities seen by all the cameras in the last run
+	uint m_uMismatch = 0; //Cameras that saw different entities with and without the hierarchy
+
+public:
+	CullingScenario(String a_sName, bool a_bHierarchical, uint a_uCount, uint a_uCameras);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+
+private:
+	//Counts the cameras for which the hierarchy and the test of every entity disagree
+	uint CountMismatches(void);
+};
+
+//The sphere of cubes of HW05_Octree around a large opaque cube, culled with the frustum only
+//or with the core as an occluder hiding the far side of the sphere
+class OcclusionScenario : public Scenario
+{
+	uint m_uCount = 0; //Cubes on the sphere
+	bool m_bOcclusion = false; //Are the hidden cubes culled?
+	bool m_bHierarchical = false; //Is the frustum culling hierarchical?
+	uint m_uThreads = 1; //Threads the occlusion buffer is drawn with
+	Model* m_pModel = nullptr; //Model shared by the entities, owned by the Model Manager
+	uint m_uVisible = 0; //Entities added to the render list by the last run
+	uint m_uOccluded = 0; //Entities hidden by the core in the last run
+	uint m_uFalseOccluded = 0; //Entities culled as hidden with a corner the camera can see, checked once in Setup
+	RenderStats m_Stats; //Calls counted by the null backend in the last run
+
+public:
+	OcclusionScenario(String a_sName, uint a_uCount, bool a_bOcclusion, bool a_bHierarchical, uint a_uThreads);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+//Rays and overlaps against a field of rotated cubes, each ray tested against every entity or
+//answered through the bounding volume hierarchy of the Entity Manager
+enum eQUERY_KIND { QUERY_BRUTE = 0, QUERY_CLOSEST = 1, QUERY_ANY = 2, QUERY_SPHERE = 3 };
+class QueryScenario : public Scenario
+{
+	eQUERY_KIND m_eKind = QUERY_CLOSEST; //How the queries are answered
+	uint m_uCount = 0; //Entities in the scene
+	std::vector<RayQuery> m_lRay; //Rays cast per run, also the centers of the sphere overlaps
+	std::vector<RayHit> m_lHit; //Result of each ray
+	std::vector<uint> m_lOverlap; //Entities found by one overlap
+	uint m_uHits = 0; //Rays that hit or entities overlapped by the last run
+	uint m_uMismatch = 0; //Closest hits that differ from testing every entity, checked in Setup before and after moves
+
+public:
+	QueryScenario(String a_sName, eQUERY_KIND a_eKind, uint a_uCount, uint a_uRays);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+
+private:
+	//Casts every ray against every entity, the reference the tree is checked against
+	uint CastBruteForce(void);
+	//Casts the rays through the tree and against every entity, returns the closest hits that differ
+	uint CheckAgainstBruteForce(void);
+};
+
+//Payloads of HW01_STDQueue handed from producer threads to consumer threads through a queue,
+//either a std::deque behind a mutex or one of the lock-free ring queues
+enum eQUEUE_KIND { QUEUE_DEQUE = 0, QUEUE_SPSC = 1, QUEUE_MPMC = 2 };
+enum eQUEUE_PAYLOAD { PAYLOAD_INT = 0, PAYLOAD_FOO = 1, PAYLOAD_ALBERTO = 2, PAYLOAD_UNIQUE = 3 };
+class QueueScenario : public Scenario
+{
+	eQUEUE_KIND m_eKind = QUEUE_DEQUE; //Queue the objects go through
+	eQUEUE_PAYLOAD m_ePayload = PAYLOAD_INT; //Type of the objects
+	uint m_uCount = 0; //Objects handed over per run
+	uint m_uProducers = 1; //Threads pushing
+	uint m_uConsumers = 1; //Threads popping
+	uint m_uCapacity = 1024; //Objects the ring queues hold
+	long long m_nSum = 0; //Sum of the values popped, checks nothing was lost
+
+public:
+	QueueScenario(String a_sName, eQUEUE_KIND a_eKind, eQUEUE_PAYLOAD a_ePayload, uint a_uCount, uint a_uProducers, uint a_uConsumers);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+
+private:
+	template <class T> void RunPayload(void);
+};
+
+//Worker threads each going through many profiler zones while the main thread closes frames,
+//like the update worker does beside the render; with the profiler off it is the cost of a zone
+//nobody records, with it on every zone has to be read by EndFrame or counted as dropped
+class ProfilerScenario : public Scenario
+{
+	bool m_bEnabled = false; //Is the profiler recording?
+	uint m_uThreads = 1; //Threads going through zones
+	uint m_uZones = 0; //Zones per thread per run
+	uint m_uRead = 0; //Zones read by EndFrame in the last run
+	uint m_uDropped = 0; //Zones dropped in the last run
+
+public:
+	ProfilerScenario(String a_sName, bool a_bEnabled, uint a_uThreads, uint a_uZones);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+
+private:
+	//Adds the zones EndFrame read in the frame it just closed to m_uRead
+	void CountFrame(void);
+};
+
+//A text file shaped like an OBJ, with a long block of comments, read line by line, or a binary
+//file of ints and floats read value by value; either through the stream of the FileReader or
+//with the whole file read into memory first
+enum eFILE_READ { FILE_STREAM = 0, FILE_BUFFERED = 1, FILE_VIEW = 2 };
+class FileReadScenario : public Scenario
+{
+	eFILE_READ m_eRead = FILE_STREAM; //How the file is read, views are only for text
+	bool m_bBinary = false; //Read typed values instead of lines?
+	uint m_uCount = 0; //Lines or values in the file
+	String m_sFileName = ""; //File written by Setup
+	uint m_uRead = 0; //Lines or values read by the last run
+	long long m_nSum = 0; //Sum of the lengths of the lines or of the values, the same for every way of reading
+
+public:
+	FileReadScenario(String a_sName, eFILE_READ a_eRead, bool a_bBinary, uint a_uCount);
+	bool Setup(void) override;
+	void Run(void) override;
+	void Teardown(void) override;
+	String GetCounters(void) override;
+};
+
+/*
+USAGE: Adds every scenario to the benchmark
+ARGUMENTS:
+-	Benchmark* a_pBenchmark -> benchmark to add them to
+-	uint a_uThreads -> threads used by the scenarios that can use several
+OUTPUT: ---
+*/
+void AddScenarios(Benchmark* a_pBenchmark, uint a_uThreads);
+
+#endif //__SCENARIOS_H_
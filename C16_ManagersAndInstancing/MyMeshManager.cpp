@@ -198,13 +198,13 @@ void MyMeshManager::Render(void)
 	//Check how many meshes are in the render list
 	uint uMeshCount = m_meshList.size();
 
+	//get view and projection matrices, the camera does not move while the meshes render
+	matrix4 m4View = m_pCamera->GetViewMatrix();
+	matrix4 m4Proj = m_pCamera->GetProjectionMatrix();
+
 	//for each mesh render
 	for (uint nMesh = 0; nMesh < uMeshCount; ++nMesh)
 	{
-		//get view and projection matrices
-		matrix4 m4View = m_pCamera->GetViewMatrix();
-		matrix4 m4Proj = m_pCamera->GetProjectionMatrix();
-		
 		//count how many do you have to render for each element in the list
 		int nCount = m_renderList[nMesh].size();
 
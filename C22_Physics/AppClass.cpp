@@ -21,6 +21,10 @@ void Application::InitVariables(void)
 		m_pEntityMngr->UsePhysicsSolver();
 		//m_pEntityMngr->SetMass(0.5f);
 	}
+
+	//the first frame draws the scene as it starts
+	m_pEntityMngr->StoreRenderState();
+	m_pEntityMngr->SwapRenderState();
 }
 void Application::Update(void)
 {
@@ -33,11 +37,11 @@ void Application::Update(void)
 	//Is the first person camera active?
 	CameraRotation();
 
-	//Update Entity Manager
-	m_pEntityMngr->Update();
+	//Update Entity Manager on a worker, this frame draws the result of the last update meanwhile
+	m_pEntityMngr->BeginUpdate();
 
 	//Add objects to render list
-	m_pEntityMngr->AddEntityToRenderList(-1, true);
+	m_pEntityMngr->AddRenderStateToRenderList(true);
 }
 void Application::Display(void)
 {
@@ -60,6 +64,9 @@ void Application::Display(void)
 	
 	//end the current frame (internally swaps the front and back buffers)
 	m_pWindow->display();
+
+	//the controls move the entities, the update has to be done before they are read
+	m_pEntityMngr->EndUpdate();
 }
 void Application::Release(void)
 {
@@ -0,0 +1,14 @@
+#ifndef __FOO_H_
+#define __FOO_H_
+#include <iostream>
+struct Foo
+{
+	int content = 0;
+	Foo(int a_content) : content(a_content) {};
+	friend std::ostream& operator<<(std::ostream& os, Foo other)
+	{
+		os << other.content;
+		return os;
+	}
+};
+#endif //__FOO_H_
@@ -79,6 +79,26 @@ int main(void)
 		std::cout << myAlbertoQueue[i] << std::endl;
 	}
 
+	//Handing objects to another thread, the queue is full when the producer gets ahead
+	BTX::SPSCQueue<AlbertoClass> myHandoffQueue(4);
+	std::thread producer([&myHandoffQueue]()
+	{
+		for (int i = 40; i < 50; ++i)
+		{
+			while (!myHandoffQueue.TryPush(i))
+				std::this_thread::yield();
+		}
+	});
+	std::cout << "	Handed over" << std::endl;
+	for (uint i = 0; i < 10; ++i)
+	{
+		AlbertoClass alberto;
+		while (!myHandoffQueue.TryPop(alberto))
+			std::this_thread::yield();
+		std::cout << alberto << std::endl;
+	}
+	producer.join();
+
 	std::cout << "Press Enter to finish." << std::endl;
 
 
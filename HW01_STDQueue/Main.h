@@ -6,16 +6,9 @@ on: 2017/06/02
 #define __MAIN_H_
 #include <iostream>
 #include <deque>
+#include <thread>
 #include "Alberto.h"
+#include "Foo.h"
+#include "BTX\System\RingQueue.h"
 #define uint unsigned int
-struct Foo
-{
-	int content = 0;
-	Foo(int a_content) : content(a_content) {};
-	friend std::ostream& operator<<(std::ostream& os, Foo other)
-	{
-		os << other.content;
-		return os;
-	}
-};
 #endif //__MAIN_H_
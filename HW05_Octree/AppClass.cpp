@@ -42,6 +42,9 @@ void Application::Update(void)
 	//Is the first person camera active?
 	CameraRotation();
 
+	//the octree only places again what moved, before the collisions are checked
+	m_pRoot->UpdateEntities(m_pEntityMngr->GetMovedEntities());
+
 	//Update Entity Manager
 	m_pEntityMngr->Update();
 
@@ -52,6 +52,59 @@ void Application::DrawGUI(void)
 		ImGui::End();
 	}
 	
+	//Profiler
+	{
+		ImGui::SetNextWindowPos(ImVec2(1, 480), ImGuiSetCond_FirstUseEver);
+		ImGui::SetNextWindowSize(ImVec2(460, 230), ImGuiSetCond_FirstUseEver);
+		ImGui::SetNextWindowCollapsed(true, ImGuiSetCond_FirstUseEver);
+		ImGui::Begin("Profiler", (bool*)0, ImGuiWindowFlags_NoResize);
+		{
+			bool bEnabled = Profiler::IsEnabled();
+			if (ImGui::Checkbox("Enabled", &bEnabled))
+				Profiler::SetEnabled(bEnabled);
+			if (bEnabled)
+			{
+				Profiler* pProfiler = Profiler::GetInstance();
+				ImGui::SameLine();
+				if (pProfiler->IsCapturing())
+				{
+					if (ImGui::Button("Stop and Save Trace"))
+					{
+						pProfiler->StopCapture();
+						pProfiler->SaveChromeTrace(m_pSystem->m_pFolder->GetFolderRoot() + "Trace.json");
+					}
+					ImGui::SameLine();
+					ImGui::Text("%u events", pProfiler->GetCaptureSize());
+				}
+				else if (ImGui::Button("Capture Trace"))
+				{
+					pProfiler->StartCapture();
+				}
+
+				ImGui::Columns(5, "ProfilerZones");
+				ImGui::Separator();
+				ImGui::Text("Zone"); ImGui::NextColumn();
+				ImGui::Text("Calls"); ImGui::NextColumn();
+				ImGui::Text("Last [ms]"); ImGui::NextColumn();
+				ImGui::Text("Avg [ms]"); ImGui::NextColumn();
+				ImGui::Text("Max [ms]"); ImGui::NextColumn();
+				ImGui::Separator();
+				for (uint i = 0; i < pProfiler->GetZoneCount(); i++)
+				{
+					ProfileStat stat = pProfiler->GetZoneStat(i);
+					ImGui::Text("%s", stat.sName.c_str()); ImGui::NextColumn();
+					ImGui::Text("%u", stat.uCalls); ImGui::NextColumn();
+					ImGui::Text("%.3f", stat.fLastMs); ImGui::NextColumn();
+					ImGui::Text("%.3f", stat.fAverageMs); ImGui::NextColumn();
+					ImGui::Text("%.3f", stat.fMaxMs); ImGui::NextColumn();
+				}
+				ImGui::Columns(1);
+				ImGui::Separator();
+			}
+		}
+		ImGui::End();
+	}
+
 	//Controller Debugger
 	if (false) //if you want to enable the controller debugger window just make this true
 	{
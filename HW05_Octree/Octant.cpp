@@ -44,7 +44,7 @@ Octant::Octant(uint a_nMaxLevel, uint a_nIdealEntityCount)
 	vector3 halfWidth = pRigidBody->GetHalfWidth();
 	float max = halfWidth.x;
 
-	for (int i = 0; i < 2; i++)
+	for (int i = 1; i < 3; i++)
 	{
 		max = std::max(max, halfWidth[i]);
 	}
@@ -94,11 +94,7 @@ void Octant::Display(uint a_nIndex, vector3 a_v3Color)
 {
 	if (m_uID == a_nIndex)
 	{
-		m_pModelMngr->AddWireCubeToRenderList(
-			glm::translate(IDENTITY_M4, m_v3Center) *
-			glm::scale(vector3(m_fSize)),
-			a_v3Color
-		);
+		m_pModelMngr->GetBoundsBatch()->AddBox(m_v3Center, vector3(m_fSize / 2.0f), a_v3Color);
 		return;
 	}
 
@@ -110,16 +106,23 @@ void Octant::Display(uint a_nIndex, vector3 a_v3Color)
 
 void Octant::Display(vector3 a_v3Color)
 {
-	for (int i = 0; i < m_uChildren; i++)
+	//the whole subtree goes to the bounds batch in one call
+	m_pRoot->m_lBoxCenter.clear();
+	m_pRoot->m_lBoxHalfWidth.clear();
+	CollectBoxes();
+	m_pModelMngr->GetBoundsBatch()->AddBoxes(m_pRoot->m_lBoxCenter.size(),
+		m_pRoot->m_lBoxCenter.data(), m_pRoot->m_lBoxHalfWidth.data(), a_v3Color);
+}
+
+void Octant::CollectBoxes(void)
+{
+	for (uint i = 0; i < m_uChildren; i++)
 	{
-		m_pChild[i]->Display(a_v3Color);
+		m_pChild[i]->CollectBoxes();
 	}
 
-	m_pModelMngr->AddWireCubeToRenderList(
-		glm::translate(IDENTITY_M4, m_v3Center) *
-		glm::scale(vector3(m_fSize)),
-		a_v3Color
-	);
+	m_pRoot->m_lBoxCenter.push_back(m_v3Center);
+	m_pRoot->m_lBoxHalfWidth.push_back(vector3(m_fSize / 2.0f));
 }
 
 void Octant::Subdivide(void)
@@ -193,6 +196,44 @@ void Octant::AssignIDtoEntity(void)
 		}
 	}
 }
+void Octant::UpdateEntities(std::vector<uint> const& a_lEntity)
+{
+	//If this method is tried to be applied to something else
+	//other than the root, don't.
+	if (m_uLevel != 0 || a_lEntity.empty())
+		return;
+
+	//the entities that did not move keep their leaves and dimensions
+	for (uint uEntity : a_lEntity)
+	{
+		m_pEntityMngr->ClearDimensionSet(uEntity);
+	}
+	ReassignEntities(a_lEntity);
+
+	//leaves might have been emptied or filled
+	m_lChild.clear();
+	ConstructList();
+}
+
+void Octant::ReassignEntities(std::vector<uint> const& a_lEntity)
+{
+	for (int i = 0; i < m_uChildren; i++)
+	{
+		m_pChild[i]->ReassignEntities(a_lEntity);
+	}
+	if (m_uChildren != 0)
+		return;
+
+	for (uint uEntity : a_lEntity)
+	{
+		m_EntityList.erase(std::remove(m_EntityList.begin(), m_EntityList.end(), uEntity), m_EntityList.end());
+		if (IsColliding(uEntity))
+		{
+			m_EntityList.push_back(uEntity);
+			m_pEntityMngr->AddDimension(uEntity, m_uID);
+		}
+	}
+}
 //-------------------------------------------------------------------------------------------------------------------
 // You can assume the following is fine and does not need changes, you may add onto it but the code is fine as is
 // in the proposed solution.
@@ -227,6 +268,8 @@ void Octant::Swap(Octant& other)
 	std::swap(m_uID, other.m_uID);
 	std::swap(m_pRoot, other.m_pRoot);
 	std::swap(m_lChild, other.m_lChild);
+	std::swap(m_lBoxCenter, other.m_lBoxCenter);
+	std::swap(m_lBoxHalfWidth, other.m_lBoxHalfWidth);
 
 	std::swap(m_v3Center, other.m_v3Center);
 	std::swap(m_v3Min, other.m_v3Min);
@@ -253,9 +296,13 @@ void Octant::Release(void)
 	m_fSize = 0.0f;
 	m_EntityList.clear();
 	m_lChild.clear();
+	m_lBoxCenter.clear();
+	m_lBoxHalfWidth.clear();
 }
 void Octant::ConstructTree(uint a_nMaxLevel)
 {
+	BTX_PROFILE_ZONE("Octant::ConstructTree");
+
 	//If this method is tried to be applied to something else
 	//other than the root, don't.
 	if (m_uLevel != 0)
@@ -357,17 +404,22 @@ void Octant::KillBranches(void)
 void Octant::DisplayLeaves(vector3 a_v3Color)
 {
 	/*
-	* Recursive method
-	* it will traverse the tree until it find leaves and once found will draw them
+	* The leaves that contain objects are listed in m_lChild, they are drawn along with this
+	* node in a single call to the bounds batch
 	*/
-	uint nLeafs = m_lChild.size(); //get how many children this will have (either 0 or 8)
+	m_pRoot->m_lBoxCenter.clear();
+	m_pRoot->m_lBoxHalfWidth.clear();
+	uint nLeafs = m_lChild.size(); //get how many leaves have objects (root only)
 	for (uint nChild = 0; nChild < nLeafs; nChild++)
 	{
-		m_lChild[nChild]->DisplayLeaves(a_v3Color);
+		m_pRoot->m_lBoxCenter.push_back(m_lChild[nChild]->m_v3Center);
+		m_pRoot->m_lBoxHalfWidth.push_back(vector3(m_lChild[nChild]->m_fSize / 2.0f));
 	}
 	//Draw the cube
-	m_pModelMngr->AddWireCubeToRenderList(glm::translate(IDENTITY_M4, m_v3Center) *
-		glm::scale(vector3(m_fSize)), a_v3Color);
+	m_pRoot->m_lBoxCenter.push_back(m_v3Center);
+	m_pRoot->m_lBoxHalfWidth.push_back(vector3(m_fSize / 2.0f));
+	m_pModelMngr->GetBoundsBatch()->AddBoxes(m_pRoot->m_lBoxCenter.size(),
+		m_pRoot->m_lBoxCenter.data(), m_pRoot->m_lBoxHalfWidth.data(), a_v3Color);
 }
 void Octant::ClearEntityList(void)
 {
@@ -37,6 +37,8 @@ class Octant
 
 	Octant* m_pRoot = nullptr;//Root octant
 	std::vector<Octant*> m_lChild; //list of nodes that contain objects (this will be applied to root only)
+	std::vector<vector3> m_lBoxCenter; //centers of the boxes a display sends in one call (root only)
+	std::vector<vector3> m_lBoxHalfWidth; //half sizes of the boxes a display sends in one call (root only)
 	
 public:
 	/*
@@ -182,6 +184,15 @@ public:
 	*/
 	void AssignIDtoEntity(void);
 
+	/*
+	USAGE: Moves the entities given to the leaves they are in now without making the tree again,
+		only the root does it
+	ARGUMENTS:
+	- std::vector<uint> const& a_lEntity -> indices in the Entity Manager of the entities that moved
+	OUTPUT: ---
+	*/
+	void UpdateEntities(std::vector<uint> const& a_lEntity);
+
 	/*
 	USAGE: Gets the total number of octants in the world
 	ARGUMENTS: ---
@@ -241,6 +252,22 @@ private:
 	OUTPUT: ---
 	*/
 	void ConstructList(void);
+
+	/*
+	USAGE: Traverse the tree up to the leafs, takes the entities given out of them and puts them
+		back in the ones they are in now
+	ARGUMENTS:
+	- std::vector<uint> const& a_lEntity -> indices in the Entity Manager of the entities that moved
+	OUTPUT: ---
+	*/
+	void ReassignEntities(std::vector<uint> const& a_lEntity);
+
+	/*
+	USAGE: Adds the volume of this octant and of all the octants under it to the root's box list
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void CollectBoxes(void);
 };//class
 
 } //namespace BTX
@@ -0,0 +1,21 @@
+#version 330
+layout (location = 0) in vec3 Position_b;
+layout (location = 1) in vec3 Center_i;
+layout (location = 2) in vec3 Extent_i;
+layout (location = 3) in vec4 Orientation_i;
+layout (location = 4) in vec3 Color_i;
+
+uniform mat4 VP;
+
+out vec3 Color;
+
+void main()
+{
+	//unit shape scaled by the extent and rotated by the quaternion of the instance
+	vec3 v3Local = Position_b * Extent_i;
+	vec3 v3Axis = Orientation_i.xyz;
+	v3Local += 2.0 * cross(v3Axis, cross(v3Axis, v3Local) + Orientation_i.w * v3Local);
+	gl_Position = VP * vec4(Center_i + v3Local, 1);
+	
+	Color = Color_i;
+}
\ No newline at end of file
@@ -9,6 +9,7 @@ Update: 2021/02
 #pragma warning( disable : 4251 )
 
 #include "BTX\Physics\EntityManager.h"
+#include "BTX\Physics\AnimationManager.h"
 
 namespace BTX
 {
@@ -19,6 +20,7 @@ namespace BTX
 	*/
 	static void ReleaseAllSingletons(void)
 	{
+		AnimationManager::ReleaseInstance();
 		EntityManager::ReleaseInstance();
 		ModelManager::ReleaseInstance();
 		CameraManager::ReleaseInstance();
@@ -27,6 +29,9 @@ namespace BTX
 		FolderSingleton::ReleaseInstance();
 		ShaderManager::ReleaseInstance();
 		SystemSingleton::ReleaseInstance();
+		Profiler::ReleaseInstance();
+		NameTable::ReleaseInstance(); //after the managers, they keep name handles
+		RenderBackend::ReleaseInstance(); //last, the other singletons release their objects through it
 		//GLSystem::ReleaseInstance();
 		//LightManager::ReleaseInstance();
 		//Text::ReleaseInstance();
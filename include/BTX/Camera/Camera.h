@@ -7,10 +7,22 @@ Update: 2021/02
 #define __CAMERACLASS_H_
 
 #include "BTX\System\SystemSingleton.h"
+#include "BTX\Camera\Frustum.h"
 #include "BTXs\Camera\Camera.h"
 
 namespace BTX
 {
+//Everything a frame reads from a camera, made once per change instead of once per read
+struct CameraSnapshot
+{
+	matrix4 m4View = IDENTITY_M4; //View matrix
+	matrix4 m4Projection = IDENTITY_M4; //Projection matrix
+	matrix4 m4VP = IDENTITY_M4; //Projection * View
+	matrix4 m4InverseVP = IDENTITY_M4; //Inverse of Projection * View, from clip space back to the world
+	vector3 v3Position = ZERO_V3; //Position of the camera
+	Frustum frustum; //Planes of m4VP
+};
+
 //Camera Class
 class BTXDLL Camera : BTXs::Camera
 {
@@ -40,6 +52,17 @@ class BTXDLL Camera : BTXs::Camera
 	matrix4 m_m4Projection = matrix4(1.0f); //Projection Matrix
 	matrix4 m_m4View = matrix4(1.0f); //View matrix
 	*/
+	/*
+	The matrices are only made again after something they depend on changed, the getters can be
+	called many times per frame. The window size is checked on every read since it can change
+	without the camera knowing.
+	*/
+	bool m_bViewDirty = true; //Did the vectors change since m_m4View was made?
+	bool m_bProjectionDirty = true; //Did the lens, the mode or the window change since m_m4Projection was made?
+	bool m_bSnapshotDirty = true; //Did either matrix change since m_Snapshot was made?
+	CameraSnapshot m_Snapshot; //Matrices and frustum of the last change
+	uint m_uViewBuilds = 0; //Times the view matrix was made
+	uint m_uProjectionBuilds = 0; //Times the projection matrix was made
 public:
 	/*
 	USAGE: Constructor
@@ -106,6 +129,22 @@ public:
 	OUTPUT: View projection matrix
 	*/
 	matrix4 GetVP(void);
+
+	/*
+	USAGE: Gets the matrices and frustum of the camera, they are only made again if the camera
+		changed since the last call
+	ARGUMENTS: ---
+	OUTPUT: snapshot, valid until the camera changes
+	*/
+	CameraSnapshot const& GetSnapshot(void);
+
+	/*
+	USAGE: Gets the number of times the view and projection matrices were made, the rest of the
+		reads came from the cache
+	ARGUMENTS: ---
+	OUTPUT: views made + projections made
+	*/
+	uint GetMatrixBuildCount(void);
 	
 	/*
 	USAGE:  Gets the position of the camera
@@ -166,14 +205,14 @@ public:
 	void SetNearFarPlanes(float a_fNear, float a_fFar);
 	
 	/*
-	USAGE: Calculates the projection based on the camera values
+	USAGE: Calculates the projection based on the camera values, the getters call it when needed
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
 	void CalculateProjection(void);
 	
 	/*
-	USAGE: Calculates the view based on the camera values
+	USAGE: Calculates the view based on the camera values, the getters call it when needed
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
@@ -311,6 +350,21 @@ protected:
 	OUTPUT: ---
 	*/
 	void SetWidthAndHeightOfDisplay(vector2 a_v2WidhtHeight);
+
+	/*
+	USAGE: Marks the view to be made again, and the projection too for the orthographic modes
+		since they are sized by the position
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void SetViewDirty(void);
+
+	/*
+	USAGE: Makes the matrices that changed since they were last made
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void UpdateMatrices(void);
 };
 
 	EXPIMP_TEMPLATE template class BTXDLL std::vector<Camera>;
@@ -7,6 +7,7 @@ Update: 2021/02
 #define __CAMERAMANAGER_H_
 
 #include "BTX\Camera\Camera.h"
+#include "BTX\Camera\Frustum.h"
 
 namespace BTX
 {
@@ -87,6 +88,42 @@ public:
 	*/
 	matrix4 GetProjectionMatrix(int a_nIndex = -1);
 	
+	/*
+	USAGE: Gets the view frustum of the camera specified by index, if -1 it will use the active camera
+	ARGUMENTS:
+		int a_nIndex = -1 -> Index of the camera, -1 will use the active camera's index
+	OUTPUT: frustum built from the projection and view matrices
+	*/
+	Frustum GetFrustum(int a_nIndex = -1);
+
+	/*
+	USAGE: Gets the matrices and frustum of the camera specified by index, if -1 it will use the
+		active camera; they are made once per change of the camera, not once per read
+	ARGUMENTS:
+		int a_nIndex = -1 -> Index of the camera, -1 will use the active camera's index
+	OUTPUT: snapshot, valid until the camera changes
+	*/
+	CameraSnapshot const& GetSnapshot(int a_nIndex = -1);
+
+	/*
+	USAGE: Gets the ray that goes from a camera through a point of the window, for picking
+	ARGUMENTS:
+		vector2 a_v2Screen -> point in pixels from the top left corner of the window, like the mouse
+		vector3& a_v3Origin -> [out] point of the near plane under the screen point
+		vector3& a_v3Direction -> [out] normalized direction into the scene
+		int a_nIndex = -1 -> Index of the camera, -1 will use the active camera's index
+	OUTPUT: ---
+	*/
+	void GetPickRay(vector2 a_v2Screen, vector3& a_v3Origin, vector3& a_v3Direction, int a_nIndex = -1);
+
+	/*
+	USAGE: Makes the matrices and snapshots of every camera that changed in a single pass, call it
+		once per frame after the cameras were moved so the reads of the frame find them ready
+	ARGUMENTS: ---
+	OUTPUT: number of cameras whose matrices were made again
+	*/
+	uint UpdateCameras(void);
+	
 	/*
 	USAGE: Gets the ModelViewProjection matrix from the camera specified by index, if -1 it will use the active camera
 	ARGUMENTS:
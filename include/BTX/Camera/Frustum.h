@@ -0,0 +1,104 @@
+#ifndef __FRUSTUMCLASS_H_
+#define __FRUSTUMCLASS_H_
+
+#include "BTX\System\Definitions.h"
+
+namespace BTX
+{
+	//Result of testing a volume against the frustum
+	enum eBTX_FRUSTUM
+	{
+		FRUSTUM_OUTSIDE = 0, //Completely outside of at least one plane
+		FRUSTUM_INTERSECT = 1, //Crosses at least one plane
+		FRUSTUM_INSIDE = 2 //Completely inside of all planes
+	};
+
+	/*
+	Six planes extracted from a view projection matrix, used to reject volumes
+	before they are sent to the render list. The tests are conservative, a volume
+	close to an edge of the frustum can be reported as visible when it is not.
+	*/
+	//Frustum Class
+	class BTXDLL Frustum
+	{
+		vector4 m_v4Plane[6]; //left, right, bottom, top, near, far; xyz normal pointing inwards, w distance
+
+	public:
+		/*
+		USAGE: Constructor, the frustum accepts everything until a matrix is set
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		Frustum(void);
+		/*
+		USAGE: Constructor
+		ARGUMENTS: matrix4 a_m4ViewProjection -> Projection * View of the camera
+		OUTPUT: class object instance
+		*/
+		Frustum(matrix4 a_m4ViewProjection);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		Frustum(Frustum const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		Frustum& operator=(Frustum const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~Frustum(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(Frustum& other);
+
+		/*
+		USAGE: Extracts the planes of the frustum from the matrix
+		ARGUMENTS: matrix4 a_m4ViewProjection -> Projection * View of the camera
+		OUTPUT: ---
+		*/
+		void SetMatrix(matrix4 a_m4ViewProjection);
+		/*
+		USAGE: Gets one of the planes of the frustum
+		ARGUMENTS: uint a_uIndex -> left, right, bottom, top, near, far
+		OUTPUT: normalized plane, xyz normal pointing inwards and w distance
+		*/
+		vector4 GetPlane(uint a_uIndex);
+		/*
+		USAGE: Classifies an axis aligned box against the frustum
+		ARGUMENTS:
+		-	vector3 a_v3Min -> minimum corner of the box in world space
+		-	vector3 a_v3Max -> maximum corner of the box in world space
+		OUTPUT: FRUSTUM_OUTSIDE, FRUSTUM_INTERSECT or FRUSTUM_INSIDE
+		*/
+		eBTX_FRUSTUM ClassifyBox(vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Asks if an axis aligned box can be seen
+		ARGUMENTS:
+		-	vector3 a_v3Min -> minimum corner of the box in world space
+		-	vector3 a_v3Max -> maximum corner of the box in world space
+		OUTPUT: is the box at least partially inside?
+		*/
+		bool IsBoxVisible(vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Asks if a sphere can be seen
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the sphere in world space
+		-	float a_fRadius -> radius of the sphere
+		OUTPUT: is the sphere at least partially inside?
+		*/
+		bool IsSphereVisible(vector3 a_v3Center, float a_fRadius);
+	};
+
+} //namespace BTX
+
+#endif //__FRUSTUMCLASS_H_
@@ -0,0 +1,190 @@
+#ifndef __OCCLUSIONBUFFERCLASS_H_
+#define __OCCLUSIONBUFFERCLASS_H_
+
+#include "BTX\System\Profiler.h"
+
+namespace BTX
+{
+	/*
+	Low resolution depth buffer filled on the CPU with a few large occluders so the boxes of
+	other objects can be tested against it before they are sent to the render list. It needs
+	no window or graphics context.
+
+	Occluders are boxes with a model matrix. Each one is drawn as the outline of its projection
+	with the depth of its front faces; a pixel is only written if the box covers all of it and
+	it gets the farthest depth the box has inside of it, so an object is never hidden by an
+	occluder that does not hide it completely. Boxes that cross the near plane are not drawn.
+	The rows of the buffer are split in bands drawn on separate threads.
+
+	Once drawn, a pyramid of levels is made where every texel keeps the farthest depth of the
+	four below it, a box is tested against the level where its outline covers a couple of
+	texels and is hidden if its nearest corner is behind all of them.
+	*/
+	//OcclusionBuffer Class
+	class BTXDLL OcclusionBuffer
+	{
+		//Occluder ready to be drawn, in pixels of the buffer
+		struct Occluder
+		{
+			uint uEdges = 0; //edges of the outline in use
+			vector3 v3Edge[6]; //a * x + b * y + c >= 0 for pixels completely inside, the half pixel is in c
+			uint uPlanes = 0; //front faces in use
+			vector3 v3Plane[3]; //1 / w = a * x + b * y + c of each front face, the half pixel is in c
+			int nRowMin = 0; //first row the outline touches
+			int nRowMax = -1; //last row the outline touches
+		};
+
+		uint m_uWidth = 256; //Pixels per row of the full resolution level
+		uint m_uHeight = 144; //Rows of the full resolution level
+		uint m_uThreads = 0; //Threads that draw the bands, 0 uses the hardware concurrency (at most 8)
+		matrix4 m_m4ViewProjection = IDENTITY_M4; //Projection * View the occluders are drawn with
+		std::vector<Occluder> m_lOccluder; //Occluders added since Begin
+		std::vector<std::vector<float>> m_lLevel; //Depth pyramid, level 0 is the full resolution
+		std::vector<uint> m_lLevelWidth; //Texels per row of each level
+		std::vector<uint> m_lLevelHeight; //Rows of each level
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS:
+		-	uint a_uWidth = 256 -> pixels per row
+		-	uint a_uHeight = 144 -> rows
+		OUTPUT: class object instance
+		*/
+		OcclusionBuffer(uint a_uWidth = 256, uint a_uHeight = 144);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		OcclusionBuffer(OcclusionBuffer const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		OcclusionBuffer& operator=(OcclusionBuffer const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~OcclusionBuffer(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(OcclusionBuffer& other);
+
+		/*
+		USAGE: Sets the size of the buffer, the occluders have to be drawn again
+		ARGUMENTS:
+		-	uint a_uWidth -> pixels per row
+		-	uint a_uHeight -> rows
+		OUTPUT: ---
+		*/
+		void SetResolution(uint a_uWidth, uint a_uHeight);
+		/*
+		USAGE: Gets the pixels per row of the buffer
+		ARGUMENTS: ---
+		OUTPUT: width
+		*/
+		uint GetWidth(void);
+		/*
+		USAGE: Gets the rows of the buffer
+		ARGUMENTS: ---
+		OUTPUT: height
+		*/
+		uint GetHeight(void);
+		/*
+		USAGE: Sets the number of threads the bands of rows are drawn on
+		ARGUMENTS: uint a_uThreads -> threads, 0 uses the hardware concurrency (at most 8)
+		OUTPUT: ---
+		*/
+		void SetThreadCount(uint a_uThreads);
+		/*
+		USAGE: Gets the number of threads the bands of rows are drawn on
+		ARGUMENTS: ---
+		OUTPUT: threads, 0 for the hardware concurrency
+		*/
+		uint GetThreadCount(void);
+		/*
+		USAGE: Gets the number of occluders added since Begin that will be drawn
+		ARGUMENTS: ---
+		OUTPUT: occluders
+		*/
+		uint GetOccluderCount(void);
+		/*
+		USAGE: Gets the depth of a pixel of the full resolution level
+		ARGUMENTS:
+		-	uint a_uX -> column, 0 is the left
+		-	uint a_uY -> row, 0 is the bottom
+		OUTPUT: inverse of the clip space w of the nearest occluder, 0 where nothing was drawn
+		*/
+		float GetDepth(uint a_uX, uint a_uY);
+
+		/*
+		USAGE: Forgets the occluders of the last frame
+		ARGUMENTS: matrix4 a_m4ViewProjection -> Projection * View of the camera
+		OUTPUT: ---
+		*/
+		void Begin(matrix4 a_m4ViewProjection);
+		/*
+		USAGE: Adds a box that hides what is behind it, it has to be inside of the object it
+			stands for or it would hide things the object does not
+		ARGUMENTS:
+		-	matrix4 a_m4ToWorld -> model matrix of the box
+		-	vector3 a_v3Min -> minimum corner of the box in local space
+		-	vector3 a_v3Max -> maximum corner of the box in local space
+		OUTPUT: will it be drawn? not if it crosses the near plane or is too thin to see
+		*/
+		bool AddOccluder(matrix4 a_m4ToWorld, vector3 a_v3Min, vector3 a_v3Max);
+		/*
+		USAGE: Clears the buffer, draws the occluders added since Begin and makes the pyramid
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Rasterize(void);
+		/*
+		USAGE: Asks if an axis aligned box is hidden by the occluders, boxes that cross the near
+			plane are never hidden and the parts off the screen are not looked at
+		ARGUMENTS:
+		-	vector3 a_v3Min -> minimum corner of the box in world space
+		-	vector3 a_v3Max -> maximum corner of the box in world space
+		OUTPUT: is the box completely behind the occluders?
+		*/
+		bool IsBoxOccluded(vector3 a_v3Min, vector3 a_v3Max);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Clears a band of rows of the full resolution level and draws the occluders in it
+		ARGUMENTS:
+		-	int a_nRowBegin -> first row of the band
+		-	int a_nRowEnd -> row after the last one of the band
+		OUTPUT: ---
+		*/
+		void RasterizeBand(int a_nRowBegin, int a_nRowEnd);
+		/*
+		USAGE: Makes every level of the pyramid above the full resolution from the one below
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void BuildPyramid(void);
+	};
+
+} //namespace BTX
+
+#endif //__OCCLUSIONBUFFERCLASS_H_
@@ -18,7 +18,7 @@ class BTXDLL MaterialManager
 		The material vector is public for accessing speed reasons its more secure to have it as private
 		and provide the right accessors for it
 	*/
-	std::map<String,int> m_map; //Map of the materials
+	NameMap<int> m_map; //Map of the materials by name handle
 	SystemSingleton* m_pSystem; //System class Pointer
 	static MaterialManager* m_pInstance; // Singleton Pointer
 
@@ -8,6 +8,7 @@ Update: 2021/02
 
 #include "BTX\System\SystemSingleton.h"
 #include "BTX\System\FileReader.h"
+#include "BTX\System\RenderBackend.h"
 #include "FreeImage\FreeImage.h"
 
 namespace BTX
@@ -19,6 +20,11 @@ namespace BTX
 		String m_sName = "NULL";
 		String m_sFileName = "NULL";
 		String m_sAbsoluteRoute = "";
+		GLubyte* m_pPixels = nullptr; //Pixels decoded but not yet uploaded, every mip level one after the other
+		int m_nWidth = 0; //Width of the decoded pixels
+		int m_nHeight = 0; //Height of the decoded pixels
+		uint m_uLevels = 0; //Mip levels in m_pPixels, the first one is the full size
+		GLenum m_eFormat = GL_RGBA; //Order of the channels of m_pPixels, GL_BGRA or GL_RGBA
 
 	public:
 		/*
@@ -61,9 +67,112 @@ namespace BTX
 		ARGUMENTS:
 			String a_sFileName -> name of the file, if path not define will look
 			under the textures folder
+			bool a_bUseCooked = true -> read and write the cooked file of the texture?
 		OUTPUT: success
 		*/
-		bool LoadTexture(String a_sFileName);
+		bool LoadTexture(String a_sFileName, bool a_bUseCooked = true);
+
+		/*
+		USAGE: Sets the name and file of the texture without reading it
+		ARGUMENTS:
+			String a_sFileName -> name of the file, if path not define will look
+			under the textures folder
+		OUTPUT: does the file exist?
+		*/
+		bool ResolveFileName(String a_sFileName);
+
+		/*
+		USAGE: Names a texture made from memory, it is filed under the textures folder as if it
+			had been read from there so the managers find it by name
+		ARGUMENTS: String a_sName -> name of the texture
+		OUTPUT: ---
+		*/
+		void SetName(String a_sName);
+
+		/*
+		USAGE: Decodes the file of the texture and makes its mip levels, it does not use OpenGL
+			so it can run on any thread; the levels are read from the cooked file instead when it
+			is newer than the source, otherwise they are saved to it for the next time
+		ARGUMENTS: bool a_bUseCooked = true -> read and write the cooked file?
+		OUTPUT: success
+		*/
+		bool Decode(bool a_bUseCooked = true);
+
+		/*
+		USAGE: Sets the pixels to upload from memory instead of a file, the mip levels are made
+			from them
+		ARGUMENTS:
+		-	int a_nWidth -> width in pixels
+		-	int a_nHeight -> height in pixels
+		-	const GLubyte* a_pPixels -> 4 bytes per pixel, rows from the bottom up
+		-	GLenum a_eFormat = GL_RGBA -> order of the channels, GL_RGBA or GL_BGRA
+		-	bool a_bMips = true -> make the mip levels?
+		OUTPUT: ---
+		*/
+		void SetPixels(int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat = GL_RGBA, bool a_bMips = true);
+
+		/*
+		USAGE: Generates the OpenGL name of the texture without giving it any storage, a
+			material can use the name before the pixels are uploaded
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void ReserveGLTextureID(void);
+
+		/*
+		USAGE: Uploads the decoded pixels and their mip levels to OpenGL as they are, in the
+			order FreeImage gave them, and releases them; it needs to be called from the thread
+			that owns the OpenGL context
+		ARGUMENTS: ---
+		OUTPUT: success
+		*/
+		bool Upload(void);
+
+		/*
+		USAGE: Saves the decoded pixels and their mip levels so the next Decode does not need
+			to read the source file, Decode already does it
+		ARGUMENTS: ---
+		OUTPUT: success
+		*/
+		bool SaveCooked(void);
+
+		/*
+		USAGE: Gets the number of levels of a full mip chain
+		ARGUMENTS:
+		-	int a_nWidth -> width of the first level
+		-	int a_nHeight -> height of the first level
+		OUTPUT: levels, down to 1x1
+		*/
+		static uint GetMipCount(int a_nWidth, int a_nHeight);
+
+		/*
+		USAGE: Gets the bytes of the first levels of a mip chain of 4 byte pixels
+		ARGUMENTS:
+		-	int a_nWidth -> width of the first level
+		-	int a_nHeight -> height of the first level
+		-	uint a_uLevels -> levels counted
+		OUTPUT: bytes
+		*/
+		static uint GetMipChainSize(int a_nWidth, int a_nHeight, uint a_uLevels);
+
+		/*
+		USAGE: Fills the mip levels of a chain from its first level, each pixel is the average
+			of the 2x2 pixels under it, the last row or column is repeated on odd sizes
+		ARGUMENTS:
+		-	GLubyte* a_pChain -> chain of GetMipChainSize bytes, with the first level filled
+		-	int a_nWidth -> width of the first level
+		-	int a_nHeight -> height of the first level
+		-	uint a_uLevels -> levels in the chain
+		OUTPUT: ---
+		*/
+		static void GenerateMips(GLubyte* a_pChain, int a_nWidth, int a_nHeight, uint a_uLevels);
+
+		/*
+		USAGE: Gets the cooked file of a texture file
+		ARGUMENTS: String a_sFileName -> absolute route of the texture file
+		OUTPUT: cooked file, in the Cache folder of the textures
+		*/
+		static String GetCookedFileName(String a_sFileName);
 
 		//Accessors
 		/*
@@ -97,7 +206,49 @@ namespace BTX
 		*/
 		String GetAbsoluteRoute(void);
 
+		/*
+		USAGE: Returns the size of the decoded pixels, they are kept until they are uploaded
+		ARGUMENTS: ---
+		OUTPUT: width in pixels
+		*/
+		int GetWidth(void);
+
+		/*
+		USAGE: Returns the size of the decoded pixels, they are kept until they are uploaded
+		ARGUMENTS: ---
+		OUTPUT: height in pixels
+		*/
+		int GetHeight(void);
+
+		/*
+		USAGE: Returns the number of mip levels decoded
+		ARGUMENTS: ---
+		OUTPUT: levels
+		*/
+		uint GetLevelCount(void);
+
+		/*
+		USAGE: Returns the decoded pixels, they are kept until they are uploaded
+		ARGUMENTS: ---
+		OUTPUT: every mip level one after the other, nullptr once uploaded
+		*/
+		const GLubyte* GetPixels(void);
+
+		/*
+		USAGE: Returns the order of the channels of the decoded pixels
+		ARGUMENTS: ---
+		OUTPUT: GL_RGBA or GL_BGRA
+		*/
+		GLenum GetFormat(void);
+
 	private:
+		/*
+		USAGE: Reads the pixels from the cooked file if it was made from the current source
+		ARGUMENTS: ---
+		OUTPUT: was it read?
+		*/
+		bool ReadCooked(void);
+
 		/*
 		USAGE:
 		ARGUMENTS: ---
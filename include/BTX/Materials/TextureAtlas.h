@@ -0,0 +1,202 @@
+#ifndef __TEXTUREATLASCLASS_H_
+#define __TEXTUREATLASCLASS_H_
+
+#include "BTX\Materials\MaterialManager.h"
+
+namespace BTX
+{
+	/*
+	Packs many small textures into a few large pages with stb_rect_pack, so meshes that only
+	differed by their diffuse map can share a material: each source keeps a region of a page
+	and the UVs of a mesh are moved into that region. Each region is surrounded by a gutter
+	that repeats its border so filtering and the first mip levels do not pick up the neighbors.
+	*/
+	//TextureAtlas Class
+	class BTXDLL TextureAtlas
+	{
+	public:
+		//Place of a source in the atlas
+		struct Region
+		{
+			int nPage = -1; //Page the source was packed in, -1 if it did not fit
+			vector2 v2Offset = vector2(0.0f); //UV of the corner of the source in the page
+			vector2 v2Scale = vector2(1.0f); //Size of the source in the UVs of the page
+		};
+
+	private:
+		//Texture waiting to be packed
+		struct Source
+		{
+			String sName = ""; //Name the source is identified by
+			int nWidth = 0; //Width in pixels
+			int nHeight = 0; //Height in pixels
+			std::vector<GLubyte> lPixels; //4 bytes per pixel in the format of the atlas, rows from the bottom up
+		};
+
+		String m_sName = "Atlas"; //Name of the atlas, the pages are named after it
+		int m_nMaxSize = 2048; //Largest side of a page
+		int m_nGutter = 4; //Pixels repeated around each source
+		GLenum m_eFormat = GL_NONE; //Order of the channels of the pages, the one of the first source
+
+		std::vector<Source> m_lSource; //Sources in the order they were added
+		NameMap<int> m_map; //Index of each source by name handle
+		std::vector<Region> m_lRegion; //Region of each source, filled by Pack
+		std::vector<int> m_lPageTexture; //Texture Manager index of each page
+		std::vector<int> m_lPageMaterial; //Material Manager index of the material of each page
+
+		TextureManager* m_pTextureMngr = nullptr; //Texture Manager
+		MaterialManager* m_pMatMngr = nullptr; //Material Manager
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS:
+		-	String a_sName = "Atlas" -> name of the atlas, the pages are named "<name>_<page>"
+		-	int a_nMaxSize = 2048 -> largest side of a page in pixels
+		-	int a_nGutter = 4 -> pixels repeated around each source
+		OUTPUT: class object instance
+		*/
+		TextureAtlas(String a_sName = "Atlas", int a_nMaxSize = 2048, int a_nGutter = 4);
+		/*
+		USAGE: Copy Constructor, the copy shares the pages already made
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		TextureAtlas(TextureAtlas const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		TextureAtlas& operator=(TextureAtlas const& other);
+		/*
+		USAGE: Destructor, the pages stay in the Texture and Material Managers
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~TextureAtlas(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(TextureAtlas& other);
+
+		/*
+		USAGE: Adds a texture file to be packed, it is decoded through its cooked file when the
+			Texture Manager uses them
+		ARGUMENTS: String a_sFileName -> name of the file, if path not define will look under
+			the textures folder
+		OUTPUT: index of the source, -1 if it could not be read or does not fit in a page
+		*/
+		int AddTexture(String a_sFileName);
+
+		/*
+		USAGE: Adds pixels in memory to be packed
+		ARGUMENTS:
+		-	String a_sName -> name the source is identified by, a diffuse map name to use it
+			from a material
+		-	int a_nWidth -> width in pixels
+		-	int a_nHeight -> height in pixels
+		-	const GLubyte* a_pPixels -> 4 bytes per pixel, rows from the bottom up
+		-	GLenum a_eFormat = GL_RGBA -> order of the channels, GL_RGBA or GL_BGRA
+		OUTPUT: index of the source, -1 if it does not fit in a page
+		*/
+		int AddPixels(String a_sName, int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat = GL_RGBA);
+
+		/*
+		USAGE: Packs the sources into as few pages as they fit in, uploads the pages and makes a
+			material for each; calling it again after adding sources makes the pages again
+		ARGUMENTS: ---
+		OUTPUT: number of pages
+		*/
+		uint Pack(void);
+
+		/*
+		USAGE: Looks for a source by name, the route is not needed if the name has none
+		ARGUMENTS: String a_sName -> name of the source or of its file
+		OUTPUT: index of the source, -1 if it is not in the atlas
+		*/
+		int IdentifySource(String a_sName);
+
+		/*
+		USAGE: Gets the place of a source in the atlas
+		ARGUMENTS: uint a_uSource -> index of the source
+		OUTPUT: region, its page is -1 if it was not packed yet
+		*/
+		Region GetRegion(uint a_uSource);
+
+		/*
+		USAGE: Moves a UV of the source into its region of the page, UVs outside of [0, 1]
+			would sample the neighbors so tiling textures should not be atlased
+		ARGUMENTS:
+		-	uint a_uSource -> index of the source
+		-	vector3 a_v3UV -> UV on the source, z is kept
+		OUTPUT: UV on the page
+		*/
+		vector3 TransformUV(uint a_uSource, vector3 a_v3UV);
+
+		/*
+		USAGE: Gets the number of sources added
+		ARGUMENTS: ---
+		OUTPUT: sources
+		*/
+		uint GetSourceCount(void);
+
+		/*
+		USAGE: Gets the number of pages made by the last Pack
+		ARGUMENTS: ---
+		OUTPUT: pages
+		*/
+		uint GetPageCount(void);
+
+		/*
+		USAGE: Gets the name a page is loaded by in the Texture Manager
+		ARGUMENTS: uint a_uPage -> index of the page
+		OUTPUT: name of the page texture
+		*/
+		String GetPageName(uint a_uPage);
+
+		/*
+		USAGE: Gets the material that samples a page, meshes moved into the page use it
+		ARGUMENTS: uint a_uPage -> index of the page
+		OUTPUT: Material Manager index, -1 if there is no such page
+		*/
+		int GetPageMaterial(uint a_uPage);
+
+		/*
+		USAGE: Gets the name of the atlas
+		ARGUMENTS: ---
+		OUTPUT: name
+		*/
+		String GetName(void);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Copies a source into a page with its gutter
+		ARGUMENTS:
+		-	Source const& a_Source -> source to copy
+		-	GLubyte* a_pPage -> pixels of the page
+		-	int a_nPageWidth -> width of the page
+		-	int a_nX -> column of the corner of the gutter
+		-	int a_nY -> row of the corner of the gutter
+		OUTPUT: ---
+		*/
+		void CopySource(Source const& a_Source, GLubyte* a_pPage, int a_nPageWidth, int a_nX, int a_nY);
+	};
+
+} //namespace BTX
+
+#endif //__TEXTUREATLASCLASS_H_
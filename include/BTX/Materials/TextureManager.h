@@ -7,6 +7,7 @@ Update: 2021/02
 #define __TEXTUREMANAGER_H_
 
 #include "BTX\Materials\Texture.h"
+#include "BTX\System\NameTable.h"
 
 
 namespace BTX
@@ -15,7 +16,17 @@ namespace BTX
 //TextureManager Singleton
 class BTXDLL TextureManager
 {
-	std::map<String,int> m_map;//indexer
+	NameMap<int> m_map;//indexer by name handle of the file name
+
+	//Texture being decoded in the background
+	struct PendingTexture
+	{
+		int nIndex; //index of the texture in m_textureList
+		std::future<bool> Decoded; //result of Texture::Decode
+	};
+	std::vector<PendingTexture> m_lPending; //textures waiting for their upload
+	bool m_bAsync = false; //decode new textures in the background?
+	bool m_bCooked = true; //read and write the cooked files of the textures?
 
 public:
 	std::vector<Texture*> m_textureList; //Vector of Textures
@@ -48,6 +59,61 @@ public:
 	*/
 	int LoadTexture(String sName);
 
+	/*
+	USAGE: Adds a texture made in memory and uploads it, materials load it by its name like
+		any file under the textures folder; a texture with the same name gets the new pixels
+		and keeps its OpenGL name
+	ARGUMENTS:
+	-	String a_sName -> name of the texture
+	-	int a_nWidth -> width in pixels
+	-	int a_nHeight -> height in pixels
+	-	const GLubyte* a_pPixels -> 4 bytes per pixel, rows from the bottom up
+	-	GLenum a_eFormat = GL_RGBA -> order of the channels, GL_RGBA or GL_BGRA
+	-	bool a_bMips = true -> make the mip levels?
+	OUTPUT: index of the texture, -1 if it could not be uploaded
+	*/
+	int AddTexture(String a_sName, int a_nWidth, int a_nHeight, const GLubyte* a_pPixels, GLenum a_eFormat = GL_RGBA,
+		bool a_bMips = true);
+
+	/*
+	USAGE: Sets whether new textures are decoded in the background, the OpenGL name of the
+		texture is reserved right away so it can be handed to materials, it gets its pixels once
+		UpdateLoads uploads them
+	ARGUMENTS: bool a_bAsync -> decode in the background?
+	OUTPUT: ---
+	*/
+	void SetAsyncLoading(bool a_bAsync);
+
+	/*
+	USAGE: Asks whether new textures are decoded in the background
+	ARGUMENTS: ---
+	OUTPUT: are textures decoded in the background?
+	*/
+	bool IsAsyncLoading(void);
+
+	/*
+	USAGE: Sets whether new textures are read from their cooked files, which keep the decoded
+		pixels and mip levels so FreeImage does not run again until the source changes
+	ARGUMENTS: bool a_bCooked -> use the cooked files?
+	OUTPUT: ---
+	*/
+	void SetCookedTextures(bool a_bCooked);
+
+	/*
+	USAGE: Asks whether new textures are read from their cooked files
+	ARGUMENTS: ---
+	OUTPUT: are the cooked files used?
+	*/
+	bool IsCookedTextures(void);
+
+	/*
+	USAGE: Uploads the textures that finished decoding, call it once per frame from the thread
+		that owns the OpenGL context
+	ARGUMENTS: uint a_uBudget = 4 -> maximum number of textures uploaded in this call
+	OUTPUT: number of textures still waiting for their upload
+	*/
+	uint UpdateLoads(uint a_uBudget = 4);
+
 	/*
 	USAGE:
 	ARGUMENTS: ---
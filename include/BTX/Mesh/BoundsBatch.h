@@ -0,0 +1,196 @@
+#ifndef __BOUNDSBATCHCLASS_H_
+#define __BOUNDSBATCHCLASS_H_
+
+#include "BTX\System\ShaderManager.h"
+#include "BTX\System\RenderBackend.h"
+
+namespace BTX
+{
+	/*
+	Draws bounding volumes as instanced wire shapes: each box or sphere is a center, an
+	extent, an orientation and a color kept in one array per attribute, those arrays are
+	sent to the GPU as they are and every shape is drawn in a single instanced call, so
+	thousands of volumes cost no matrices on the CPU and two draws on the GPU.
+	*/
+	//BoundsBatch Class
+	class BTXDLL BoundsBatch
+	{
+		//Instances of one of the wire shapes and the buffers they are drawn with
+		struct ShapeList
+		{
+			std::vector<vector3> lCenter; //Center of each instance
+			std::vector<vector3> lExtent; //Half of the size of each instance on its own axis
+			std::vector<quaternion> lOrientation; //Rotation of each instance
+			std::vector<vector3> lColor; //Color of each instance
+			std::vector<vector3> lShape; //Line vertices of the unit shape, from -1 to 1
+			GLuint uVAO = 0; //Vertex array, made the first time the shape renders
+			GLuint uBuffer[5] = { 0, 0, 0, 0, 0 }; //Unit shape, then one buffer per attribute
+		};
+		ShapeList m_Box; //Wire boxes
+		ShapeList m_Sphere; //Wire spheres, three circles each
+
+		ShaderManager* m_pShaderMngr = nullptr; //Shader Manager
+		RenderBackend* m_pBackend = nullptr; //Backend the batch is drawn with
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		BoundsBatch(void);
+		/*
+		USAGE: Copy Constructor, the copy gets the instances but makes its own buffers
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		BoundsBatch(BoundsBatch const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		BoundsBatch& operator=(BoundsBatch const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~BoundsBatch(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(BoundsBatch& other);
+
+		/*
+		USAGE: Adds a wire box
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the box in world space
+		-	vector3 a_v3HalfWidth -> half of the size of the box on each of its axis
+		-	vector3 a_v3Color = C_WHITE -> color of the box
+		-	quaternion a_qOrientation = quaternion(1, 0, 0, 0) -> rotation of the box, axis
+			aligned by default
+		OUTPUT: ---
+		*/
+		void AddBox(vector3 a_v3Center, vector3 a_v3HalfWidth, vector3 a_v3Color = C_WHITE,
+			quaternion a_qOrientation = quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+
+		/*
+		USAGE: Adds a set of axis aligned wire boxes
+		ARGUMENTS:
+		-	uint a_uCount -> number of boxes
+		-	const vector3* a_pCenter -> center of each box
+		-	const vector3* a_pHalfWidth -> half of the size of each box
+		-	const vector3* a_pColor -> color of each box
+		OUTPUT: ---
+		*/
+		void AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth, const vector3* a_pColor);
+
+		/*
+		USAGE: Adds a set of axis aligned wire boxes of the same color
+		ARGUMENTS:
+		-	uint a_uCount -> number of boxes
+		-	const vector3* a_pCenter -> center of each box
+		-	const vector3* a_pHalfWidth -> half of the size of each box
+		-	vector3 a_v3Color -> color of all the boxes
+		OUTPUT: ---
+		*/
+		void AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth, vector3 a_v3Color);
+
+		/*
+		USAGE: Adds a set of oriented wire boxes
+		ARGUMENTS:
+		-	uint a_uCount -> number of boxes
+		-	const vector3* a_pCenter -> center of each box
+		-	const vector3* a_pHalfWidth -> half of the size of each box on its own axis
+		-	const quaternion* a_pOrientation -> rotation of each box
+		-	const vector3* a_pColor -> color of each box
+		OUTPUT: ---
+		*/
+		void AddBoxes(uint a_uCount, const vector3* a_pCenter, const vector3* a_pHalfWidth,
+			const quaternion* a_pOrientation, const vector3* a_pColor);
+
+		/*
+		USAGE: Adds a wire sphere
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the sphere in world space
+		-	float a_fRadius -> radius of the sphere
+		-	vector3 a_v3Color = C_WHITE -> color of the sphere
+		OUTPUT: ---
+		*/
+		void AddSphere(vector3 a_v3Center, float a_fRadius, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Adds a set of wire spheres
+		ARGUMENTS:
+		-	uint a_uCount -> number of spheres
+		-	const vector3* a_pCenter -> center of each sphere
+		-	const float* a_pRadius -> radius of each sphere
+		-	const vector3* a_pColor -> color of each sphere
+		OUTPUT: ---
+		*/
+		void AddSpheres(uint a_uCount, const vector3* a_pCenter, const float* a_pRadius, const vector3* a_pColor);
+
+		/*
+		USAGE: Gets the number of boxes added since the last Clear
+		ARGUMENTS: ---
+		OUTPUT: number of boxes
+		*/
+		uint GetBoxCount(void);
+
+		/*
+		USAGE: Gets the number of spheres added since the last Clear
+		ARGUMENTS: ---
+		OUTPUT: number of spheres
+		*/
+		uint GetSphereCount(void);
+
+		/*
+		USAGE: Removes the shapes added, the buffers are kept for the next frame
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Clear(void);
+
+		/*
+		USAGE: Sends the instances to their buffers and draws each shape in one call, the
+			shapes stay until Clear is called
+		ARGUMENTS:
+		-	matrix4 a_m4Projection -> projection of the camera
+		-	matrix4 a_m4View -> view of the camera
+		OUTPUT: number of draw calls
+		*/
+		uint Render(matrix4 a_m4Projection, matrix4 a_m4View);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Sends the instances of a shape and draws them
+		ARGUMENTS: ShapeList& a_Shape -> shape to draw
+		OUTPUT: number of draw calls, 0 if it had no instances
+		*/
+		uint RenderShape(ShapeList& a_Shape);
+		/*
+		USAGE: Deletes the buffers of a shape
+		ARGUMENTS: ShapeList& a_Shape -> shape to release
+		OUTPUT: ---
+		*/
+		void ReleaseShape(ShapeList& a_Shape);
+	};
+
+} //namespace BTX
+
+#endif //__BOUNDSBATCHCLASS_H_
@@ -0,0 +1,171 @@
+#ifndef __DEBUGBATCHCLASS_H_
+#define __DEBUGBATCHCLASS_H_
+
+#include "BTX\System\ShaderManager.h"
+#include "BTX\System\RenderBackend.h"
+
+namespace BTX
+{
+	/*
+	Immediate mode debug drawing: lines, wire boxes, wire spheres and axes are added every
+	frame already transformed to world space, kept in a single vertex list and sent to one
+	dynamic buffer when rendered, so the whole frame of debug lines is one draw call instead
+	of a model lookup and a matrix per line.
+	*/
+	//DebugBatch Class
+	class BTXDLL DebugBatch
+	{
+		std::vector<vector3> m_lVertex; //Position and color of each vertex, interleaved
+		std::vector<vector3> m_lCircle; //Points of the unit circle the wire spheres are made of
+		GLuint m_VAO = 0; //Vertex array of the batch, made the first time it renders
+		GLuint m_VBO = 0; //Dynamic buffer the vertices are sent to
+
+		ShaderManager* m_pShaderMngr = nullptr; //Shader Manager
+		RenderBackend* m_pBackend = nullptr; //Backend the batch is drawn with
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		DebugBatch(void);
+		/*
+		USAGE: Copy Constructor, the copy gets the vertices but makes its own buffer
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		DebugBatch(DebugBatch const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		DebugBatch& operator=(DebugBatch const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~DebugBatch(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(DebugBatch& other);
+
+		/*
+		USAGE: Adds a line in world space
+		ARGUMENTS:
+		-	vector3 a_v3Start -> start point
+		-	vector3 a_v3End -> end point
+		-	vector3 a_v3ColorStart = C_WHITE -> color of the start point
+		-	vector3 a_v3ColorEnd = C_WHITE -> color of the end point
+		OUTPUT: ---
+		*/
+		void AddLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart = C_WHITE, vector3 a_v3ColorEnd = C_WHITE);
+
+		/*
+		USAGE: Adds a line given in local space
+		ARGUMENTS:
+		-	matrix4 a_m4ToWorld -> space the points are in
+		-	vector3 a_v3Start -> start point in local space
+		-	vector3 a_v3End -> end point in local space
+		-	vector3 a_v3ColorStart = C_WHITE -> color of the start point
+		-	vector3 a_v3ColorEnd = C_WHITE -> color of the end point
+		OUTPUT: ---
+		*/
+		void AddLine(matrix4 a_m4ToWorld, vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart = C_WHITE, vector3 a_v3ColorEnd = C_WHITE);
+
+		/*
+		USAGE: Adds the twelve edges of an axis aligned box
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the box
+		-	vector3 a_v3HalfWidth -> half of the size of the box on each axis
+		-	vector3 a_v3Color = C_WHITE -> color of the edges
+		OUTPUT: ---
+		*/
+		void AddWireBox(vector3 a_v3Center, vector3 a_v3HalfWidth, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Adds the twelve edges of a unit cube (size 1 centered at the origin) moved
+			by a matrix, the same box AddWireCubeToRenderList draws
+		ARGUMENTS:
+		-	matrix4 a_m4ToWorld -> space of the cube
+		-	vector3 a_v3Color = C_WHITE -> color of the edges
+		OUTPUT: ---
+		*/
+		void AddWireBox(matrix4 a_m4ToWorld, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Adds a sphere drawn as its three axis circles
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the sphere
+		-	float a_fRadius -> radius of the sphere
+		-	vector3 a_v3Color = C_WHITE -> color of the circles
+		OUTPUT: ---
+		*/
+		void AddWireSphere(vector3 a_v3Center, float a_fRadius, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Adds a sphere of radius 1 at the origin moved by a matrix, drawn as its three
+			axis circles
+		ARGUMENTS:
+		-	matrix4 a_m4ToWorld -> space of the sphere
+		-	vector3 a_v3Color = C_WHITE -> color of the circles
+		OUTPUT: ---
+		*/
+		void AddWireSphere(matrix4 a_m4ToWorld, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Adds the three axis of a space as red, green and blue lines
+		ARGUMENTS:
+		-	matrix4 a_m4ToWorld -> space to draw
+		-	float a_fSize = 1.0f -> length of the lines
+		OUTPUT: ---
+		*/
+		void AddAxis(matrix4 a_m4ToWorld, float a_fSize = 1.0f);
+
+		/*
+		USAGE: Gets the number of lines added since the last Clear
+		ARGUMENTS: ---
+		OUTPUT: number of lines
+		*/
+		uint GetLineCount(void);
+
+		/*
+		USAGE: Removes the lines added, the buffer is kept for the next frame
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Clear(void);
+
+		/*
+		USAGE: Sends the lines to the buffer and draws them in one call, the lines stay until
+			Clear is called
+		ARGUMENTS:
+		-	matrix4 a_m4Projection -> projection of the camera
+		-	matrix4 a_m4View -> view of the camera
+		OUTPUT: number of draw calls, 0 if there was nothing to draw
+		*/
+		uint Render(matrix4 a_m4Projection, matrix4 a_m4View);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+	};
+
+} //namespace BTX
+
+#endif //__DEBUGBATCHCLASS_H_
@@ -8,10 +8,37 @@ Update: 2021/02
 
 #include "BTX\Materials\MaterialManager.h"
 #include "BTX\System\ShaderManager.h"
+#include "BTX\System\RenderBackend.h"
 #include "BTXs\BTXs.h"
 
 namespace BTX
 {
+	/*
+	OpenGL state last set while rendering a sorted queue, the meshes skip the calls that
+	would set the same state again and count the ones they do make
+	*/
+	struct BTXDLL RenderState
+	{
+		GLuint uShader = 0; //program in use
+		GLuint uVAO = 0; //vertex array bound
+		GLuint uTexture[3] = { 0, 0, 0 }; //textures bound to the diffuse, normal and specular units
+		GLenum uPolygonMode = GL_FILL; //polygon mode, GL_LINE comes with the polygon offset on
+		std::vector<GLuint> lFrameShader; //programs that already got the camera and light uniforms
+
+		uint uShaderBinds = 0; //glUseProgram calls
+		uint uVAOBinds = 0; //glBindVertexArray calls
+		uint uTextureBinds = 0; //glBindTexture calls
+		uint uModeChanges = 0; //glPolygonMode calls
+		uint uDrawCalls = 0; //glDrawArraysInstanced calls
+
+		/*
+		USAGE: Forgets the state so the next call of each kind is made, and zeroes the counters
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Reset(void);
+	};
+
 	/*
 	A Mesh is the most basic container of a model or mesh.
 	It contains the information about the material and the vertex cloud that forms it
@@ -50,6 +77,7 @@ namespace BTX
 		Mesh* m_pOriginal = nullptr; //Marks the Mesh this is a copy from, nullptr if this is the original
 		ShaderManager* m_pShaderMngr = nullptr;	//Shader Manager
 		MaterialManager* m_pMatMngr = nullptr;		//Material Manager
+		RenderBackend* m_pBackend = nullptr;	//Backend the mesh is drawn with
 
 		static uint m_nIndexer; //Identifier count
 #pragma region Construction / Destruction
@@ -138,6 +166,24 @@ namespace BTX
 		*/
 		void CompileOpenGL3X(void);
 
+		/*
+		USAGE: Sends the vertex lists to the GPU again after they were changed, the buffers of
+			the last compile are deleted; instances share the buffers of their original and are
+			left as they are
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void RebuildOpenGL3X(void);
+
+		/*
+		USAGE: Adds the vertices of another mesh after the ones of this mesh, the material,
+			shader and tint of this mesh are kept; call RebuildOpenGL3X to see the result
+		ARGUMENTS: Mesh* a_pSource -> mesh to copy the vertices from, it needs its vertex
+			lists (not an instance)
+		OUTPUT: ---
+		*/
+		void AppendMesh(Mesh* a_pSource);
+
 		/*
 		USAGE: Completes the triangle information
 		ARGUMENTS:
@@ -163,10 +209,12 @@ namespace BTX
 		-	int a_nInstances -> Number of instances to display
 		-	vector3 a_v3CameraPosition -> Position of the camera in world space
 		-	int a_RenderOption = eBTO_RENDER::SOLID -> Render options SOLID | WIRE
+		-	RenderState* a_pState = nullptr -> state shared by consecutive draws, nullptr sets everything
 		OUTPUT: ---
 		*/
 		uint Render(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances,
-			vector3 a_v3CameraPosition = vector3(0), int a_RenderOption = eBTX_RENDER::RENDER_SOLID);
+			vector3 a_v3CameraPosition = vector3(0), int a_RenderOption = eBTX_RENDER::RENDER_SOLID,
+			RenderState* a_pState = nullptr);
 
 		/*
 		USAGE: Renders the mesh 
@@ -190,9 +238,11 @@ namespace BTX
 		-	matrix4 a_mView -> View matrix
 		-	float* a_fMatrixArray -> Array of matrices that represent positions
 		-	int a_nInstances -> Number of instances to display
+		-	RenderState* a_pState = nullptr -> state shared by consecutive draws, nullptr sets everything
 		OUTPUT: ---
 		*/
-		uint RenderWire(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances);
+		uint RenderWire(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances,
+			RenderState* a_pState = nullptr);
 
 		/*
 		USAGE: Renders the mesh a_nInstances number of times on the specified positions by the a_fMatrixArray and by the
@@ -203,9 +253,11 @@ namespace BTX
 		-	float* a_fMatrixArray -> Array of matrices that represent positions
 		-	int a_nInstances -> Number of instances to display
 		-	vector3 a_v3CameraPosition -> Position of the camera in world space
+		-	RenderState* a_pState = nullptr -> state shared by consecutive draws, nullptr sets everything
 		OUTPUT: ---
 		*/
-		uint RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition);
+		uint RenderSolid(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances, vector3 a_v3CameraPosition,
+			RenderState* a_pState = nullptr);
 
 		/*
 		USAGE: Will render the line mesh using line mode, the object needs to be
@@ -215,9 +267,11 @@ namespace BTX
 		-	matrix4 a_mView -> View matrix
 		-	float* a_fMatrixArray -> Array of matrices that represent positions
 		-	int a_nInstances -> Number of instances to display
+		-	RenderState* a_pState = nullptr -> state shared by consecutive draws, nullptr sets everything
 		OUTPUT: ---
 		*/
-		uint RenderLines(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances);
+		uint RenderLines(matrix4 a_mProjection, matrix4 a_mView, float* a_fMatrixArray, int a_nInstances,
+			RenderState* a_pState = nullptr);
 
 #pragma region Add Information to Mesh
 		/*
@@ -579,6 +633,13 @@ namespace BTX
 		*/
 		GLuint GetVBO(void);
 
+		/*
+		USAGE: Asks if the mesh is made of lines
+		ARGUMENTS: ---
+		OUTPUT: is this a line object?
+		*/
+		bool IsLineObject(void);
+
 		/*
 		USAGE: Returns the unique identifier of the mesh
 		ARGUMENTS: ---
@@ -744,6 +805,28 @@ namespace BTX
 		*/
 		void GenerateLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart, vector3 a_v3ColorEnd);
 
+		/*
+		USAGE: Generates a square grid of lines one unit apart on the XY plane, centered at the origin
+		ARGUMENTS:
+		-	uint a_uSize -> length of the side of the grid
+		-	bool a_bCenterLines -> add the two lines that go through the origin?
+		-	vector3 a_v3Color -> Color of the mesh
+		OUTPUT: ---
+		*/
+		void GenerateGrid(uint a_uSize, bool a_bCenterLines, vector3 a_v3Color = C_WHITE);
+
+		/*
+		USAGE: Generates a coarser version of another mesh by collapsing the edges that change
+			its shape the least (quadric error metric), the corners that are left keep the colors,
+			UVs and smooth normals of the source; used for the levels of detail of loaded models
+		ARGUMENTS:
+		-	Mesh* a_pSource -> mesh to simplify, it needs its vertex lists (not an instance)
+		-	float a_fRatio -> fraction of the triangles of the source to keep, the borders and
+			the collapses that would fold the surface are kept so it can end up with more
+		OUTPUT: ---
+		*/
+		void GenerateSimplified(Mesh* a_pSource, float a_fRatio);
+
 
 
 		/*
@@ -6,9 +6,13 @@ Update: 2021/02
 #ifndef __MODELCLASS_H_
 #define __MODELCLASS_H_
 
-#include "BTX\Mesh\Mesh.h"
+#include "BTX\Mesh\RenderQueue.h"
+#include "BTX\System\NameTable.h"
+#include "BTX\Materials\TextureAtlas.h"
 namespace BTX
 {
+	struct ModelSource; //Data read from the disk for a model, defined in Model.cpp
+
 	//Model Class
 	class BTXDLL Model
 	{
@@ -16,9 +20,23 @@ namespace BTX
 		std::vector<Mesh*> m_MeshList; //list of meshes that belong to this model
 		std::vector<matrix4> m_RenderListSolid; //For each mesh in the List where would we render them?
 		std::vector<matrix4> m_RenderListWire; //For each mesh in the List where would we render them in wireframe?
+		std::vector<uint> m_RenderIDSolid; //Instance handle of each solid matrix, NameTable::INVALID if it has none
+		std::vector<uint> m_RenderIDWire; //Instance handle of each wire matrix, NameTable::INVALID if it has none
+
+		std::vector<std::vector<Mesh*>> m_lLODMesh; //Meshes of each coarser level of detail, the first level is m_MeshList
+		std::vector<float> m_lLODSize; //Size on the screen under which each coarser level is used
+		NameMap<uint> m_lLODSolid; //Level each solid instance used on the last frame, by instance handle
+		NameMap<uint> m_lLODWire; //Level each wire instance used on the last frame, by instance handle
+		std::vector<std::vector<matrix4>> m_lLODBucket; //Instances of each level while they are added to the queue
 
 		MaterialManager* m_pMatMngr = nullptr; //Material Manager pointer
 		String m_sMaterialAppend = ""; //Name of the material based on the file
+		vector3 m_v3MinL = ZERO_V3; //Minimum vertex of the model in local space
+		vector3 m_v3MaxL = ZERO_V3; //Maximum vertex of the model in local space
+		static uint m_uLoaderThreads; //Threads used to parse OBJ files, 0 uses the hardware concurrency
+		static uint m_uLODLevels; //Levels of detail simplified for the OBJ files and cooked with them
+		ModelSource* m_pSource = nullptr; //Data being read in the background, nullptr once the model is built
+		std::future<bool> m_Loading; //Background read of m_pSource
 
 	public:
 		
@@ -27,9 +45,11 @@ namespace BTX
 		Arguments: 
 		-	String a_sFileName -> Name to give the model or file to load if a_bIsModelFile = true
 		-	bool a_bIsModelFile -> Is a_sFileName the name of a file to load?
+		-	bool a_bAsync -> Read the file in the background? the model will be empty until
+			FinishLoading builds it on the main thread
 		Output: class object instance
 		*/
-		Model(String a_sFileName, bool a_bIsModelFile = true);
+		Model(String a_sFileName, bool a_bIsModelFile = true, bool a_bAsync = false);
 
 		/*
 		Usage: Constructor based on a single mesh,
@@ -88,6 +108,20 @@ namespace BTX
 		*/
 		void SetName(String a_sName);
 
+		/*
+		USAGE: Adds a mesh to the model, the model owns it from now on
+		ARGUMENTS: Mesh* a_pMesh -> mesh to add
+		OUTPUT: ---
+		*/
+		void AddMesh(Mesh* a_pMesh);
+
+		/*
+		USAGE: Returns the number of meshes of the model, each one is a draw
+		ARGUMENTS: ---
+		OUTPUT: number of meshes
+		*/
+		uint GetMeshCount(void);
+
 		/*
 		USAGE: 
 		ARGUMENTS: ---
@@ -95,6 +129,17 @@ namespace BTX
 		*/
 		void AddToRenderList(matrix4 a_m4Transform, int a_RenderOption = BTX::eBTX_RENDER::RENDER_SOLID);
 
+		/*
+		USAGE: Adds an instance that keeps its level of detail from one frame to the next
+		ARGUMENTS:
+		-	matrix4 a_m4Transform -> model to world matrix of the instance
+		-	int a_RenderOption -> RENDER_SOLID and/or RENDER_WIRE
+		-	uint a_uInstance -> handle that names the instance on every frame, like the one of
+			the unique ID of an entity; NameTable::INVALID picks the level without the last frame
+		OUTPUT: ---
+		*/
+		void AddToRenderList(matrix4 a_m4Transform, int a_RenderOption, uint a_uInstance);
+
 		/*
 		Usage: Will Get all matrix transforms for where to draw this model instanced
 		Arguments: ---
@@ -116,6 +161,89 @@ namespace BTX
 		Output: ---
 		*/
 		uint RenderLists(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3CameraPosition);
+
+		/*
+		Usage: Adds both wire and solid lists to a render queue instead of rendering them
+		Arguments:
+		-	RenderQueue* a_pQueue -> queue that will sort and draw the batches
+		-	uint a_uLayer = 1 -> draw layer, lower layers draw first
+		Output: ---
+		*/
+		void AddListsToQueue(RenderQueue* a_pQueue, uint a_uLayer = 1);
+
+		/*
+		Usage: Adds a coarser level of detail, the instances that look smaller on the screen than
+			the given size draw its meshes instead of the ones of the model; the levels go from
+			the finest to the coarsest. The instances are matched with the last frame by the
+			handle they are added with, the ones added without one get no hysteresis
+		Arguments:
+		-	std::vector<Mesh*> a_lMesh -> meshes of the level, the model owns them from now on
+		-	float a_fScreenSize -> fraction of the height of the viewport the diameter of the
+			model covers under which the level is used, it is clamped to the one of the last level
+		Output: ---
+		*/
+		void AddLOD(std::vector<Mesh*> a_lMesh, float a_fScreenSize);
+
+		/*
+		Usage: Makes the levels of detail of the model by simplifying its meshes, each level keeps
+			a fraction of the triangles of the one before it and is used under half the screen
+			size of the one before it; the levels it had are released first
+		Arguments:
+		-	uint a_uLevels = 2 -> number of coarser levels to make
+		-	float a_fRatio = 0.5f -> fraction of the triangles each level keeps
+		-	float a_fScreenSize = 0.1f -> screen size under which the first coarser level is used
+		Output: number of levels made, it stops early when a level would not be much lighter
+		*/
+		uint GenerateLOD(uint a_uLevels = 2, float a_fRatio = 0.5f, float a_fScreenSize = 0.1f);
+
+		/*
+		Usage: Releases the levels of detail, the model draws its own meshes everywhere
+		Arguments: ---
+		Output: ---
+		*/
+		void ClearLOD(void);
+
+		/*
+		Usage: Gets the number of levels of detail coarser than the model
+		Arguments: ---
+		Output: number of levels
+		*/
+		uint GetLODCount(void);
+
+		/*
+		Usage: Gets the number of vertices of a level of detail
+		Arguments: uint a_uLevel -> level, 0 is the model itself
+		Output: vertices of all the meshes of the level, 0 if out of bounds
+		*/
+		uint GetLODVertexCount(uint a_uLevel);
+
+		/*
+		Usage: Moves the meshes whose diffuse map was packed in an atlas onto the material of
+			its page, their UVs (and the ones of their levels of detail) are moved into the region
+			of the map; meshes with normal or specular maps, or with UVs outside of [0, 1], keep
+			their own material
+		Arguments:
+		-	TextureAtlas* a_pAtlas -> atlas, already packed
+		-	bool a_bMerge = true -> merge the meshes that end up with the same material after?
+		Output: number of meshes moved to the atlas
+		*/
+		uint ApplyAtlas(TextureAtlas* a_pAtlas, bool a_bMerge = true);
+
+		/*
+		Usage: Adds the diffuse maps of the meshes ApplyAtlas could move to an atlas, the maps the
+			atlas already has are skipped
+		Arguments: TextureAtlas* a_pAtlas -> atlas, packed after all its maps are added
+		Output: number of maps added
+		*/
+		uint AddMapsToAtlas(TextureAtlas* a_pAtlas);
+
+		/*
+		Usage: Merges the meshes drawn with the same material, shader and tint into one mesh so
+			they are a single draw, the levels of detail are merged the same way
+		Arguments: ---
+		Output: number of meshes left
+		*/
+		uint MergeMeshes(void);
 		
 		/*
 		Usage: Will remove the objects from both render lists
@@ -130,6 +258,76 @@ namespace BTX
 		OUTPUT:
 		*/
 		std::vector<vector3> GetVertexList();
+		/*
+		USAGE: Gets the minimum vertex of the model in local space
+		ARGUMENTS: ---
+		OUTPUT: minimum corner of the bounding box of the model
+		*/
+		vector3 GetMinLocal(void);
+		/*
+		USAGE: Gets the maximum vertex of the model in local space
+		ARGUMENTS: ---
+		OUTPUT: maximum corner of the bounding box of the model
+		*/
+		vector3 GetMaxLocal(void);
+		/*
+		USAGE: Sets the number of threads used to parse OBJ files, large files are split in
+			line aligned chunks that are parsed in parallel and stitched together in file order,
+			the output is the same regardless of the number of threads
+		ARGUMENTS: uint a_uThreads -> number of threads, 0 uses the hardware concurrency (at most 8)
+		OUTPUT: ---
+		*/
+		static void SetLoaderThreadCount(uint a_uThreads);
+		/*
+		USAGE: Gets the number of threads used to parse OBJ files
+		ARGUMENTS: ---
+		OUTPUT: number of threads, 0 means the hardware concurrency is used
+		*/
+		static uint GetLoaderThreadCount(void);
+		/*
+		USAGE: Sets the number of coarser levels of detail simplified for the OBJ files, they are
+			made when the file is cooked and read back from the cooked file afterwards; a cooked
+			file made with a different number is cooked again
+		ARGUMENTS: uint a_uLevels -> levels per model, 0 keeps the models as they are
+		OUTPUT: ---
+		*/
+		static void SetLODLevelCount(uint a_uLevels);
+		/*
+		USAGE: Gets the number of coarser levels of detail simplified for the OBJ files
+		ARGUMENTS: ---
+		OUTPUT: levels per model
+		*/
+		static uint GetLODLevelCount(void);
+		/*
+		USAGE: Reads and parses a model file without making its meshes or materials, it does not
+			need an OpenGL context; used to measure the loader on its own
+		ARGUMENTS:
+		-	String a_sFileName -> absolute route of the file
+		-	bool a_bUseCooked = true -> read the cooked file when it is up to date?
+		OUTPUT: was the file read?
+		*/
+		static bool ReadFile(String a_sFileName, bool a_bUseCooked = true);
+		/*
+		USAGE: Gets the name of the cooked file of the specified model, cooked files
+			live in the MBTO folder with the .btc extension
+		ARGUMENTS: String a_sFileName -> absolute route of the source file
+		OUTPUT: absolute route of the cooked file
+		*/
+		static String GetCookedFileName(String a_sFileName);
+		/*
+		USAGE: Asks if the model is still being read in the background
+		ARGUMENTS: ---
+		OUTPUT: is the model waiting for FinishLoading to build it?
+		*/
+		bool IsLoading(void);
+		/*
+		USAGE: Builds the meshes of a model read in the background, needs to be called from the
+			thread that owns the OpenGL context; the textures of the model are decoded in the
+			background and uploaded by TextureManager::UpdateLoads
+		ARGUMENTS: bool a_bWait = false -> wait for the background read if it is not done?
+		OUTPUT: was the model built by this call?
+		*/
+		bool FinishLoading(bool a_bWait = false);
 
 #pragma region Primitive Generation
 		/*
@@ -318,11 +516,25 @@ namespace BTX
 		String Load(String a_sFileName);
 
 		/*
-		Usage: Load the specified model
-		Arguments: filename to open
+		Usage: Makes the source that will hold the data read for the specified file
+		Arguments: String a_sFileName -> absolute route of the file to load
+		Output: new source, the caller owns it
+		*/
+		ModelSource* PrepareSource(String a_sFileName);
+
+		/*
+		Usage: Builds the meshes and materials of the model out of the data read from the disk
+		Arguments: ModelSource* a_pSource -> data read for the model
+		Output: filename, or the error found while reading it
+		*/
+		String Build(ModelSource* a_pSource);
+
+		/*
+		Usage: Builds the model out of the chunks parsed from an obj file
+		Arguments: ModelSource* a_pSource -> data read for the model
 		Output: filename
 		*/
-		String LoadOBJ(String a_sFileName);
+		String BuildOBJ(ModelSource* a_pSource);
 
 		/*
 		USAGE: Loads the material file for this model
@@ -346,6 +558,39 @@ namespace BTX
 		Output: ----
 		*/
 		void CompileMeshes(void);
+		/*
+		Usage: Calculates the local bounding box of the model from the vertices of its meshes
+		Arguments: ---
+		Output: ---
+		*/
+		void CalculateBounds(void);
+		/*
+		Usage: Picks the level of detail of each instance of a list and adds the instances of each
+			level to the queue with the meshes of that level
+		Arguments:
+		-	RenderQueue* a_pQueue -> queue that will sort and draw the batches
+		-	std::vector<matrix4> const& a_lMatrix -> instances
+		-	std::vector<uint> const& a_lInstance -> handle of each instance
+		-	NameMap<uint>& a_lLast -> level of each instance on the last frame by handle, updated
+		-	int a_nRenderOption -> RENDER_SOLID or RENDER_WIRE
+		-	uint a_uLayer -> draw layer
+		Output: ---
+		*/
+		void AddLODToQueue(RenderQueue* a_pQueue, std::vector<matrix4> const& a_lMatrix, std::vector<uint> const& a_lInstance,
+			NameMap<uint>& a_lLast, int a_nRenderOption, uint a_uLayer);
+		/*
+		Usage: Builds the model out of the meshes read from its cooked binary file, the cooked
+			file is only read if it was made from the current version of the obj and mtl files
+		Arguments: ModelSource* a_pSource -> data read for the model
+		Output: filename
+		*/
+		String BuildCooked(ModelSource* a_pSource);
+		/*
+		Usage: Saves the meshes, materials and bounds of the model into its cooked binary file
+		Arguments: String a_sFileName -> absolute route of the source file
+		Output: ---
+		*/
+		void SaveCooked(String a_sFileName);
 	};
 }
 
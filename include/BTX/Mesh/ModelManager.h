@@ -7,6 +7,8 @@ Update: 2021/02
 #define __MESHMANAGER_H_
 #include "BTX\Mesh\Model.h"
 #include "BTX\Camera\CameraManager.h"
+#include "BTX\Mesh\DebugBatch.h"
+#include "BTX\Mesh\BoundsBatch.h"
 
 namespace BTX
 {
@@ -15,12 +17,20 @@ namespace BTX
 class BTXDLL ModelManager
 {
 	std::vector<Model*> m_ModelList; //Lit of all the Models added to the system
-	std::map<String, Model*> m_ModelMap; //map of Model names and corresponding pointer
+	NameMap<uint> m_ModelMap; //index in m_ModelList by name handle, also by the name without the data folder
+	std::vector<Model*> m_lLoading; //Models being read in the background
+	uint m_uLoadBudget = 1; //Number of models built per frame out of the ones read in the background
+	bool m_bLoadAtlas = true; //Pack the diffuse maps of the models loaded in an atlas they share?
+	std::vector<Model*> m_lAtlasPending; //Models loaded since the last atlas was packed
+	uint m_uAtlasCount = 0; //Atlases packed so far, names the next one
 	
 	static ModelManager* m_pInstance; // Singleton pointer
 	ShaderManager* m_pShaderMngr = nullptr;	//Shader Manager
 	MaterialManager* m_pMatMngr = nullptr;	//Material Manager
 	CameraManager* m_pCameraMngr = nullptr;	//Camera Manager
+	RenderQueue* m_pRenderQueue = nullptr; //Sorts the batches of the frame by the state they need
+	DebugBatch* m_pDebugBatch = nullptr; //Lines of the frame, drawn in a single call
+	BoundsBatch* m_pBoundsBatch = nullptr; //Bounding volumes of the frame, drawn instanced
 public:
 	//Singleton Methods
 	/*
@@ -38,7 +48,8 @@ public:
 	static void ReleaseInstance(void);
 
 	/*
-	USAGE: Returns the mesh specified by name from the list of Meshes
+	USAGE: Returns the mesh specified by name from the list of Meshes, a model read from a file
+		is also found by its name without the data folder
 	ARGUMENTS: String a_sName -> name of the mesh
 	OUTPUT: index in the list, -1 if not found
 	*/
@@ -176,6 +187,14 @@ public:
 	*/
 	Model* GenerateLine(vector3 a_v3Start, vector3 a_v3End, vector3 a_v3ColorStart, vector3 a_v3ColorEnd);
 
+	/*
+	USAGE: Generates the 100 by 100 white grid on the XY plane the AddGridToRenderList methods draw
+	ARGUMENTS: bool a_bCenterLines -> add the lines through the origin? the camera grid
+		draws colored axis there instead
+	OUTPUT: grid model
+	*/
+	Model* GenerateGrid(bool a_bCenterLines);
+
 	/*
 	USAGE: will return all the names already stored in the mesh list
 	ARGUMENTS: ---
@@ -402,6 +421,101 @@ public:
 	*/
 	String LoadModel(String a_sFileName);
 
+	/*
+	USAGE: Starts reading the specified model in the background, the model is added to the
+		manager right away and renders as a wire cube until UpdateLoads builds it
+	ARGUMENTS: String a_sFileName -> file to load
+	OUTPUT: name of the model, the same LoadModel would return, "" if the file was not found
+	*/
+	String LoadModelAsync(String a_sFileName);
+
+	/*
+	USAGE: Gets the queue Render sorts the batches with, its stats hold the binds of the last frame
+	ARGUMENTS: ---
+	OUTPUT: render queue
+	*/
+	RenderQueue* GetRenderQueue(void);
+
+	/*
+	USAGE: Gets the batch the lines of the frame are added to, it also takes wire boxes, wire
+		spheres and axis; Render draws it after the models and ClearRenderList empties it
+	ARGUMENTS: ---
+	OUTPUT: debug batch
+	*/
+	DebugBatch* GetDebugBatch(void);
+
+	/*
+	USAGE: Gets the batch the bounding volumes of the frame are added to, rigid bodies and
+		octants use it instead of a wire cube matrix each; Render draws it after the models
+		and ClearRenderList empties it
+	ARGUMENTS: ---
+	OUTPUT: bounds batch
+	*/
+	BoundsBatch* GetBoundsBatch(void);
+
+	/*
+	USAGE: Builds the models and uploads the textures that finished loading in the background,
+		Render calls it every frame
+	ARGUMENTS: ---
+	OUTPUT: number of models still loading
+	*/
+	uint UpdateLoads(void);
+
+	/*
+	USAGE: Sets how many models UpdateLoads builds per call, building a model compiles its
+		meshes so this keeps big loads from stalling a single frame
+	ARGUMENTS: uint a_uBudget -> models per call, at least one
+	OUTPUT: ---
+	*/
+	void SetLoadBudget(uint a_uBudget);
+
+	/*
+	USAGE: Gets how many models UpdateLoads builds per call
+	ARGUMENTS: ---
+	OUTPUT: models per call
+	*/
+	uint GetLoadBudget(void);
+
+	/*
+	USAGE: Sets how many coarser levels of detail are simplified for the models loaded from
+		now on, they are cooked with the model so only its first load simplifies them; the
+		generated primitives get coarser tessellations instead
+	ARGUMENTS: uint a_uLevels -> levels per model, 0 keeps the models as they are
+	OUTPUT: ---
+	*/
+	void SetLODLevels(uint a_uLevels);
+
+	/*
+	USAGE: Gets how many coarser levels of detail are simplified for the models loaded
+	ARGUMENTS: ---
+	OUTPUT: levels per model
+	*/
+	uint GetLODLevels(void);
+
+	/*
+	USAGE: Sets if the diffuse maps of the models loaded from files are packed in an atlas they
+		share, the first frame rendered with no model left to load packs the ones loaded since
+		the last atlas so instances of different models are drawn from the same texture
+	ARGUMENTS: bool a_bAtlas -> pack them?
+	OUTPUT: ---
+	*/
+	void SetLoadAtlas(bool a_bAtlas);
+
+	/*
+	USAGE: Gets if the diffuse maps of the models loaded from files are packed in an atlas
+	ARGUMENTS: ---
+	OUTPUT: packed?
+	*/
+	bool GetLoadAtlas(void);
+
+	/*
+	USAGE: Packs the diffuse maps of the models loaded since the last atlas into a new one and
+		moves their meshes onto its pages, see Model::ApplyAtlas
+	ARGUMENTS: ---
+	OUTPUT: number of meshes moved to the atlas
+	*/
+	uint PackAtlas(void);
+
 	/*
 	USAGE: Gets the vertex list of the model
 	ARGUMENTS:
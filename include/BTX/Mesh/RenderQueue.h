@@ -0,0 +1,231 @@
+#ifndef __RENDERQUEUECLASS_H_
+#define __RENDERQUEUECLASS_H_
+
+#include "BTX\Mesh\Mesh.h"
+
+namespace BTX
+{
+	/*
+	Collects the instance batches of a frame, sorts them by the state they need
+	(layer, shader, material, mesh, mode) and draws them in that order so the meshes
+	can skip the binds that are already in place. Building the keys and sorting them
+	does not touch OpenGL. The queue also knows the camera of the frame so the models
+	can pick the level of detail of each instance by its size on the screen.
+	*/
+	//RenderQueue Class
+	class BTXDLL RenderQueue
+	{
+		//An instance batch of a mesh waiting to be drawn
+		struct RenderItem
+		{
+			Mesh* pMesh = nullptr; //Mesh to draw
+			uint uFirstMatrix = 0; //First matrix of the batch in m_lMatrix
+			uint uMatrixCount = 0; //Number of instances
+			int nRenderOption = eBTX_RENDER::RENDER_SOLID; //Single pass to draw
+		};
+		//Sort key of an item
+		struct RenderEntry
+		{
+			unsigned long long uKey = 0;
+			uint uItem = 0;
+		};
+
+		std::vector<RenderItem> m_lItem; //Batches in the order they were added
+		std::vector<RenderEntry> m_lEntry; //Keys of the batches, sorted by Sort
+		std::vector<RenderEntry> m_lScratch; //Second buffer of the radix sort
+		std::vector<float> m_lMatrix; //Matrices of all the batches, 16 floats each
+		RenderState m_State; //State of the last draw, holds the bind counters of the last Render
+		bool m_bSorted = true; //Are the entries sorted?
+
+		matrix4 m_m4View = IDENTITY_M4; //View of the frame, set by SetView
+		float m_fProjectionScale = 1.0f; //Vertical scale of the projection (cot of half the fov)
+		bool m_bPerspective = true; //Does the size on screen shrink with the distance?
+		float m_fLODHysteresis = 0.15f; //Fraction past a threshold an instance goes before it changes level
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		RenderQueue(void);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		RenderQueue(RenderQueue const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		RenderQueue& operator=(RenderQueue const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~RenderQueue(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(RenderQueue& other);
+
+		/*
+		USAGE: Builds the sort key of a batch, the fields are ordered from the most expensive
+			state change to the cheapest one, values wider than their field are masked
+		ARGUMENTS:
+		-	uint a_uLayer -> draw layer, lower layers draw first (4 bits)
+		-	uint a_uShader -> OpenGL program (16 bits)
+		-	uint a_uMaterial -> material index (16 bits)
+		-	uint a_uMesh -> mesh identifier, the VAO (20 bits)
+		-	uint a_uMode -> 0 solid, 1 wire, 2 lines (8 bits)
+		OUTPUT: sort key
+		*/
+		static unsigned long long MakeKey(uint a_uLayer, uint a_uShader, uint a_uMaterial, uint a_uMesh, uint a_uMode);
+
+		/*
+		USAGE: Adds the matrices of a set of instances to the queue, the same matrices can be
+			used by several meshes
+		ARGUMENTS: std::vector<matrix4> const& a_lMatrix -> instance matrices
+		OUTPUT: index of the first matrix added
+		*/
+		uint AddMatrices(std::vector<matrix4> const& a_lMatrix);
+
+		/*
+		USAGE: Adds the batches of a mesh, solid and wire are split in two batches so each
+			one is sorted with the other batches that use its shader
+		ARGUMENTS:
+		-	Mesh* a_pMesh -> mesh to draw
+		-	uint a_uFirstMatrix -> first matrix returned by AddMatrices
+		-	uint a_uMatrixCount -> number of instances
+		-	int a_nRenderOption -> RENDER_SOLID | RENDER_WIRE
+		-	uint a_uLayer = 1 -> draw layer, lower layers draw first
+		OUTPUT: ---
+		*/
+		void AddMesh(Mesh* a_pMesh, uint a_uFirstMatrix, uint a_uMatrixCount, int a_nRenderOption, uint a_uLayer = 1);
+
+		/*
+		USAGE: Adds a single batch with the given key
+		ARGUMENTS:
+		-	unsigned long long a_uKey -> sort key, see MakeKey
+		-	Mesh* a_pMesh -> mesh to draw
+		-	uint a_uFirstMatrix -> first matrix returned by AddMatrices
+		-	uint a_uMatrixCount -> number of instances
+		-	int a_nRenderOption -> single pass to draw, RENDER_SOLID or RENDER_WIRE
+		OUTPUT: ---
+		*/
+		void AddItem(unsigned long long a_uKey, Mesh* a_pMesh, uint a_uFirstMatrix, uint a_uMatrixCount, int a_nRenderOption);
+
+		/*
+		USAGE: Sorts the batches by key, batches with the same key keep the order they were added in
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Sort(void);
+
+		/*
+		USAGE: Gets the number of batches in the queue
+		ARGUMENTS: ---
+		OUTPUT: number of batches
+		*/
+		uint GetItemCount(void);
+
+		/*
+		USAGE: Gets the key of a batch in draw order, call Sort first
+		ARGUMENTS: uint a_uIndex -> position in the draw order
+		OUTPUT: key, 0 if out of bounds
+		*/
+		unsigned long long GetKey(uint a_uIndex);
+
+		/*
+		USAGE: Sorts and draws all the batches then empties the queue
+		ARGUMENTS:
+		-	matrix4 a_m4Projection -> Projection matrix
+		-	matrix4 a_m4View -> View matrix
+		-	vector3 a_v3CameraPosition -> Position of the camera in world space
+		OUTPUT: number of draw calls
+		*/
+		uint Render(matrix4 a_m4Projection, matrix4 a_m4View, vector3 a_v3CameraPosition);
+
+		/*
+		USAGE: Empties the queue without drawing it
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Clear(void);
+
+		/*
+		USAGE: Gets the binds, mode changes and draw calls made by the last Render
+		ARGUMENTS: ---
+		OUTPUT: state of the last Render
+		*/
+		RenderState GetStats(void);
+
+		/*
+		USAGE: Sets the camera the levels of detail of the frame are picked with, call it before
+			the models add their lists
+		ARGUMENTS:
+		-	matrix4 a_m4Projection -> Projection matrix
+		-	matrix4 a_m4View -> View matrix
+		OUTPUT: ---
+		*/
+		void SetView(matrix4 a_m4Projection, matrix4 a_m4View);
+
+		/*
+		USAGE: Gets the size of a sphere on the screen with the camera given to SetView
+		ARGUMENTS:
+		-	vector3 a_v3Center -> center of the sphere in world space
+		-	float a_fRadius -> radius of the sphere in world space
+		OUTPUT: fraction of the height of the viewport its diameter covers, can be larger than 1
+		*/
+		float GetScreenSize(vector3 a_v3Center, float a_fRadius);
+
+		/*
+		USAGE: Picks the level of detail for a size on the screen, the instance keeps its last
+			level until its size goes past the threshold by the hysteresis so it does not flicker
+			between two levels when it sits on the threshold
+		ARGUMENTS:
+		-	float a_fScreenSize -> size on the screen, see GetScreenSize
+		-	std::vector<float> const& a_lThreshold -> size under which each coarser level is
+			used, from the largest to the smallest; level i + 1 is used under a_lThreshold[i]
+		-	uint a_uLast = 0 -> level used by the instance on the last frame
+		OUTPUT: level to use, 0 is the full detail
+		*/
+		uint SelectLOD(float a_fScreenSize, std::vector<float> const& a_lThreshold, uint a_uLast = 0);
+
+		/*
+		USAGE: Sets how far past a threshold an instance needs to go to change its level
+		ARGUMENTS: float a_fHysteresis -> fraction of the threshold, 0 changes right on it
+		OUTPUT: ---
+		*/
+		void SetLODHysteresis(float a_fHysteresis);
+
+		/*
+		USAGE: Gets how far past a threshold an instance needs to go to change its level
+		ARGUMENTS: ---
+		OUTPUT: fraction of the threshold
+		*/
+		float GetLODHysteresis(void);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+	};
+
+} //namespace BTX
+
+#endif //__RENDERQUEUECLASS_H_
@@ -0,0 +1,242 @@
+#ifndef __ANIMATIONCLIPCLASS_H_
+#define __ANIMATIONCLIPCLASS_H_
+
+#include "BTX\System\Definitions.h"
+
+namespace BTX
+{
+	//How a track goes from one key to the next
+	enum eBTX_INTERPOLATION
+	{
+		INTERPOLATION_STEP = 0, //Keeps the value of a key until the next one
+		INTERPOLATION_LINEAR = 1, //LERP for positions and scales, SLERP for rotations
+		INTERPOLATION_CUBIC = 2 //Catmull-Rom for positions and scales, SQUAD for rotations
+	};
+
+	//Key each track of a clip was sampled at last, sampling close to it again avoids the search
+	struct AnimationCursor
+	{
+		uint uPosition = 0; //Key before the time sampled last on the position track
+		uint uRotation = 0; //Key before the time sampled last on the rotation track
+		uint uScale = 0; //Key before the time sampled last on the scale track
+	};
+
+	/*
+	Keyframes of the position, rotation and scale of an object over time. Each track has its own
+	keys and interpolation, a track with no keys leaves that part of the transform as it was.
+	The keys are kept sorted by time with their values in a separate list so a search only
+	walks the times.
+	*/
+	//AnimationClip Class
+	class BTXDLL AnimationClip
+	{
+	public:
+		//Keys of a single part of the transform
+		template <class T>
+		struct Track
+		{
+			std::vector<float> lTime; //Time of each key in seconds, sorted
+			std::vector<T> lValue; //Value of each key
+			eBTX_INTERPOLATION eInterpolation = INTERPOLATION_LINEAR; //How the keys are blended
+		};
+
+	private:
+		String m_sName = "Clip"; //Name of the clip
+		bool m_bLoop = true; //Does the clip start over after its last key?
+		float m_fDuration = 0.0f; //Time of the last key of any track
+
+		Track<vector3> m_Position; //Position keys
+		Track<quaternion> m_Rotation; //Rotation keys
+		Track<vector3> m_Scale; //Scale keys
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS:
+		-	String a_sName = "Clip" -> name of the clip
+		-	bool a_bLoop = true -> start over after the last key?
+		OUTPUT: class object instance
+		*/
+		AnimationClip(String a_sName = "Clip", bool a_bLoop = true);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		AnimationClip(AnimationClip const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		AnimationClip& operator=(AnimationClip const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~AnimationClip(void);
+		/*
+		USAGE: Changes object contents for other object's
+		ARGUMENTS: other -> object to swap content from
+		OUTPUT: ---
+		*/
+		void Swap(AnimationClip& other);
+
+		/*
+		USAGE: Adds a position key, a key at the time of another one replaces it
+		ARGUMENTS:
+		-	float a_fTime -> time of the key in seconds
+		-	vector3 a_v3Position -> position at that time
+		OUTPUT: ---
+		*/
+		void AddPositionKey(float a_fTime, vector3 a_v3Position);
+		/*
+		USAGE: Adds a rotation key, a key at the time of another one replaces it
+		ARGUMENTS:
+		-	float a_fTime -> time of the key in seconds
+		-	quaternion a_qRotation -> rotation at that time
+		OUTPUT: ---
+		*/
+		void AddRotationKey(float a_fTime, quaternion a_qRotation);
+		/*
+		USAGE: Adds a scale key, a key at the time of another one replaces it
+		ARGUMENTS:
+		-	float a_fTime -> time of the key in seconds
+		-	vector3 a_v3Scale -> scale at that time
+		OUTPUT: ---
+		*/
+		void AddScaleKey(float a_fTime, vector3 a_v3Scale);
+
+		/*
+		USAGE: Sets how each track blends its keys
+		ARGUMENTS:
+		-	eBTX_INTERPOLATION a_ePosition -> interpolation of the position keys
+		-	eBTX_INTERPOLATION a_eRotation -> interpolation of the rotation keys
+		-	eBTX_INTERPOLATION a_eScale -> interpolation of the scale keys
+		OUTPUT: ---
+		*/
+		void SetInterpolation(eBTX_INTERPOLATION a_ePosition, eBTX_INTERPOLATION a_eRotation, eBTX_INTERPOLATION a_eScale);
+
+		/*
+		USAGE: Brings a time into the clip, wrapping it around if the clip loops or clamping it if not
+		ARGUMENTS: float a_fTime -> time in seconds
+		OUTPUT: time between 0 and the duration
+		*/
+		float WrapTime(float a_fTime);
+
+		/*
+		USAGE: Samples the tracks, the parts of the transform with no keys are left as they came
+		ARGUMENTS:
+		-	float a_fTime -> time in seconds, wrapped or clamped into the clip
+		-	vector3& a_v3Position -> [in/out] position
+		-	quaternion& a_qRotation -> [in/out] rotation
+		-	vector3& a_v3Scale -> [in/out] scale
+		-	AnimationCursor& a_Cursor -> [in/out] keys of the last sample, a time close to the
+			last one finds its keys in a step or two instead of a binary search
+		OUTPUT: ---
+		*/
+		void Sample(float a_fTime, vector3& a_v3Position, quaternion& a_qRotation, vector3& a_v3Scale, AnimationCursor& a_Cursor);
+		/*
+		USAGE: Samples the tracks with a binary search for the keys, for a time with no history
+		ARGUMENTS:
+		-	float a_fTime -> time in seconds, wrapped or clamped into the clip
+		-	vector3& a_v3Position -> [in/out] position
+		-	quaternion& a_qRotation -> [in/out] rotation
+		-	vector3& a_v3Scale -> [in/out] scale
+		OUTPUT: ---
+		*/
+		void Sample(float a_fTime, vector3& a_v3Position, quaternion& a_qRotation, vector3& a_v3Scale);
+
+		/*
+		USAGE: Gets the keys of the position track
+		ARGUMENTS: ---
+		OUTPUT: track
+		*/
+		Track<vector3> const& GetPositionTrack(void);
+		/*
+		USAGE: Gets the keys of the rotation track
+		ARGUMENTS: ---
+		OUTPUT: track
+		*/
+		Track<quaternion> const& GetRotationTrack(void);
+		/*
+		USAGE: Gets the keys of the scale track
+		ARGUMENTS: ---
+		OUTPUT: track
+		*/
+		Track<vector3> const& GetScaleTrack(void);
+
+		/*
+		USAGE: Gets the time of the last key of any track
+		ARGUMENTS: ---
+		OUTPUT: duration in seconds
+		*/
+		float GetDuration(void);
+		/*
+		USAGE: Sets whether the clip starts over after its last key
+		ARGUMENTS: bool a_bLoop = true -> loop?
+		OUTPUT: ---
+		*/
+		void SetLoop(bool a_bLoop = true);
+		/*
+		USAGE: Asks whether the clip starts over after its last key
+		ARGUMENTS: ---
+		OUTPUT: loop?
+		*/
+		bool IsLoop(void);
+		/*
+		USAGE: Gets the name of the clip
+		ARGUMENTS: ---
+		OUTPUT: name
+		*/
+		String GetName(void);
+
+		/*
+		USAGE: Finds the key before a time starting from a cursor, stepping forward or back a few
+			keys before falling back to a binary search
+		ARGUMENTS:
+		-	std::vector<float> const& a_lTime -> sorted times of the keys, at least two
+		-	float a_fTime -> time to look for
+		-	uint a_uCursor -> key to start from
+		OUTPUT: index of the last key at or before the time, never the last key
+		*/
+		static uint FindKey(std::vector<float> const& a_lTime, float a_fTime, uint a_uCursor);
+		/*
+		USAGE: Catmull-Rom curve between a key and the next one, the tangents are scaled by the
+			times of the keys around so keys that are not evenly spaced do not overshoot
+		ARGUMENTS:
+		-	Track<vector3> const& a_Track -> track with at least two keys
+		-	uint a_uKey -> key the segment starts at, never the last key
+		-	float a_fS -> fraction of the segment between 0 and 1
+		OUTPUT: value on the curve
+		*/
+		static vector3 Cubic(Track<vector3> const& a_Track, uint a_uKey, float a_fS);
+		/*
+		USAGE: SQUAD curve between a key and the next one
+		ARGUMENTS:
+		-	Track<quaternion> const& a_Track -> track with at least two keys
+		-	uint a_uKey -> key the segment starts at, never the last key
+		-	float a_fS -> fraction of the segment between 0 and 1
+		OUTPUT: rotation on the curve
+		*/
+		static quaternion Cubic(Track<quaternion> const& a_Track, uint a_uKey, float a_fS);
+
+	private:
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+	};
+
+} //namespace BTX
+
+#endif //__ANIMATIONCLIPCLASS_H_
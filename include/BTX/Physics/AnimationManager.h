@@ -0,0 +1,221 @@
+#ifndef __ANIMATIONMANAGER_H_
+#define __ANIMATIONMANAGER_H_
+
+#include "BTX\Physics\Entity.h"
+#include "BTX\Physics\AnimationClip.h"
+
+namespace BTX
+{
+	/*
+	Plays clips on many objects at once. Each playing clip is an instance, the instances are kept
+	as parallel lists (time, speed, cursor, output) so Update runs through them in passes: the
+	times move forward, the keys around each time are found from the cursor of the last frame,
+	the blends of the keys run as flat loops over the gathered values and last the results are
+	written into the transforms of the entities the instances are bound to.
+	*/
+	//AnimationManager Singleton
+	class BTXDLL AnimationManager
+	{
+		static AnimationManager* m_pInstance; //Singleton pointer
+
+		std::vector<AnimationClip> m_lClip; //Clips that can be played
+
+		//Instances, one entry per playing clip in each list
+		std::vector<uint> m_lClipIndex; //Clip played
+		std::vector<float> m_lTime; //Time in the clip in seconds
+		std::vector<float> m_lSpeed; //Multiplier of the time added each update
+		std::vector<AnimationCursor> m_lCursor; //Keys found in the last update
+		std::vector<uint> m_lEntity; //Name Table handle of the unique ID of the entity, NameTable::INVALID for none
+		std::vector<vector3> m_lPosition; //Sampled position
+		std::vector<quaternion> m_lRotation; //Sampled rotation
+		std::vector<vector3> m_lScale; //Sampled scale
+
+		//Segments gathered for the blend loops, reused every update
+		std::vector<uint> m_lBlendTarget; //Instance each segment is written to
+		std::vector<float> m_lBlendS; //Fraction of each segment
+		std::vector<vector3> m_lBlendA; //Value at the start of each vector segment
+		std::vector<vector3> m_lBlendB; //Value at the end of each vector segment
+		std::vector<quaternion> m_lBlendQA; //Value at the start of each rotation segment
+		std::vector<quaternion> m_lBlendQB; //Value at the end of each rotation segment
+
+		uint m_uApplied = 0; //Entities written to by the last update
+
+	public:
+		/*
+		USAGE: Gets/Constructs the singleton pointer
+		ARGUMENTS: ---
+		OUTPUT: singleton pointer
+		*/
+		static AnimationManager* GetInstance(void);
+		/*
+		USAGE: Destroys the singleton
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		static void ReleaseInstance(void);
+
+		/*
+		USAGE: Adds a clip that can be played, the clip is copied
+		ARGUMENTS: AnimationClip const& a_Clip -> clip
+		OUTPUT: index of the clip
+		*/
+		uint AddClip(AnimationClip const& a_Clip);
+		/*
+		USAGE: Gets a clip
+		ARGUMENTS: uint a_uClip -> index of the clip
+		OUTPUT: clip, nullptr if the index is not valid
+		*/
+		AnimationClip* GetClip(uint a_uClip);
+		/*
+		USAGE: Gets the index of a clip by name
+		ARGUMENTS: String a_sName -> name of the clip
+		OUTPUT: index of the clip, -1 if there is none with that name
+		*/
+		int GetClipIndex(String a_sName);
+		/*
+		USAGE: Gets the number of clips
+		ARGUMENTS: ---
+		OUTPUT: clips
+		*/
+		uint GetClipCount(void);
+
+		/*
+		USAGE: Starts playing a clip
+		ARGUMENTS:
+		-	uint a_uClip -> index of the clip
+		-	String a_sUniqueID = "" -> entity the clip moves, none if empty
+		-	float a_fTime = 0.0f -> time in the clip to start at
+		-	float a_fSpeed = 1.0f -> multiplier of the time added each update
+		OUTPUT: index of the instance, -1 if the clip does not exist
+		*/
+		int AddInstance(uint a_uClip, String a_sUniqueID = "", float a_fTime = 0.0f, float a_fSpeed = 1.0f);
+		/*
+		USAGE: Stops playing an instance, the last instance takes its index
+		ARGUMENTS: uint a_uInstance -> index of the instance
+		OUTPUT: ---
+		*/
+		void RemoveInstance(uint a_uInstance);
+		/*
+		USAGE: Stops playing every instance, the clips are kept
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void ClearInstances(void);
+		/*
+		USAGE: Gets the number of instances playing
+		ARGUMENTS: ---
+		OUTPUT: instances
+		*/
+		uint GetInstanceCount(void);
+
+		/*
+		USAGE: Sets the time of an instance
+		ARGUMENTS:
+		-	uint a_uInstance -> index of the instance
+		-	float a_fTime -> time in seconds
+		OUTPUT: ---
+		*/
+		void SetTime(uint a_uInstance, float a_fTime);
+		/*
+		USAGE: Sets the speed of an instance, 0 pauses it
+		ARGUMENTS:
+		-	uint a_uInstance -> index of the instance
+		-	float a_fSpeed -> multiplier of the time added each update
+		OUTPUT: ---
+		*/
+		void SetSpeed(uint a_uInstance, float a_fSpeed);
+		/*
+		USAGE: Gets the time of an instance
+		ARGUMENTS: uint a_uInstance -> index of the instance
+		OUTPUT: time in seconds, 0 if the index is not valid
+		*/
+		float GetTime(uint a_uInstance);
+
+		/*
+		USAGE: Gets the position sampled for an instance by the last update
+		ARGUMENTS: uint a_uInstance -> index of the instance
+		OUTPUT: position
+		*/
+		vector3 GetPosition(uint a_uInstance);
+		/*
+		USAGE: Gets the rotation sampled for an instance by the last update
+		ARGUMENTS: uint a_uInstance -> index of the instance
+		OUTPUT: rotation
+		*/
+		quaternion GetRotation(uint a_uInstance);
+		/*
+		USAGE: Gets the scale sampled for an instance by the last update
+		ARGUMENTS: uint a_uInstance -> index of the instance
+		OUTPUT: scale
+		*/
+		vector3 GetScale(uint a_uInstance);
+		/*
+		USAGE: Gets the number of entities written to by the last update
+		ARGUMENTS: ---
+		OUTPUT: entities
+		*/
+		uint GetAppliedCount(void);
+
+		/*
+		USAGE: Moves every instance forward in time, samples its clip and writes the result into
+			its entity
+		ARGUMENTS: float a_fDeltaTime -> seconds since the last update
+		OUTPUT: ---
+		*/
+		void Update(float a_fDeltaTime);
+
+	private:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		AnimationManager(void);
+		/*
+		USAGE: Copy Constructor, the singleton is not copied
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		AnimationManager(AnimationManager const& other);
+		/*
+		USAGE: Copy Assignment Operator, the singleton is not copied
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		AnimationManager& operator=(AnimationManager const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~AnimationManager(void);
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Samples the position or scale track of every instance into an output list
+		ARGUMENTS:
+		-	bool a_bScale -> scale tracks if true, position tracks if false
+		OUTPUT: ---
+		*/
+		void SampleVectors(bool a_bScale);
+		/*
+		USAGE: Samples the rotation track of every instance
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void SampleRotations(void);
+	};
+
+} //namespace BTX
+
+#endif //__ANIMATIONMANAGER_H_
@@ -18,7 +18,9 @@ class BTXDLL Entity
 {
 	bool m_bInMemory = false; //loaded flag
 	bool m_bSetAxis = false; //render axis flag
+	bool m_bOccluder = false; //does it hide what is behind it in the occlusion culling?
 	String m_sUniqueID = ""; //Unique identifier name
+	uint m_uUniqueID = NameTable::INVALID; //Name Table handle of the unique identifier
 
 	uint m_nDimensionCount = 0; //tells how many dimensions this entity lives in
 	uint* m_DimensionArray = nullptr; //Dimensions on which this entity is located
@@ -26,16 +28,36 @@ class BTXDLL Entity
 	Model* m_pModel = nullptr; //Model associated with this Entity
 	RigidBody* m_pRigidBody = nullptr; //Rigid Body associated with this Entity
 
-	matrix4 m_m4ToWorld = IDENTITY_M4; //Model matrix associated with this Entity
+	vector3 m_v3Position = ZERO_V3; //Translation of the entity
+	quaternion m_qOrientation = quaternion(1.0f, 0.0f, 0.0f, 0.0f); //Rotation of the entity
+	vector3 m_v3Scale = vector3(1.0f); //Scale of the entity
+	matrix4 m_m4ToWorld = IDENTITY_M4; //Model matrix associated with this Entity, made from the components above
+	bool m_bMatrixDirty = false; //Did the components change since m_m4ToWorld was made?
+	uint m_uMoveStamp = 0; //m_uMoveCount right after this entity last moved
+	static uint m_uMoveCount; //Times any entity was moved, wraps around
 	ModelManager* m_pModelMngr = nullptr; //For rendering shapes
 
-	static std::map<String, Entity*> m_IDMap; //a map of the unique ID's
+	static NameMap<Entity*> m_IDMap; //a map of the unique ID's by name handle
+	static NameMap<uint> m_SuffixMap; //next number tried by GenUniqueID for each name asked for
 
 	bool m_bUsePhysicsSolver = false; //Indicates if we will use a physics solver 
+	bool m_bModelLoading = false; //Was the rigid body made while the model was still loading?
 
 	Solver* m_pSolver = nullptr; //Physics Solver
 
 public:
+	//What the render list needs from an entity, copied so it can be drawn while the entity moves on
+	struct RenderState
+	{
+		Model* pModel = nullptr; //model to draw
+		matrix4 m4ToWorld = IDENTITY_M4; //model matrix
+		uint uUniqueID = NameTable::INVALID; //handle of the unique ID, keeps the level of detail between frames
+		vector3 v3Min = ZERO_V3; //minimum corner of the rigid body in global space, for culling
+		vector3 v3Max = ZERO_V3; //maximum corner of the rigid body in global space, for culling
+		bool bAxis = false; //draw the axis?
+		RigidBody::DrawState rigidBody; //volumes of the rigid body
+	};
+
 	/*
 	Usage: Constructor based on a Model pointer
 	Arguments:
@@ -50,9 +72,10 @@ public:
 	Arguments:
 	-	String a_sFileName -> Name of the model to load
 	-	String a_sUniqueID -> Name wanted as identifier, if not available will generate one
+	-	bool a_bAsync -> Load the model in the background? the rigid body is remade once it is ready
 	Output: class object instance
 	*/
-	Entity(String a_sFileName, String a_sUniqueID = "NA");
+	Entity(String a_sFileName, String a_sUniqueID = "NA", bool a_bAsync = false);
 	/*
 	Usage: Copy Constructor
 	Arguments: class object to copy
@@ -84,12 +107,47 @@ public:
 	*/
 	matrix4 GetModelMatrix(void);
 	/*
-	USAGE: Sets the model matrix associated with this entity
+	USAGE: Sets the model matrix associated with this entity, the matrix is kept as it is and
+		split into position, orientation and scale; prefer SetTransform when those are known
 	ARGUMENTS: matrix4 a_m4ToWorld -> model matrix to set
 	OUTPUT: ---
 	*/
 	void SetModelMatrix(matrix4 a_m4ToWorld);
 	/*
+	USAGE: Sets the position, orientation and scale of this entity, the model matrix is made
+		from them the next time it is needed
+	ARGUMENTS:
+	-	vector3 a_v3Position -> position to set
+	-	quaternion a_qOrientation -> orientation to set
+	-	vector3 a_v3Scale -> scale to set
+	OUTPUT: ---
+	*/
+	void SetTransform(vector3 a_v3Position, quaternion a_qOrientation, vector3 a_v3Scale);
+	/*
+	USAGE: Sets the orientation of this entity
+	ARGUMENTS: quaternion a_qOrientation -> orientation to set
+	OUTPUT: ---
+	*/
+	void SetOrientation(quaternion a_qOrientation);
+	/*
+	USAGE: Gets the orientation of this entity
+	ARGUMENTS: ---
+	OUTPUT: orientation
+	*/
+	quaternion GetOrientation(void);
+	/*
+	USAGE: Sets the scale of this entity and the size of its solver
+	ARGUMENTS: vector3 a_v3Scale -> scale to set
+	OUTPUT: ---
+	*/
+	void SetScale(vector3 a_v3Scale);
+	/*
+	USAGE: Gets the scale of this entity
+	ARGUMENTS: ---
+	OUTPUT: scale
+	*/
+	vector3 GetScale(void);
+	/*
 	USAGE: Gets the model associated with this entity
 	ARGUMENTS: ---
 	OUTPUT: Model
@@ -102,6 +160,14 @@ public:
 	*/
 	RigidBody* GetRigidBody(void);
 	/*
+	USAGE: Remakes the rigid body once the model it was made for finished loading; it reads the
+		model, so it runs on the thread that builds the models and no rigid body may point to the
+		old one afterwards
+	ARGUMENTS: ---
+	OUTPUT: was the rigid body remade?
+	*/
+	bool RefreshRigidBody(void);
+	/*
 	USAGE: Will reply to the question, is the Entity Initialized?
 	ARGUMENTS: ---
 	OUTPUT: initialized?
@@ -114,6 +180,20 @@ public:
 	*/
 	void AddToRenderList(bool a_bDrawRigidBody = false);
 	/*
+	USAGE: Copies what AddToRenderList would draw right now
+	ARGUMENTS: RenderState& a_State -> [out] state of the entity
+	OUTPUT: false if the entity is not in memory, nothing would be drawn
+	*/
+	bool GetRenderState(RenderState& a_State);
+	/*
+	USAGE: Adds an entity to the render list from a state copied before
+	ARGUMENTS:
+	-	RenderState const& a_State -> state copied with GetRenderState
+	-	bool a_bDrawRigidBody = false -> draw the rigid body?
+	OUTPUT: ---
+	*/
+	static void AddToRenderList(RenderState const& a_State, bool a_bDrawRigidBody = false);
+	/*
 	USAGE: Tells if this entity is colliding with the incoming one
 	ARGUMENTS: Entity* const other -> inspected entity
 	OUTPUT: are they colliding?
@@ -126,6 +206,12 @@ public:
 	*/
 	static Entity* GetEntity(String a_sUniqueID);
 	/*
+	USAGE: Gets the Entity specified by the Name Table handle of its unique ID, nullptr if not exists
+	ARGUMENTS: uint a_uUniqueID -> handle of the unique ID of the queried entity
+	OUTPUT: Entity specified by unique ID, nullptr if not exists
+	*/
+	static Entity* GetEntity(uint a_uUniqueID);
+	/*
 	USAGE: Will generate a unique id based on the name provided
 	ARGUMENTS: String& a_sUniqueID -> desired name
 	OUTPUT: will output though the argument
@@ -138,12 +224,31 @@ public:
 	*/
 	String GetUniqueID(void);
 	/*
+	USAGE: Gets the Name Table handle of the Unique ID of this model
+	ARGUMENTS: ---
+	OUTPUT: handle, NameTable::INVALID if the entity was not initialized
+	*/
+	uint GetUniqueIDHandle(void);
+	/*
 	USAGE: Sets the visibility of the axis of this Entity
 	ARGUMENTS: bool a_bSetAxis = true -> axis visible?
 	OUTPUT: ---
 	*/
 	void SetAxisVisible(bool a_bSetAxis = true);
 	/*
+	USAGE: Sets whether the rigid body of this Entity hides what is behind it when the Entity
+		Manager culls occluded entities, only for entities that fill their rigid body like boxes
+	ARGUMENTS: bool a_bOccluder = true -> occluder?
+	OUTPUT: ---
+	*/
+	void SetOccluder(bool a_bOccluder = true);
+	/*
+	USAGE: Asks if the rigid body of this Entity hides what is behind it
+	ARGUMENTS: ---
+	OUTPUT: occluder?
+	*/
+	bool IsOccluder(void);
+	/*
 	USAGE: Will set a dimension to the Entity
 	ARGUMENTS: uint a_uDimension -> dimension to set
 	OUTPUT: ---
@@ -229,17 +334,30 @@ public:
 	*/
 	void ApplyForce(vector3 a_v3Force);
 	/*
-	USAGE: Sets the position of the solver
+	USAGE: Sets the position of the entity and its solver
 	ARGUMENTS: vector3 a_v3Position -> position to set
 	OUTPUT: ---
 	*/
 	void SetPosition(vector3 a_v3Position);
 	/*
-	USAGE: Gets the position of the solver
+	USAGE: Gets the position of the entity
 	ARGUMENTS: ---
-	OUTPUT: position of the solver
+	OUTPUT: position of the entity
 	*/
 	vector3 GetPosition(void);
+	/*
+	USAGE: Asks if the entity moved after a move count was read
+	ARGUMENTS: uint a_uMoveCount -> value of GetMoveCount read earlier
+	OUTPUT: moved since then?
+	*/
+	bool HasMovedSince(uint a_uMoveCount);
+	/*
+	USAGE: Gets the number of times any entity was moved, the same count later means no entity
+		moved in between
+	ARGUMENTS: ---
+	OUTPUT: count
+	*/
+	static uint GetMoveCount(void);
 
 	/*
 	USAGE: Sets the velocity of the solver
@@ -293,6 +411,20 @@ private:
 	Output: ---
 	*/
 	void Init(void);
+	/*
+	Usage: Remakes the model matrix from the position, orientation and scale if they changed
+		and moves the rigid body with it
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateMatrix(void);
+	/*
+	Usage: Stamps the entity with a new move count, whatever keeps track of where it is finds it
+		moved from then on
+	Arguments: ---
+	Output: ---
+	*/
+	void MarkMoved(void);
 };//class
 
   //EXPIMP_TEMPLATE template class BTXDLL std::vector<Entity>;
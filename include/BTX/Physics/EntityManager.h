@@ -7,17 +7,74 @@ Update: 2021/02
 #define __ENTITYMANAGER_H_
 
 #include "BTX\Physics\Entity.h"
+#include "BTX\Camera\OcclusionBuffer.h"
 
 namespace BTX
 {
 
+//Entity hit by a ray
+struct RayHit
+{
+	int nEntity = -1; //index of the entity in the manager, -1 if nothing was hit
+	float fDistance = 0.0f; //distance along the ray to the hit
+	vector3 v3Point = ZERO_V3; //point hit in global space
+	vector3 v3Normal = ZERO_V3; //normal of the face hit in global space
+};
+
+//Ray of a batched cast
+struct RayQuery
+{
+	vector3 v3Origin = ZERO_V3; //start of the ray
+	vector3 v3Direction = AXIS_Z; //direction of the ray, does not need to be normalized
+	float fMaxDistance = std::numeric_limits<float>::max(); //hits further than this are ignored
+	int nIgnore = -1; //index of an entity the ray goes through, like the one casting it
+};
+
 //System Class
 class BTXDLL EntityManager
 {
 	typedef Entity* PEntity; //Entity Pointer
 	uint m_uEntityCount = 0; //number of elements in the list
+	uint m_uEntityCapacity = 0; //number of elements the array has room for
 	PEntity* m_mEntityArray = nullptr; //array of Entity pointers
+	NameMap<uint> m_IndexMap; //index in the array by the name handle of the unique ID
 	static EntityManager* m_pInstance; // Singleton pointer
+
+	//Node of the bounding volume hierarchy used to cull groups of entities
+	struct CullNode
+	{
+		vector3 v3Min = vector3(0.0f); //minimum corner of the node in world space
+		vector3 v3Max = vector3(0.0f); //maximum corner of the node in world space
+		uint uFirst = 0; //first entry of the node in m_lCullEntity
+		uint uCount = 0; //number of entries under the node
+		uint uRight = 0; //index of the second child, 0 for leaves (the first child is the next node)
+		bool bMoved = false; //did something under the node move since the last refit? only set during one
+	};
+	bool m_bFrustumCulling = true; //Skip the entities outside of the camera frustum when adding all?
+	bool m_bHierarchicalCulling = false; //Cull groups of entities with the hierarchy before testing them?
+	bool m_bCullTreeDirty = true; //Does the hierarchy need to be rebuilt?
+	uint m_uVisibleCount = 0; //Entities added to the render list by the last culled submission
+	uint m_uCulledCount = 0; //Entities skipped by the last culled submission
+	bool m_bOcclusionCulling = false; //Skip the entities hidden behind the occluders when culling?
+	uint m_uOccludedCount = 0; //Entities skipped by the last culled submission for being hidden
+	OcclusionBuffer m_Occlusion; //Depth of the occluders seen by the camera
+	std::vector<CullNode> m_lCullNode; //hierarchy nodes in depth first order
+	std::vector<uint> m_lCullEntity; //entity indices grouped by leaf
+	std::vector<uint> m_lCullLeaf; //leaf node holding each entity, by entity index
+	uint m_uCullMoveCount = 0; //Entity::GetMoveCount when the hierarchy was last fit
+	std::vector<uint> m_lMoved; //entities moved since the last update started, made by GetMovedEntities
+	uint m_uMovedFrom = 0; //Entity::GetMoveCount when the last update started
+	uint m_uMovedListed = 0; //Entity::GetMoveCount when m_lMoved was made
+	bool m_bMovedListed = false; //Is m_lMoved the list for m_uMovedFrom and m_uMovedListed?
+
+	//Render state of every entity twice: the update writes one copy while the render lists
+	//are built from the other, SwapRenderState exchanges them
+	std::vector<Entity::RenderState> m_lRenderState[2];
+	uint m_uRenderRead = 0; //copy the render lists are built from
+	std::future<void> m_Update; //update running on a worker since BeginUpdate
+	std::vector<uint> m_lQueryStack; //nodes left to visit by a query, kept between queries
+	std::vector<uint> m_lVisible; //entities let through by the last culled submission, kept between frames
+	std::vector<RigidBody::DrawState> m_lBodyState; //rigid bodies of a submission, drawn together at its end
 public:
 	/*
 	Usage: Gets the singleton pointer
@@ -37,6 +94,13 @@ public:
 	OUTPUT: index from the list of entities, -1 if not found
 	*/
 	int GetEntityIndex(String a_sUniqueID);
+	/*
+	USAGE: Gets the index (from the list of entities) of the entity specified by the Name Table
+		handle of its UniqueID, resolving the name once and keeping the handle skips hashing it
+	ARGUMENTS: uint a_uUniqueID -> handle of the unique ID
+	OUTPUT: index from the list of entities, -1 if not found
+	*/
+	int GetEntityIndex(uint a_uUniqueID);
 
 	/*
 	USAGE: Will add an entry to the list of entities
@@ -60,9 +124,10 @@ public:
 	ARGUMENTS:
 	-	String a_sFileName -> Name of the model to load
 	-	String a_sUniqueID -> Name wanted as identifier, if not available will generate one
+	-	bool a_bAsync -> Load the model in the background instead of stalling the frame?
 	OUTPUT: ---
 	*/
-	String AddEntity(String a_sFileName, String a_sUniqueID = "NA");
+	String AddEntity(String a_sFileName, String a_sUniqueID = "NA", bool a_bAsync = false);
 	/*
 	USAGE: Deletes the Entity Specified by unique ID and removes it from the list
 	ARGUMENTS: uint a_uIndex -> index of the queried entry, if < 0 asks for the last one added
@@ -88,12 +153,21 @@ public:
 	*/
 	Entity* GetEntity(uint a_uIndex = -1);
 	/*
-	USAGE: Will update the Entity manager
+	USAGE: Will update the Entity manager, ending the update started by BeginUpdate first
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
 	void Update(void);
 	/*
+	USAGE: Gets the entities moved since the last update started, by the solver in that update or
+		by the application after it; structures that keep the entities by where they are, like an
+		octree, only need to place these again, right before the next update checks collisions.
+		The list is made once and kept until something moves or the next update starts
+	ARGUMENTS: ---
+	OUTPUT: indices of the entities, each once
+	*/
+	std::vector<uint> const& GetMovedEntities(void);
+	/*
 	USAGE: Gets the model associated with this entity
 	ARGUMENTS: uint a_uIndex = -1 -> index in the list of entities; if less than 0 it will add it to the last in the list
 	OUTPUT: Model
@@ -178,6 +252,202 @@ public:
 	*/
 	void AddEntityToRenderList(String a_sUniqueID, bool a_bRigidBody = false);
 	/*
+	USAGE: Sets whether adding all the entities to the render list skips the ones outside
+		of the active camera's frustum
+	ARGUMENTS: bool a_bCull = true -> cull the entities?
+	OUTPUT: ---
+	*/
+	void SetFrustumCulling(bool a_bCull = true);
+	/*
+	USAGE: Asks if adding all the entities to the render list skips the ones outside of the frustum
+	ARGUMENTS: ---
+	OUTPUT: frustum culling enabled?
+	*/
+	bool GetFrustumCulling(void);
+	/*
+	USAGE: Sets whether the frustum culling tests groups of nearby entities first so whole
+		groups can be accepted or rejected with a single test
+	ARGUMENTS: bool a_bHierarchical = true -> use the hierarchy?
+	OUTPUT: ---
+	*/
+	void SetHierarchicalCulling(bool a_bHierarchical = true);
+	/*
+	USAGE: Asks if the frustum culling is using the hierarchy
+	ARGUMENTS: ---
+	OUTPUT: hierarchical culling enabled?
+	*/
+	bool GetHierarchicalCulling(void);
+	/*
+	USAGE: Gets the number of entities added by the last culled submission of all the entities
+	ARGUMENTS: ---
+	OUTPUT: visible entities
+	*/
+	uint GetVisibleCount(void);
+	/*
+	USAGE: Gets the number of entities skipped by the last culled submission of all the entities
+	ARGUMENTS: ---
+	OUTPUT: culled entities
+	*/
+	uint GetCulledCount(void);
+	/*
+	USAGE: Gets the entities a frustum lets through, the same ones adding all the entities to the
+		render list would add with it; uses the hierarchy when it is enabled and the occluders as
+		the active camera sees them when occlusion culling is
+	ARGUMENTS:
+	-	Frustum& a_Frustum -> frustum to cull with
+	-	std::vector<uint>& a_lOutput -> [out] indices of the entities, in the order they would be added
+	OUTPUT: ---
+	*/
+	void GetVisibleEntities(Frustum& a_Frustum, std::vector<uint>& a_lOutput);
+	/*
+	USAGE: Sets whether the frustum culling also skips the entities hidden behind the entities
+		marked as occluders, the occluders are drawn into a small depth buffer on the CPU first
+	ARGUMENTS: bool a_bCull = true -> cull the hidden entities?
+	OUTPUT: ---
+	*/
+	void SetOcclusionCulling(bool a_bCull = true);
+	/*
+	USAGE: Asks if the frustum culling also skips the hidden entities
+	ARGUMENTS: ---
+	OUTPUT: occlusion culling enabled?
+	*/
+	bool GetOcclusionCulling(void);
+	/*
+	USAGE: Gets the number of entities inside of the frustum the last culled submission skipped
+		for being hidden, they are counted in GetCulledCount too
+	ARGUMENTS: ---
+	OUTPUT: hidden entities
+	*/
+	uint GetOccludedCount(void);
+	/*
+	USAGE: Gets the depth buffer the occluders are drawn into, to change its size or threads
+	ARGUMENTS: ---
+	OUTPUT: occlusion buffer
+	*/
+	OcclusionBuffer* GetOcclusionBuffer(void);
+	/*
+	USAGE: Sets whether the specified entity hides what is behind it
+	ARGUMENTS:
+	-	bool a_bOccluder -> occluder?
+	-	String a_sUniqueID -> ID of the Entity
+	OUTPUT: ---
+	*/
+	void SetOccluder(bool a_bOccluder, String a_sUniqueID);
+	/*
+	USAGE: Sets whether the specified entity hides what is behind it
+	ARGUMENTS:
+	-	bool a_bOccluder = true -> occluder?
+	-	uint a_uIndex = -1 -> ID of the Entity if < 0 last object added
+	OUTPUT: ---
+	*/
+	void SetOccluder(bool a_bOccluder = true, uint a_uIndex = -1);
+	/*
+	USAGE: Copies the render state of every entity into the copy that is not being read, the
+		update started by BeginUpdate does this on its worker when it is done
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void StoreRenderState(void);
+	/*
+	USAGE: Makes the copy written by the last StoreRenderState the one the render lists are
+		built from
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void SwapRenderState(void);
+	/*
+	USAGE: Adds every entity to the render list from the stored render state instead of the
+		entities, skipping the ones outside of the frustum if frustum culling is on; it can run
+		while the update started by BeginUpdate moves the entities
+	ARGUMENTS: bool a_bRigidBody = false -> draw rigid body?
+	OUTPUT: ---
+	*/
+	void AddRenderStateToRenderList(bool a_bRigidBody = false);
+	/*
+	USAGE: Starts Update and StoreRenderState on a worker thread. The rigid bodies of the models
+		that finished loading are remade here first, and again in EndUpdate, as the models are
+		built on this thread by ModelManager::Render and the worker must not read them. Until
+		EndUpdate returns the entities belong to the worker: the frame is built with
+		AddRenderStateToRenderList and nothing may change or read the entities; adding or
+		removing entities, culling them, listing what moved and the queries wait for it
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void BeginUpdate(void);
+	/*
+	USAGE: Waits for the update started by BeginUpdate and swaps the render state so the next
+		frame draws its result, does nothing if no update is running
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void EndUpdate(void);
+	/*
+	USAGE: Asks if an update started by BeginUpdate has not been ended yet
+	ARGUMENTS: ---
+	OUTPUT: updating?
+	*/
+	bool IsUpdating(void);
+	/*
+	USAGE: Finds the closest entity a ray hits, the ray is tested against the culling hierarchy
+		first and against the oriented boxes of the rigid bodies it reaches; nodes further than
+		the closest hit so far are skipped
+	ARGUMENTS:
+	-	vector3 a_v3Origin -> start of the ray
+	-	vector3 a_v3Direction -> direction of the ray, does not need to be normalized
+	-	RayHit& a_Hit -> [out] closest hit
+	-	float a_fMaxDistance = max float -> hits further than this are ignored
+	-	int a_nIgnore = -1 -> index of an entity the ray goes through
+	OUTPUT: was anything hit?
+	*/
+	bool CastRay(vector3 a_v3Origin, vector3 a_v3Direction, RayHit& a_Hit,
+		float a_fMaxDistance = std::numeric_limits<float>::max(), int a_nIgnore = -1);
+	/*
+	USAGE: Finds the entity closest to the start of a segment that the segment hits
+	ARGUMENTS:
+	-	vector3 a_v3Start -> start of the segment
+	-	vector3 a_v3End -> end of the segment
+	-	RayHit& a_Hit -> [out] closest hit
+	-	int a_nIgnore = -1 -> index of an entity the segment goes through
+	OUTPUT: was anything hit?
+	*/
+	bool CastSegment(vector3 a_v3Start, vector3 a_v3End, RayHit& a_Hit, int a_nIgnore = -1);
+	/*
+	USAGE: Casts many rays at once, the hierarchy is fit once for all of them
+	ARGUMENTS:
+	-	std::vector<RayQuery> const& a_lRay -> rays to cast
+	-	std::vector<RayHit>& a_lHit -> [out] hit of each ray, nEntity is -1 for the ones that missed
+	-	bool a_bAnyHit = false -> stop each ray at the first entity it hits instead of the
+		closest one, enough to know if something is in the way like a line of sight check
+	OUTPUT: number of rays that hit something
+	*/
+	uint CastRays(std::vector<RayQuery> const& a_lRay, std::vector<RayHit>& a_lHit, bool a_bAnyHit = false);
+	/*
+	USAGE: Casts a ray from the active camera through a point of the window
+	ARGUMENTS:
+	-	vector2 a_v2Screen -> point in pixels from the top left corner of the window, like the mouse
+	-	RayHit& a_Hit -> [out] closest hit
+	OUTPUT: was anything hit?
+	*/
+	bool PickEntity(vector2 a_v2Screen, RayHit& a_Hit);
+	/*
+	USAGE: Finds the entities whose global boxes overlap a sphere
+	ARGUMENTS:
+	-	vector3 a_v3Center -> center of the sphere
+	-	float a_fRadius -> radius of the sphere
+	-	std::vector<uint>& a_lEntity -> [out] indices of the entities found, cleared first
+	OUTPUT: number of entities found
+	*/
+	uint OverlapSphere(vector3 a_v3Center, float a_fRadius, std::vector<uint>& a_lEntity);
+	/*
+	USAGE: Finds the entities whose global boxes overlap an axis aligned box
+	ARGUMENTS:
+	-	vector3 a_v3Min -> minimum corner of the box
+	-	vector3 a_v3Max -> maximum corner of the box
+	-	std::vector<uint>& a_lEntity -> [out] indices of the entities found, cleared first
+	OUTPUT: number of entities found
+	*/
+	uint OverlapBox(vector3 a_v3Min, vector3 a_v3Max, std::vector<uint>& a_lEntity);
+	/*
 	USAGE: Will set a dimension to the Entity
 	ARGUMENTS:
 	-	uint a_uIndex -> index (from the list) of the entity queried if < 0 will use the last one
@@ -356,6 +626,20 @@ private:
 	*/
 	~EntityManager(void);
 	/*
+	Usage: remakes the rigid bodies of the entities whose model finished loading, on the thread
+		that builds the models
+	Arguments: ---
+	Output: ---
+	*/
+	void RefreshRigidBodies(void);
+	/*
+	Usage: clears and checks the collisions and updates every entity, what Update and the
+		worker started by BeginUpdate run
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateEntities(void);
+	/*
 	Usage: releases the allocated member pointers
 	Arguments: ---
 	Output: ---
@@ -367,6 +651,98 @@ private:
 	Output: ---
 	*/
 	void Init(void);
+	/*
+	Usage: adds all the entities inside of the frustum to the render list
+	Arguments:
+	-	Frustum& a_Frustum -> frustum of the camera
+	-	bool a_bRigidBody -> draw rigid body?
+	Output: ---
+	*/
+	void AddVisibleToRenderList(Frustum& a_Frustum, bool a_bRigidBody);
+	/*
+	Usage: adds an entity to the render list, its rigid body is kept to be drawn with the others
+		by AddBodiesToRenderList
+	Arguments:
+	-	uint a_uIndex -> index of the entity
+	-	bool a_bRigidBody -> draw rigid body?
+	Output: ---
+	*/
+	void AddIndexToRenderList(uint a_uIndex, bool a_bRigidBody);
+	/*
+	Usage: sends the rigid bodies kept by the submission to the bounds batch in one call
+	Arguments: ---
+	Output: ---
+	*/
+	void AddBodiesToRenderList(void);
+	/*
+	Usage: finds the entities inside of the frustum and not hidden, counts the visible, culled and
+		occluded ones
+	Arguments:
+	-	Frustum& a_Frustum -> frustum of the camera
+	-	std::vector<uint>& a_lVisible -> [out] indices of the entities that can be seen
+	Output: ---
+	*/
+	void CullEntities(Frustum& a_Frustum, std::vector<uint>& a_lVisible);
+	/*
+	Usage: draws the occluders inside of the frustum into the occlusion buffer
+	Arguments: Frustum& a_Frustum -> frustum of the camera
+	Output: ---
+	*/
+	void RasterizeOccluders(Frustum& a_Frustum);
+	/*
+	Usage: asks if an entity inside of the frustum is hidden behind the occluders
+	Arguments:
+	-	Entity* a_pEntity -> entity
+	-	RigidBody* a_pRigidBody -> rigid body of the entity
+	Output: hidden? never for the occluders themselves or when occlusion culling is off
+	*/
+	bool IsOccluded(Entity* a_pEntity, RigidBody* a_pRigidBody);
+	/*
+	Usage: rebuilds the culling hierarchy from the current bounds of the entities
+	Arguments: ---
+	Output: ---
+	*/
+	void BuildCullTree(void);
+	/*
+	Usage: recursively splits a range of m_lCullEntity into nodes
+	Arguments:
+	-	uint a_uFirst -> first entry of the range
+	-	uint a_uCount -> number of entries in the range
+	Output: ---
+	*/
+	void BuildCullNode(uint a_uFirst, uint a_uCount);
+	/*
+	Usage: fits the nodes of the culling hierarchy to the current bounds of the entities,
+		only the branches with rigid bodies that moved are visited
+	Arguments: ---
+	Output: ---
+	*/
+	void RefitCullTree(void);
+	/*
+	Usage: builds or refits the culling hierarchy so the queries see where the entities are now
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateQueryTree(void);
+	/*
+	Usage: walks the culling hierarchy with a ray, nearest nodes first
+	Arguments:
+	-	RayQuery const& a_Ray -> ray, its direction normalized
+	-	bool a_bAnyHit -> stop at the first hit?
+	-	std::vector<uint>& a_lStack -> nodes left to visit, reused between rays
+	-	RayHit& a_Hit -> [out] hit
+	Output: was anything hit?
+	*/
+	bool TraverseRay(RayQuery const& a_Ray, bool a_bAnyHit, std::vector<uint>& a_lStack, RayHit& a_Hit);
+	/*
+	Usage: walks the culling hierarchy collecting the entities whose boxes pass a test
+	Arguments:
+	-	Test a_Overlap -> test of a box given as minimum and maximum corners
+	-	std::vector<uint>& a_lEntity -> [out] indices of the entities found
+	Output: number of entities found
+	*/
+	template <class Test>
+	uint Overlap(Test a_Overlap, std::vector<uint>& a_lEntity);
 };//class
 
 } //namespace Simplex
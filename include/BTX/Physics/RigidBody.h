@@ -18,6 +18,20 @@ class BTXDLL RigidBody
 public:
 	typedef RigidBody* PRigidBody; //Entity Pointer
 
+	//Volumes AddToRenderList draws, copied out so they can be drawn while the body keeps moving
+	struct DrawState
+	{
+		bool bSphere = false; //draw the bounding sphere?
+		bool bOBB = false; //draw the oriented box?
+		bool bARBB = false; //draw the axis realigned box?
+		vector3 v3Center = ZERO_V3; //center in global space
+		float fRadius = 0.0f; //radius of the sphere in global space
+		vector3 v3OBBExtent = ZERO_V3; //half size of the oriented box in global space
+		quaternion qOBBOrientation; //orientation of the oriented box
+		vector3 v3OBBColor = C_WHITE; //color of the oriented box, shows if it collides
+		vector3 v3ARBBExtent = ZERO_V3; //half size of the axis realigned box
+	};
+
 protected:
 	ModelManager* m_pModelMngr = nullptr; //for displaying the Rigid Body
 
@@ -26,6 +40,7 @@ protected:
 	bool m_bVisibleARBB = true; //Visibility of axis (Re)aligned bounding box
 
 	float m_fRadius = 0.0f; //Radius
+	float m_fRadiusG = 0.0f; //Radius in global space, scaled by the model matrix
 
 	vector3 m_v3ColorColliding = C_RED; //Color when colliding
 	vector3 m_v3ColorNotColliding = C_WHITE; //Color when not colliding
@@ -43,6 +58,7 @@ protected:
 	vector3 m_v3ARBBSize = ZERO_V3;// size of the Axis (Re)Alligned Bounding Box
 
 	matrix4 m_m4ToWorld = IDENTITY_M4; //Matrix that will take us from local to world coordinate
+	bool m_bGlobalDirty = true; //Do the global center, box and radius need to be updated from the matrix?
 
 	uint m_uCollidingCount = 0; //size of the colliding set
 	PRigidBody* m_CollidingArray = nullptr; //array of rigid bodies this one is colliding with
@@ -85,6 +101,27 @@ public:
 	OUTPUT: ---
 	*/
 	void AddToRenderList(void);
+	/*
+	USAGE: Gets the volumes AddToRenderList would draw right now
+	ARGUMENTS: ---
+	OUTPUT: volumes in global space
+	*/
+	DrawState GetDrawState(void);
+	/*
+	USAGE: Draws volumes taken before with GetDrawState
+	ARGUMENTS: DrawState const& a_State -> volumes to draw
+	OUTPUT: ---
+	*/
+	static void AddToRenderList(DrawState const& a_State);
+	/*
+	USAGE: Draws a set of volumes taken before with GetDrawState, each kind of volume goes to the
+		bounds batch in one call; called from the thread that renders
+	ARGUMENTS:
+	-	uint a_uCount -> number of states
+	-	DrawState const* a_pState -> volumes to draw
+	OUTPUT: ---
+	*/
+	static void AddToRenderList(uint a_uCount, DrawState const* a_pState);
 
 	/*
 	USAGE: Clears the colliding list
@@ -113,6 +150,17 @@ public:
 	OUTPUT: are they colliding?
 	*/
 	bool IsColliding(RigidBody* const other);
+	/*
+	USAGE: Intersects a ray with the oriented box of the rigid body
+	ARGUMENTS:
+	-	vector3 a_v3Origin -> start of the ray in global space
+	-	vector3 a_v3Direction -> normalized direction of the ray
+	-	float a_fMaxDistance -> hits further than this along the ray are ignored
+	-	float& a_fDistance -> [out] distance along the ray to the hit, 0 if it starts inside
+	-	vector3& a_v3Normal -> [out] normal of the face hit in global space
+	OUTPUT: does the ray hit the box?
+	*/
+	bool IsIntersectingRay(vector3 a_v3Origin, vector3 a_v3Direction, float a_fMaxDistance, float& a_fDistance, vector3& a_v3Normal);
 #pragma region Accessors
 	/*
 	Usage: Gets visibility of bounding sphere
@@ -157,6 +205,12 @@ public:
 	*/
 	float GetRadius(void);
 	/*
+	Usage: Gets radius in global space, scaled by the model matrix
+	Arguments: ---
+	Output: radius
+	*/
+	float GetRadiusGlobal(void);
+	/*
 	Usage: Gets the color when colliding
 	Arguments: ---
 	Output: color
@@ -255,6 +309,12 @@ public:
 	bool IsInCollidingArray(RigidBody* a_pEntry);
 	
 private:
+	/*
+	Usage: Updates the global center, box and radius from the model matrix if it changed
+	Arguments: ---
+	Output: ---
+	*/
+	void UpdateGlobal(void);
 	/*
 	Usage: Deallocates member fields
 	Arguments: ---
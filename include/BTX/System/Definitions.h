@@ -24,6 +24,11 @@ Update: 2021/02
 #include <map>
 #include <set>
 #include <deque>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <mutex>
+#include <chrono>
 #include <locale>
 
 // Include the GL extension Wrangler
@@ -11,6 +11,21 @@ Update: 2021/02
 namespace BTX
 {
 
+//Line of a file read in buffered mode, points inside of the buffer of the reader so it is
+//only valid until the reader opens another file or is closed; it is not null terminated
+struct BTXDLL LineView
+{
+	const char* szData = nullptr; //First character of the line
+	uint uLength = 0; //Characters in the line
+
+	/*
+	USAGE: Copies the line into a string
+	ARGUMENTS: ---
+	OUTPUT: copy of the line
+	*/
+	String ToString(void) const { return String(szData, uLength); }
+};
+
 //FileReader class
 class BTXDLL FileReader
 {
@@ -18,6 +33,9 @@ class BTXDLL FileReader
 	FILE* m_pFile; //File pointer
 	std::ifstream m_iStream;
 	std::ofstream m_oStream;
+	bool m_bBuffered = false; //Was the file read into m_lBuffer instead of opened as a stream?
+	std::vector<char> m_lBuffer; //Whole file followed by a null, only in buffered mode
+	size_t m_uCursor = 0; //Next byte of m_lBuffer to read
 
 public:
 	String m_sLine = ""; //Line of file
@@ -58,7 +76,7 @@ public:
 	ARGUMENTS: ---
 	OUTPUT: ---
 	*/
-	void Rewind(void) const;
+	void Rewind(void);
 	/*
 	USAGE: Reads Files and allocates it on the string
 	ARGUMENTS:
@@ -84,6 +102,20 @@ public:
 	*/
 	eBTX_OUTPUT ReadBinaryFile(String a_sFileName);
 	/*
+	USAGE: Reads the whole file into memory with a single read, the lines and the typed reads
+		that follow come from memory instead of the stream; it works for text and binary files
+	ARGUMENTS:
+		String a_sFileName -> File to read
+	OUTPUT: OUT_ERR_FILE_MISSING if it could not be opened or read
+	*/
+	eBTX_OUTPUT ReadFileBuffered(String a_sFileName);
+	/*
+	USAGE: Asks if the file was read into memory by ReadFileBuffered
+	ARGUMENTS: ---
+	OUTPUT: buffered?
+	*/
+	bool IsBuffered(void);
+	/*
 	USAGE: closes the file
 	ARGUMENTS: ---
 	OUTPUT: ---
@@ -162,6 +194,22 @@ public:
 	*/
 	String ReadString(void);
 	/*
+	USAGE: Writes a block of memory into the binary file in a single call
+	ARGUMENTS:
+		const void* a_pData -> start of the block to write
+		uint a_uSize -> size of the block in bytes
+	OUTPUT: ---
+	*/
+	void WriteBuffer(const void* a_pData, uint a_uSize);
+	/*
+	USAGE: Reads a block of memory from the binary file in a single call
+	ARGUMENTS:
+		void* a_pData -> output; memory to fill, needs to hold at least a_uSize bytes
+		uint a_uSize -> size of the block in bytes
+	OUTPUT: true if the whole block was read
+	*/
+	bool ReadBuffer(void* a_pData, uint a_uSize);
+	/*
 	USAGE: Removes all tabs from the string (it makes regular spaces)
 	ARGUMENTS:
 	OUTPUT:
@@ -175,6 +223,16 @@ public:
 	*/
 	eBTX_OUTPUT ReadNextLine(bool a_bSkipComments = true);
 	/*
+	USAGE: reads a line of a file opened with ReadFileBuffered without copying it, the blanks at
+		its beginning and the carriage return at its end are left out
+	ARGUMENTS:
+		LineView& a_Line -> output; the line, untouched when done
+		bool a_bSkipComments = true -> skip empty lines and lines that start with # or //
+	OUTPUT: will return BTO_OUTPUT::OUT_DONE when done
+		OR OUT_RUNNING when running, OUT_ERR_NOT_INITIALIZED if the file is not buffered
+	*/
+	eBTX_OUTPUT ReadNextLine(LineView& a_Line, bool a_bSkipComments = true);
+	/*
 	USAGE: Removes the blank spaces of the line
 		Modified by AndrewWilkinson88@gmail.com
 	ARGUMENTS:
@@ -249,6 +307,24 @@ public:
 		bool -> File exists?
 	*/
 	static bool FileExists(String a_sFileName);
+	/*
+	USAGE: Gets the size and the last write time of a file, used to tell if a file changed
+	ARGUMENTS:
+		String a_sFileName -> File to query
+		unsigned long long* a_pSize -> output; size of the file in bytes
+		unsigned long long* a_pTime -> output; last time the file was written
+	OUTPUT:
+		bool -> File exists?
+	*/
+	static bool GetFileStamp(String a_sFileName, unsigned long long* a_pSize, unsigned long long* a_pTime);
+	/*
+	USAGE: Asks if a line is skipped when comments are, empty or starting with # or //
+	ARGUMENTS:
+		const char* a_szLine -> line without the blanks at its beginning
+		uint a_uLength -> characters in the line
+	OUTPUT: is it a comment?
+	*/
+	static bool IsComment(const char* a_szLine, uint a_uLength);
 private:
 	/*
 	USAGE: Initializes the variables of the object
@@ -256,6 +332,14 @@ private:
 	OUTPUT: ---
 	*/
 	void Init(void);
+	/*
+	USAGE: Copies bytes from the buffer of a file opened with ReadFileBuffered
+	ARGUMENTS:
+		void* a_pData -> output; memory to fill, needs to hold at least a_uSize bytes
+		size_t a_uSize -> bytes to copy
+	OUTPUT: true if there were a_uSize bytes left, nothing is copied otherwise
+	*/
+	bool CopyFromBuffer(void* a_pData, size_t a_uSize);
 };
 
 EXPIMP_TEMPLATE template class BTXDLL std::vector<FileReader>;
@@ -0,0 +1,289 @@
+#ifndef __NAMETABLE_H_
+#define __NAMETABLE_H_
+
+#include "BTX\System\Definitions.h"
+
+namespace BTX
+{
+	/*
+	Gives every name a small integer handle, the same name always gets the same handle for as
+	long as the program runs. The hash of each name is computed once when it is interned, the
+	names are found again with open addressing on those hashes so a lookup compares at most a
+	couple of strings. The managers keep their tables by handle, a name used every frame can
+	be resolved once and looked up by handle afterwards.
+	Like the managers that use it, it is meant to be used from the main thread.
+	*/
+	//NameTable Singleton
+	class BTXDLL NameTable
+	{
+		static NameTable* m_pInstance; //Singleton pointer
+
+		std::vector<String> m_lName; //Name of each handle
+		std::vector<unsigned long long> m_lHash; //Hash of each handle
+		std::vector<uint> m_lSlot; //Open addressing table of handles, a power of two in size
+		uint m_uMask = 0; //Size of m_lSlot minus one
+
+	public:
+		enum : uint { INVALID = 0xFFFFFFFF }; //Handle of a name that was not interned, an enum so it needs no definition
+
+		/*
+		USAGE: Gets/Constructs the singleton pointer
+		ARGUMENTS: ---
+		OUTPUT: singleton pointer
+		*/
+		static NameTable* GetInstance(void);
+		/*
+		USAGE: Destroys the singleton, the handles given before are no longer valid
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		static void ReleaseInstance(void);
+
+		/*
+		USAGE: Hashes a name the way the table does (FNV-1a)
+		ARGUMENTS: String const& a_sName -> name to hash
+		OUTPUT: hash
+		*/
+		static unsigned long long Hash(String const& a_sName);
+
+		/*
+		USAGE: Gets the handle of a name, the name is added if it was not interned before
+		ARGUMENTS: String const& a_sName -> name
+		OUTPUT: handle
+		*/
+		uint Intern(String const& a_sName);
+
+		/*
+		USAGE: Gets the handle of a name without adding it
+		ARGUMENTS: String const& a_sName -> name
+		OUTPUT: handle, INVALID if the name was never interned
+		*/
+		uint Find(String const& a_sName);
+
+		/*
+		USAGE: Gets the name of a handle
+		ARGUMENTS: uint a_uHandle -> handle
+		OUTPUT: name, empty if the handle is not valid
+		*/
+		String const& GetName(uint a_uHandle);
+
+		/*
+		USAGE: Gets the hash of the name of a handle
+		ARGUMENTS: uint a_uHandle -> handle
+		OUTPUT: hash, 0 if the handle is not valid
+		*/
+		unsigned long long GetHash(uint a_uHandle);
+
+		/*
+		USAGE: Gets the number of names interned
+		ARGUMENTS: ---
+		OUTPUT: names
+		*/
+		uint GetCount(void);
+
+	private:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		NameTable(void);
+		/*
+		USAGE: Copy Constructor, the singleton is not copied
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		NameTable(NameTable const& other);
+		/*
+		USAGE: Copy Assignment Operator, the singleton is not copied
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		NameTable& operator=(NameTable const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~NameTable(void);
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Gets the slot that holds a name or the empty slot it would go in
+		ARGUMENTS:
+		-	String const& a_sName -> name
+		-	unsigned long long a_uHash -> hash of the name
+		OUTPUT: index in m_lSlot
+		*/
+		uint FindSlot(String const& a_sName, unsigned long long a_uHash);
+		/*
+		USAGE: Doubles the slots and places the handles again from their stored hashes
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Grow(void);
+	};
+
+	/*
+	Open addressing map from handles of the Name Table to values, the handles are spread
+	with Fibonacci hashing and probed linearly; erasing shifts the entries after it back so
+	no tombstones are left behind.
+	*/
+	//NameMap Class
+	template <class T>
+	class NameMap
+	{
+		std::vector<uint> m_lKey; //Handle of each slot, NameTable::INVALID if the slot is empty
+		std::vector<T> m_lValue; //Value of each slot
+		uint m_uCount = 0; //Slots in use
+		uint m_uShift = 32; //Bits dropped from the product to get a slot
+
+	public:
+		/*
+		USAGE: Looks for the value of a handle
+		ARGUMENTS: uint a_uKey -> handle
+		OUTPUT: pointer to the value, nullptr if the handle is not in the map
+		*/
+		T* Find(uint a_uKey)
+		{
+			if (m_uCount == 0 || a_uKey == NameTable::INVALID)
+				return nullptr;
+			uint uMask = static_cast<uint>(m_lKey.size()) - 1;
+			for (uint uSlot = Slot(a_uKey); ; uSlot = (uSlot + 1) & uMask)
+			{
+				if (m_lKey[uSlot] == a_uKey)
+					return &m_lValue[uSlot];
+				if (m_lKey[uSlot] == NameTable::INVALID)
+					return nullptr;
+			}
+		}
+		/*
+		USAGE: Sets the value of a handle, adding it if it is not in the map
+		ARGUMENTS:
+		-	uint a_uKey -> handle
+		-	T const& a_Value -> value
+		OUTPUT: ---
+		*/
+		void Set(uint a_uKey, T const& a_Value)
+		{
+			if (a_uKey == NameTable::INVALID)
+				return;
+			//keeps at least half of the slots empty
+			if (2 * (m_uCount + 1) > m_lKey.size())
+				Grow();
+			uint uMask = static_cast<uint>(m_lKey.size()) - 1;
+			uint uSlot = Slot(a_uKey);
+			while (m_lKey[uSlot] != NameTable::INVALID && m_lKey[uSlot] != a_uKey)
+				uSlot = (uSlot + 1) & uMask;
+			if (m_lKey[uSlot] == NameTable::INVALID)
+			{
+				m_lKey[uSlot] = a_uKey;
+				++m_uCount;
+			}
+			m_lValue[uSlot] = a_Value;
+		}
+		/*
+		USAGE: Removes a handle from the map
+		ARGUMENTS: uint a_uKey -> handle
+		OUTPUT: was it in the map?
+		*/
+		bool Erase(uint a_uKey)
+		{
+			if (m_uCount == 0 || a_uKey == NameTable::INVALID)
+				return false;
+			uint uMask = static_cast<uint>(m_lKey.size()) - 1;
+			uint uSlot = Slot(a_uKey);
+			while (m_lKey[uSlot] != a_uKey)
+			{
+				if (m_lKey[uSlot] == NameTable::INVALID)
+					return false;
+				uSlot = (uSlot + 1) & uMask;
+			}
+			//moves back every entry of the run that would not be found past the hole
+			uint uNext = (uSlot + 1) & uMask;
+			while (m_lKey[uNext] != NameTable::INVALID)
+			{
+				uint uHome = Slot(m_lKey[uNext]);
+				if (((uNext - uHome) & uMask) >= ((uNext - uSlot) & uMask))
+				{
+					m_lKey[uSlot] = m_lKey[uNext];
+					m_lValue[uSlot] = m_lValue[uNext];
+					uSlot = uNext;
+				}
+				uNext = (uNext + 1) & uMask;
+			}
+			m_lKey[uSlot] = NameTable::INVALID;
+			m_lValue[uSlot] = T();
+			--m_uCount;
+			return true;
+		}
+		/*
+		USAGE: Gets the number of handles in the map
+		ARGUMENTS: ---
+		OUTPUT: count
+		*/
+		uint GetCount(void) const { return m_uCount; }
+		/*
+		USAGE: Removes every handle, the slots are kept for reuse
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Clear(void)
+		{
+			std::fill(m_lKey.begin(), m_lKey.end(), NameTable::INVALID);
+			std::fill(m_lValue.begin(), m_lValue.end(), T());
+			m_uCount = 0;
+		}
+
+	private:
+		/*
+		USAGE: Gets the first slot a handle is probed at
+		ARGUMENTS: uint a_uKey -> handle
+		OUTPUT: slot
+		*/
+		uint Slot(uint a_uKey) const
+		{
+			//the handles are consecutive, the golden ratio product spreads them over the high bits
+			return static_cast<uint>((static_cast<unsigned long long>(a_uKey) * 2654435769ULL & 0xFFFFFFFFULL) >> m_uShift);
+		}
+		/*
+		USAGE: Doubles the slots and places the handles again
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Grow(void)
+		{
+			std::vector<uint> lKey(m_lKey.empty() ? 16 : 2 * m_lKey.size(), NameTable::INVALID);
+			std::vector<T> lValue(lKey.size());
+			m_uShift = 32;
+			for (size_t uSize = lKey.size(); uSize > 1; uSize >>= 1)
+				--m_uShift;
+			uint uMask = static_cast<uint>(lKey.size()) - 1;
+			for (uint i = 0; i < m_lKey.size(); ++i)
+			{
+				if (m_lKey[i] == NameTable::INVALID)
+					continue;
+				uint uSlot = Slot(m_lKey[i]);
+				while (lKey[uSlot] != NameTable::INVALID)
+					uSlot = (uSlot + 1) & uMask;
+				lKey[uSlot] = m_lKey[i];
+				lValue[uSlot] = m_lValue[i];
+			}
+			m_lKey.swap(lKey);
+			m_lValue.swap(lValue);
+		}
+	};
+
+} //namespace BTX
+
+#endif //__NAMETABLE_H_
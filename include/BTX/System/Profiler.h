@@ -0,0 +1,279 @@
+#ifndef __PROFILER_H_
+#define __PROFILER_H_
+
+#include "BTX\System\Definitions.h"
+#include "BTX\System\RingQueue.h"
+
+namespace BTX
+{
+	//Time spent inside of a zone by one thread
+	struct ProfileEvent
+	{
+		const char* sName = nullptr; //Name of the zone, it is not copied so it has to be a string literal
+		unsigned long long uStart = 0; //Nanoseconds from the start of the profiler to the start of the zone
+		unsigned long long uEnd = 0; //Nanoseconds from the start of the profiler to the end of the zone
+		uint uThread = 0; //Index of the thread that recorded the zone
+	};
+
+	//Statistics of a zone over the last frames
+	struct ProfileStat
+	{
+		String sName = ""; //Name of the zone
+		uint uCalls = 0; //Times the zone was entered in the last frame
+		float fLastMs = 0.0f; //Milliseconds spent in the zone in the last frame
+		float fAverageMs = 0.0f; //Average milliseconds per frame over the history
+		float fMaxMs = 0.0f; //Largest milliseconds per frame over the history
+	};
+
+	struct ProfileBuffer; //Events of a single thread, defined in Profiler.cpp
+
+	/*
+	Collects the time spent in the zones marked with BTX_PROFILE_ZONE. Each thread pushes its
+	events into its own SPSCQueue without locking and EndFrame pops them once per frame to
+	update the statistics and, while capturing, to keep the events for SaveChromeTrace; an event
+	is only read after its thread published it and a full queue drops new events instead of
+	writing over the ones being read. The profiler starts disabled, a disabled zone only reads
+	a flag inline, without calling into the library.
+	*/
+	//Profiler Singleton
+	class BTXDLL Profiler
+	{
+		//Per frame totals of a zone
+		struct ZoneHistory
+		{
+			String sName = ""; //Name of the zone
+			uint uCalls = 0; //Times entered in the frame being collected
+			double dFrameMs = 0.0; //Milliseconds spent in the frame being collected
+			std::vector<float> lFrameMs; //Milliseconds of the last frames, used as a ring
+			uint uNext = 0; //Next entry of lFrameMs to write
+			ProfileStat stat; //Statistics made at the end of the last frame
+		};
+
+		static Profiler* m_pInstance; //Singleton pointer
+		static std::atomic<bool> m_bEnabled; //Are zones recorded?
+
+		std::mutex m_Mutex; //Guards m_lBuffer, only taken when a thread records its first zone and by EndFrame
+		std::vector<ProfileBuffer*> m_lBuffer; //One buffer per thread that recorded zones
+
+		std::vector<ZoneHistory> m_lZone; //Zones seen so far
+		std::map<const char*, uint> m_mZonePointer; //Index of a zone by the address of its name
+		std::map<String, uint> m_mZoneName; //Index of a zone by its name, for names with several addresses
+		uint m_uHistorySize = 120; //Frames kept by the statistics
+
+		bool m_bCapturing = false; //Are the events being kept for the trace?
+		uint m_uCaptureLimit = 1000000; //Maximum number of events kept for the trace
+		std::vector<ProfileEvent> m_lCapture; //Events kept for the trace
+		uint m_uDropped = 0; //Events dropped because the queue of their thread was full
+
+		unsigned long long m_uFrameStart = 0; //Time at which the current frame started
+
+	public:
+		/*
+		USAGE: Gets/Constructs the singleton pointer
+		ARGUMENTS: ---
+		OUTPUT: singleton pointer
+		*/
+		static Profiler* GetInstance(void);
+		/*
+		USAGE: Destroys the singleton, the threads that record zones have to be done first
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		static void ReleaseInstance(void);
+
+		/*
+		USAGE: Turns the recording of zones on or off, turning it on makes the singleton
+		ARGUMENTS: bool a_bEnabled = true -> record zones?
+		OUTPUT: ---
+		*/
+		static void SetEnabled(bool a_bEnabled = true);
+		/*
+		USAGE: Asks if the zones are being recorded
+		ARGUMENTS: ---
+		OUTPUT: enabled?
+		*/
+		static bool IsEnabled(void) { return m_bEnabled.load(std::memory_order_relaxed); }
+		/*
+		USAGE: Gets the time the zones are measured with
+		ARGUMENTS: ---
+		OUTPUT: nanoseconds since the profiler clock started
+		*/
+		static unsigned long long GetTime(void);
+		/*
+		USAGE: Adds a zone to the buffer of the calling thread, does nothing if disabled
+		ARGUMENTS:
+		-	const char* a_sName -> name of the zone, a string literal
+		-	unsigned long long a_uStart -> GetTime at the start of the zone
+		-	unsigned long long a_uEnd -> GetTime at the end of the zone
+		OUTPUT: ---
+		*/
+		static void Record(const char* a_sName, unsigned long long a_uStart, unsigned long long a_uEnd);
+
+		/*
+		USAGE: Closes the frame, reads the zones every thread recorded since the last call and
+			updates the statistics; call it once per frame from the main thread
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void EndFrame(void);
+		/*
+		USAGE: Gets the number of zones seen so far
+		ARGUMENTS: ---
+		OUTPUT: zone count
+		*/
+		uint GetZoneCount(void);
+		/*
+		USAGE: Gets the statistics of a zone as they were at the end of the last frame
+		ARGUMENTS: uint a_uIndex -> index of the zone
+		OUTPUT: statistics, empty if out of bounds
+		*/
+		ProfileStat GetZoneStat(uint a_uIndex);
+		/*
+		USAGE: Sets the number of frames the statistics are made from
+		ARGUMENTS: uint a_uFrames -> frames to keep, at least 1
+		OUTPUT: ---
+		*/
+		void SetHistorySize(uint a_uFrames);
+		/*
+		USAGE: Gets the number of events dropped because their thread recorded more zones in a
+			frame than its queue holds
+		ARGUMENTS: ---
+		OUTPUT: dropped events
+		*/
+		uint GetDroppedCount(void);
+
+		/*
+		USAGE: Starts keeping the events of the following frames for SaveChromeTrace,
+			the events of a previous capture are discarded
+		ARGUMENTS: uint a_uLimit = 1000000 -> maximum number of events to keep
+		OUTPUT: ---
+		*/
+		void StartCapture(uint a_uLimit = 1000000);
+		/*
+		USAGE: Stops keeping events, the ones kept so far stay until the next capture
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void StopCapture(void);
+		/*
+		USAGE: Asks if the events are being kept
+		ARGUMENTS: ---
+		OUTPUT: capturing?
+		*/
+		bool IsCapturing(void);
+		/*
+		USAGE: Gets the number of events kept
+		ARGUMENTS: ---
+		OUTPUT: event count
+		*/
+		uint GetCaptureSize(void);
+		/*
+		USAGE: Writes the kept events as a Chrome trace (chrome://tracing, Perfetto)
+		ARGUMENTS: String a_sFileName -> file to write
+		OUTPUT: OUT_ERR_NONE if written, OUT_ERR_FILE if the file could not be opened
+		*/
+		eBTX_OUTPUT SaveChromeTrace(String a_sFileName);
+
+	private:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: ---
+		OUTPUT: class object instance
+		*/
+		Profiler(void);
+		/*
+		USAGE: Copy Constructor
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		Profiler(Profiler const& other);
+		/*
+		USAGE: Copy Assignment Operator
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		Profiler& operator=(Profiler const& other);
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~Profiler(void);
+		/*
+		USAGE: Deallocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Release(void);
+		/*
+		USAGE: Allocates member fields
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void Init(void);
+		/*
+		USAGE: Gets the buffer of the calling thread, making it the first time
+		ARGUMENTS: ---
+		OUTPUT: buffer of the thread
+		*/
+		ProfileBuffer* GetThreadBuffer(void);
+		/*
+		USAGE: Gets the index of a zone, adding it the first time it is seen
+		ARGUMENTS: const char* a_sName -> name of the zone
+		OUTPUT: index in m_lZone
+		*/
+		uint GetZoneIndex(const char* a_sName);
+	};
+
+	//Measures the scope it is declared in, use it through BTX_PROFILE_ZONE
+	class BTXDLL ProfileZone
+	{
+		const char* m_sName = nullptr; //Name of the zone
+		unsigned long long m_uStart = 0; //Time at which the zone started
+		bool m_bActive = false; //Was the profiler enabled when the zone started?
+
+	public:
+		/*
+		USAGE: Starts the zone
+		ARGUMENTS: const char* a_sName -> name of the zone, a string literal
+		OUTPUT: class object instance
+		*/
+		ProfileZone(const char* a_sName)
+		{
+			m_bActive = Profiler::IsEnabled();
+			if (m_bActive)
+			{
+				m_sName = a_sName;
+				m_uStart = Profiler::GetTime();
+			}
+		}
+		/*
+		USAGE: Ends the zone and records it
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~ProfileZone(void)
+		{
+			if (m_bActive)
+				Profiler::Record(m_sName, m_uStart, Profiler::GetTime());
+		}
+
+	private:
+		ProfileZone(ProfileZone const& other);
+		ProfileZone& operator=(ProfileZone const& other);
+	};
+
+} //namespace BTX
+
+/*
+	USAGE: measures the rest of the scope as a zone of the profiler, define BTX_NO_PROFILER to compile the zones out
+*/
+#ifndef BTX_NO_PROFILER
+#	define BTX_PROFILE_JOIN_(a, b) a##b
+#	define BTX_PROFILE_JOIN(a, b) BTX_PROFILE_JOIN_(a, b)
+#	define BTX_PROFILE_ZONE(name) BTX::ProfileZone BTX_PROFILE_JOIN(btxProfileZone, __LINE__)(name)
+#else
+#	define BTX_PROFILE_ZONE(name)
+#endif
+
+#endif //__PROFILER_H_
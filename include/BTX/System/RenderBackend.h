@@ -0,0 +1,349 @@
+#ifndef __RENDERBACKEND_H_
+#define __RENDERBACKEND_H_
+
+#include "BTX\System\Definitions.h"
+
+namespace BTX
+{
+	//Implementations of RenderBackend
+	enum eBTX_BACKEND
+	{
+		BACKEND_OPENGL, //Calls OpenGL, needs a context
+		BACKEND_NULL //Records the calls and draws nothing, does not need a context
+	};
+
+	//Kinds of calls recorded by the null backend
+	enum eBTX_COMMAND
+	{
+		COMMAND_CREATE, //uObject: new name, uValue: 0 vertex array, 1 buffer, 2 program, 3 texture
+		COMMAND_DELETE, //uObject: name deleted, uValue: same as COMMAND_CREATE
+		COMMAND_USE_PROGRAM, //uObject: program
+		COMMAND_BIND_VERTEX_ARRAY, //uObject: vertex array
+		COMMAND_BIND_BUFFER, //uObject: buffer, uValue: target
+		COMMAND_BIND_TEXTURE, //uObject: texture, uValue: texture unit
+		COMMAND_BUFFER_DATA, //uObject: target, uValue: bytes
+		COMMAND_VERTEX_ATTRIBUTE, //uObject: attribute index, uValue: components, uCount: offset in bytes
+		COMMAND_VERTEX_DIVISOR, //uObject: attribute index, uValue: divisor
+		COMMAND_TEXTURE_IMAGE, //uObject: texture, uValue: bytes, uCount: levels
+		COMMAND_UNIFORM, //uObject: location, uValue: bytes, uCount: elements
+		COMMAND_POLYGON_MODE, //uObject: mode
+		COMMAND_POLYGON_OFFSET, //no arguments
+		COMMAND_ENABLE, //uObject: capability
+		COMMAND_DISABLE, //uObject: capability
+		COMMAND_DRAW //uObject: primitive, uValue: vertices, uCount: instances
+	};
+
+	//A call recorded by the null backend
+	struct RenderCommand
+	{
+		eBTX_COMMAND eType = COMMAND_DRAW; //Kind of call
+		uint uObject = 0; //Main argument, see eBTX_COMMAND
+		uint uValue = 0; //Second argument, see eBTX_COMMAND
+		uint uCount = 0; //Third argument, see eBTX_COMMAND
+	};
+
+	//Totals of the calls made to the null backend since its last ResetStats
+	struct RenderStats
+	{
+		uint uDrawCalls = 0; //DrawArraysInstanced calls
+		unsigned long long uInstances = 0; //Instances drawn
+		unsigned long long uVertices = 0; //Vertices drawn, counting every instance
+		uint uProgramBinds = 0; //UseProgram calls
+		uint uVertexArrayBinds = 0; //BindVertexArray calls
+		uint uBufferBinds = 0; //BindBuffer calls
+		uint uTextureBinds = 0; //BindTexture calls
+		uint uStateChanges = 0; //PolygonMode, PolygonOffset, Enable and Disable calls
+		uint uUniformLookups = 0; //GetUniformLocation calls
+		uint uUniformUploads = 0; //Uniform calls
+		unsigned long long uUniformBytes = 0; //Bytes sent as uniforms
+		uint uBufferUploads = 0; //BufferData calls
+		unsigned long long uBufferBytes = 0; //Bytes sent to buffers
+		uint uTextureUploads = 0; //TextureImage calls
+		unsigned long long uTextureBytes = 0; //Bytes sent to textures
+		uint uObjectsCreated = 0; //Vertex arrays, buffers, programs and textures made
+		uint uObjectsDeleted = 0; //Vertex arrays, buffers, programs and textures deleted
+		uint uProgramsCompiled = 0; //CreateProgram calls
+		uint uProgramsLoaded = 0; //CreateProgramFromBinary calls that gave a program
+	};
+
+	/*
+	Every call the engine makes to the GPU goes through the active backend. OpenGL is the
+	default; the null backend makes no calls and keeps totals (and optionally the list) of
+	what it was asked to do, so meshes can be made and rendered without a window to measure
+	and test the submission code. The names the null backend returns are never 0.
+	*/
+	//RenderBackend Singleton
+	class BTXDLL RenderBackend
+	{
+		static RenderBackend* m_pInstance; //Singleton pointer
+
+	public:
+		/*
+		USAGE: Gets the active backend, makes the OpenGL one if none was set
+		ARGUMENTS: ---
+		OUTPUT: singleton pointer
+		*/
+		static RenderBackend* GetInstance(void);
+		/*
+		USAGE: Destroys the active backend, the objects made with it have to be released first
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		static void ReleaseInstance(void);
+		/*
+		USAGE: Makes the given backend the active one; call it before any mesh, shader or texture
+			is made, the objects made by a backend only mean something to that backend
+		ARGUMENTS: eBTX_BACKEND a_eBackend -> backend to use
+		OUTPUT: ---
+		*/
+		static void SetBackend(eBTX_BACKEND a_eBackend);
+
+		/*
+		USAGE: Destructor
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual ~RenderBackend(void) {}
+		/*
+		USAGE: Gets the kind of backend
+		ARGUMENTS: ---
+		OUTPUT: kind
+		*/
+		virtual eBTX_BACKEND GetType(void) = 0;
+		/*
+		USAGE: Gets the totals of the calls made since the last ResetStats, only the null backend counts
+		ARGUMENTS: ---
+		OUTPUT: totals
+		*/
+		virtual RenderStats GetStats(void) { return RenderStats(); }
+		/*
+		USAGE: Zeroes the totals
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		virtual void ResetStats(void) {}
+
+		//Objects, mirror glGen*/glDelete*
+		virtual GLuint CreateVertexArray(void) = 0;
+		virtual void DeleteVertexArray(GLuint a_uVertexArray) = 0;
+		virtual GLuint CreateBuffer(void) = 0;
+		virtual void DeleteBuffer(GLuint a_uBuffer) = 0;
+		virtual GLuint CreateTexture(void) = 0;
+		virtual void DeleteTexture(GLuint a_uTexture) = 0;
+		/*
+		USAGE: Compiles and links a program, prints the log if there is one
+		ARGUMENTS:
+		-	String a_sVertexSource -> code of the vertex shader
+		-	String a_sFragmentSource -> code of the fragment shader
+		OUTPUT: program name
+		*/
+		virtual GLuint CreateProgram(String a_sVertexSource, String a_sFragmentSource) = 0;
+		virtual void DeleteProgram(GLuint a_uProgram) = 0;
+		/*
+		USAGE: Gets a text that names the driver, a program binary only loads back under the
+			same driver it was taken from
+		ARGUMENTS: ---
+		OUTPUT: vendor, renderer and version of the driver
+		*/
+		virtual String GetDriverID(void) = 0;
+		/*
+		USAGE: Gets the linked binary of a program so it can be made again without compiling
+		ARGUMENTS:
+		-	GLuint a_uProgram -> linked program
+		-	std::vector<char>& a_lBinary -> receives the binary
+		-	GLenum& a_eFormat -> receives the format of the binary
+		OUTPUT: was there a binary to get?
+		*/
+		virtual bool GetProgramBinary(GLuint a_uProgram, std::vector<char>& a_lBinary, GLenum& a_eFormat) = 0;
+		/*
+		USAGE: Makes a program out of a binary given by GetProgramBinary
+		ARGUMENTS:
+		-	GLenum a_eFormat -> format of the binary
+		-	const void* a_pBinary -> binary
+		-	uint a_uBytes -> size of the binary
+		OUTPUT: program name, 0 if the driver rejected the binary
+		*/
+		virtual GLuint CreateProgramFromBinary(GLenum a_eFormat, const void* a_pBinary, uint a_uBytes) = 0;
+
+		//Data, mirror glBufferData/glVertexAttribPointer/glTexImage2D
+		virtual void BindBuffer(GLenum a_eTarget, GLuint a_uBuffer) = 0;
+		virtual void BufferData(GLenum a_eTarget, uint a_uBytes, const void* a_pData, GLenum a_eUsage) = 0;
+		/*
+		USAGE: Enables a float attribute of the bound vertex array and points it into the bound buffer
+		ARGUMENTS:
+		-	GLuint a_uIndex -> attribute index
+		-	GLint a_nComponents -> floats in the attribute
+		-	GLsizei a_nStride -> bytes between vertices
+		-	uint a_uOffset -> bytes from the start of the vertex to the attribute
+		OUTPUT: ---
+		*/
+		virtual void VertexAttribute(GLuint a_uIndex, GLint a_nComponents, GLsizei a_nStride, uint a_uOffset) = 0;
+		/*
+		USAGE: Makes an attribute of the bound vertex array advance per instance instead of per vertex
+		ARGUMENTS:
+		-	GLuint a_uIndex -> attribute index
+		-	GLuint a_uDivisor -> instances drawn before it advances, 0 goes back to per vertex
+		OUTPUT: ---
+		*/
+		virtual void VertexDivisor(GLuint a_uIndex, GLuint a_uDivisor) = 0;
+		/*
+		USAGE: Sends the pixels of a 2D texture and its mip levels, with clamped edges, nearest
+			filtering when magnified and trilinear when minified
+		ARGUMENTS:
+		-	GLuint a_uTexture -> texture to fill, it is left bound
+		-	int a_nWidth -> width in pixels of the first level
+		-	int a_nHeight -> height in pixels of the first level
+		-	const void* a_pPixels -> 4 bytes per pixel, every level one after the other, each
+			half the size of the last one down to 1x1
+		-	uint a_uLevels -> levels in a_pPixels, 1 for no mip levels
+		-	GLenum a_eFormat -> order of the channels, GL_RGBA or GL_BGRA
+		OUTPUT: was it sent without errors?
+		*/
+		virtual bool TextureImage(GLuint a_uTexture, int a_nWidth, int a_nHeight, const void* a_pPixels, uint a_uLevels, GLenum a_eFormat) = 0;
+
+		//State, mirror glUseProgram/glBindVertexArray/glActiveTexture + glBindTexture/glPolygonMode/...
+		virtual void UseProgram(GLuint a_uProgram) = 0;
+		virtual void BindVertexArray(GLuint a_uVertexArray) = 0;
+		virtual void BindTexture(uint a_uUnit, GLuint a_uTexture) = 0;
+		virtual void PolygonMode(GLenum a_eMode) = 0;
+		virtual void PolygonOffset(float a_fFactor, float a_fUnits) = 0;
+		virtual void Enable(GLenum a_eCapability) = 0;
+		virtual void Disable(GLenum a_eCapability) = 0;
+
+		//Uniforms of the program in use, mirror glGetUniformLocation/glUniform*
+		virtual GLint GetUniformLocation(GLuint a_uProgram, const char* a_sName) = 0;
+		virtual void Uniform1i(GLint a_nLocation, int a_nValue) = 0;
+		virtual void Uniform1f(GLint a_nLocation, float a_fValue) = 0;
+		virtual void Uniform3f(GLint a_nLocation, float a_fX, float a_fY, float a_fZ) = 0;
+		virtual void UniformMatrix4(GLint a_nLocation, uint a_uCount, const float* a_pMatrix) = 0;
+
+		//Draws, mirror glDrawArraysInstanced
+		virtual void DrawArraysInstanced(GLenum a_ePrimitive, uint a_uFirst, uint a_uVertices, uint a_uInstances) = 0;
+	};
+
+	//Forwards every call to OpenGL
+	class BTXDLL GLRenderBackend : public RenderBackend
+	{
+	public:
+		eBTX_BACKEND GetType(void) override;
+		GLuint CreateVertexArray(void) override;
+		void DeleteVertexArray(GLuint a_uVertexArray) override;
+		GLuint CreateBuffer(void) override;
+		void DeleteBuffer(GLuint a_uBuffer) override;
+		GLuint CreateTexture(void) override;
+		void DeleteTexture(GLuint a_uTexture) override;
+		GLuint CreateProgram(String a_sVertexSource, String a_sFragmentSource) override;
+		void DeleteProgram(GLuint a_uProgram) override;
+		String GetDriverID(void) override;
+		bool GetProgramBinary(GLuint a_uProgram, std::vector<char>& a_lBinary, GLenum& a_eFormat) override;
+		GLuint CreateProgramFromBinary(GLenum a_eFormat, const void* a_pBinary, uint a_uBytes) override;
+		void BindBuffer(GLenum a_eTarget, GLuint a_uBuffer) override;
+		void BufferData(GLenum a_eTarget, uint a_uBytes, const void* a_pData, GLenum a_eUsage) override;
+		void VertexAttribute(GLuint a_uIndex, GLint a_nComponents, GLsizei a_nStride, uint a_uOffset) override;
+		void VertexDivisor(GLuint a_uIndex, GLuint a_uDivisor) override;
+		bool TextureImage(GLuint a_uTexture, int a_nWidth, int a_nHeight, const void* a_pPixels, uint a_uLevels, GLenum a_eFormat) override;
+		void UseProgram(GLuint a_uProgram) override;
+		void BindVertexArray(GLuint a_uVertexArray) override;
+		void BindTexture(uint a_uUnit, GLuint a_uTexture) override;
+		void PolygonMode(GLenum a_eMode) override;
+		void PolygonOffset(float a_fFactor, float a_fUnits) override;
+		void Enable(GLenum a_eCapability) override;
+		void Disable(GLenum a_eCapability) override;
+		GLint GetUniformLocation(GLuint a_uProgram, const char* a_sName) override;
+		void Uniform1i(GLint a_nLocation, int a_nValue) override;
+		void Uniform1f(GLint a_nLocation, float a_fValue) override;
+		void Uniform3f(GLint a_nLocation, float a_fX, float a_fY, float a_fZ) override;
+		void UniformMatrix4(GLint a_nLocation, uint a_uCount, const float* a_pMatrix) override;
+		void DrawArraysInstanced(GLenum a_ePrimitive, uint a_uFirst, uint a_uVertices, uint a_uInstances) override;
+	};
+
+	//Counts every call and, while recording, keeps them in order; makes no OpenGL calls
+	class BTXDLL NullRenderBackend : public RenderBackend
+	{
+		RenderStats m_Stats; //Totals since the last ResetStats
+		bool m_bRecording = false; //Are the calls being kept?
+		std::vector<RenderCommand> m_lCommand; //Calls kept while recording
+		GLuint m_uNextName = 1; //Next name to give to an object
+		std::map<String, GLint> m_mUniform; //Location given to each uniform name
+
+	public:
+		/*
+		USAGE: Starts or stops keeping the calls, starting discards the ones kept before
+		ARGUMENTS: bool a_bRecording = true -> keep the calls?
+		OUTPUT: ---
+		*/
+		void SetRecording(bool a_bRecording = true);
+		/*
+		USAGE: Asks if the calls are being kept
+		ARGUMENTS: ---
+		OUTPUT: recording?
+		*/
+		bool IsRecording(void);
+		/*
+		USAGE: Gets the number of calls kept
+		ARGUMENTS: ---
+		OUTPUT: count
+		*/
+		uint GetCommandCount(void);
+		/*
+		USAGE: Gets a call kept, in the order they were made
+		ARGUMENTS: uint a_uIndex -> index of the call
+		OUTPUT: call, an empty draw if out of bounds
+		*/
+		RenderCommand GetCommand(uint a_uIndex);
+		/*
+		USAGE: Discards the calls kept
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		void ClearCommands(void);
+
+		eBTX_BACKEND GetType(void) override;
+		RenderStats GetStats(void) override;
+		void ResetStats(void) override;
+		GLuint CreateVertexArray(void) override;
+		void DeleteVertexArray(GLuint a_uVertexArray) override;
+		GLuint CreateBuffer(void) override;
+		void DeleteBuffer(GLuint a_uBuffer) override;
+		GLuint CreateTexture(void) override;
+		void DeleteTexture(GLuint a_uTexture) override;
+		GLuint CreateProgram(String a_sVertexSource, String a_sFragmentSource) override;
+		void DeleteProgram(GLuint a_uProgram) override;
+		String GetDriverID(void) override;
+		bool GetProgramBinary(GLuint a_uProgram, std::vector<char>& a_lBinary, GLenum& a_eFormat) override;
+		GLuint CreateProgramFromBinary(GLenum a_eFormat, const void* a_pBinary, uint a_uBytes) override;
+		void BindBuffer(GLenum a_eTarget, GLuint a_uBuffer) override;
+		void BufferData(GLenum a_eTarget, uint a_uBytes, const void* a_pData, GLenum a_eUsage) override;
+		void VertexAttribute(GLuint a_uIndex, GLint a_nComponents, GLsizei a_nStride, uint a_uOffset) override;
+		void VertexDivisor(GLuint a_uIndex, GLuint a_uDivisor) override;
+		bool TextureImage(GLuint a_uTexture, int a_nWidth, int a_nHeight, const void* a_pPixels, uint a_uLevels, GLenum a_eFormat) override;
+		void UseProgram(GLuint a_uProgram) override;
+		void BindVertexArray(GLuint a_uVertexArray) override;
+		void BindTexture(uint a_uUnit, GLuint a_uTexture) override;
+		void PolygonMode(GLenum a_eMode) override;
+		void PolygonOffset(float a_fFactor, float a_fUnits) override;
+		void Enable(GLenum a_eCapability) override;
+		void Disable(GLenum a_eCapability) override;
+		GLint GetUniformLocation(GLuint a_uProgram, const char* a_sName) override;
+		void Uniform1i(GLint a_nLocation, int a_nValue) override;
+		void Uniform1f(GLint a_nLocation, float a_fValue) override;
+		void Uniform3f(GLint a_nLocation, float a_fX, float a_fY, float a_fZ) override;
+		void UniformMatrix4(GLint a_nLocation, uint a_uCount, const float* a_pMatrix) override;
+		void DrawArraysInstanced(GLenum a_ePrimitive, uint a_uFirst, uint a_uVertices, uint a_uInstances) override;
+
+	private:
+		/*
+		USAGE: Keeps a call if recording
+		ARGUMENTS:
+		-	eBTX_COMMAND a_eType -> kind of call
+		-	uint a_uObject -> main argument
+		-	uint a_uValue -> second argument
+		-	uint a_uCount -> third argument
+		OUTPUT: ---
+		*/
+		void Record(eBTX_COMMAND a_eType, uint a_uObject = 0, uint a_uValue = 0, uint a_uCount = 0);
+	};
+
+} //namespace BTX
+
+#endif //__RENDERBACKEND_H_
@@ -0,0 +1,286 @@
+#ifndef __RINGQUEUE_H_
+#define __RINGQUEUE_H_
+
+//Only the standard library, so projects without the rest of BTX can use the queues too
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BTX
+{
+	//Bytes the indices of the queues are spread apart by so each one sits on its own cache line
+	static const size_t uQueueCacheLine = 64;
+
+	/*
+	Bounded queue for handing objects from one thread to another, like the std::deque of
+	HW01_STDQueue but without locks: exactly one thread may push and exactly one other thread
+	may pop. The slots are a ring of raw storage a power of two in size, objects are built in
+	place when pushed and moved out when popped so payloads that cannot be copied work too.
+	Each side keeps a copy of the index of the other side and only reads the shared one when
+	its copy says the queue is full or empty, most calls touch no cache line the other thread
+	writes to.
+	*/
+	//SPSCQueue Class
+	template <class T>
+	class SPSCQueue
+	{
+		typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot; //Storage of one object
+
+		alignas(uQueueCacheLine) std::atomic<size_t> m_uHead; //Next slot to pop, written by the consumer
+		size_t m_uTailCache = 0; //Consumer copy of m_uTail
+		alignas(uQueueCacheLine) std::atomic<size_t> m_uTail; //Next slot to push, written by the producer
+		size_t m_uHeadCache = 0; //Producer copy of m_uHead
+		alignas(uQueueCacheLine) size_t m_uMask = 0; //Slots minus one
+		std::vector<Slot> m_lSlot; //Ring of slots
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: size_t a_uCapacity -> objects the queue holds, rounded up to a power of two
+		OUTPUT: class object instance
+		*/
+		explicit SPSCQueue(size_t a_uCapacity)
+		{
+			size_t uSize = 2;
+			while (uSize < a_uCapacity)
+				uSize <<= 1;
+			m_lSlot.resize(uSize);
+			m_uMask = uSize - 1;
+			m_uHead.store(0, std::memory_order_relaxed);
+			m_uTail.store(0, std::memory_order_relaxed);
+		}
+		/*
+		USAGE: Destructor, destroys the objects still in the queue
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~SPSCQueue(void)
+		{
+			size_t uTail = m_uTail.load(std::memory_order_relaxed);
+			for (size_t i = m_uHead.load(std::memory_order_relaxed); i != uTail; ++i)
+				reinterpret_cast<T*>(&m_lSlot[i & m_uMask])->~T();
+		}
+		/*
+		USAGE: Builds an object at the back of the queue, only from the producer thread
+		ARGUMENTS: Args&&... a_Args -> arguments of the constructor of the object
+		OUTPUT: false if the queue was full, nothing was built then
+		*/
+		template <class... Args>
+		bool TryPush(Args&&... a_Args)
+		{
+			size_t uTail = m_uTail.load(std::memory_order_relaxed);
+			if (uTail - m_uHeadCache > m_uMask)
+			{
+				m_uHeadCache = m_uHead.load(std::memory_order_acquire);
+				if (uTail - m_uHeadCache > m_uMask)
+					return false;
+			}
+			new (&m_lSlot[uTail & m_uMask]) T(std::forward<Args>(a_Args)...);
+			m_uTail.store(uTail + 1, std::memory_order_release);
+			return true;
+		}
+		/*
+		USAGE: Moves the object at the front of the queue out, only from the consumer thread
+		ARGUMENTS: T& a_Out -> [out] object popped
+		OUTPUT: false if the queue was empty, a_Out is untouched then
+		*/
+		bool TryPop(T& a_Out)
+		{
+			size_t uHead = m_uHead.load(std::memory_order_relaxed);
+			if (uHead == m_uTailCache)
+			{
+				m_uTailCache = m_uTail.load(std::memory_order_acquire);
+				if (uHead == m_uTailCache)
+					return false;
+			}
+			T* pObject = reinterpret_cast<T*>(&m_lSlot[uHead & m_uMask]);
+			a_Out = std::move(*pObject);
+			pObject->~T();
+			m_uHead.store(uHead + 1, std::memory_order_release);
+			return true;
+		}
+		/*
+		USAGE: Gets the number of objects in the queue, only a hint while the other thread works
+		ARGUMENTS: ---
+		OUTPUT: objects
+		*/
+		size_t GetSize(void) const
+		{
+			return m_uTail.load(std::memory_order_acquire) - m_uHead.load(std::memory_order_acquire);
+		}
+		/*
+		USAGE: Gets the number of objects the queue holds
+		ARGUMENTS: ---
+		OUTPUT: capacity
+		*/
+		size_t GetCapacity(void) const { return m_uMask + 1; }
+
+	private:
+		/*
+		USAGE: Copy Constructor, a queue other threads are using cannot be copied
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		SPSCQueue(SPSCQueue const& other);
+		/*
+		USAGE: Copy Assignment Operator, a queue other threads are using cannot be copied
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		SPSCQueue& operator=(SPSCQueue const& other);
+	};
+
+	/*
+	Bounded queue any number of threads may push to and pop from at the same time. Each slot
+	carries a sequence number that says whose turn it is: a producer claims the back index with
+	a compare and swap when the sequence of its slot says the slot is free, builds the object
+	and then moves the sequence forward for the consumers; consumers do the same from the front.
+	No thread waits on a lock, a thread that loses a race tries again with the next index.
+	*/
+	//MPMCQueue Class
+	template <class T>
+	class MPMCQueue
+	{
+		//Slot of the ring with the turn it is on
+		struct Cell
+		{
+			std::atomic<size_t> uSequence; //Index it can be pushed at, or that index plus one once it holds an object
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage; //Storage of one object
+		};
+
+		alignas(uQueueCacheLine) std::atomic<size_t> m_uTail; //Next index to push at
+		alignas(uQueueCacheLine) std::atomic<size_t> m_uHead; //Next index to pop from
+		alignas(uQueueCacheLine) size_t m_uMask = 0; //Cells minus one
+		Cell* m_pCell = nullptr; //Ring of cells
+
+	public:
+		/*
+		USAGE: Constructor
+		ARGUMENTS: size_t a_uCapacity -> objects the queue holds, rounded up to a power of two
+		OUTPUT: class object instance
+		*/
+		explicit MPMCQueue(size_t a_uCapacity)
+		{
+			size_t uSize = 2;
+			while (uSize < a_uCapacity)
+				uSize <<= 1;
+			m_pCell = new Cell[uSize];
+			for (size_t i = 0; i < uSize; ++i)
+				m_pCell[i].uSequence.store(i, std::memory_order_relaxed);
+			m_uMask = uSize - 1;
+			m_uHead.store(0, std::memory_order_relaxed);
+			m_uTail.store(0, std::memory_order_relaxed);
+		}
+		/*
+		USAGE: Destructor, destroys the objects still in the queue
+		ARGUMENTS: ---
+		OUTPUT: ---
+		*/
+		~MPMCQueue(void)
+		{
+			size_t uTail = m_uTail.load(std::memory_order_relaxed);
+			for (size_t i = m_uHead.load(std::memory_order_relaxed); i != uTail; ++i)
+				reinterpret_cast<T*>(&m_pCell[i & m_uMask].Storage)->~T();
+			delete[] m_pCell;
+			m_pCell = nullptr;
+		}
+		/*
+		USAGE: Builds an object at the back of the queue
+		ARGUMENTS: Args&&... a_Args -> arguments of the constructor of the object
+		OUTPUT: false if the queue was full, nothing was built then
+		*/
+		template <class... Args>
+		bool TryPush(Args&&... a_Args)
+		{
+			size_t uTail = m_uTail.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell& cell = m_pCell[uTail & m_uMask];
+				size_t uSequence = cell.uSequence.load(std::memory_order_acquire);
+				std::ptrdiff_t nTurn = static_cast<std::ptrdiff_t>(uSequence - uTail);
+				if (nTurn == 0)
+				{
+					//the cell is free, whoever moves the tail first gets it
+					if (m_uTail.compare_exchange_weak(uTail, uTail + 1, std::memory_order_relaxed))
+					{
+						new (&cell.Storage) T(std::forward<Args>(a_Args)...);
+						cell.uSequence.store(uTail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (nTurn < 0)
+					return false; //the cell still holds the object of a lap ago
+				else
+					uTail = m_uTail.load(std::memory_order_relaxed);
+			}
+		}
+		/*
+		USAGE: Moves the object at the front of the queue out
+		ARGUMENTS: T& a_Out -> [out] object popped
+		OUTPUT: false if the queue was empty, a_Out is untouched then
+		*/
+		bool TryPop(T& a_Out)
+		{
+			size_t uHead = m_uHead.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell& cell = m_pCell[uHead & m_uMask];
+				size_t uSequence = cell.uSequence.load(std::memory_order_acquire);
+				std::ptrdiff_t nTurn = static_cast<std::ptrdiff_t>(uSequence - (uHead + 1));
+				if (nTurn == 0)
+				{
+					if (m_uHead.compare_exchange_weak(uHead, uHead + 1, std::memory_order_relaxed))
+					{
+						T* pObject = reinterpret_cast<T*>(&cell.Storage);
+						a_Out = std::move(*pObject);
+						pObject->~T();
+						//frees the cell for the producers of the next lap
+						cell.uSequence.store(uHead + m_uMask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (nTurn < 0)
+					return false; //nothing was pushed to this cell yet
+				else
+					uHead = m_uHead.load(std::memory_order_relaxed);
+			}
+		}
+		/*
+		USAGE: Gets the number of objects in the queue, only a hint while other threads work
+		ARGUMENTS: ---
+		OUTPUT: objects
+		*/
+		size_t GetSize(void) const
+		{
+			size_t uHead = m_uHead.load(std::memory_order_acquire);
+			size_t uTail = m_uTail.load(std::memory_order_acquire);
+			return uTail > uHead ? uTail - uHead : 0;
+		}
+		/*
+		USAGE: Gets the number of objects the queue holds
+		ARGUMENTS: ---
+		OUTPUT: capacity
+		*/
+		size_t GetCapacity(void) const { return m_uMask + 1; }
+
+	private:
+		/*
+		USAGE: Copy Constructor, a queue other threads are using cannot be copied
+		ARGUMENTS: class object to copy
+		OUTPUT: class object instance
+		*/
+		MPMCQueue(MPMCQueue const& other);
+		/*
+		USAGE: Copy Assignment Operator, a queue other threads are using cannot be copied
+		ARGUMENTS: class object to copy
+		OUTPUT: ---
+		*/
+		MPMCQueue& operator=(MPMCQueue const& other);
+	};
+
+} //namespace BTX
+
+#endif //__RINGQUEUE_H_
@@ -12,12 +12,35 @@ Update: 2021/02
 namespace BTX
 {
 
+//Uniforms the engine sets on its shaders, their locations are looked up once after linking
+enum eBTX_UNIFORM
+{
+	UNIFORM_VP, //"VP", projection times view
+	UNIFORM_TO_WORLD, //"m4ToWorld", matrix of each instance
+	UNIFORM_WIREFRAME, //"vWireframe", color of the wireframe
+	UNIFORM_TEXTURE, //"TextureID", diffuse map unit
+	UNIFORM_NORMAL, //"NormalID", normal map unit
+	UNIFORM_SPECULAR, //"SpecularID", specular map unit
+	UNIFORM_TEXTURE_MASK, //"nTexture", maps in use
+	UNIFORM_TINT, //"Tint", color multiplied to the mesh
+	UNIFORM_MODEL_TO_WORLD, //"m4ModelToWorld", matrix of the whole model
+	UNIFORM_LIGHT_POSITION, //"LightPosition_W", light in world space
+	UNIFORM_LIGHT_COLOR, //"LightColor"
+	UNIFORM_LIGHT_POWER, //"LightPower"
+	UNIFORM_AMBIENT_COLOR, //"AmbientColor"
+	UNIFORM_AMBIENT_POWER, //"AmbientPower"
+	UNIFORM_CAMERA_POSITION, //"CameraPosition_W", camera in world space
+	UNIFORM_CAMERA_ON_WORLD, //"m4CameraOnWorld", matrix of the camera
+	UNIFORM_COUNT //Number of uniforms, not a uniform
+};
+
 class BTXDLL Shader
 {
 	String m_sProgramName = "NULL";
 	String m_sVertexShaderName = "NULL";
 	String m_sFragmentShaderName = "NULL";
 	GLuint m_nProgram = 0;
+	GLint m_nUniform[UNIFORM_COUNT]; //Location of each engine uniform, -1 if the program does not use it
 public:
 	/*
 	USAGE:
@@ -55,11 +78,17 @@ public:
 	void Swap(Shader& other);
 
 	/*
-	USAGE:
+	USAGE: Compiles and links the program, or loads it from the binary cache file if one is
+		given and it was saved from the same sources and driver; the locations of the engine
+		uniforms are looked up right after
 	ARGUMENTS:
-	OUTPUT:
+	-	String a_sVertexShader -> vertex shader file
+	-	String a_sFragmentShader -> fragment shader file
+	-	String a_sName = "" -> name of the program, made from the files if empty
+	-	String a_sCacheFile = "" -> binary cache file, no cache if empty
+	OUTPUT: program, 0 if it could not be made
 	*/
-	GLuint CompileShader(String a_sVertexShader, String a_sFragmentShader, String a_sName = "");
+	GLuint CompileShader(String a_sVertexShader, String a_sFragmentShader, String a_sName = "", String a_sCacheFile = "");
 
 	/*
 	USAGE:
@@ -89,6 +118,20 @@ public:
 	*/
 	int GetProgramID(void);
 
+	/*
+	USAGE: Gets the location of an engine uniform, looked up when the program was made
+	ARGUMENTS: eBTX_UNIFORM a_eUniform -> uniform to get
+	OUTPUT: location, -1 if the program does not use it
+	*/
+	GLint GetUniform(eBTX_UNIFORM a_eUniform);
+
+	/*
+	USAGE: Gets the locations of all the engine uniforms, indexed by eBTX_UNIFORM
+	ARGUMENTS: ---
+	OUTPUT: table of UNIFORM_COUNT locations
+	*/
+	const GLint* GetUniformTable(void);
+
 	/*
 	USAGE:
 	ARGUMENTS: ---
@@ -103,6 +146,13 @@ protected:
 	OUTPUT: ---
 	*/
 	void Init(void);
+
+	/*
+	USAGE: Looks up the locations of the engine uniforms in the program
+	ARGUMENTS: ---
+	OUTPUT: ---
+	*/
+	void ResolveUniforms(void);
 	
 };
 
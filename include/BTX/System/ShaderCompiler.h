@@ -8,19 +8,23 @@ Update: 2021/02
 #ifndef __SHADERCOMPILER_H_
 #define __SHADERCOMPILER_H_
 
-#include "BTX\System\Definitions.h"
+#include "BTX\System\RenderBackend.h"
 
 /*
-USAGE: Will load the specified files as vertex and fragment shaders
+USAGE: Will load the specified files as vertex and fragment shaders; with a cache file the
+	linked binary is loaded from it when it was saved from the same sources on the same
+	driver, otherwise the program is compiled and its binary saved there for the next run
 ARGUMENTS:
 -	const char * vertex_file_path -> vertex shader file
 -	const char * fragment_file_path -> fragment shader file
+-	const char * cache_file_path = nullptr -> binary cache file, no cache if null
 OUTPUT: opengl identifier of the loaded shader (0 if error)
 */
 namespace BTX
 {
 
-	BTXDLL GLuint LoadShaders(const char * vertex_file_path, const char * fragment_file_path);
+	BTXDLL GLuint LoadShaders(const char * vertex_file_path, const char * fragment_file_path,
+		const char * cache_file_path = nullptr);
 
 } //namespace BTX
 
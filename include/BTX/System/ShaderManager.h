@@ -7,6 +7,7 @@ Update: 2021/02
 #define __SHADERMANAGER_H_
 
 #include "BTX\system\Shader.h"
+#include "BTX\System\NameTable.h"
 
 namespace BTX
 {
@@ -19,7 +20,9 @@ class BTXDLL ShaderManager
 	static ShaderManager* m_pInstance; // Singleton
 	
 	std::vector<Shader> m_vShader; //vector of shaders
-	std::map<String, int> m_map;//Indexer of Shaders
+	NameMap<int> m_map;//Indexer of Shaders by name handle
+	std::map<GLuint, int> m_mProgram; //Index of the shader of each program
+	bool m_bBinaryCache = true; //Are linked programs saved and loaded back from the shader cache?
 
 public:
 	/*
@@ -64,6 +67,36 @@ public:
 	*/
 	int IdentifyShader(String a_sName);
 
+	/*
+	USAGE: Gets the locations of the engine uniforms of a program, looked up once when it was
+		made so drawing does not ask the driver for them by name
+	ARGUMENTS: GLuint a_uProgram -> program given by GetShaderID
+	OUTPUT: table of UNIFORM_COUNT locations indexed by eBTX_UNIFORM, all -1 for an unknown program
+	*/
+	const GLint* GetUniformTable(GLuint a_uProgram);
+
+	/*
+	USAGE: Sets whether the shaders compiled from now on go through the binary cache, the
+		cache files are kept in the Cache folder of the shaders
+	ARGUMENTS: bool a_bCache -> use the cache?
+	OUTPUT: ---
+	*/
+	void SetBinaryCache(bool a_bCache);
+
+	/*
+	USAGE: Asks if the shaders compiled go through the binary cache
+	ARGUMENTS: ---
+	OUTPUT: using the cache?
+	*/
+	bool GetBinaryCache(void);
+
+	/*
+	USAGE: Gets the binary cache file of a shader
+	ARGUMENTS: String a_sName -> name of the shader
+	OUTPUT: file name
+	*/
+	String GetCacheFileName(String a_sName);
+
 private:
 	/*
 	USAGE: Constructor
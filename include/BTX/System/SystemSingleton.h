@@ -7,6 +7,7 @@ Update: 2021/02
 #define __BTXSYSTEM_H_
 
 #include "FolderSingleton.h"
+#include "BTX\System\Profiler.h"
 
 namespace BTX
 {